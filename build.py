@@ -265,15 +265,21 @@ CTX.INPUT['common'] = """
  types.cpp
  UndoLog.cpp
  LargeTempTableBlockCache.cpp
+ LZ4Block.cpp
+ PageAllocator.cpp
+ RegexCache.cpp
+ PolygonCache.cpp
  NValue.cpp
  RecoveryProtoMessage.cpp
  RecoveryProtoMessageBuilder.cpp
  executorcontext.cpp
  serializeio.cpp
+ StreamBufferPool.cpp
  StreamPredicateList.cpp
  Topend.cpp
  TupleOutputStream.cpp
  TupleOutputStreamProcessor.cpp
+ TupleComparer.cpp
  MiscUtil.cpp
  debuglog.cpp
 """
@@ -294,12 +300,14 @@ CTX.INPUT['executors'] = """
  deleteexecutor.cpp
  executorfactory.cpp
  executorutil.cpp
+ hashjoinexecutor.cpp
  indexcountexecutor.cpp
  indexscanexecutor.cpp
  insertexecutor.cpp
  limitexecutor.cpp
  materializedscanexecutor.cpp
  materializeexecutor.cpp
+ mergejoinexecutor.cpp
  mergereceiveexecutor.cpp
  nestloopexecutor.cpp
  nestloopindexexecutor.cpp
@@ -339,12 +347,14 @@ CTX.INPUT['plannodes'] = """
  aggregatenode.cpp
  commontablenode.cpp
  deletenode.cpp
+ hashjoinnode.cpp
  indexcountnode.cpp
  indexscannode.cpp
  insertnode.cpp
  limitnode.cpp
  materializedscanplannode.cpp
  materializenode.cpp
+ mergejoinnode.cpp
  mergereceivenode.cpp
  nestloopindexnode.cpp
  nestloopnode.cpp
@@ -372,6 +382,7 @@ CTX.INPUT['indexes'] = """
 
 CTX.INPUT['storage'] = """
  AbstractDRTupleStream.cpp
+ BinaryLogPipeline.cpp
  BinaryLogSink.cpp
  BinaryLogSinkWrapper.cpp
  ConstraintFailureException.cpp
@@ -485,10 +496,15 @@ if whichtests in ("${eetestsuite}", "common"):
     CTX.TESTS['common'] = """
      debuglog_test
      elastic_hashinator_test
+     LZ4BlockTest
      PerFragmentStatsTest
+     PolygonCacheTest
+     RegexCacheTest
      nvalue_test
+     PageAllocatorTest
      pool_test
      serializeio_test
+     StreamBufferPoolTest
      tabletuple_test
      ThreadLocalPoolTest
      tupleschema_test
@@ -507,6 +523,9 @@ if whichtests in ("${eetestsuite}", "execution"):
 if whichtests in ("${eetestsuite}", "executors"):
     CTX.TESTS['executors'] = """
      CommonTableExpressionTest
+     HashAggregateExecutorTest
+     HashJoinExecutorTest
+     MergeJoinExecutorTest
      OptimizedProjectorTest
      MergeReceiveExecutorTest
     """
@@ -553,9 +572,11 @@ if whichtests in ("${eetestsuite}", "structures"):
     CTX.TESTS['structures'] = """
      CompactingMapTest
      CompactingMapIndexCountTest
+     CompactingBTreeTest
      CompactingHashTest
      CompactingPoolTest
      CompactingMapBenchmark
+     FlatHashMapTest
     """
 
 if whichtests in ("${eetestsuite}", "plannodes"):
@@ -0,0 +1,129 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2018 VoltDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with VoltDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef VOLTDB_LRUCACHE_H
+#define VOLTDB_LRUCACHE_H
+
+#include <cassert>
+#include <list>
+#include <string>
+
+#include <boost/unordered_map.hpp>
+
+namespace voltdb {
+
+/**
+ * The bookkeeping shared by the EE's small per-site caches: entries
+ * keyed by a byte string, kept in most-recently-used order, with a
+ * hash index for lookups.
+ *
+ * The cache does not own what its values point to.  Callers decide
+ * when to evict, and release the least recently used value before
+ * calling popLeastRecentlyUsed().
+ */
+template <typename Value>
+class LRUCache {
+public:
+    struct Entry {
+        std::string key;
+        Value value;
+    };
+
+private:
+    typedef std::list<Entry> EntryList;
+    typedef boost::unordered_map<std::string, typename EntryList::iterator> EntryMap;
+
+public:
+    typedef typename EntryList::iterator iterator;
+
+    LRUCache()
+        : m_entries()
+        , m_index()
+    {
+    }
+
+    bool empty() const {
+        return m_entries.empty();
+    }
+
+    size_t size() const {
+        return m_entries.size();
+    }
+
+    /**
+     * The most recently used entry, or NULL if the cache is empty.
+     * Callers that usually see the same key on every call can compare
+     * against it before building a key to look up.
+     */
+    Entry* mostRecentlyUsed() {
+        return m_entries.empty() ? NULL : &m_entries.front();
+    }
+
+    Entry& leastRecentlyUsed() {
+        assert( ! m_entries.empty());
+        return m_entries.back();
+    }
+
+    /** Return the value for key, making it the most recently used, or NULL */
+    Value* find(const std::string& key) {
+        typename EntryMap::iterator found = m_index.find(key);
+        if (found == m_index.end()) {
+            return NULL;
+        }
+        m_entries.splice(m_entries.begin(), m_entries, found->second);
+        return &m_entries.front().value;
+    }
+
+    /** Add an entry for a key that is not cached, as the most recently used */
+    Value* insert(const std::string& key, const Value& value) {
+        assert(m_index.find(key) == m_index.end());
+        Entry entry;
+        entry.key = key;
+        entry.value = value;
+        m_entries.push_front(entry);
+        m_index[key] = m_entries.begin();
+        return &m_entries.front().value;
+    }
+
+    void popLeastRecentlyUsed() {
+        assert( ! m_entries.empty());
+        m_index.erase(m_entries.back().key);
+        m_entries.pop_back();
+    }
+
+    iterator begin() {
+        return m_entries.begin();
+    }
+
+    iterator end() {
+        return m_entries.end();
+    }
+
+    void clear() {
+        m_entries.clear();
+        m_index.clear();
+    }
+
+private:
+    /** Most recently used first */
+    EntryList m_entries;
+    EntryMap m_index;
+};
+
+} // namespace voltdb
+
+#endif // VOLTDB_LRUCACHE_H
@@ -0,0 +1,223 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2018 VoltDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with VoltDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "common/LZ4Block.h"
+
+#include <algorithm>
+#include <cstring>
+#include <stdint.h>
+
+namespace voltdb {
+
+namespace {
+
+// Limits from the LZ4 block format: the last 5 bytes are always
+// literals, and the last match starts at least 12 bytes from the end.
+const size_t MIN_MATCH = 4;
+const size_t LAST_LITERALS = 5;
+const size_t MF_LIMIT = 12;
+const size_t MAX_OFFSET = 65535;
+const size_t RUN_MASK = 15;
+
+const int HASH_LOG = 12;
+
+inline uint32_t readSequence(const char* position) {
+    uint32_t value;
+    ::memcpy(&value, position, sizeof(value));
+    return value;
+}
+
+inline uint32_t hashSequence(uint32_t sequence) {
+    return (sequence * 2654435761U) >> (32 - HASH_LOG);
+}
+
+inline size_t lengthBytes(size_t length) {
+    return length < RUN_MASK ? 0 : (length - RUN_MASK) / 255 + 1;
+}
+
+inline char* writeLength(char* out, size_t length) {
+    for (length -= RUN_MASK; length >= 255; length -= 255) {
+        *out++ = static_cast<char>(255);
+    }
+    *out++ = static_cast<char>(length);
+    return out;
+}
+
+/**
+ * Write one sequence: the literals, then the match unless matchLength is
+ * 0, which marks the last sequence.  Return NULL if it does not fit.
+ */
+char* writeSequence(char* out, const char* outEnd,
+                    const char* literals, size_t literalLength,
+                    size_t offset, size_t matchLength) {
+    size_t needed = 1 + lengthBytes(literalLength) + literalLength;
+    if (matchLength > 0) {
+        needed += 2 + lengthBytes(matchLength - MIN_MATCH);
+    }
+    if (needed > static_cast<size_t>(outEnd - out)) {
+        return NULL;
+    }
+
+    char* token = out++;
+    *token = static_cast<char>(std::min(literalLength, RUN_MASK) << 4);
+    if (literalLength >= RUN_MASK) {
+        out = writeLength(out, literalLength);
+    }
+    ::memcpy(out, literals, literalLength);
+    out += literalLength;
+
+    if (matchLength > 0) {
+        *out++ = static_cast<char>(offset & 0xff);
+        *out++ = static_cast<char>(offset >> 8);
+        size_t extra = matchLength - MIN_MATCH;
+        *token = static_cast<char>(*token | std::min(extra, RUN_MASK));
+        if (extra >= RUN_MASK) {
+            out = writeLength(out, extra);
+        }
+    }
+    return out;
+}
+
+/** Read the continuation bytes of a length, returning false at the end of the input. */
+inline bool readLength(const unsigned char*& in, const unsigned char* inEnd, size_t& length) {
+    unsigned char next;
+    do {
+        if (in >= inEnd) {
+            return false;
+        }
+        next = *in++;
+        length += next;
+    } while (next == 255);
+    return true;
+}
+
+} // anonymous namespace
+
+size_t LZ4Block::compress(const char* source, size_t length, char* destination, size_t capacity) {
+    char* out = destination;
+    const char* outEnd = destination + capacity;
+    const char* anchor = source;
+
+    if (length > MF_LIMIT) {
+        uint32_t lastPositions[1 << HASH_LOG];
+        ::memset(lastPositions, 0, sizeof(lastPositions));
+        const char* matchStartLimit = source + length - MF_LIMIT;
+        const char* matchEndLimit = source + length - LAST_LITERALS;
+        const char* in = source;
+
+        while (in < matchStartLimit) {
+            uint32_t sequence = readSequence(in);
+            uint32_t hash = hashSequence(sequence);
+            const char* candidate = source + lastPositions[hash];
+            lastPositions[hash] = static_cast<uint32_t>(in - source);
+            if (candidate >= in ||
+                static_cast<size_t>(in - candidate) > MAX_OFFSET ||
+                readSequence(candidate) != sequence) {
+                ++in;
+                continue;
+            }
+
+            // Take in any matching bytes just before the sequence too.
+            while (in > anchor && candidate > source && in[-1] == candidate[-1]) {
+                --in;
+                --candidate;
+            }
+            const char* matchEnd = in + MIN_MATCH;
+            const char* candidateEnd = candidate + MIN_MATCH;
+            while (matchEnd < matchEndLimit && *matchEnd == *candidateEnd) {
+                ++matchEnd;
+                ++candidateEnd;
+            }
+
+            out = writeSequence(out, outEnd, anchor, in - anchor, in - candidate, matchEnd - in);
+            if (out == NULL) {
+                return 0;
+            }
+            in = matchEnd;
+            anchor = in;
+        }
+    }
+
+    out = writeSequence(out, outEnd, anchor, source + length - anchor, 0, 0);
+    if (out == NULL) {
+        return 0;
+    }
+    return out - destination;
+}
+
+bool LZ4Block::decompress(const char* source, size_t length, char* destination, size_t decompressedLength) {
+    const unsigned char* in = reinterpret_cast<const unsigned char*>(source);
+    const unsigned char* inEnd = in + length;
+    char* out = destination;
+    char* outEnd = destination + decompressedLength;
+
+    while (true) {
+        if (in >= inEnd) {
+            return false;
+        }
+        unsigned char token = *in++;
+
+        size_t literalLength = token >> 4;
+        if (literalLength == RUN_MASK && !readLength(in, inEnd, literalLength)) {
+            return false;
+        }
+        if (literalLength > static_cast<size_t>(inEnd - in) ||
+            literalLength > static_cast<size_t>(outEnd - out)) {
+            return false;
+        }
+        ::memcpy(out, in, literalLength);
+        in += literalLength;
+        out += literalLength;
+
+        // The last sequence has no match.
+        if (in == inEnd) {
+            return out == outEnd;
+        }
+
+        if (inEnd - in < 2) {
+            return false;
+        }
+        size_t offset = in[0] | (in[1] << 8);
+        in += 2;
+        if (offset == 0 || offset > static_cast<size_t>(out - destination)) {
+            return false;
+        }
+
+        size_t matchLength = token & RUN_MASK;
+        if (matchLength == RUN_MASK && !readLength(in, inEnd, matchLength)) {
+            return false;
+        }
+        matchLength += MIN_MATCH;
+        if (matchLength > static_cast<size_t>(outEnd - out)) {
+            return false;
+        }
+
+        const char* match = out - offset;
+        if (offset >= matchLength) {
+            ::memcpy(out, match, matchLength);
+            out += matchLength;
+        }
+        else {
+            // The match overlaps what it produces, repeating its start.
+            for (size_t i = 0; i < matchLength; ++i) {
+                *out++ = *match++;
+            }
+        }
+    }
+}
+
+} // namespace voltdb
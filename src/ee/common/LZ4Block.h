@@ -0,0 +1,62 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2018 VoltDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with VoltDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef VOLTDB_LZ4BLOCK_H
+#define VOLTDB_LZ4BLOCK_H
+
+#include <cstddef>
+
+namespace voltdb {
+
+/**
+ * A compressor and decompressor for the LZ4 block format -- a single
+ * block, without the LZ4 frame around it -- so that any LZ4 library can
+ * read what this writes and vice versa.
+ *
+ * The compressor is the simple greedy one: a hash table of the last
+ * position of each 4-byte sequence, and no match search beyond that.  It
+ * trades some ratio for speed, which suits table streams, whose rows
+ * repeat column layouts and string values a great deal.
+ */
+class LZ4Block {
+public:
+    /** The largest compressed size of length bytes. */
+    static size_t compressBound(size_t length) {
+        return length + length / 255 + 16;
+    }
+
+    /**
+     * Compress length bytes from source into destination, returning the
+     * compressed size, or 0 if it would not fit in capacity bytes.
+     */
+    static size_t compress(const char* source, size_t length, char* destination, size_t capacity);
+
+    /**
+     * Decompress length bytes from source into exactly decompressedLength
+     * bytes at destination.  Return false if source is not a valid block
+     * of that decompressed size; nothing outside destination is written
+     * either way.
+     */
+    static bool decompress(const char* source, size_t length, char* destination, size_t decompressedLength);
+
+private:
+    LZ4Block();
+};
+
+} // namespace voltdb
+
+#endif // VOLTDB_LZ4BLOCK_H
@@ -24,7 +24,6 @@
 #include <cstdio>
 #include <sstream>
 #include <algorithm>
-#include <set>
 
 namespace voltdb {
 Pool* NValue::getTempStringPool() {
@@ -370,12 +369,20 @@ void NValue::createDecimalFromString(const std::string &txt) {
 }
 
 struct NValueList {
+    // Lists at least this long also keep a sorted copy of their values,
+    // so that IN-list probes can binary search instead of scanning.
+    static const size_t MIN_SORTED_LENGTH = 16;
+
+    static size_t sortedCopyLength(size_t length)
+    {
+        return length >= MIN_SORTED_LENGTH ? length : 0;
+    }
+
     static int allocationSizeForLength(size_t length)
     {
-        //TODO: May want to consider extra allocation, here,
-        // such as space for a sorted copy of the array.
-        // This allocation has the advantage of getting freed via NValue::free.
-        return (int)(sizeof(NValueList) + length*sizeof(StlFriendlyNValue));
+        // This allocation, including the space for the sorted copy,
+        // has the advantage of getting freed via NValue::free.
+        return (int)(sizeof(NValueList) + (length + sortedCopyLength(length))*sizeof(StlFriendlyNValue));
     }
 
     void* operator new(size_t size, char* placement)
@@ -385,7 +392,8 @@ struct NValueList {
     void operator delete(void*, char*) {}
     void operator delete(void*) {}
 
-    NValueList(size_t length, ValueType elementType) : m_length(length), m_elementType(elementType)
+    NValueList(size_t length, ValueType elementType)
+        : m_length(length), m_elementType(elementType), m_sortedIsCurrent(false)
     { }
 
     void deserializeNValues(SerializeInputBE &input, Pool *dataPool)
@@ -393,13 +401,46 @@ struct NValueList {
         for (int ii = 0; ii < m_length; ++ii) {
             m_values[ii].deserializeFromAllocateForStorage(m_elementType, input, dataPool);
         }
+        m_sortedIsCurrent = false;
     }
 
     StlFriendlyNValue const* begin() const { return m_values; }
     StlFriendlyNValue const* end() const { return m_values + m_length; }
 
+    bool hasSortedCopy() const { return sortedCopyLength(m_length) != 0; }
+
+    /**
+     * The values in ascending order.  The sorted copy is built by the
+     * first call after the values were set, so its cost is paid once
+     * per parameter binding rather than once per probe.
+     */
+    StlFriendlyNValue const* sortedBegin()
+    {
+        assert(hasSortedCopy());
+        StlFriendlyNValue* sorted = m_values + m_length;
+        if ( ! m_sortedIsCurrent) {
+            std::copy(begin(), end(), sorted);
+            std::sort(sorted, sorted + m_length);
+            m_sortedIsCurrent = true;
+        }
+        return sorted;
+    }
+
+    bool contains(const StlFriendlyNValue& value)
+    {
+        if ( ! hasSortedCopy()) {
+            return std::find(begin(), end(), value) != end();
+        }
+        StlFriendlyNValue const* sorted = sortedBegin();
+        return std::binary_search(sorted, sorted + m_length, value);
+    }
+
+    /** Must be called after the values are changed in place. */
+    void invalidateSortedCopy() { m_sortedIsCurrent = false; }
+
     const size_t m_length;
     const ValueType m_elementType;
+    bool m_sortedIsCurrent;
     StlFriendlyNValue m_values[0];
 };
 
@@ -425,13 +466,11 @@ bool NValue::inList(const NValue& rhs) const
     if (rhsType != VALUE_TYPE_ARRAY) {
         throwDynamicSQLException("rhs of IN expression is of a non-list type %s", rhs.getValueTypeString().c_str());
     }
-    const NValueList* listOfNValues = reinterpret_cast<const NValueList*>(rhs.getObjectValue_withoutNull());
+    // The list's sorted copy is built lazily, hence the const_cast.
+    NValueList* listOfNValues = const_cast<NValueList*>(
+        reinterpret_cast<const NValueList*>(rhs.getObjectValue_withoutNull()));
     const StlFriendlyNValue& value = *static_cast<const StlFriendlyNValue*>(this);
-    //TODO: An O(ln(length)) implementation vs. the current O(length) implementation
-    // such as binary search would likely require some kind of sorting/re-org of values
-    // post-update/pre-lookup, and would likely require some sortable inequality method
-    // (operator<()?) to be defined on StlFriendlyNValue.
-    return std::find(listOfNValues->begin(), listOfNValues->end(), value) != listOfNValues->end();
+    return listOfNValues->contains(value);
 }
 
 void NValue::deserializeIntoANewNValueList(SerializeInputBE &input, Pool *dataPool)
@@ -443,8 +482,6 @@ void NValue::deserializeIntoANewNValueList(SerializeInputBE &input, Pool *dataPo
     ::memset(storage, 0, trueSize);
     NValueList* nvset = new (storage) NValueList(length, elementType);
     nvset->deserializeNValues(input, dataPool);
-    //TODO: An O(ln(length)) implementation vs. the current O(length) implementation of NValue::inList
-    // would likely require some kind of sorting/re-org of values at this point post-update pre-lookup.
 }
 
 void NValue::allocateANewNValueList(size_t length, ValueType elementType)
@@ -466,8 +503,7 @@ void NValue::setArrayElements(std::vector<NValue> &args) const
     while (ii--) {
         listOfNValues->m_values[ii] = args[ii];
     }
-    //TODO: An O(ln(length)) implementation vs. the current O(length) implementation of NValue::inList
-    // would likely require some kind of sorting/re-org of values at this point post-update pre-lookup.
+    listOfNValues->invalidateSortedCopy();
 }
 
 int NValue::arrayLength() const
@@ -488,21 +524,26 @@ const NValue& NValue::itemAtIndex(int index) const
 
 void NValue::castAndSortAndDedupArrayForInList(const ValueType outputType, std::vector<NValue> &outList) const
 {
-    int size = arrayLength();
-
-    // make a set to eliminate unique values in O(nlogn) time
-    std::set<StlFriendlyNValue> uniques;
-
-    // iterate over the array of values and build a sorted set of unique
-    // values that don't overflow or violate unique constaints
-    // (n.b. sorted set means dups are removed)
-    for (int i = 0; i < size; i++) {
-        const NValue& value = itemAtIndex(i);
+    assert(m_valueType == VALUE_TYPE_ARRAY);
+    NValueList* listOfNValues = const_cast<NValueList*>(
+        reinterpret_cast<const NValueList*>(getObjectValue_withoutNull()));
+    const size_t size = listOfNValues->m_length;
+
+    // Start from the list's sorted copy, if it keeps one, which is
+    // shared with any IN-list probes of the same parameter binding.
+    StlFriendlyNValue const* values = listOfNValues->hasSortedCopy() ?
+        listOfNValues->sortedBegin() : listOfNValues->begin();
+
+    // cast the values to the right type, dropping those that
+    // overflow or violate unique constaints
+    std::vector<StlFriendlyNValue> casted;
+    casted.reserve(size);
+    for (size_t i = 0; i < size; i++) {
         // cast the value to the right type and catch overflow/cast problems
         try {
             StlFriendlyNValue stlValue;
-            stlValue = value.castAs(outputType);
-            uniques.insert(stlValue);
+            stlValue = values[i].castAs(outputType);
+            casted.push_back(stlValue);
         }
         // cast exceptions mean the in-list test is redundant
         // don't include these values in the materialized table
@@ -510,11 +551,15 @@ void NValue::castAndSortAndDedupArrayForInList(const ValueType outputType, std::
         catch (SQLException &sqlException) {}
     }
 
-    // insert all items in the set in order
-    std::set<StlFriendlyNValue>::const_iterator iter;
-    for (iter = uniques.begin(); iter != uniques.end(); iter++) {
-        outList.push_back(*iter);
+    // Casts between numeric types keep sorted values in order, but
+    // other casts (and unsorted short lists) need a sort.
+    if ( ! std::is_sorted(casted.begin(), casted.end())) {
+        std::sort(casted.begin(), casted.end());
     }
+    casted.erase(std::unique(casted.begin(), casted.end()), casted.end());
+
+    // insert all items in order
+    outList.insert(outList.end(), casted.begin(), casted.end());
 }
 
 void NValue::streamTimestamp(std::stringstream& value) const
@@ -318,6 +318,18 @@ class NValue {
                                 static_cast<Pool*>(NULL));
     }
 
+    /** Throw a VAR_LENGTH_MISMATCH SQLException if this VARCHAR or
+        VARBINARY value is too wide for a column of the given size,
+        as serializeToTupleStorage would. */
+    void checkFitsVariableLengthColumn(int32_t maxLength, bool isInBytes) const {
+        if (isNull()) {
+            return;
+        }
+        int32_t length;
+        const char* buf = getObject_withoutNull(&length);
+        checkTooWideForVariableLengthType(m_valueType, buf, length, maxLength, isInBytes);
+    }
+
     /* Deserialize a scalar value of the specified type from the
        SerializeInput directly into the tuple storage area
        provided. This function will perform memory allocations for
@@ -0,0 +1,227 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2018 VoltDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with VoltDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "common/PageAllocator.h"
+
+#include "common/FatalException.hpp"
+
+#include <boost/unordered_map.hpp>
+
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <pthread.h>
+#include <stdint.h>
+#include <sys/mman.h>
+#ifdef LINUX
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace voltdb {
+
+namespace {
+
+// From <numaif.h>, which is not installed everywhere we build.
+const int NUMA_MPOL_PREFERRED = 1;
+
+bool s_useHugePages = false;
+bool s_bindToLocalNode = false;
+
+// How a region is backed, for the regions that are more than just mapped
+const uint8_t HUGE_PAGE_REGION = 1;
+const uint8_t NUMA_LOCAL_REGION = 2;
+
+/** What a thread has mapped, so that no lock is needed to count it. */
+struct ThreadState {
+    PageAllocator::Stats m_stats;
+    boost::unordered_map<void*, uint8_t> m_regionFlags;
+};
+
+pthread_key_t s_stateKey;
+pthread_once_t s_stateKeyOnce = PTHREAD_ONCE_INIT;
+
+void deleteThreadState(void* state) {
+    delete static_cast<ThreadState*>(state);
+}
+
+void createStateKey() {
+    (void)pthread_key_create(&s_stateKey, deleteThreadState);
+}
+
+ThreadState* currentThreadState(bool create) {
+    (void)pthread_once(&s_stateKeyOnce, createStateKey);
+    ThreadState* state = static_cast<ThreadState*>(pthread_getspecific(s_stateKey));
+    if (state == NULL && create) {
+        state = new ThreadState();
+        (void)pthread_setspecific(s_stateKey, state);
+    }
+    return state;
+}
+
+/**
+ * Regions of a huge page or more are mapped in whole huge pages whatever
+ * the current policy, so that they can be unmapped without knowing what
+ * the policy was when they were mapped.
+ */
+size_t mappedLength(size_t size) {
+    if (size < PageAllocator::HUGE_PAGE_SIZE) {
+        return size;
+    }
+    return (size + PageAllocator::HUGE_PAGE_SIZE - 1) & ~(PageAllocator::HUGE_PAGE_SIZE - 1);
+}
+
+void* mapAnonymous(size_t length, int extraFlags) {
+    void* memory = ::mmap(NULL, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANON | extraFlags, -1, 0);
+    return memory == MAP_FAILED ? NULL : memory;
+}
+
+/**
+ * Map length bytes starting on a huge page boundary, so that the kernel
+ * can back the whole region with transparent huge pages.
+ */
+void* mapHugePageAligned(size_t length) {
+    char* memory = static_cast<char*>(mapAnonymous(length + PageAllocator::HUGE_PAGE_SIZE, 0));
+    if (memory == NULL) {
+        return NULL;
+    }
+    uintptr_t address = reinterpret_cast<uintptr_t>(memory);
+    uintptr_t aligned = (address + PageAllocator::HUGE_PAGE_SIZE - 1) & ~(uintptr_t)(PageAllocator::HUGE_PAGE_SIZE - 1);
+    size_t head = aligned - address;
+    size_t tail = PageAllocator::HUGE_PAGE_SIZE - head;
+    if (head > 0) {
+        ::munmap(memory, head);
+    }
+    if (tail > 0) {
+        ::munmap(memory + head + length, tail);
+    }
+    return memory + head;
+}
+
+/**
+ * Prefer the NUMA node of the current CPU for the region's pages.  This
+ * is a preference rather than a strict binding, so a full node spills
+ * over instead of failing the allocation.
+ */
+bool preferLocalNode(void* memory, size_t length) {
+#if defined(LINUX) && defined(SYS_getcpu) && defined(SYS_mbind)
+    unsigned cpu = 0;
+    unsigned node = 0;
+    if (::syscall(SYS_getcpu, &cpu, &node, NULL) != 0 || node >= sizeof(unsigned long) * 8) {
+        return false;
+    }
+    unsigned long nodeMask = 1UL << node;
+    return ::syscall(SYS_mbind, memory, length, NUMA_MPOL_PREFERRED,
+                     &nodeMask, sizeof(nodeMask) * 8, 0) == 0;
+#else
+    (void)memory;
+    (void)length;
+    return false;
+#endif
+}
+
+} // anonymous namespace
+
+void PageAllocator::configure(bool useHugePages, bool bindToLocalNode) {
+    s_useHugePages = useHugePages;
+    s_bindToLocalNode = bindToLocalNode;
+}
+
+bool PageAllocator::useHugePages() {
+    return s_useHugePages;
+}
+
+bool PageAllocator::bindToLocalNode() {
+    return s_bindToLocalNode;
+}
+
+void* PageAllocator::allocate(size_t size) {
+    size_t length = mappedLength(size);
+    void* memory = NULL;
+    uint8_t flags = 0;
+    if (s_useHugePages && length >= HUGE_PAGE_SIZE) {
+#ifdef MAP_HUGETLB
+        memory = mapAnonymous(length, MAP_HUGETLB);
+        if (memory != NULL) {
+            flags |= HUGE_PAGE_REGION;
+        }
+#endif
+        if (memory == NULL) {
+            memory = mapHugePageAligned(length);
+#ifdef MADV_HUGEPAGE
+            if (memory != NULL && ::madvise(memory, length, MADV_HUGEPAGE) == 0) {
+                flags |= HUGE_PAGE_REGION;
+            }
+#endif
+        }
+    }
+    else {
+        memory = mapAnonymous(length, 0);
+    }
+    if (memory == NULL) {
+        std::cout << strerror(errno) << std::endl;
+        throwFatalException("Failed mmap");
+    }
+    // The pages are untouched so far, so the policy applies to all of them.
+    if (s_bindToLocalNode && preferLocalNode(memory, length)) {
+        flags |= NUMA_LOCAL_REGION;
+    }
+
+    ThreadState* state = currentThreadState(true);
+    state->m_stats.m_mappedBytes += length;
+    if (flags & HUGE_PAGE_REGION) {
+        state->m_stats.m_hugePageBytes += length;
+    }
+    if (flags & NUMA_LOCAL_REGION) {
+        state->m_stats.m_numaLocalBytes += length;
+    }
+    if (flags != 0) {
+        state->m_regionFlags[memory] = flags;
+    }
+    return memory;
+}
+
+void PageAllocator::deallocate(void* memory, size_t size) {
+    if (memory == NULL) {
+        return;
+    }
+    size_t length = mappedLength(size);
+    if (::munmap(memory, length) != 0) {
+        std::cout << strerror(errno) << std::endl;
+        throwFatalException("Failed munmap");
+    }
+
+    ThreadState* state = currentThreadState(true);
+    state->m_stats.m_mappedBytes -= length;
+    boost::unordered_map<void*, uint8_t>::iterator found = state->m_regionFlags.find(memory);
+    if (found != state->m_regionFlags.end()) {
+        if (found->second & HUGE_PAGE_REGION) {
+            state->m_stats.m_hugePageBytes -= length;
+        }
+        if (found->second & NUMA_LOCAL_REGION) {
+            state->m_stats.m_numaLocalBytes -= length;
+        }
+        state->m_regionFlags.erase(found);
+    }
+}
+
+PageAllocator::Stats PageAllocator::threadStats() {
+    ThreadState* state = currentThreadState(false);
+    return state == NULL ? Stats() : state->m_stats;
+}
+
+} // namespace voltdb
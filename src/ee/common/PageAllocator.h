@@ -0,0 +1,81 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2018 VoltDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with VoltDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef VOLTDB_PAGEALLOCATOR_H
+#define VOLTDB_PAGEALLOCATOR_H
+
+#include <cstddef>
+#include <stdint.h>
+
+namespace voltdb {
+
+/**
+ * Maps the large, long-lived regions behind tuple storage -- TupleBlock
+ * data, Pool chunks and CompactingHashTable bucket arrays -- straight
+ * from the kernel, optionally with a page size and NUMA policy.
+ *
+ * With huge pages enabled, a region of at least HUGE_PAGE_SIZE is rounded
+ * up to a whole number of huge pages and mapped with MAP_HUGETLB.  If the
+ * reserved huge page pool is exhausted, the region is instead aligned to
+ * HUGE_PAGE_SIZE and advised MADV_HUGEPAGE so that transparent huge pages
+ * can back it.  With NUMA binding enabled, each region prefers the node
+ * of the CPU that maps it; since each site's execution thread allocates
+ * its own storage, that keeps a site's tables on its own node.
+ *
+ * Both policies are off unless configure() turns them on, which
+ * VoltDBEngine::initialize() does from the options Java passes it.
+ * Regions are always returned zero-filled, and must be freed with the
+ * size they were allocated with.
+ *
+ * Each thread counts the regions it maps.  A site's execution thread
+ * maps and unmaps its own storage, so its counts are the site's, and the
+ * site reports them in the MEMORY statistics.  A region must be freed by
+ * the thread that mapped it for the counts to stay right.
+ */
+class PageAllocator {
+public:
+    static const size_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+
+    /** Bytes of the regions mapped by a thread and not yet unmapped. */
+    struct Stats {
+        Stats() : m_mappedBytes(0), m_hugePageBytes(0), m_numaLocalBytes(0) {}
+
+        int64_t m_mappedBytes;
+        /** Mapped with MAP_HUGETLB or advised MADV_HUGEPAGE */
+        int64_t m_hugePageBytes;
+        /** Given a preference for the mapping CPU's NUMA node */
+        int64_t m_numaLocalBytes;
+    };
+
+    static void configure(bool useHugePages, bool bindToLocalNode);
+    static bool useHugePages();
+    static bool bindToLocalNode();
+
+    /** Map size zero-filled bytes, throwing a FatalException on failure. */
+    static void* allocate(size_t size);
+    static void deallocate(void* memory, size_t size);
+
+    /** The counts for the calling thread. */
+    static Stats threadStats();
+
+private:
+    PageAllocator();
+};
+
+} // namespace voltdb
+
+#endif // VOLTDB_PAGEALLOCATOR_H
@@ -0,0 +1,129 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2018 VoltDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with VoltDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "common/PolygonCache.h"
+
+#include <cassert>
+#include <cstring>
+
+#include "s2geo/s2regioncoverer.h"
+
+namespace voltdb {
+
+PreparedPolygon::PreparedPolygon(const GeographyValue& geog)
+    : m_polygon()
+    , m_uses(0)
+    , m_hasCoverings(false)
+    , m_interior()
+    , m_exterior()
+{
+    m_polygon.initFromGeography(geog);
+}
+
+void PreparedPolygon::buildCoverings() {
+    // The coverings are only trustworthy for valid polygons; invalid
+    // ones are always tested against their edges.
+    if ( ! m_polygon.IsValid()) {
+        return;
+    }
+    S2RegionCoverer coverer;
+    coverer.set_max_cells(MAX_COVERING_CELLS);
+    coverer.GetInteriorCellUnion(m_polygon, &m_interior);
+    coverer.GetCellUnion(m_polygon, &m_exterior);
+    m_hasCoverings = true;
+}
+
+bool PreparedPolygon::contains(const S2Point& point) {
+    if ( ! m_hasCoverings) {
+        // Only try to build the coverings once, after the polygon has
+        // been tested against enough points.
+        if (m_uses <= USES_BEFORE_COVERING && ++m_uses > USES_BEFORE_COVERING) {
+            buildCoverings();
+        }
+        if ( ! m_hasCoverings) {
+            return m_polygon.Contains(point);
+        }
+    }
+
+    S2CellId cell = S2CellId::FromPoint(point);
+    if ( ! m_exterior.Contains(cell)) {
+        return false;
+    }
+    if (m_interior.Contains(cell)) {
+        return true;
+    }
+    // The point is near the boundary.
+    return m_polygon.Contains(point);
+}
+
+PolygonCache::PolygonCache(size_t capacity, size_t maxBytes)
+    : m_capacity(capacity)
+    , m_maxBytes(maxBytes)
+    , m_bytes(0)
+    , m_cache()
+{
+    assert(m_capacity > 0);
+}
+
+PolygonCache::~PolygonCache() {
+    clear();
+}
+
+PreparedPolygon* PolygonCache::get(const GeographyValue& geog) {
+    // Usually every row uses the same polygon, so check the most
+    // recently used one before building a key to look up.
+    LRUCache<PreparedPolygon*>::Entry* mru = m_cache.mostRecentlyUsed();
+    if (mru != NULL
+        && mru->key.size() == static_cast<size_t>(geog.length())
+        && ::memcmp(mru->key.data(), geog.data(), geog.length()) == 0) {
+        return mru->value;
+    }
+
+    std::string key(geog.data(), geog.length());
+    PreparedPolygon** found = m_cache.find(key);
+    if (found != NULL) {
+        return *found;
+    }
+
+    PreparedPolygon* polygon = new PreparedPolygon(geog);
+    while ( ! m_cache.empty()
+            && (m_cache.size() >= m_capacity || m_bytes + key.size() > m_maxBytes)) {
+        evictLeastRecentlyUsed();
+    }
+    // A polygon larger than the whole cache is still cached on its
+    // own, so that it is built only once while it is in use.
+    m_cache.insert(key, polygon);
+    m_bytes += key.size();
+    return polygon;
+}
+
+void PolygonCache::evictLeastRecentlyUsed() {
+    LRUCache<PreparedPolygon*>::Entry& lru = m_cache.leastRecentlyUsed();
+    m_bytes -= lru.key.size();
+    delete lru.value;
+    m_cache.popLeastRecentlyUsed();
+}
+
+void PolygonCache::clear() {
+    for (LRUCache<PreparedPolygon*>::iterator it = m_cache.begin(); it != m_cache.end(); ++it) {
+        delete it->value;
+    }
+    m_cache.clear();
+    m_bytes = 0;
+}
+
+} // namespace voltdb
@@ -0,0 +1,111 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2018 VoltDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with VoltDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef VOLTDB_POLYGONCACHE_H
+#define VOLTDB_POLYGONCACHE_H
+
+#include <stdint.h>
+
+#include "common/GeographyValue.hpp"
+#include "common/LRUCache.h"
+#include "s2geo/s2cellunion.h"
+
+namespace voltdb {
+
+/**
+ * A polygon deserialized from a GEOGRAPHY value, together with cell
+ * coverings that answer most point containment checks without
+ * walking the polygon's edges.
+ *
+ * The coverings are only built once the polygon has been tested
+ * against enough points to pay for them.
+ */
+class PreparedPolygon {
+public:
+    /** Number of contains() calls before the coverings are built */
+    static const uint32_t USES_BEFORE_COVERING = 64;
+    /** Maximum number of cells in each covering */
+    static const int MAX_COVERING_CELLS = 64;
+
+    explicit PreparedPolygon(const GeographyValue& geog);
+
+    bool contains(const S2Point& point);
+
+    Polygon& polygon() {
+        return m_polygon;
+    }
+
+private:
+    void buildCoverings();
+
+    Polygon m_polygon;
+    uint32_t m_uses;
+    bool m_hasCoverings;
+    /** Cells entirely inside the polygon */
+    S2CellUnion m_interior;
+    /** Cells that together contain the polygon */
+    S2CellUnion m_exterior;
+};
+
+/**
+ * A least-recently-used cache of PreparedPolygons keyed by the bytes
+ * of the GEOGRAPHY value they were built from, so that geo functions
+ * whose polygon argument is a constant or parameter deserialize it
+ * once rather than for every row.
+ *
+ * The cache is bounded both by its number of polygons and by the
+ * total size of their serialized forms.  There is one cache per
+ * ExecutorContext, so it is only ever used by one thread.
+ */
+class PolygonCache {
+public:
+    static const size_t DEFAULT_CAPACITY = 16;
+    static const size_t DEFAULT_MAX_BYTES = 16 * 1024 * 1024;
+
+    explicit PolygonCache(size_t capacity = DEFAULT_CAPACITY,
+                          size_t maxBytes = DEFAULT_MAX_BYTES);
+    ~PolygonCache();
+
+    /**
+     * Return the prepared form of the polygon, building it (and
+     * possibly evicting the least recently used entries) if it is not
+     * cached.  The result remains valid until the next call.
+     */
+    PreparedPolygon* get(const GeographyValue& geog);
+
+    size_t size() const {
+        return m_cache.size();
+    }
+
+    size_t bytes() const {
+        return m_bytes;
+    }
+
+    void clear();
+
+private:
+    void evictLeastRecentlyUsed();
+
+    const size_t m_capacity;
+    const size_t m_maxBytes;
+    size_t m_bytes;
+    LRUCache<PreparedPolygon*> m_cache;
+};
+
+} // namespace voltdb
+
+#endif // VOLTDB_POLYGONCACHE_H
@@ -25,6 +25,7 @@
 #include <climits>
 #include <string.h>
 #include "common/FatalException.hpp"
+#include "common/PageAllocator.h"
 
 namespace voltdb {
 static const size_t TEMP_POOL_CHUNK_SIZE = 262144;
@@ -98,11 +99,7 @@ public:
     void init() {
 #ifdef USE_MMAP
         char *storage =
-                static_cast<char*>(::mmap( 0, m_allocationSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANON, -1, 0 ));
-        if (storage == MAP_FAILED) {
-            std::cout << strerror( errno ) << std::endl;
-            throwFatalException("Failed mmap");
-        }
+                static_cast<char*>(PageAllocator::allocate(m_allocationSize));
 #else
         char *storage = new char[m_allocationSize];
 #endif
@@ -112,20 +109,14 @@ public:
     ~Pool() {
         for (std::size_t ii = 0; ii < m_chunks.size(); ii++) {
 #ifdef USE_MMAP
-            if (::munmap( m_chunks[ii].m_chunkData, m_chunks[ii].m_size) != 0) {
-                std::cout << strerror( errno ) << std::endl;
-                throwFatalException("Failed munmap");
-            }
+            PageAllocator::deallocate(m_chunks[ii].m_chunkData, m_chunks[ii].m_size);
 #else
             delete [] m_chunks[ii].m_chunkData;
 #endif
         }
         for (std::size_t ii = 0; ii < m_oversizeChunks.size(); ii++) {
 #ifdef USE_MMAP
-            if (::munmap( m_oversizeChunks[ii].m_chunkData, m_oversizeChunks[ii].m_size) != 0) {
-                std::cout << strerror( errno ) << std::endl;
-                throwFatalException("Failed munmap");
-            }
+            PageAllocator::deallocate(m_oversizeChunks[ii].m_chunkData, m_oversizeChunks[ii].m_size);
 #else
             delete [] m_oversizeChunks[ii].m_chunkData;
 #endif
@@ -150,11 +141,7 @@ public:
                  */
 #ifdef USE_MMAP
                 char *storage =
-                        static_cast<char*>(::mmap( 0, nexthigher(size), PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANON, -1, 0 ));
-                if (storage == MAP_FAILED) {
-                    std::cout << strerror( errno ) << std::endl;
-                    throwFatalException("Failed mmap");
-                }
+                        static_cast<char*>(PageAllocator::allocate(nexthigher(size)));
 #else
                 char *storage = new char[size];
 #endif
@@ -182,11 +169,7 @@ public:
 //                  "happen frequently" << std::endl;
 #ifdef USE_MMAP
                 char *storage =
-                        static_cast<char*>(::mmap( 0, m_allocationSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANON, -1, 0 ));
-                if (storage == MAP_FAILED) {
-                    std::cout << strerror( errno ) << std::endl;
-                    throwFatalException("Failed mmap");
-                }
+                        static_cast<char*>(PageAllocator::allocate(m_allocationSize));
 #else
                 char *storage = new char[m_allocationSize];
 #endif
@@ -225,10 +208,7 @@ public:
         const std::size_t numOversizeChunks = m_oversizeChunks.size();
         for (std::size_t ii = 0; ii < numOversizeChunks; ii++) {
 #ifdef USE_MMAP
-            if (::munmap( m_oversizeChunks[ii].m_chunkData, m_oversizeChunks[ii].m_size) != 0) {
-                std::cout << strerror( errno ) << std::endl;
-                throwFatalException("Failed munmap");
-            }
+            PageAllocator::deallocate(m_oversizeChunks[ii].m_chunkData, m_oversizeChunks[ii].m_size);
 #else
             delete [] m_oversizeChunks[ii].m_chunkData;
 #endif
@@ -247,10 +227,7 @@ public:
         if (numChunks > m_maxChunkCount) {
             for (std::size_t ii = m_maxChunkCount; ii < numChunks; ii++) {
 #ifdef USE_MMAP
-                if (::munmap( m_chunks[ii].m_chunkData, m_chunks[ii].m_size) != 0) {
-                    std::cout << strerror( errno ) << std::endl;
-                    throwFatalException("Failed munmap");
-                }
+                PageAllocator::deallocate(m_chunks[ii].m_chunkData, m_chunks[ii].m_size);
 #else
                 delete []m_chunks[ii].m_chunkData;
 #endif
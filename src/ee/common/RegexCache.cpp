@@ -0,0 +1,116 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2018 VoltDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with VoltDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "common/RegexCache.h"
+
+#include "common/executorcontext.hpp"
+
+#include <cassert>
+#include <cstring>
+
+namespace voltdb {
+
+RegexCache::RegexCache(size_t capacity)
+    : m_capacity(capacity)
+    , m_cache()
+{
+    assert(m_capacity > 0);
+}
+
+RegexCache::~RegexCache() {
+    clear();
+}
+
+RegexCache* RegexCache::forCurrentSite() {
+    ExecutorContext* context = ExecutorContext::getExecutorContext();
+    assert(context != NULL);
+    return context->regexCache();
+}
+
+std::string RegexCache::makeKey(const char* pattern, size_t length, uint32_t options) {
+    std::string key;
+    key.reserve(length + sizeof(options));
+    key.append(pattern, length);
+    key.append(reinterpret_cast<const char*>(&options), sizeof(options));
+    return key;
+}
+
+void RegexCache::freeRegex(CompiledRegex& regex) {
+    pcre2_match_data_free(regex.matchData);
+    pcre2_code_free(regex.code);
+}
+
+const RegexCache::CompiledRegex* RegexCache::get(const char* pattern,
+                                                 size_t length,
+                                                 uint32_t options,
+                                                 int* errorCode) {
+    // Most often every row uses the same pattern, so check the most
+    // recently used one before building a key to look up.
+    LRUCache<CompiledRegex>::Entry* mru = m_cache.mostRecentlyUsed();
+    if (mru != NULL
+        && mru->key.size() == length + sizeof(options)
+        && ::memcmp(mru->key.data(), pattern, length) == 0
+        && ::memcmp(mru->key.data() + length, &options, sizeof(options)) == 0) {
+        return &mru->value;
+    }
+
+    std::string key = makeKey(pattern, length, options);
+    CompiledRegex* found = m_cache.find(key);
+    if (found != NULL) {
+        return found;
+    }
+
+    PCRE2_SIZE errorOffset = 0;
+    pcre2_code* code = pcre2_compile(reinterpret_cast<PCRE2_SPTR>(pattern),
+                                     length,
+                                     options,
+                                     errorCode,
+                                     &errorOffset,
+                                     NULL);
+    if (code == NULL) {
+        return NULL;
+    }
+    // This fails harmlessly if the library was built without JIT
+    // support; matching then uses the interpreter.
+    pcre2_jit_compile(code, PCRE2_JIT_COMPLETE);
+
+    pcre2_match_data* matchData = pcre2_match_data_create_from_pattern(code, NULL);
+    if (matchData == NULL) {
+        pcre2_code_free(code);
+        *errorCode = PCRE2_ERROR_NOMEMORY;
+        return NULL;
+    }
+
+    if (m_cache.size() >= m_capacity) {
+        freeRegex(m_cache.leastRecentlyUsed().value);
+        m_cache.popLeastRecentlyUsed();
+    }
+
+    CompiledRegex regex;
+    regex.code = code;
+    regex.matchData = matchData;
+    return m_cache.insert(key, regex);
+}
+
+void RegexCache::clear() {
+    for (LRUCache<CompiledRegex>::iterator it = m_cache.begin(); it != m_cache.end(); ++it) {
+        freeRegex(it->value);
+    }
+    m_cache.clear();
+}
+
+} // namespace voltdb
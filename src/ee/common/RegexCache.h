@@ -0,0 +1,90 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2018 VoltDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with VoltDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef VOLTDB_REGEXCACHE_H
+#define VOLTDB_REGEXCACHE_H
+
+#include <string>
+#include <stdint.h>
+
+#include "common/LRUCache.h"
+
+#ifndef PCRE2_CODE_UNIT_WIDTH
+#define PCRE2_CODE_UNIT_WIDTH 8
+#endif
+#include "pcre2.h"
+
+namespace voltdb {
+
+/**
+ * A least-recently-used cache of compiled regular expressions, keyed
+ * by the pattern and its compile options, so that functions like
+ * REGEXP_POSITION compile a constant or parameter pattern once rather
+ * than for every row.
+ *
+ * Each entry also holds match data sized for its pattern, which
+ * callers reuse for every match.  Patterns are JIT-compiled when the
+ * PCRE2 library supports it.  There is one cache per ExecutorContext,
+ * so it is only ever used by one thread.
+ */
+class RegexCache {
+public:
+    static const size_t DEFAULT_CAPACITY = 64;
+
+    struct CompiledRegex {
+        pcre2_code* code;
+        pcre2_match_data* matchData;
+    };
+
+    explicit RegexCache(size_t capacity = DEFAULT_CAPACITY);
+    ~RegexCache();
+
+    /** The cache owned by the executing site's ExecutorContext */
+    static RegexCache* forCurrentSite();
+
+    /**
+     * Return the compiled pattern, compiling it (and possibly evicting
+     * the least recently used entry) if it is not cached.  The result
+     * remains valid until the next call.  If the pattern does not
+     * compile, return NULL and set errorCode to the PCRE2 error code.
+     */
+    const CompiledRegex* get(const char* pattern, size_t length, uint32_t options, int* errorCode);
+
+    size_t size() const {
+        return m_cache.size();
+    }
+
+    size_t capacity() const {
+        return m_capacity;
+    }
+
+    /** Free all the compiled patterns */
+    void clear();
+
+private:
+    /** The pattern followed by the bytes of the options */
+    static std::string makeKey(const char* pattern, size_t length, uint32_t options);
+
+    static void freeRegex(CompiledRegex& regex);
+
+    const size_t m_capacity;
+    LRUCache<CompiledRegex> m_cache;
+};
+
+} // namespace voltdb
+
+#endif // VOLTDB_REGEXCACHE_H
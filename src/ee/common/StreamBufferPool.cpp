@@ -0,0 +1,177 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2018 VoltDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with VoltDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "common/StreamBufferPool.h"
+
+namespace voltdb {
+
+StreamBufferPool::StreamBufferPool(size_t capacity)
+    : m_capacity(capacity), m_closed(false), m_outstandingBuffers(0)
+{
+    pthread_mutex_init(&m_mutex, NULL);
+}
+
+StreamBufferPool::~StreamBufferPool() {
+    pthread_mutex_destroy(&m_mutex);
+}
+
+StreamBufferPool::BufferHeader* StreamBufferPool::allocateBuffer(StreamBufferPool* pool, size_t size) {
+    BufferHeader* header = reinterpret_cast<BufferHeader*>(new char[sizeof(BufferHeader) + size]);
+    header->m_pool = pool;
+    header->m_size = size;
+    return header;
+}
+
+void StreamBufferPool::freeBuffer(BufferHeader* header) {
+    delete [] reinterpret_cast<char*>(header);
+}
+
+void StreamBufferPool::close() {
+    std::vector<BufferHeader*> toFree;
+    pthread_mutex_lock(&m_mutex);
+    m_closed = true;
+    for (FreeBufferMap::iterator it = m_freeBuffers.begin(); it != m_freeBuffers.end(); ++it) {
+        toFree.insert(toFree.end(), it->second.begin(), it->second.end());
+    }
+    m_freeBuffers.clear();
+    m_stats.m_pooledBytes = 0;
+    bool unused = m_outstandingBuffers == 0;
+    pthread_mutex_unlock(&m_mutex);
+
+    for (size_t i = 0; i < toFree.size(); ++i) {
+        freeBuffer(toFree[i]);
+    }
+    if (unused) {
+        delete this;
+    }
+}
+
+char* StreamBufferPool::acquire(size_t size) {
+    BufferHeader* header = NULL;
+    pthread_mutex_lock(&m_mutex);
+    FreeBufferMap::iterator found = m_freeBuffers.find(size);
+    if (found != m_freeBuffers.end()) {
+        header = found->second.back();
+        found->second.pop_back();
+        if (found->second.empty()) {
+            m_freeBuffers.erase(found);
+        }
+        m_stats.m_pooledBytes -= size;
+        ++m_stats.m_hits;
+    }
+    else {
+        ++m_stats.m_misses;
+    }
+    m_stats.m_outstandingBytes += size;
+    ++m_outstandingBuffers;
+    pthread_mutex_unlock(&m_mutex);
+
+    if (header == NULL) {
+        header = allocateBuffer(this, size);
+    }
+    return reinterpret_cast<char*>(header + 1);
+}
+
+char* StreamBufferPool::allocateUnpooled(size_t size) {
+    return reinterpret_cast<char*>(allocateBuffer(NULL, size) + 1);
+}
+
+void StreamBufferPool::release(char* buffer) {
+    if (buffer == NULL) {
+        return;
+    }
+    BufferHeader* header = reinterpret_cast<BufferHeader*>(buffer) - 1;
+    if (header->m_pool == NULL) {
+        freeBuffer(header);
+    }
+    else {
+        header->m_pool->giveBack(header);
+    }
+}
+
+void StreamBufferPool::giveBack(BufferHeader* header) {
+    size_t size = header->m_size;
+    bool pooled = false;
+    pthread_mutex_lock(&m_mutex);
+    m_stats.m_outstandingBytes -= size;
+    --m_outstandingBuffers;
+    if (!m_closed && m_stats.m_pooledBytes + size <= static_cast<int64_t>(m_capacity)) {
+        m_freeBuffers[size].push_back(header);
+        m_stats.m_pooledBytes += size;
+        pooled = true;
+    }
+    bool lastRelease = m_closed && m_outstandingBuffers == 0;
+    pthread_mutex_unlock(&m_mutex);
+
+    if (!pooled) {
+        freeBuffer(header);
+    }
+    if (lastRelease) {
+        delete this;
+    }
+}
+
+/**
+ * Take pooled buffers out until the pool is within its capacity, adding
+ * them to toFree so that they can be deleted outside the lock.
+ */
+void StreamBufferPool::trimLocked(std::vector<BufferHeader*>& toFree) {
+    FreeBufferMap::iterator it = m_freeBuffers.begin();
+    while (m_stats.m_pooledBytes > static_cast<int64_t>(m_capacity) && it != m_freeBuffers.end()) {
+        while (!it->second.empty() && m_stats.m_pooledBytes > static_cast<int64_t>(m_capacity)) {
+            toFree.push_back(it->second.back());
+            it->second.pop_back();
+            m_stats.m_pooledBytes -= it->first;
+        }
+        if (it->second.empty()) {
+            m_freeBuffers.erase(it++);
+        }
+        else {
+            ++it;
+        }
+    }
+}
+
+void StreamBufferPool::setCapacity(size_t capacity) {
+    std::vector<BufferHeader*> toFree;
+    pthread_mutex_lock(&m_mutex);
+    m_capacity = capacity;
+    trimLocked(toFree);
+    pthread_mutex_unlock(&m_mutex);
+
+    for (size_t i = 0; i < toFree.size(); ++i) {
+        freeBuffer(toFree[i]);
+    }
+}
+
+size_t StreamBufferPool::capacity() const
+{
+    pthread_mutex_lock(&m_mutex);
+    size_t result = m_capacity;
+    pthread_mutex_unlock(&m_mutex);
+    return result;
+}
+
+StreamBufferPool::Stats StreamBufferPool::stats() const
+{
+    pthread_mutex_lock(&m_mutex);
+    Stats result = m_stats;
+    pthread_mutex_unlock(&m_mutex);
+    return result;
+}
+
+} // namespace voltdb
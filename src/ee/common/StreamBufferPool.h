@@ -0,0 +1,116 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2018 VoltDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with VoltDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef VOLTDB_STREAMBUFFERPOOL_H
+#define VOLTDB_STREAMBUFFERPOOL_H
+
+#include <cstddef>
+#include <map>
+#include <pthread.h>
+#include <stdint.h>
+#include <vector>
+
+namespace voltdb {
+
+/**
+ * A bounded pool of the buffers behind a site's export and DR
+ * StreamBlocks.
+ *
+ * A stream acquires a buffer for each new StreamBlock and hands it to the
+ * topend, which releases it once the block is acknowledged -- from Java
+ * through DBBPool.deleteCharArrayMemory, so usually on another thread than
+ * the one that acquired it.  Released buffers are kept, by size, for the
+ * next acquire of the same size until the pool holds its capacity in
+ * bytes; past that they are freed.
+ *
+ * Each buffer starts with a small header naming the pool it came from,
+ * so release() goes straight to that pool and only takes that pool's
+ * lock.  allocateUnpooled() makes buffers with the same header and no
+ * pool, for the other native memory that Java frees the same way.
+ *
+ * ExecutorContext owns one pool for its site.  The pool is closed rather
+ * than deleted, and goes away once its last outstanding buffer has been
+ * released.
+ */
+class StreamBufferPool {
+public:
+    static const size_t DEFAULT_CAPACITY = 32 * 1024 * 1024;
+
+    struct Stats {
+        Stats() : m_hits(0), m_misses(0), m_outstandingBytes(0), m_pooledBytes(0) {}
+
+        /** Acquires served from the pool */
+        int64_t m_hits;
+        /** Acquires that allocated a new buffer */
+        int64_t m_misses;
+        /** Bytes acquired and not yet released */
+        int64_t m_outstandingBytes;
+        /** Bytes held by the pool for reuse */
+        int64_t m_pooledBytes;
+    };
+
+    explicit StreamBufferPool(size_t capacity = DEFAULT_CAPACITY);
+
+    /**
+     * Free the pooled buffers, and the pool itself once every buffer it
+     * handed out has been released.  Use this instead of delete.
+     */
+    void close();
+
+    char* acquire(size_t size);
+
+    /** Allocate a buffer that release() frees instead of pooling. */
+    static char* allocateUnpooled(size_t size);
+
+    /**
+     * Give back a buffer from acquire() or allocateUnpooled(), on any
+     * thread.  NULL is ignored.
+     */
+    static void release(char* buffer);
+
+    /** Set the pool's capacity, freeing pooled buffers beyond it. */
+    void setCapacity(size_t capacity);
+    size_t capacity() const;
+    Stats stats() const;
+
+private:
+    struct BufferHeader {
+        StreamBufferPool* m_pool;
+        size_t m_size;
+    };
+
+    typedef std::map<size_t, std::vector<BufferHeader*> > FreeBufferMap;
+
+    ~StreamBufferPool();
+
+    static BufferHeader* allocateBuffer(StreamBufferPool* pool, size_t size);
+    static void freeBuffer(BufferHeader* header);
+
+    void giveBack(BufferHeader* header);
+    void trimLocked(std::vector<BufferHeader*>& toFree);
+
+    mutable pthread_mutex_t m_mutex;
+    size_t m_capacity;
+    bool m_closed;
+    int64_t m_outstandingBuffers;
+    FreeBufferMap m_freeBuffers;
+    Stats m_stats;
+};
+
+} // namespace voltdb
+
+#endif // VOLTDB_STREAMBUFFERPOOL_H
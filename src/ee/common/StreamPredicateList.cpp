@@ -34,7 +34,8 @@ namespace voltdb
 bool StreamPredicateList::parseStrings(
         const std::vector<std::string> &predicateStrings,
         std::ostringstream& errmsg,
-        std::vector<bool> &predicateDeletes)
+        std::vector<bool> &predicateDeletes,
+        std::vector<bool> &predicateCompresses)
 {
     bool failed = false;
     for (std::vector<std::string>::const_iterator iter = predicateStrings.begin();
@@ -48,6 +49,8 @@ bool StreamPredicateList::parseStrings(
                     PlannerDomValue predicateObject = domRoot.rootObject();
 
                     predicateDeletes.push_back(predicateObject.valueForKey("triggersDelete").asBool());
+                    predicateCompresses.push_back(predicateObject.hasKey("compressRows") &&
+                                                  predicateObject.valueForKey("compressRows").asBool());
 
                     AbstractExpression *expr = NULL;
                     if (predicateObject.hasKey("predicateExpression")) {
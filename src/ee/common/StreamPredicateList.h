@@ -48,7 +48,8 @@ public:
     /** Parse expression strings and add generated predicate objects to list. */
     bool parseStrings(const std::vector<std::string> &predicateStrings,
                       std::ostringstream& errmsg,
-                      std::vector<bool> &predicateDeleteFlags);
+                      std::vector<bool> &predicateDeleteFlags,
+                      std::vector<bool> &predicateCompressFlags);
 };
 
 } // namespace voltdb
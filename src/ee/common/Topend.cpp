@@ -16,6 +16,7 @@
  */
 #include "common/Topend.h"
 #include "common/StreamBlock.h"
+#include "common/StreamBufferPool.h"
 #include "storage/table.h"
 #include "storage/persistenttable.h"
 #include "storage/tablefactory.h"
@@ -76,7 +77,7 @@ namespace voltdb {
         partitionIds.push(partitionId);
         signatures.push(signature);
         blocks.push_back(boost::shared_ptr<StreamBlock>(new StreamBlock(block)));
-        data.push_back(boost::shared_array<char>(block->rawPtr()));
+        data.push_back(boost::shared_array<char>(block->rawPtr(), StreamBufferPool::release));
         receivedExportBuffer = true;
     }
 
@@ -90,7 +91,7 @@ namespace voltdb {
         receivedDRBuffer = true;
         partitionIds.push(partitionId);
         blocks.push_back(boost::shared_ptr<StreamBlock>(new StreamBlock(block)));
-        data.push_back(boost::shared_array<char>(block->rawPtr()));
+        data.push_back(boost::shared_array<char>(block->rawPtr(), StreamBufferPool::release));
         return pushDRBufferRetval;
     }
 
@@ -98,7 +99,7 @@ namespace voltdb {
     void DummyTopend::pushPoisonPill(int32_t partitionId, std::string& reason, StreamBlock *block) {
         partitionIds.push(partitionId);
         blocks.push_back(boost::shared_ptr<StreamBlock>(new StreamBlock(block)));
-        data.push_back(boost::shared_array<char>(block->rawPtr()));
+        data.push_back(boost::shared_array<char>(block->rawPtr(), StreamBufferPool::release));
     }
 
 
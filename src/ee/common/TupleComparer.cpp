@@ -0,0 +1,49 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2018 VoltDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with VoltDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "common/TupleComparer.h"
+
+#include "expressions/abstractexpression.h"
+
+#include <algorithm>
+#include <cassert>
+
+namespace voltdb {
+
+TupleComparer::TupleComparer(const std::vector<AbstractExpression*>& keys,
+                             const std::vector<SortDirectionType>& dirs)
+    : m_keys(keys), m_dirs(dirs), m_keyCount(keys.size())
+{
+    assert(keys.size() == dirs.size());
+    assert(std::find(m_dirs.begin(), m_dirs.end(), SORT_DIRECTION_TYPE_INVALID) == m_dirs.end());
+}
+
+bool TupleComparer::operator()(TableTuple ta, TableTuple tb) const
+{
+    for (size_t i = 0; i < m_keyCount; ++i)
+    {
+        AbstractExpression* k = m_keys[i];
+        SortDirectionType dir = m_dirs[i];
+        int cmp = k->eval(&ta, NULL).compare(k->eval(&tb, NULL));
+
+        if (cmp < 0) return (dir == SORT_DIRECTION_TYPE_ASC);
+        if (cmp > 0) return (dir == SORT_DIRECTION_TYPE_DESC);
+    }
+    return false; // ta == tb on these keys
+}
+
+} // namespace voltdb
@@ -0,0 +1,49 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2018 VoltDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with VoltDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TUPLECOMPARER_H_
+#define TUPLECOMPARER_H_
+
+#include "common/tabletuple.h"
+#include "common/types.h"
+
+#include <vector>
+
+namespace voltdb {
+
+class AbstractExpression;
+
+/**
+ * Compares two tuples based on the provided sets of expressions and sort
+ * directions.  The expressions and directions must outlive the comparer.
+ */
+struct TupleComparer
+{
+    TupleComparer(const std::vector<AbstractExpression*>& keys,
+                  const std::vector<SortDirectionType>& dirs);
+
+    bool operator()(TableTuple ta, TableTuple tb) const;
+
+private:
+    const std::vector<AbstractExpression*>& m_keys;
+    const std::vector<SortDirectionType>& m_dirs;
+    size_t m_keyCount;
+};
+
+} // namespace voltdb
+
+#endif // TUPLECOMPARER_H_
@@ -16,6 +16,7 @@
  */
 
 #include "TupleOutputStream.h"
+#include "LZ4Block.h"
 #include "tabletuple.h"
 #include <limits>
 
@@ -63,4 +64,26 @@ void TupleOutputStream::endRows()
     writeIntAt(m_rowCountPosition, m_rowCount);
 }
 
+bool TupleOutputStream::compressRows(std::vector<char> &scratch)
+{
+    if (m_rowCount == 0) {
+        return false;
+    }
+    const std::size_t rowsPosition = m_rowCountPosition + sizeof(int32_t);
+    const std::size_t rowsLength = position() - rowsPosition;
+    scratch.resize(LZ4Block::compressBound(rowsLength));
+    std::size_t compressedLength =
+        LZ4Block::compress(data() + rowsPosition, rowsLength, &scratch[0], scratch.size());
+    if (compressedLength == 0 || COMPRESSED_ROWS_HEADER_SIZE + compressedLength >= rowsLength) {
+        return false;
+    }
+
+    setPosition(rowsPosition);
+    writeInt(COMPRESSED_ROWS_MARKER);
+    writeInt(static_cast<int32_t>(rowsLength));
+    writeInt(static_cast<int32_t>(compressedLength));
+    writeBytes(&scratch[0], compressedLength);
+    return true;
+}
+
 } // namespace voltdb
@@ -19,6 +19,7 @@
 #define TUPLEOUTPUTSTREAM_H_
 
 #include <cstddef>
+#include <vector>
 #include <boost/ptr_container/ptr_vector.hpp>
 #include "serializeio.h"
 
@@ -34,6 +35,16 @@ class TupleOutputStream : public ReferenceSerializeOutput {
 
 public:
 
+    /**
+     * Written after the row count, where the first row's length would be,
+     * when the rows are compressed.  It is followed by the uncompressed and
+     * compressed lengths of the rows and then the rows as an LZ4 block.
+     * The row count itself is left as it is, so readers that only count
+     * rows need not know about the frame.
+     */
+    static const int32_t COMPRESSED_ROWS_MARKER = -1;
+    static const std::size_t COMPRESSED_ROWS_HEADER_SIZE = 3 * sizeof(int32_t);
+
     /**
      * Constructor.
      */
@@ -64,6 +75,14 @@ public:
      */
     void endRows();
 
+    /**
+     * After endRows(), compress the rows into a COMPRESSED_ROWS_MARKER
+     * frame, using scratch as working space.  The rows are left as they
+     * are if there are none or compressing them would not save any space.
+     * Return true if they were compressed.
+     */
+    bool compressRows(std::vector<char> &scratch);
+
     /**
      * Access the total bytes serialized counter.
      */
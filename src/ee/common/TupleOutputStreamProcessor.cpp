@@ -49,6 +49,7 @@ void TupleOutputStreamProcessor::clearState()
 {
     m_maxTupleLength = 0;
     m_predicates = NULL;
+    m_predicateCompresses = NULL;
     m_table = NULL;
 }
 
@@ -65,7 +66,8 @@ void TupleOutputStreamProcessor::open(PersistentTable &table,
                                       std::size_t maxTupleLength,
                                       int32_t partitionId,
                                       StreamPredicateList &predicates,
-                                      std::vector<bool> &predicateDeletes)
+                                      std::vector<bool> &predicateDeletes,
+                                      std::vector<bool> &predicateCompresses)
 {
     m_table = &table;
     m_maxTupleLength = maxTupleLength;
@@ -76,6 +78,7 @@ void TupleOutputStreamProcessor::open(PersistentTable &table,
     }
     m_predicates = &predicates;
     m_predicateDeletes = &predicateDeletes;
+    m_predicateCompresses = &predicateCompresses;
     for (TupleOutputStreamProcessor::iterator iter = begin(); iter != end(); ++iter) {
         iter->startRows(partitionId);
     }
@@ -84,8 +87,13 @@ void TupleOutputStreamProcessor::open(PersistentTable &table,
 /** Stop serializing. */
 void TupleOutputStreamProcessor::close()
 {
-    for (TupleOutputStreamProcessor::iterator iter = begin(); iter != end(); ++iter) {
+    std::size_t iStream = 0;
+    for (TupleOutputStreamProcessor::iterator iter = begin(); iter != end(); ++iter, ++iStream) {
         iter->endRows();
+        if (m_predicateCompresses != NULL && iStream < m_predicateCompresses->size() &&
+                (*m_predicateCompresses)[iStream]) {
+            iter->compressRows(m_compressionBuffer);
+        }
     }
     clearState();
 }
@@ -50,9 +50,10 @@ public:
               std::size_t maxTupleLength,
               int32_t partitionId,
               StreamPredicateList &predicates,
-              std::vector<bool> &predicateDeletes);
+              std::vector<bool> &predicateDeletes,
+              std::vector<bool> &predicateCompresses);
 
-    /** Stop serializing. */
+    /** Stop serializing, compressing the rows of streams whose predicate asks for it. */
     void close();
 
     /**
@@ -81,6 +82,12 @@ private:
     /** Vector of booleans that indicates whether the predicate return true means the row should be deleted */
     std::vector<bool> *m_predicateDeletes;
 
+    /** Vector of booleans that indicates whether the predicate's stream has its rows compressed on close() */
+    std::vector<bool> *m_predicateCompresses;
+
+    /** Working space for compressing rows. Not cleared with the other state. */
+    std::vector<char> m_compressionBuffer;
+
     /** Private method used by constructors, etc. to clear state. */
     void clearState();
 };
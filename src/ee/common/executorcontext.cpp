@@ -17,6 +17,8 @@
 #include "common/executorcontext.hpp"
 
 #include "common/debuglog.h"
+#include "common/PolygonCache.h"
+#include "common/StreamBufferPool.h"
 #include "executors/abstractexecutor.h"
 #include "storage/AbstractDRTupleStream.h"
 #include "storage/DRTupleStream.h"
@@ -100,6 +102,9 @@ ExecutorContext::ExecutorContext(int64_t siteId,
     m_currentTxnTimestamp(0),
     m_currentDRTimestamp(0),
     m_lttBlockCache(topend, engine ? engine->tempTableMemoryLimit() : 50*1024*1024), // engine may be null in unit tests
+    m_regexCache(),
+    m_polygonCache(),
+    m_streamBufferPool(new StreamBufferPool()),
     m_traceOn(false),
     m_lastCommittedSpHandle(0),
     m_siteId(siteId),
@@ -115,8 +120,9 @@ ExecutorContext::ExecutorContext(int64_t siteId,
 
 ExecutorContext::~ExecutorContext() {
     m_lttBlockCache.releaseAllBlocks();
+    m_streamBufferPool->close();
 
-    // currently does not own any of its pointers
+    // currently does not own any of its other pointers
 
     VOLT_DEBUG("De-installing EC(%ld)", (long)this);
 
@@ -316,6 +322,13 @@ bool ExecutorContext::allOutputTempTablesAreEmpty() const {
     return true;
 }
 
+PolygonCache* ExecutorContext::polygonCache() {
+    if (m_polygonCache.get() == NULL) {
+        m_polygonCache.reset(new PolygonCache());
+    }
+    return m_polygonCache.get();
+}
+
 void ExecutorContext::setDrStream(AbstractDRTupleStream *drStream) {
     assert (m_drStream != NULL);
     assert (drStream != NULL);
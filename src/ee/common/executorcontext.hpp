@@ -20,6 +20,7 @@
 
 #include "Topend.h"
 #include "common/LargeTempTableBlockCache.h"
+#include "common/RegexCache.h"
 #include "common/UndoQuantum.h"
 #include "common/valuevector.h"
 #include "common/subquerycontext.h"
@@ -33,6 +34,8 @@
 #include <map>
 #include <memory>
 
+#include "boost/scoped_ptr.hpp"
+
 namespace voltdb {
 
 extern const int64_t VOLT_EPOCH;
@@ -43,6 +46,8 @@ const int64_t LONG_OP_THRESHOLD = 10000;
 
 class AbstractExecutor;
 class AbstractDRTupleStream;
+class PolygonCache;
+class StreamBufferPool;
 class VoltDBEngine;
 
 class TempTable;
@@ -410,6 +415,19 @@ class ExecutorContext {
         return &m_lttBlockCache;
     }
 
+    /** Compiled regular expressions shared by the statements run on this site */
+    RegexCache* regexCache() {
+        return &m_regexCache;
+    }
+
+    /** Deserialized polygons shared by the statements run on this site */
+    PolygonCache* polygonCache();
+
+    /** The buffers behind this site's export and DR stream blocks */
+    StreamBufferPool* streamBufferPool() {
+        return m_streamBufferPool;
+    }
+
   private:
     Topend *m_topend;
     Pool *m_tempStringPool;
@@ -440,6 +458,11 @@ class ExecutorContext {
     int64_t m_currentTxnTimestamp;
     int64_t m_currentDRTimestamp;
     LargeTempTableBlockCache m_lttBlockCache;
+    RegexCache m_regexCache;
+    // Created on first use, to keep the S2 headers out of this one
+    boost::scoped_ptr<PolygonCache> m_polygonCache;
+    // Closed rather than deleted, since Java may still hold its buffers
+    StreamBufferPool* m_streamBufferPool;
     bool m_traceOn;
 
   public:
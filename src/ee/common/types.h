@@ -186,6 +186,8 @@ enum PlanNodeType {
     //
     PLAN_NODE_TYPE_NESTLOOP         = 20,
     PLAN_NODE_TYPE_NESTLOOPINDEX    = 21,
+    PLAN_NODE_TYPE_HASHJOIN         = 22,
+    PLAN_NODE_TYPE_MERGEJOIN        = 23,
 
     //
     // Operator Nodes
@@ -359,7 +361,7 @@ enum QuantifierType {
 enum TableIndexType {
     BALANCED_TREE_INDEX     = 1,
     HASH_TABLE_INDEX        = 2,
-    BTREE_INDEX             = 3, // unused
+    BTREE_INDEX             = 3, // a B+tree, otherwise like BALANCED_TREE_INDEX
     COVERING_CELL_INDEX     = 4
 };
 
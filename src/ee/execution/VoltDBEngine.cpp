@@ -68,6 +68,7 @@
 #include "common/FailureInjection.h"
 #include "common/FatalException.hpp"
 #include "common/InterruptException.h"
+#include "common/PageAllocator.h"
 #include "common/RecoveryProtoMessage.h"
 #include "common/SerializableEEException.h"
 #include "common/TupleOutputStream.h"
@@ -120,6 +121,8 @@ ENABLE_BOOST_FOREACH_ON_CONST_MAP(Table);
 ENABLE_BOOST_FOREACH_ON_CONST_MAP(Function);
 
 static const size_t PLAN_CACHE_SIZE = 1000;
+// rows indexed per tick for each table building an index
+static const size_t INDEX_BUILD_TUPLES_PER_TICK = 100000;
 // table name prefix of DR conflict table
 const std::string DR_REPLICATED_CONFLICT_TABLE_NAME = "VOLTDB_AUTOGEN_XDCR_CONFLICTS_REPLICATED";
 const std::string DR_PARTITIONED_CONFLICT_TABLE_NAME = "VOLTDB_AUTOGEN_XDCR_CONFLICTS_PARTITIONED";
@@ -183,7 +186,14 @@ void VoltDBEngine::initialize(int32_t clusterIndex,
                               int32_t defaultDrBufferSize,
                               int64_t tempTableMemoryLimit,
                               bool createDrReplicatedStream,
-                              int32_t compactionThreshold) {
+                              int32_t compactionThreshold,
+                              int32_t options) {
+    // Before anything maps tuple storage for this site
+    PageAllocator::configure((options & ENGINE_OPTION_HUGE_PAGES) != 0,
+                             (options & ENGINE_OPTION_NUMA_BIND) != 0);
+    setBatchApplyBinaryLogs((options & ENGINE_OPTION_DR_BATCH_APPLY) != 0);
+    setPipelineBinaryLogs((options & ENGINE_OPTION_DR_PIPELINE_APPLY) != 0);
+
     m_clusterIndex = clusterIndex;
     m_siteId = siteId;
     m_partitionId = partitionId;
@@ -1081,6 +1091,8 @@ bool VoltDBEngine::processCatalogAdditions(bool isStreamUpdate, int64_t timestam
             // find all of the indexes to add
             //////////////////////////////////////////
 
+            // an index still being built must be matched against the catalog too
+            persistentTable->finishIndexBuild();
             auto currentIndexes = persistentTable->allIndexes();
             PersistentTable *deltaTable = persistentTable->deltaTable();
 
@@ -1119,8 +1131,8 @@ bool VoltDBEngine::processCatalogAdditions(bool isStreamUpdate, int64_t timestam
                     TableIndex *index = TableIndexFactory::getInstance(scheme);
                     assert(index);
 
-                    // all of the data should be added here
-                    persistentTable->addIndex(index);
+                    // the data is added here, or by later ticks for a large table
+                    persistentTable->addIndexIncrementally(index);
                     // Add the same index structure to the delta table.
                     if (deltaTable) {
                         TableIndex *indexForDelta = TableIndexFactory::getInstance(scheme);
@@ -1727,6 +1739,14 @@ void VoltDBEngine::tick(int64_t timeInMillis, int64_t lastCommittedSpHandle) {
     }
     m_exportingDeletedStreams.clear();
 
+    // Fill in a chunk more of any index created on a populated table.
+    BOOST_FOREACH (LabeledTCD delegatePair, m_delegatesByName) {
+        PersistentTable* persistentTable = delegatePair.second->getPersistentTable();
+        if (persistentTable && persistentTable->isBuildingIndex()) {
+            persistentTable->continueIndexBuild(INDEX_BUILD_TUPLES_PER_TICK);
+        }
+    }
+
     m_executorContext->drStream()->periodicFlush(timeInMillis, lastCommittedSpHandle);
     if (m_executorContext->drReplicatedStream()) {
         m_executorContext->drReplicatedStream()->periodicFlush(timeInMillis, lastCommittedSpHandle);
@@ -120,6 +120,19 @@ typedef std::unique_ptr<AbstractTempTable, TempTableTupleDeleter> UniqueTempTabl
 
 const int64_t DEFAULT_TEMP_TABLE_MEMORY = 1024 * 1024 * 100;
 
+const int32_t DEFAULT_COMPACTION_THRESHOLD = 95;
+
+/**
+ * Optional features, passed to VoltDBEngine::initialize() as a bit mask.
+ * Keep these in sync with the EE_OPTION_* constants in ExecutionEngine.java.
+ */
+enum EngineOption {
+    ENGINE_OPTION_HUGE_PAGES = 1 << 0,
+    ENGINE_OPTION_NUMA_BIND = 1 << 1,
+    ENGINE_OPTION_DR_BATCH_APPLY = 1 << 2,
+    ENGINE_OPTION_DR_PIPELINE_APPLY = 1 << 3
+};
+
 /**
  * Represents an Execution Engine which holds catalog objects (i.e. table) and executes
  * plans on the objects. Every operation starts from this object.
@@ -140,7 +153,8 @@ class __attribute__((visibility("default"))) VoltDBEngine {
                         int32_t defaultDrBufferSize,
                         int64_t tempTableMemoryLimit,
                         bool createDrReplicatedStream,
-                        int32_t compactionThreshold = 95);
+                        int32_t compactionThreshold = DEFAULT_COMPACTION_THRESHOLD,
+                        int32_t options = 0);
         virtual ~VoltDBEngine();
 
         // ------------------------------------------------------------------
@@ -498,6 +512,25 @@ class __attribute__((visibility("default"))) VoltDBEngine {
                             int64_t undoToken,
                             char const* log);
 
+        /**
+         * Look up runs of deletes or updates of a table together when
+         * applying binary logs.  Off unless initialize() is given
+         * ENGINE_OPTION_DR_BATCH_APPLY; see BinaryLogSinkWrapper.
+         */
+        void setBatchApplyBinaryLogs(bool batchApply) {
+            m_wrapper.setBatchApply(batchApply);
+        }
+
+        /**
+         * Read and check each binary log transaction on a helper thread
+         * while the site applies the one before it.  Off unless
+         * initialize() is given ENGINE_OPTION_DR_PIPELINE_APPLY; see
+         * BinaryLogSinkWrapper.
+         */
+        void setPipelineBinaryLogs(bool pipeline) {
+            m_wrapper.setPipelinedApply(pipeline);
+        }
+
         /*
          * Execute an arbitrary task represented by the task id and serialized parameters.
          * Returns serialized representation of the results
@@ -48,6 +48,7 @@
 
 #include "common/InterruptException.h"
 #include "common/tabletuple.h"
+#include "common/TupleComparer.h"
 #include "common/types.h"
 #include "execution/VoltDBEngine.h"
 #include "plannodes/abstractplannode.h"
@@ -109,20 +110,6 @@ class AbstractExecutor {
         return true;
     }
 
-    // Compares two tuples based on the provided sets of expressions and sort directions
-    struct TupleComparer
-    {
-        TupleComparer(const std::vector<AbstractExpression*>& keys,
-                  const std::vector<SortDirectionType>& dirs);
-
-        bool operator()(TableTuple ta, TableTuple tb) const;
-
-    private:
-        const std::vector<AbstractExpression*>& m_keys;
-        const std::vector<SortDirectionType>& m_dirs;
-        size_t m_keyCount;
-    };
-
     // Return a string with useful debug info
     virtual std::string debug() const;
 
@@ -53,7 +53,9 @@
 #include "expressions/abstractexpression.h"
 #include "plannodes/aggregatenode.h"
 #include "plannodes/limitnode.h"
+#include "storage/LargeTempTableBlock.h"
 #include "storage/temptable.h"
+#include "storage/tablefactory.h"
 #include "storage/tableiterator.h"
 
 #include "boost/foreach.hpp"
@@ -776,6 +778,44 @@ void AggregateExecutorBase::p_execute_finish()
 
 AggregateHashExecutor::~AggregateHashExecutor() {}
 
+// The most partitions to spill into at once.  Each partition being
+// written pins one LTT block.
+static const size_t MAX_SPILL_PARTITIONS = 16;
+
+// How many times a partition whose groups still do not fit in memory
+// may be re-partitioned before it is aggregated in memory regardless.
+static const int MAX_SPILL_DEPTH = 4;
+
+bool AggregateHashExecutor::p_init(AbstractPlanNode* abstractNode, const ExecutorVector& executorVector)
+{
+    if (! AggregateExecutorBase::p_init(abstractNode, executorVector)) {
+        return false;
+    }
+
+    m_spillPartitionCount = 0;
+    if (executorVector.isLargeQuery()) {
+        // Leave one block of the LTT block cache for scanning the
+        // input and one for reading back a partition.
+        LargeTempTableBlockCache* lttBlockCache = ExecutorContext::getExecutorContext()->lttBlockCache();
+        int64_t cacheBlocks = lttBlockCache->maxCacheSizeInBytes() / LargeTempTableBlock::BLOCK_SIZE_IN_BYTES;
+        if (cacheBlocks - 2 >= 2) {
+            m_spillPartitionCount = std::min(MAX_SPILL_PARTITIONS, static_cast<size_t>(cacheBlocks - 2));
+            // Groups may use as much memory outside the cache as half
+            // of what the cache itself may use.
+            m_spillMemoryBudget = lttBlockCache->maxCacheSizeInBytes() / 2;
+        }
+    }
+
+    return true;
+}
+
+void AggregateHashExecutor::cleanupMemoryPool()
+{
+    m_spillPartitions.clear();
+    m_spillDepth = 0;
+    AggregateExecutorBase::cleanupMemoryPool();
+}
+
 TableTuple AggregateHashExecutor::p_execute_init(const NValueArray& params,
                                                  ProgressMonitorProxy* pmp,
                                                  const TupleSchema * schema,
@@ -784,6 +824,8 @@ TableTuple AggregateHashExecutor::p_execute_init(const NValueArray& params,
 {
     VOLT_TRACE("hash aggregate executor init..");
     m_hash.clear();
+    m_spillPartitions.clear();
+    m_spillDepth = 0;
 
     return AggregateExecutorBase::p_execute_init(params, pmp, schema, newTempTable, parentPostfilter);
 }
@@ -822,16 +864,38 @@ void AggregateHashExecutor::p_execute_tuple(const TableTuple& nextTuple) {
 
     // Group not found. Make a new entry in the hash for this new group.
     if (keyIter == m_hash.end()) {
+        if (shouldSpill()) {
+            size_t partition = nextGroupByKeyTuple.hashCode(m_spillDepth + 1) % m_spillPartitions.size();
+            TableTuple spilledTuple = nextTuple;
+            m_spillPartitions[partition]->insertTuple(spilledTuple);
+            return;
+        }
+
         VOLT_TRACE("hash aggregate: new group..");
         aggregateRow = new (m_memoryPool, m_aggTypes.size()) AggregateRow();
-        m_hash.insert(HashAggregateMapType::value_type(nextGroupByKeyTuple, aggregateRow));
-
-        initAggInstances(aggregateRow);
-
         char* storage = reinterpret_cast<char*>(m_memoryPool.allocateZeroes(m_inputSchema->tupleLength() + TUPLE_HEADER_SIZE));
         TableTuple passThroughTupleSource = TableTuple(storage, m_inputSchema);
 
-        aggregateRow->recordPassThroughTuple(passThroughTupleSource, nextTuple);
+        if (nextTuple.nonInlinedDataIsVolatile()) {
+            // Large temp table blocks (the input of a large query and the
+            // spill partitions) are freed as they are scanned, so the group
+            // must own copies of the objects its key and pass-through
+            // tuple refer to.
+            const TupleSchema* keySchema = nextGroupByKeyTuple.getSchema();
+            for (uint16_t ii = 0; ii < keySchema->getUninlinedObjectColumnCount(); ii++) {
+                int column = keySchema->getUninlinedObjectColumnInfoIndex(ii);
+                nextGroupByKeyTuple.setNValueAllocateForObjectCopies(column,
+                                                                     nextGroupByKeyTuple.getNValue(column),
+                                                                     &m_memoryPool);
+            }
+            aggregateRow->recordPassThroughTuple(passThroughTupleSource, nextTuple, &m_memoryPool);
+        } else {
+            aggregateRow->recordPassThroughTuple(passThroughTupleSource, nextTuple);
+        }
+
+        m_hash.insert(HashAggregateMapType::value_type(nextGroupByKeyTuple, aggregateRow));
+
+        initAggInstances(aggregateRow);
         // The map is referencing the current key tuple for use by the new group,
         // so force a new tuple allocation to hold the next candidate key.
         nextGroupByKeyTuple.move(NULL);
@@ -851,6 +915,15 @@ void AggregateHashExecutor::p_execute_tuple(const TableTuple& nextTuple) {
 void AggregateHashExecutor::p_execute_finish() {
     VOLT_TRACE("finalizing..");
 
+    finishGroups();
+    if (! m_spillPartitions.empty()) {
+        aggregateSpilledPartitions();
+    }
+
+    AggregateExecutorBase::p_execute_finish();
+}
+
+void AggregateHashExecutor::finishGroups() {
     // If there is no aggregation, results are already inserted already
     if (m_aggTypes.size() != 0) {
         for (HashAggregateMapType::const_iterator iter = m_hash.begin(); iter != m_hash.end(); iter++) {
@@ -864,7 +937,90 @@ void AggregateHashExecutor::p_execute_finish() {
 
     // Clean up
     m_hash.clear();
-    AggregateExecutorBase::p_execute_finish();
+}
+
+bool AggregateHashExecutor::shouldSpill() {
+    if (! m_spillPartitions.empty()) {
+        return true;
+    }
+
+    if (m_spillPartitionCount == 0 || m_spillDepth >= MAX_SPILL_DEPTH) {
+        return false;
+    }
+
+    // The pool holds the group keys, aggregate rows and pass-through
+    // tuples; the map holds one slot per bucket.
+    int64_t groupMemory = m_memoryPool.getAllocatedMemory() + m_hash.allocatedMemory();
+    if (groupMemory <= m_spillMemoryBudget) {
+        return false;
+    }
+
+    VOLT_DEBUG("hash aggregate: spilling new groups into %d partitions at depth %d",
+               (int)m_spillPartitionCount, m_spillDepth);
+    if (m_spillColumnNames.empty()) {
+        for (int ii = 0; ii < m_inputSchema->columnCount(); ++ii) {
+            std::ostringstream oss;
+            oss << "C" << ii;
+            m_spillColumnNames.push_back(oss.str());
+        }
+    }
+
+    for (size_t ii = 0; ii < m_spillPartitionCount; ++ii) {
+        m_spillPartitions.emplace_back(TableFactory::buildLargeTempTable("spilled hash aggregate partition",
+                                                                         TupleSchema::createTupleSchema(m_inputSchema),
+                                                                         m_spillColumnNames));
+    }
+
+    return true;
+}
+
+void AggregateHashExecutor::aggregateSpilledPartitions() {
+    // Partitions still to be aggregated, each with its spill depth.
+    // Processing them last-in first-out keeps at most one level of
+    // partitions being written at any time.
+    std::vector<std::pair<std::unique_ptr<LargeTempTable>, int> > pending;
+    int depth = m_spillDepth + 1;
+    do {
+        BOOST_FOREACH(std::unique_ptr<LargeTempTable>& partition, m_spillPartitions) {
+            partition->finishInserts();
+            if (partition->activeTupleCount() > 0) {
+                pending.push_back(std::make_pair(std::move(partition), depth));
+            }
+        }
+        m_spillPartitions.clear();
+
+        if (pending.empty()) {
+            break;
+        }
+
+        std::unique_ptr<LargeTempTable> partition = std::move(pending.back().first);
+        m_spillDepth = pending.back().second;
+        pending.pop_back();
+
+        // Nothing more can be output once the limit has been reached.
+        if (! m_postfilter.isUnderLimit()) {
+            continue;
+        }
+
+        // The previous groups have all been output and deleted, so
+        // reclaim their memory (including the map's buckets) for this
+        // partition's groups.
+        HashAggregateMapType().swap(m_hash);
+        TableTuple& nextGroupByKeyTuple = m_nextGroupByKeyStorage;
+        nextGroupByKeyTuple.move(NULL);
+        m_memoryPool.purge();
+
+        TableIterator it = partition->iteratorDeletingAsWeGo();
+        TableTuple nextTuple(partition->schema());
+        while (it.next(nextTuple)) {
+            p_execute_tuple(nextTuple);
+        }
+        finishGroups();
+
+        depth = m_spillDepth + 1;
+    } while (true);
+
+    m_spillDepth = 0;
 }
 
 AggregateSerialExecutor::~AggregateSerialExecutor() {}
@@ -55,6 +55,10 @@
 #include "expressions/abstractexpression.h"
 #include "execution/ProgressMonitorProxy.h"
 #include "executors/executorutil.h"
+#include "storage/LargeTempTable.h"
+#include "structures/FlatHashMap.h"
+
+#include <memory>
 
 namespace voltdb {
 
@@ -144,6 +148,13 @@ struct AggregateRow
         m_passThroughTuple = passThroughTupleSource;
     }
 
+    /// Like the above, but copy any non-inlined objects into the pool.
+    void recordPassThroughTuple(TableTuple &passThroughTupleSource, const TableTuple &tuple, Pool* pool)
+    {
+        passThroughTupleSource.copyForPersistentInsert(tuple, pool);
+        m_passThroughTuple = passThroughTupleSource;
+    }
+
     // A tuple from the group of tuples being aggregated. Source of pass through columns.
     TableTuple m_passThroughTuple;
 
@@ -258,10 +269,10 @@ private:
     TupleSchema* constructGroupBySchema(bool partial);
 };
 
-typedef boost::unordered_map<TableTuple,
-                             AggregateRow*,
-                             TableTupleHasher,
-                             TableTupleEqualityChecker> HashAggregateMapType;
+typedef FlatHashMap<TableTuple,
+                    AggregateRow*,
+                    TableTupleHasher,
+                    TableTupleEqualityChecker> HashAggregateMapType;
 
 
 /**
@@ -272,7 +283,11 @@ class AggregateHashExecutor : public AggregateExecutorBase
 {
 public:
     AggregateHashExecutor(VoltDBEngine* engine, AbstractPlanNode* abstract_node) :
-        AggregateExecutorBase(engine, abstract_node) { }
+        AggregateExecutorBase(engine, abstract_node),
+        m_spillPartitionCount(0),
+        m_spillMemoryBudget(0),
+        m_spillDepth(0)
+    { }
 
     // empty destructor defined in .cpp file because of it is called virtually (not inline)
     // same reason for serial and partial
@@ -284,9 +299,42 @@ public:
     void p_execute_tuple(const TableTuple& nextTuple);
     void p_execute_finish();
 
+    virtual void cleanupMemoryPool();
+
+protected:
+    virtual bool p_init(AbstractPlanNode*, const ExecutorVector& executorVector);
+
 private:
     virtual bool p_execute(const NValueArray& params);
+
+    /// Output (and free) every group in the hash table.
+    void finishGroups();
+
+    /// Returns true if input rows of new groups should be written to
+    /// spill partitions rather than starting a group in the hash table,
+    /// creating the partitions the first time the memory budget is exceeded.
+    bool shouldSpill();
+
+    /// Aggregate each spilled partition in turn, spilling again if a
+    /// partition's groups still do not fit.
+    void aggregateSpilledPartitions();
+
     HashAggregateMapType m_hash;
+
+    /*
+     * Grace hash aggregation for large queries.  Once the groups in
+     * m_hash exceed m_spillMemoryBudget, rows of groups that are not
+     * already in the hash table are hash-partitioned into large temp
+     * tables (whose blocks may be stored to disk), and each partition
+     * is aggregated on its own after the in-memory groups are output.
+     * A group is either entirely in memory or entirely in one partition.
+     * Spilling is disabled when m_spillPartitionCount is zero.
+     */
+    size_t m_spillPartitionCount;
+    int64_t m_spillMemoryBudget;
+    int m_spillDepth;
+    std::vector<std::string> m_spillColumnNames;
+    std::vector<std::unique_ptr<LargeTempTable> > m_spillPartitions;
 };
 
 /**
@@ -0,0 +1,366 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2018 VoltDB Inc.
+ *
+ * This file contains original code and/or modifications of original code.
+ * Any modifications made by VoltDB Inc. are licensed under the following
+ * terms and conditions:
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with VoltDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/* Copyright (C) 2008 by H-Store Project
+ * Brown University
+ * Massachusetts Institute of Technology
+ * Yale University
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT
+ * IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "hashjoinexecutor.h"
+
+#include "common/debuglog.h"
+#include "common/SerializableEEException.h"
+#include "common/tabletuple.h"
+#include "common/TupleSchema.h"
+#include "executors/aggregateexecutor.h"
+#include "executors/executorutil.h"
+#include "execution/ExecutorVector.h"
+#include "execution/ProgressMonitorProxy.h"
+#include "expressions/abstractexpression.h"
+#include "storage/table.h"
+#include "storage/tableiterator.h"
+#include "storage/tabletuplefilter.h"
+#include "plannodes/hashjoinnode.h"
+#include "plannodes/limitnode.h"
+
+#include <algorithm>
+#include <vector>
+
+using namespace std;
+using namespace voltdb;
+
+const static int8_t UNMATCHED_TUPLE(TableTupleFilter::ACTIVE_TUPLE);
+const static int8_t MATCHED_TUPLE(TableTupleFilter::ACTIVE_TUPLE + 1);
+
+HashJoinExecutor::~HashJoinExecutor()
+{
+    // NULL safe operation
+    TupleSchema::freeTupleSchema(m_keySchema);
+}
+
+bool HashJoinExecutor::p_init(AbstractPlanNode* abstractNode,
+                              const ExecutorVector& executorVector)
+{
+    VOLT_TRACE("init HashJoin Executor");
+
+    HashJoinPlanNode* node = dynamic_cast<HashJoinPlanNode*>(m_abstractNode);
+    assert(node);
+    // The build side is referenced by tuple address for the duration of the
+    // probe, which is not compatible with large temp table blocks being
+    // unpinned and swapped out.
+    assert(! executorVector.isLargeQuery());
+
+    // Init parent first
+    if (!AbstractJoinExecutor::p_init(abstractNode, executorVector)) {
+        return false;
+    }
+
+    // NULL tuples for left and full joins
+    p_init_null_tuples(node->getInputTable(), node->getInputTable(1));
+
+    // Both sides' keys are materialized into tuples of a common key schema
+    // so that the hasher and equality checker see identically typed columns.
+    // Each key column takes the type both sides' values are promoted to when
+    // compared, so that e.g. an INTEGER key equated to a DOUBLE key is
+    // hashed and compared as DOUBLE rather than truncated to INTEGER.
+    // Variable length columns get the wider of the two sides' sizes.
+    const std::vector<AbstractExpression*>& outerKeys = node->getOuterHashExpressions();
+    const std::vector<AbstractExpression*>& innerKeys = node->getInnerHashExpressions();
+    assert(outerKeys.size() == innerKeys.size());
+    assert( ! outerKeys.empty());
+    std::vector<ValueType> keyColumnTypes;
+    std::vector<int32_t> keyColumnSizes;
+    std::vector<bool> keyColumnAllowNull;
+    std::vector<bool> keyColumnInBytes;
+    for (int ii = 0; ii < outerKeys.size(); ii++) {
+        keyColumnTypes.push_back(hashKeyType(outerKeys[ii]->getValueType(),
+                                             innerKeys[ii]->getValueType()));
+        keyColumnSizes.push_back(std::max(outerKeys[ii]->getValueSize(), innerKeys[ii]->getValueSize()));
+        keyColumnAllowNull.push_back(true);
+        keyColumnInBytes.push_back(outerKeys[ii]->getInBytes() || innerKeys[ii]->getInBytes());
+    }
+    TupleSchema::freeTupleSchema(m_keySchema);
+    m_keySchema = TupleSchema::createTupleSchema(keyColumnTypes,
+                                                 keyColumnSizes,
+                                                 keyColumnAllowNull,
+                                                 keyColumnInBytes);
+    return true;
+}
+
+ValueType HashJoinExecutor::hashKeyType(ValueType outerType, ValueType innerType)
+{
+    // A NULL-typed key never matches, so it needs no promotion.
+    if (outerType == innerType || innerType == VALUE_TYPE_NULL) {
+        return outerType;
+    }
+    if (outerType == VALUE_TYPE_NULL) {
+        return innerType;
+    }
+    ValueType keyType = NValue::promoteForOp(outerType, innerType);
+    if (keyType == VALUE_TYPE_INVALID) {
+        throwSerializableEEException("HashJoinExecutor: incompatible hash key types %s and %s",
+                                     getTypeName(outerType).c_str(),
+                                     getTypeName(innerType).c_str());
+    }
+    return keyType;
+}
+
+bool HashJoinExecutor::evalHashKey(TableTuple& keyTuple,
+                                   const std::vector<AbstractExpression*>& keyExpressions,
+                                   const TableTuple& tuple)
+{
+    for (int ii = 0; ii < keyExpressions.size(); ii++) {
+        NValue value = keyExpressions[ii]->eval(&tuple, NULL);
+        if (value.isNull()) {
+            return false;
+        }
+        keyTuple.setNValue(ii, value);
+    }
+    return true;
+}
+
+void HashJoinExecutor::buildHashTable(Table* buildTable,
+                                      const std::vector<AbstractExpression*>& keyExpressions,
+                                      AbstractExpression* buildPredicate,
+                                      ProgressMonitorProxy& pmp)
+{
+    TableTuple buildTuple(buildTable->schema());
+    TableIterator iterator = buildTable->iterator();
+    m_buildKeyStorage.init(m_keySchema, &m_memoryPool);
+    TableTuple& buildKeyTuple = m_buildKeyStorage;
+    buildKeyTuple.move(NULL);
+    while (iterator.next(buildTuple)) {
+        pmp.countdownProgress();
+        if (buildPredicate != NULL && ! buildPredicate->eval(&buildTuple, NULL).isTrue()) {
+            continue;
+        }
+        if (buildKeyTuple.isNullTuple()) {
+            m_buildKeyStorage.allocateActiveTuple();
+        }
+        if ( ! evalHashKey(buildKeyTuple, keyExpressions, buildTuple)) {
+            // A NULL key can never satisfy the equi-join condition,
+            // so keep the key storage for the next candidate.
+            continue;
+        }
+        m_hash.insert(HashJoinMapType::value_type(buildKeyTuple, buildTuple.address()));
+        // The map references the current key tuple,
+        // so force a new tuple allocation for the next key.
+        buildKeyTuple.move(NULL);
+    }
+    VOLT_DEBUG("hash join built %d entries from %d tuples",
+               (int)m_hash.size(), (int)buildTable->activeTupleCount());
+}
+
+bool HashJoinExecutor::p_execute(const NValueArray &params) {
+    VOLT_DEBUG("executing HashJoin...");
+
+    HashJoinPlanNode* node = dynamic_cast<HashJoinPlanNode*>(m_abstractNode);
+    assert(node);
+    assert(node->getInputTableCount() == 2);
+
+    // output table must be a temp table
+    assert(m_tmpOutputTable);
+
+    Table* outer_table = node->getInputTable();
+    assert(outer_table);
+
+    Table* inner_table = node->getInputTable(1);
+    assert(inner_table);
+
+    VOLT_TRACE ("input table left:\n %s", outer_table->debug().c_str());
+    VOLT_TRACE ("input table right:\n %s", inner_table->debug().c_str());
+
+    AbstractExpression *preJoinPredicate = node->getPreJoinPredicate();
+    AbstractExpression *joinPredicate = node->getJoinPredicate();
+    AbstractExpression *wherePredicate = node->getWherePredicate();
+
+    LimitPlanNode* limit_node = dynamic_cast<LimitPlanNode*>(node->getInlinePlanNode(PLAN_NODE_TYPE_LIMIT));
+    int limit = CountingPostfilter::NO_LIMIT;
+    int offset = CountingPostfilter::NO_OFFSET;
+    if (limit_node) {
+        limit_node->getLimitAndOffsetByReference(params, limit, offset);
+    }
+
+    int outer_cols = outer_table->columnCount();
+    int inner_cols = inner_table->columnCount();
+    TableTuple outer_tuple(outer_table->schema());
+    TableTuple inner_tuple(inner_table->schema());
+
+    ProgressMonitorProxy pmp(m_engine->getExecutorContext(), this);
+    // Init the postfilter
+    CountingPostfilter postfilter(m_tmpOutputTable, wherePredicate, limit, offset);
+
+    TableTuple join_tuple;
+    if (m_aggExec != NULL) {
+        VOLT_TRACE("Init inline aggregate...");
+        const TupleSchema * aggInputSchema = node->getTupleSchemaPreAgg();
+        join_tuple = m_aggExec->p_execute_init(params, &pmp, aggInputSchema, m_tmpOutputTable, &postfilter);
+    } else {
+        join_tuple = m_tmpOutputTable->tempTuple();
+    }
+
+    m_hash.clear();
+    m_memoryPool.purge();
+    m_probeKeyStorage.init(m_keySchema, &m_memoryPool);
+    m_probeKeyStorage.allocateActiveTuple();
+    TableTuple& probeKeyTuple = m_probeKeyStorage;
+
+    // Only an inner join can swap the roles of its inputs, since outer joins
+    // must see every outer tuple exactly once to null-pad the unmatched ones.
+    bool buildOnOuter = m_joinType == JOIN_TYPE_INNER &&
+            outer_table->activeTupleCount() < inner_table->activeTupleCount();
+
+    if (buildOnOuter) {
+        // The pre-join predicate depends only on the outer table, so outer
+        // tuples that fail it can never join and are left out of the build.
+        buildHashTable(outer_table, node->getOuterHashExpressions(), preJoinPredicate, pmp);
+
+        TableIterator iterator1 = inner_table->iteratorDeletingAsWeGo();
+        while (postfilter.isUnderLimit() && iterator1.next(inner_tuple)) {
+            pmp.countdownProgress();
+            if ( ! evalHashKey(probeKeyTuple, node->getInnerHashExpressions(), inner_tuple)) {
+                continue;
+            }
+            std::pair<HashJoinMapType::const_iterator, HashJoinMapType::const_iterator> range =
+                    m_hash.equal_range(probeKeyTuple);
+            for (HashJoinMapType::const_iterator it = range.first;
+                 it != range.second && postfilter.isUnderLimit(); ++it) {
+                outer_tuple.move(it->second);
+                if (joinPredicate == NULL || joinPredicate->eval(&outer_tuple, &inner_tuple).isTrue()) {
+                    if (postfilter.eval(&outer_tuple, &inner_tuple)) {
+                        join_tuple.setNValues(0, outer_tuple, 0, outer_cols);
+                        join_tuple.setNValues(outer_cols, inner_tuple, 0, inner_cols);
+                        outputTuple(postfilter, join_tuple, pmp);
+                    }
+                }
+            }
+        }
+    }
+    else {
+        // The table filter to keep track of inner tuples that don't match any of outer tuples for FULL joins
+        TableTupleFilter innerTableFilter;
+        if (m_joinType == JOIN_TYPE_FULL) {
+            // Prepopulate the view with all inner tuples
+            innerTableFilter.init(inner_table);
+        }
+
+        buildHashTable(inner_table, node->getInnerHashExpressions(), NULL, pmp);
+
+        const TableTuple& null_inner_tuple = m_null_inner_tuple.tuple();
+        TableIterator iterator0 = outer_table->iteratorDeletingAsWeGo();
+        while (postfilter.isUnderLimit() && iterator0.next(outer_tuple)) {
+            pmp.countdownProgress();
+
+            // populate output table's temp tuple with outer table's values
+            join_tuple.setNValues(0, outer_tuple, 0, outer_cols);
+
+            // did this loop body find at least one match for this tuple?
+            bool outerMatch = false;
+            // For outer joins if outer tuple fails pre-join predicate
+            // (join expression based on the outer table only)
+            // it can't match any of inner tuples
+            if ((preJoinPredicate == NULL || preJoinPredicate->eval(&outer_tuple, NULL).isTrue()) &&
+                evalHashKey(probeKeyTuple, node->getOuterHashExpressions(), outer_tuple)) {
+                std::pair<HashJoinMapType::const_iterator, HashJoinMapType::const_iterator> range =
+                        m_hash.equal_range(probeKeyTuple);
+                for (HashJoinMapType::const_iterator it = range.first;
+                     it != range.second && postfilter.isUnderLimit(); ++it) {
+                    inner_tuple.move(it->second);
+                    if (joinPredicate == NULL || joinPredicate->eval(&outer_tuple, &inner_tuple).isTrue()) {
+                        outerMatch = true;
+                        // The inner tuple passed the join predicate
+                        if (m_joinType == JOIN_TYPE_FULL) {
+                            // Mark it as matched
+                            innerTableFilter.updateTuple(inner_tuple, MATCHED_TUPLE);
+                        }
+                        // Filter the joined tuple
+                        if (postfilter.eval(&outer_tuple, &inner_tuple)) {
+                            // Matched! Complete the joined tuple with the inner column values.
+                            join_tuple.setNValues(outer_cols, inner_tuple, 0, inner_cols);
+                            outputTuple(postfilter, join_tuple, pmp);
+                        }
+                    }
+                }
+            }
+
+            //
+            // Left Outer Join
+            //
+            if (m_joinType != JOIN_TYPE_INNER && !outerMatch && postfilter.isUnderLimit()) {
+                // Still needs to pass the filter
+                if (postfilter.eval(&outer_tuple, &null_inner_tuple)) {
+                    join_tuple.setNValues(outer_cols, null_inner_tuple, 0, inner_cols);
+                    outputTuple(postfilter, join_tuple, pmp);
+                }
+            }
+        }
+
+        //
+        // FULL Outer Join. Iterate over the unmatched inner tuples
+        //
+        if (m_joinType == JOIN_TYPE_FULL && postfilter.isUnderLimit()) {
+            // Preset outer columns to null
+            const TableTuple& null_outer_tuple = m_null_outer_tuple.tuple();
+            join_tuple.setNValues(0, null_outer_tuple, 0, outer_cols);
+
+            TableTupleFilter_iter<UNMATCHED_TUPLE> endItr = innerTableFilter.end<UNMATCHED_TUPLE>();
+            for (TableTupleFilter_iter<UNMATCHED_TUPLE> itr = innerTableFilter.begin<UNMATCHED_TUPLE>();
+                    itr != endItr && postfilter.isUnderLimit(); ++itr) {
+                // Restore the tuple value
+                uint64_t tupleAddr = innerTableFilter.getTupleAddress(*itr);
+                inner_tuple.move((char *)tupleAddr);
+                // Still needs to pass the filter
+                assert(inner_tuple.isActive());
+                if (postfilter.eval(&null_outer_tuple, &inner_tuple)) {
+                    join_tuple.setNValues(outer_cols, inner_tuple, 0, inner_cols);
+                    outputTuple(postfilter, join_tuple, pmp);
+                }
+            }
+        }
+    }
+
+    if (m_aggExec != NULL) {
+        m_aggExec->p_execute_finish();
+    }
+
+    m_hash.clear();
+    m_memoryPool.purge();
+
+    return (true);
+}
@@ -0,0 +1,121 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2018 VoltDB Inc.
+ *
+ * This file contains original code and/or modifications of original code.
+ * Any modifications made by VoltDB Inc. are licensed under the following
+ * terms and conditions:
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with VoltDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/* Copyright (C) 2008 by H-Store Project
+ * Brown University
+ * Massachusetts Institute of Technology
+ * Yale University
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT
+ * IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef HSTOREHASHJOINEXECUTOR_H
+#define HSTOREHASHJOINEXECUTOR_H
+
+#include "common/common.h"
+#include "common/Pool.hpp"
+#include "common/tabletuple.h"
+#include "common/valuevector.h"
+#include "executors/abstractjoinexecutor.h"
+
+#include <boost/unordered_map.hpp>
+
+namespace voltdb {
+
+class AbstractExpression;
+
+typedef boost::unordered_multimap<TableTuple,
+                                  char*,
+                                  TableTupleHasher,
+                                  TableTupleEqualityChecker> HashJoinMapType;
+
+/**
+ * The executor for PLAN_NODE_TYPE_HASHJOIN.
+ *
+ * The build phase evaluates the hash key expressions for every tuple of the
+ * build input and maps the resulting key tuple to the tuple's address.
+ * The probe phase evaluates the other side's hash key expressions and visits
+ * only the build tuples with equal keys, so the join costs O(N + M) instead
+ * of the O(N * M) of a nested loop.
+ *
+ * The inner table is the build input for outer joins, so that unmatched
+ * outer tuples can be null-padded as they stream by.  Inner joins build
+ * over whichever input has fewer tuples.  Keys containing a NULL never
+ * match, per SQL equality semantics.
+ */
+class HashJoinExecutor : public AbstractJoinExecutor {
+public:
+    HashJoinExecutor(VoltDBEngine *engine, AbstractPlanNode* abstract_node)
+        : AbstractJoinExecutor(engine, abstract_node)
+        , m_keySchema(NULL)
+    { }
+    ~HashJoinExecutor();
+
+private:
+    bool p_init(AbstractPlanNode*, const ExecutorVector& executorVector);
+    bool p_execute(const NValueArray &params);
+
+    /**
+     * Return the type that a key column equating values of the two types
+     * is hashed and compared as, following NValue's comparison promotion.
+     * Throw if values of the two types can not be compared.
+     */
+    static ValueType hashKeyType(ValueType outerType, ValueType innerType);
+
+    /**
+     * Evaluate the key expressions against the tuple into the key tuple.
+     * Return false if any of the key values is NULL.
+     */
+    static bool evalHashKey(TableTuple& keyTuple,
+                            const std::vector<AbstractExpression*>& keyExpressions,
+                            const TableTuple& tuple);
+
+    void buildHashTable(Table* buildTable,
+                        const std::vector<AbstractExpression*>& keyExpressions,
+                        AbstractExpression* buildPredicate,
+                        ProgressMonitorProxy& pmp);
+
+    TupleSchema* m_keySchema;
+    Pool m_memoryPool;
+    PoolBackedTupleStorage m_buildKeyStorage;
+    PoolBackedTupleStorage m_probeKeyStorage;
+    HashJoinMapType m_hash;
+};
+
+}
+
+#endif
@@ -0,0 +1,281 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2018 VoltDB Inc.
+ *
+ * This file contains original code and/or modifications of original code.
+ * Any modifications made by VoltDB Inc. are licensed under the following
+ * terms and conditions:
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with VoltDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/* Copyright (C) 2008 by H-Store Project
+ * Brown University
+ * Massachusetts Institute of Technology
+ * Yale University
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT
+ * IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "mergejoinexecutor.h"
+
+#include "common/debuglog.h"
+#include "common/tabletuple.h"
+#include "executors/aggregateexecutor.h"
+#include "executors/executorutil.h"
+#include "execution/ExecutorVector.h"
+#include "execution/ProgressMonitorProxy.h"
+#include "expressions/abstractexpression.h"
+#include "storage/table.h"
+#include "storage/tableiterator.h"
+#include "storage/tabletuplefilter.h"
+#include "plannodes/mergejoinnode.h"
+#include "plannodes/limitnode.h"
+
+using namespace std;
+using namespace voltdb;
+
+const static int8_t UNMATCHED_TUPLE(TableTupleFilter::ACTIVE_TUPLE);
+const static int8_t MATCHED_TUPLE(TableTupleFilter::ACTIVE_TUPLE + 1);
+
+bool MergeJoinExecutor::p_init(AbstractPlanNode* abstractNode,
+                               const ExecutorVector& executorVector)
+{
+    VOLT_TRACE("init MergeJoin Executor");
+
+    MergeJoinPlanNode* node = dynamic_cast<MergeJoinPlanNode*>(m_abstractNode);
+    assert(node);
+    // The current run of inner tuples is referenced by tuple address,
+    // which is not compatible with large temp table blocks being unpinned
+    // and swapped out.
+    assert(! executorVector.isLargeQuery());
+
+    // Init parent first
+    if (!AbstractJoinExecutor::p_init(abstractNode, executorVector)) {
+        return false;
+    }
+
+    // NULL tuples for left and full joins
+    p_init_null_tuples(node->getInputTable(), node->getInputTable(1));
+
+    m_outerKeys = &node->getOuterKeyExpressions();
+    m_innerKeys = &node->getInnerKeyExpressions();
+    assert(m_outerKeys->size() == m_innerKeys->size());
+    assert( ! m_outerKeys->empty());
+    m_descending = (node->getSortDirection() == SORT_DIRECTION_TYPE_DESC);
+    m_outerKeyValues.resize(m_outerKeys->size());
+    return true;
+}
+
+bool MergeJoinExecutor::evalOuterKey(const TableTuple& outerTuple)
+{
+    for (int ii = 0; ii < m_outerKeyValues.size(); ii++) {
+        m_outerKeyValues[ii] = (*m_outerKeys)[ii]->eval(&outerTuple, NULL);
+        if (m_outerKeyValues[ii].isNull()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+int MergeJoinExecutor::compareInnerToOuterKey(const TableTuple& innerTuple) const
+{
+    for (int ii = 0; ii < m_outerKeyValues.size(); ii++) {
+        int cmp = (*m_innerKeys)[ii]->eval(&innerTuple, NULL).compare(m_outerKeyValues[ii]);
+        if (cmp != VALUE_COMPARE_EQUAL) {
+            return m_descending ? -cmp : cmp;
+        }
+    }
+    return VALUE_COMPARE_EQUAL;
+}
+
+bool MergeJoinExecutor::p_execute(const NValueArray &params) {
+    VOLT_DEBUG("executing MergeJoin...");
+
+    MergeJoinPlanNode* node = dynamic_cast<MergeJoinPlanNode*>(m_abstractNode);
+    assert(node);
+    assert(node->getInputTableCount() == 2);
+
+    // output table must be a temp table
+    assert(m_tmpOutputTable);
+
+    Table* outer_table = node->getInputTable();
+    assert(outer_table);
+
+    Table* inner_table = node->getInputTable(1);
+    assert(inner_table);
+
+    VOLT_TRACE ("input table left:\n %s", outer_table->debug().c_str());
+    VOLT_TRACE ("input table right:\n %s", inner_table->debug().c_str());
+
+    AbstractExpression *preJoinPredicate = node->getPreJoinPredicate();
+    AbstractExpression *joinPredicate = node->getJoinPredicate();
+    AbstractExpression *wherePredicate = node->getWherePredicate();
+
+    // The table filter to keep track of inner tuples that don't match any of outer tuples for FULL joins
+    TableTupleFilter innerTableFilter;
+    if (m_joinType == JOIN_TYPE_FULL) {
+        // Prepopulate the view with all inner tuples
+        innerTableFilter.init(inner_table);
+    }
+
+    LimitPlanNode* limit_node = dynamic_cast<LimitPlanNode*>(node->getInlinePlanNode(PLAN_NODE_TYPE_LIMIT));
+    int limit = CountingPostfilter::NO_LIMIT;
+    int offset = CountingPostfilter::NO_OFFSET;
+    if (limit_node) {
+        limit_node->getLimitAndOffsetByReference(params, limit, offset);
+    }
+
+    int outer_cols = outer_table->columnCount();
+    int inner_cols = inner_table->columnCount();
+    TableTuple outer_tuple(outer_table->schema());
+    TableTuple inner_tuple(inner_table->schema());
+    TableTuple run_tuple(inner_table->schema());
+    const TableTuple& null_inner_tuple = m_null_inner_tuple.tuple();
+
+    // The inner tuples are revisited through m_innerRun,
+    // so they must not be deleted as we go.
+    TableIterator iterator0 = outer_table->iteratorDeletingAsWeGo();
+    TableIterator iterator1 = inner_table->iterator();
+    bool innerValid = iterator1.next(inner_tuple);
+    m_innerRun.clear();
+
+    ProgressMonitorProxy pmp(m_engine->getExecutorContext(), this);
+    // Init the postfilter
+    CountingPostfilter postfilter(m_tmpOutputTable, wherePredicate, limit, offset);
+
+    TableTuple join_tuple;
+    if (m_aggExec != NULL) {
+        VOLT_TRACE("Init inline aggregate...");
+        const TupleSchema * aggInputSchema = node->getTupleSchemaPreAgg();
+        join_tuple = m_aggExec->p_execute_init(params, &pmp, aggInputSchema, m_tmpOutputTable, &postfilter);
+    } else {
+        join_tuple = m_tmpOutputTable->tempTuple();
+    }
+
+    while (postfilter.isUnderLimit() && iterator0.next(outer_tuple)) {
+        pmp.countdownProgress();
+
+        // populate output table's temp tuple with outer table's values
+        join_tuple.setNValues(0, outer_tuple, 0, outer_cols);
+
+        // did this loop body find at least one match for this tuple?
+        bool outerMatch = false;
+        if ((preJoinPredicate == NULL || preJoinPredicate->eval(&outer_tuple, NULL).isTrue()) &&
+            evalOuterKey(outer_tuple)) {
+            // Outer keys are non-decreasing, so the remembered run is reusable
+            // exactly when its key equals the current outer key.
+            bool reuseRun = false;
+            if ( ! m_innerRun.empty()) {
+                run_tuple.move(m_innerRun.front());
+                reuseRun = (compareInnerToOuterKey(run_tuple) == VALUE_COMPARE_EQUAL);
+            }
+            if ( ! reuseRun) {
+                m_innerRun.clear();
+                // Skip the inner tuples whose keys sort before the outer key.
+                while (innerValid && compareInnerToOuterKey(inner_tuple) < 0) {
+                    pmp.countdownProgress();
+                    innerValid = iterator1.next(inner_tuple);
+                }
+                // Collect the run of inner tuples with an equal key.
+                while (innerValid && compareInnerToOuterKey(inner_tuple) == VALUE_COMPARE_EQUAL) {
+                    pmp.countdownProgress();
+                    m_innerRun.push_back(inner_tuple.address());
+                    innerValid = iterator1.next(inner_tuple);
+                }
+            }
+
+            for (std::vector<char*>::const_iterator it = m_innerRun.begin();
+                 it != m_innerRun.end() && postfilter.isUnderLimit(); ++it) {
+                run_tuple.move(*it);
+                if (joinPredicate == NULL || joinPredicate->eval(&outer_tuple, &run_tuple).isTrue()) {
+                    outerMatch = true;
+                    // The inner tuple passed the join predicate
+                    if (m_joinType == JOIN_TYPE_FULL) {
+                        // Mark it as matched
+                        innerTableFilter.updateTuple(run_tuple, MATCHED_TUPLE);
+                    }
+                    // Filter the joined tuple
+                    if (postfilter.eval(&outer_tuple, &run_tuple)) {
+                        // Matched! Complete the joined tuple with the inner column values.
+                        join_tuple.setNValues(outer_cols, run_tuple, 0, inner_cols);
+                        outputTuple(postfilter, join_tuple, pmp);
+                    }
+                }
+            }
+        }
+
+        //
+        // Left Outer Join
+        //
+        if (m_joinType != JOIN_TYPE_INNER && !outerMatch && postfilter.isUnderLimit()) {
+            // Still needs to pass the filter
+            if (postfilter.eval(&outer_tuple, &null_inner_tuple)) {
+                join_tuple.setNValues(outer_cols, null_inner_tuple, 0, inner_cols);
+                outputTuple(postfilter, join_tuple, pmp);
+            }
+        }
+
+        // An inner join is done once the inner input is exhausted
+        // and no outer tuple can match the remembered run any more.
+        if (m_joinType == JOIN_TYPE_INNER && ! innerValid && m_innerRun.empty()) {
+            break;
+        }
+    }
+
+    //
+    // FULL Outer Join. Iterate over the unmatched inner tuples
+    //
+    if (m_joinType == JOIN_TYPE_FULL && postfilter.isUnderLimit()) {
+        // Preset outer columns to null
+        const TableTuple& null_outer_tuple = m_null_outer_tuple.tuple();
+        join_tuple.setNValues(0, null_outer_tuple, 0, outer_cols);
+
+        TableTupleFilter_iter<UNMATCHED_TUPLE> endItr = innerTableFilter.end<UNMATCHED_TUPLE>();
+        for (TableTupleFilter_iter<UNMATCHED_TUPLE> itr = innerTableFilter.begin<UNMATCHED_TUPLE>();
+                itr != endItr && postfilter.isUnderLimit(); ++itr) {
+            // Restore the tuple value
+            uint64_t tupleAddr = innerTableFilter.getTupleAddress(*itr);
+            inner_tuple.move((char *)tupleAddr);
+            // Still needs to pass the filter
+            assert(inner_tuple.isActive());
+            if (postfilter.eval(&null_outer_tuple, &inner_tuple)) {
+                join_tuple.setNValues(outer_cols, inner_tuple, 0, inner_cols);
+                outputTuple(postfilter, join_tuple, pmp);
+            }
+        }
+    }
+
+    if (m_aggExec != NULL) {
+        m_aggExec->p_execute_finish();
+    }
+
+    m_innerRun.clear();
+
+    return (true);
+}
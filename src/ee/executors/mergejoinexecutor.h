@@ -0,0 +1,104 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2018 VoltDB Inc.
+ *
+ * This file contains original code and/or modifications of original code.
+ * Any modifications made by VoltDB Inc. are licensed under the following
+ * terms and conditions:
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with VoltDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/* Copyright (C) 2008 by H-Store Project
+ * Brown University
+ * Massachusetts Institute of Technology
+ * Yale University
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT
+ * IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef HSTOREMERGEJOINEXECUTOR_H
+#define HSTOREMERGEJOINEXECUTOR_H
+
+#include "common/common.h"
+#include "common/tabletuple.h"
+#include "common/valuevector.h"
+#include "executors/abstractjoinexecutor.h"
+
+#include <vector>
+
+namespace voltdb {
+
+class AbstractExpression;
+
+/**
+ * The executor for PLAN_NODE_TYPE_MERGEJOIN.
+ *
+ * Both inputs are consumed in a single forward pass.  The inner input is
+ * advanced past keys that sort before the current outer key and the run of
+ * inner tuples with an equal key is remembered, so that consecutive outer
+ * tuples with the same key are joined against that run without rereading
+ * the inner input.  Outer tuples with a NULL key never match.
+ */
+class MergeJoinExecutor : public AbstractJoinExecutor {
+public:
+    MergeJoinExecutor(VoltDBEngine *engine, AbstractPlanNode* abstract_node)
+        : AbstractJoinExecutor(engine, abstract_node)
+        , m_outerKeys(NULL)
+        , m_innerKeys(NULL)
+        , m_descending(false)
+    { }
+
+private:
+    bool p_init(AbstractPlanNode*, const ExecutorVector& executorVector);
+    bool p_execute(const NValueArray &params);
+
+    /**
+     * Evaluate the outer key expressions into m_outerKeyValues.
+     * Return false if any of the key values is NULL.
+     */
+    bool evalOuterKey(const TableTuple& outerTuple);
+
+    /**
+     * Compare the current outer key with the key of the inner tuple
+     * in the order of the inputs: negative if the inner tuple comes first.
+     */
+    int compareInnerToOuterKey(const TableTuple& innerTuple) const;
+
+    const std::vector<AbstractExpression*>* m_outerKeys;
+    const std::vector<AbstractExpression*>* m_innerKeys;
+    bool m_descending;
+    std::vector<NValue> m_outerKeyValues;
+    // Addresses of the run of inner tuples matching the last outer key
+    std::vector<char*> m_innerRun;
+};
+
+}
+
+#endif
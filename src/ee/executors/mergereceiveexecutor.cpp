@@ -79,7 +79,7 @@ typedef std::vector<tuple_range>::iterator range_iterator;
 // Functor to compare two non-empty tuple ranges by comparing their first tuples using provided TupleComparer
 struct TupleRangeComparer : std::binary_function<tuple_range, tuple_range, bool>
 {
-    TupleRangeComparer(AbstractExecutor::TupleComparer comp) :
+    TupleRangeComparer(TupleComparer comp) :
         m_comp(comp)
     {}
 
@@ -90,14 +90,14 @@ struct TupleRangeComparer : std::binary_function<tuple_range, tuple_range, bool>
         assert(tb.first != tb.second);
         return m_comp(*ta.first, *tb.first);
     }
-    AbstractExecutor::TupleComparer m_comp;
+    TupleComparer m_comp;
 };
 
 }
 
 void MergeReceiveExecutor::merge_sort(const std::vector<TableTuple>& tuples,
                                       std::vector<int64_t>& partitionTupleCounts,
-                                      AbstractExecutor::TupleComparer comp,
+                                      TupleComparer comp,
                                       CountingPostfilter& postfilter,
                                       AggregateExecutorBase* agg_exec,
                                       AbstractTempTable* output_table,
@@ -277,7 +277,7 @@ bool MergeReceiveExecutor::p_execute(const NValueArray &params) {
     }
 
     // Merge Sort
-    AbstractExecutor::TupleComparer comp(m_orderby_node->getSortExpressions(), m_orderby_node->getSortDirections());
+    TupleComparer comp(m_orderby_node->getSortExpressions(), m_orderby_node->getSortDirections());
     merge_sort(xs, partitionTupleCounts, comp, postfilter, m_agg_exec, m_tmpOutputTable, &pmp);
 
     VOLT_TRACE("Result of MergeReceive:\n '%s'", m_tmpOutputTable->debug().c_str());
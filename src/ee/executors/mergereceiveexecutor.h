@@ -77,7 +77,7 @@ namespace voltdb {
         // Public for testing purpose only
         static void merge_sort(const std::vector<TableTuple>& tuples,
                                std::vector<int64_t>& partitionTupleCounts,
-                               AbstractExecutor::TupleComparer comp,
+                               TupleComparer comp,
                                CountingPostfilter& postfilter,
                                AggregateExecutorBase* agg_exec,
                                AbstractTempTable* output_table,
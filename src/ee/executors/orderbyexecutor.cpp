@@ -54,6 +54,7 @@
 #include "plannodes/limitnode.h"
 #include "storage/table.h"
 #include "storage/AbstractTempTable.hpp"
+#include "storage/LargeTempTable.h"
 #include "storage/tableiterator.h"
 #include "storage/tablefactory.h"
 
@@ -67,8 +68,6 @@ OrderByExecutor::p_init(AbstractPlanNode* abstract_node,
                         const ExecutorVector& executorVector)
 {
     VOLT_TRACE("init OrderBy Executor");
-    // We cannot yet do any sorting with large queries.
-    assert(! executorVector.isLargeQuery());
 
     OrderByPlanNode* node = dynamic_cast<OrderByPlanNode*>(abstract_node);
     assert(node);
@@ -81,9 +80,12 @@ OrderByExecutor::p_init(AbstractPlanNode* abstract_node,
         //
         // Our output table should look exactly like our input table
         //
-        node->setOutputTable(TableFactory::buildCopiedTempTable(node->getInputTable()->name(),
-                                                                node->getInputTable(),
-                                                                executorVector));
+        // (For large queries this is a large temp table, and registering
+        // it as m_tmpOutputTable lets execute() unpin its last block.)
+        m_tmpOutputTable = TableFactory::buildCopiedTempTable(node->getInputTable()->name(),
+                                                              node->getInputTable(),
+                                                              executorVector);
+        node->setOutputTable(m_tmpOutputTable);
         // pickup an inlined limit, if one exists
         limit_node =
             dynamic_cast<LimitPlanNode*>(node->
@@ -128,6 +130,16 @@ OrderByExecutor::p_execute(const NValueArray &params)
 
     VOLT_TRACE("Running OrderBy '%s'", m_abstractNode->debug().c_str());
     VOLT_TRACE("Input Table:\n '%s'", input_table->debug().c_str());
+
+    LargeTempTable* large_input_table = dynamic_cast<LargeTempTable*>(input_table);
+    if (large_input_table != NULL) {
+        if (limit != 0) {
+            executeLargeSort(large_input_table, output_table, limit, offset);
+        }
+        VOLT_TRACE("Result of OrderBy:\n '%s'", output_table->debug().c_str());
+        return true;
+    }
+
     TableIterator iterator = input_table->iterator();
     TableTuple tuple(input_table->schema());
 
@@ -151,11 +163,11 @@ OrderByExecutor::p_execute(const NValueArray &params)
         if (limit >= 0 && xs.begin() + limit + offset < xs.end()) {
             // partial sort
             partial_sort(xs.begin(), xs.begin() + limit + offset, xs.end(),
-                    AbstractExecutor::TupleComparer(node->getSortExpressions(), node->getSortDirections()));
+                    TupleComparer(node->getSortExpressions(), node->getSortDirections()));
         } else {
             // full sort
             sort(xs.begin(), xs.end(),
-                    AbstractExecutor::TupleComparer(node->getSortExpressions(), node->getSortDirections()));
+                    TupleComparer(node->getSortExpressions(), node->getSortDirections()));
         }
 
         int tuple_ctr = 0;
@@ -187,6 +199,44 @@ OrderByExecutor::p_execute(const NValueArray &params)
     return true;
 }
 
+/*
+ * For large queries the input may not fit in memory, so instead of
+ * collecting the tuples into a vector the input table is sorted with
+ * an external merge sort over its blocks, which the block cache may
+ * store to disk and reload as needed.  The sorted input is then
+ * scanned, releasing blocks as it goes, to apply the offset and limit.
+ */
+void
+OrderByExecutor::executeLargeSort(LargeTempTable* input_table,
+                                  AbstractTempTable* output_table,
+                                  int limit,
+                                  int offset)
+{
+    OrderByPlanNode* node = static_cast<OrderByPlanNode*>(m_abstractNode);
+    ProgressMonitorProxy pmp(m_engine->getExecutorContext(), this);
+
+    // With a limit, only the first limit + offset tuples are needed.
+    int sort_limit = limit >= 0 ? limit + offset : -1;
+    input_table->sort(TupleComparer(node->getSortExpressions(),
+                                                      node->getSortDirections()),
+                      sort_limit);
+
+    TableIterator iterator = input_table->iteratorDeletingAsWeGo();
+    TableTuple tuple(input_table->schema());
+    int tuple_ctr = 0;
+    int tuple_skipped = 0;
+    while (((limit < 0) || (tuple_ctr < limit)) && iterator.next(tuple)) {
+        pmp.countdownProgress();
+        if (tuple_skipped < offset) {
+            tuple_skipped++;
+            continue;
+        }
+
+        output_table->insertTempTuple(tuple);
+        tuple_ctr += 1;
+    }
+}
+
 OrderByExecutor::~OrderByExecutor() {
 }
 
@@ -55,6 +55,8 @@ namespace voltdb {
     class UndoLog;
     class ReadWriteSet;
     class LimitPlanNode;
+    class AbstractTempTable;
+    class LargeTempTable;
 
     /**
      *
@@ -72,6 +74,11 @@ namespace voltdb {
         bool p_execute(const NValueArray &params);
 
     private:
+        void executeLargeSort(LargeTempTable* input_table,
+                              AbstractTempTable* output_table,
+                              int limit,
+                              int offset);
+
         LimitPlanNode *limit_node;
     };
 
@@ -54,11 +54,13 @@
 #include "execution/ExecutorVector.h"
 #include "execution/ProgressMonitorProxy.h"
 #include "expressions/abstractexpression.h"
+#include "expressions/tuplevalueexpression.h"
 #include "plannodes/aggregatenode.h"
 #include "plannodes/insertnode.h"
 #include "plannodes/seqscannode.h"
 #include "plannodes/projectionnode.h"
 #include "plannodes/limitnode.h"
+#include "storage/persistenttable.h"
 #include "storage/table.h"
 #include "storage/temptable.h"
 #include "storage/tablefactory.h"
@@ -66,6 +68,76 @@
 
 using namespace voltdb;
 
+/**
+ * Narrow the filter to the ranges that the predicate's comparisons of
+ * an integer column with an integer constant or parameter require.
+ * Only comparisons that are ANDed together at the top of the predicate
+ * are used, since each of them must hold for a tuple to qualify.
+ */
+static void addZoneMapRanges(const AbstractExpression* predicate, ZoneMapFilter& filter) {
+    ExpressionType type = predicate->getExpressionType();
+    if (type == EXPRESSION_TYPE_CONJUNCTION_AND) {
+        addZoneMapRanges(predicate->getLeft(), filter);
+        addZoneMapRanges(predicate->getRight(), filter);
+        return;
+    }
+
+    const AbstractExpression* left = predicate->getLeft();
+    const AbstractExpression* right = predicate->getRight();
+    if (left == NULL || right == NULL ||
+            left->getExpressionType() != EXPRESSION_TYPE_VALUE_TUPLE ||
+            (right->getExpressionType() != EXPRESSION_TYPE_VALUE_CONSTANT &&
+             right->getExpressionType() != EXPRESSION_TYPE_VALUE_PARAMETER)) {
+        return;
+    }
+    const TupleValueExpression* column = static_cast<const TupleValueExpression*>(left);
+    if (column->getTupleId() != 0) {
+        return;
+    }
+
+    NValue value = right->eval(NULL, NULL);
+    if (value.isNull()) {
+        return;
+    }
+    switch (ValuePeeker::peekValueType(value)) {
+    case VALUE_TYPE_TINYINT:
+    case VALUE_TYPE_SMALLINT:
+    case VALUE_TYPE_INTEGER:
+    case VALUE_TYPE_BIGINT:
+    case VALUE_TYPE_TIMESTAMP:
+        break;
+    default:
+        return;
+    }
+
+    int64_t bound = ValuePeeker::peekAsRawInt64(value);
+    switch (type) {
+    case EXPRESSION_TYPE_COMPARE_EQUAL:
+        filter.addRange(column->getColumnId(), bound, bound);
+        break;
+    case EXPRESSION_TYPE_COMPARE_LESSTHAN:
+        if (bound == INT64_MIN) {
+            return;
+        }
+        filter.addRange(column->getColumnId(), INT64_MIN, bound - 1);
+        break;
+    case EXPRESSION_TYPE_COMPARE_LESSTHANOREQUALTO:
+        filter.addRange(column->getColumnId(), INT64_MIN, bound);
+        break;
+    case EXPRESSION_TYPE_COMPARE_GREATERTHAN:
+        if (bound == INT64_MAX) {
+            return;
+        }
+        filter.addRange(column->getColumnId(), bound + 1, INT64_MAX);
+        break;
+    case EXPRESSION_TYPE_COMPARE_GREATERTHANOREQUALTO:
+        filter.addRange(column->getColumnId(), bound, INT64_MAX);
+        break;
+    default:
+        break;
+    }
+}
+
 bool SeqScanExecutor::p_init(AbstractPlanNode* abstract_node,
                              const ExecutorVector& executorVector)
 {
@@ -169,11 +241,7 @@ bool SeqScanExecutor::p_execute(const NValueArray &params) {
     // change any nodes in our expression tree to be ready for the
     // projection operations in execute
     //
-    int num_of_columns = -1;
     ProjectionPlanNode* projectionNode = dynamic_cast<ProjectionPlanNode*>(node->getInlinePlanNode(PLAN_NODE_TYPE_PROJECTION));
-    if (projectionNode != NULL) {
-        num_of_columns = static_cast<int> (projectionNode->getOutputColumnExpressions().size());
-    }
     //
     // OPTIMIZATION: NESTED LIMIT
     // How nice! We can also cut off our scanning with a nested limit!
@@ -206,13 +274,46 @@ bool SeqScanExecutor::p_execute(const NValueArray &params) {
             VOLT_TRACE("SCAN PREDICATE :\n%s\n", predicate->debug(true).c_str());
         }
 
+        //
+        // OPTIMIZATION: ZONE MAPS
+        //
+        // Skip the blocks of a persistent table whose per-block ranges
+        // of some integer column cannot satisfy the predicate.  Inline
+        // inserts may write to the table being scanned, so they visit
+        // every block.
+        //
+        boost::scoped_ptr<ZoneMapFilter> zoneMapFilter;
+        PersistentTable* persistentTable = dynamic_cast<PersistentTable*>(input_table);
+        if (predicate != NULL && persistentTable != NULL && m_insertExec == NULL &&
+                !persistentTable->zoneMapColumns().empty()) {
+            zoneMapFilter.reset(new ZoneMapFilter(persistentTable->schema(),
+                                                  persistentTable->zoneMapColumns()));
+            addZoneMapRanges(predicate, *zoneMapFilter);
+            if (!zoneMapFilter->isEmpty()) {
+                iterator.setZoneMapFilter(zoneMapFilter.get());
+            }
+        }
+
         int limit = CountingPostfilter::NO_LIMIT;
         int offset = CountingPostfilter::NO_OFFSET;
         if (limit_node) {
             limit_node->getLimitAndOffsetByReference(params, limit, offset);
         }
+        //
+        // OPTIMIZATION: BATCH PREDICATE EVALUATION
+        //
+        // Without a limit to cut the scan short, the predicate is
+        // evaluated over batches of tuples from the same block at a
+        // time, so fixed-width comparisons can be done on raw column
+        // values.  Predicates that cannot do that fall back to
+        // evaluating each tuple of the batch on its own.  Inline
+        // inserts keep scanning a tuple at a time, in case they write
+        // to the table being scanned.
+        //
+        const bool batchPredicate = (predicate != NULL && limit_node == NULL && m_insertExec == NULL);
+
         // Initialize the postfilter
-        CountingPostfilter postfilter(m_tmpOutputTable, predicate, limit, offset);
+        CountingPostfilter postfilter(m_tmpOutputTable, batchPredicate ? NULL : predicate, limit, offset);
 
         ProgressMonitorProxy pmp(m_engine->getExecutorContext(), this);
         TableTuple temp_tuple;
@@ -260,45 +361,64 @@ bool SeqScanExecutor::p_execute(const NValueArray &params) {
             temp_tuple = m_tmpOutputTable->tempTuple();
         }
 
-        while (postfilter.isUnderLimit() && iterator.next(tuple))
-        {
+        if (batchPredicate) {
+            std::vector<TableTuple> batch;
+            batch.reserve(MAX_BATCH_SIZE);
+            SelectionVector selection;
+            selection.reserve(MAX_BATCH_SIZE);
+
+            while (postfilter.isUnderLimit()) {
+                // Collect a batch, stopping at the end of the block
+                // since moving on may free the block of a temp table.
+                batch.clear();
+                while (batch.size() < MAX_BATCH_SIZE && iterator.next(tuple)) {
+                    pmp.countdownProgress();
+                    batch.push_back(tuple);
+                    if (iterator.atBlockBoundary()) {
+                        break;
+                    }
+                }
+                if (batch.empty()) {
+                    break;
+                }
+
+                selection.resize(batch.size());
+                for (uint32_t ii = 0; ii < batch.size(); ++ii) {
+                    selection[ii] = ii;
+                }
+                predicate->evalPredicateBatch(&batch[0], selection);
+
+                for (size_t ii = 0; ii < selection.size() && postfilter.isUnderLimit(); ++ii) {
+                    TableTuple& selected = batch[selection[ii]];
+                    if (postfilter.eval(&selected, NULL)) {
+                        projectAndOutputTuple(selected, temp_tuple, projectionNode);
+                        pmp.countdownProgress();
+                    }
+                }
+            }
+        }
+        else {
+            while (postfilter.isUnderLimit() && iterator.next(tuple))
+            {
 #if   defined(VOLT_TRACE_ENABLED)
-            int tuple_ctr = 0;
+                int tuple_ctr = 0;
 #endif
-            VOLT_TRACE("INPUT TUPLE: %s, %d/%d\n",
-                       tuple.debug(input_table->name()).c_str(),
-                       ++tuple_ctr,
-                       (int)input_table->activeTupleCount());
-            pmp.countdownProgress();
-
-            //
-            // For each tuple we need to evaluate it against our predicate and limit/offset
-            //
-            if (postfilter.eval(&tuple, NULL))
-            {
+                VOLT_TRACE("INPUT TUPLE: %s, %d/%d\n",
+                           tuple.debug(input_table->name()).c_str(),
+                           ++tuple_ctr,
+                           (int)input_table->activeTupleCount());
+                pmp.countdownProgress();
+
                 //
-                // Nested Projection
-                // Project (or replace) values from input tuple
+                // For each tuple we need to evaluate it against our predicate and limit/offset
                 //
-                if (projectionNode != NULL)
+                if (postfilter.eval(&tuple, NULL))
                 {
-                    VOLT_TRACE("inline projection...");
-                    // Project the scanned table row onto
-                    // the columns of the select list in the
-                    // select statement.
-                    for (int ctr = 0; ctr < num_of_columns; ctr++) {
-                        NValue value = projectionNode->getOutputColumnExpressions()[ctr]->eval(&tuple, NULL);
-                        temp_tuple.setNValue(ctr, value);
-                    }
-                    outputTuple(temp_tuple);
-                }
-                else
-                {
-                    outputTuple(tuple);
+                    projectAndOutputTuple(tuple, temp_tuple, projectionNode);
+                    pmp.countdownProgress();
                 }
-                pmp.countdownProgress();
-            }
-        } // end while we have more tuples to scan
+            } // end while we have more tuples to scan
+        }
 
         if (m_aggExec != NULL) {
             m_aggExec->p_execute_finish();
@@ -316,6 +436,32 @@ bool SeqScanExecutor::p_execute(const NValueArray &params) {
     return true;
 }
 
+void SeqScanExecutor::projectAndOutputTuple(TableTuple& tuple,
+                                            TableTuple& temp_tuple,
+                                            ProjectionPlanNode* projectionNode) {
+    //
+    // Nested Projection
+    // Project (or replace) values from input tuple
+    //
+    if (projectionNode != NULL)
+    {
+        VOLT_TRACE("inline projection...");
+        // Project the scanned table row onto
+        // the columns of the select list in the
+        // select statement.
+        const std::vector<AbstractExpression*>& columnExpressions = projectionNode->getOutputColumnExpressions();
+        for (int ctr = 0; ctr < columnExpressions.size(); ctr++) {
+            NValue value = columnExpressions[ctr]->eval(&tuple, NULL);
+            temp_tuple.setNValue(ctr, value);
+        }
+        outputTuple(temp_tuple);
+    }
+    else
+    {
+        outputTuple(tuple);
+    }
+}
+
 /*
  * We may output a tuple to an inline aggregate or
  * inline insert node.  If there is a limit or projection, this will have
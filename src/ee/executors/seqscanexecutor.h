@@ -56,6 +56,7 @@ namespace voltdb
     class AggregateExecutorBase;
     struct CountingPostfilter;
     class InsertExecutor;
+    class ProjectionPlanNode;
 
     class SeqScanExecutor : public AbstractExecutor {
     public:
@@ -70,6 +71,14 @@ namespace voltdb
         bool p_execute(const NValueArray& params);
 
     private:
+        /**
+         * Apply the inline projection, if any, to a tuple that
+         * passed the predicate and output the result.
+         */
+        void projectAndOutputTuple(TableTuple& tuple,
+                                   TableTuple& temp_tuple,
+                                   ProjectionPlanNode* projectionNode);
+
         /**
          * Output a tuple.  This may send the tuple to an
          * inline insert or aggregate node, or it may send the
@@ -85,6 +94,10 @@ namespace voltdb
         // freeing them.
         AggregateExecutorBase* m_aggExec;
         InsertExecutor* m_insertExec;
+
+        // The most tuples whose predicate is evaluated together
+        // when scanning a block at a time.
+        static const size_t MAX_BATCH_SIZE = 1024;
     };
 }
 
@@ -46,7 +46,10 @@
 #include "abstractexpression.h"
 
 #include "common/debuglog.h"
+#include "common/NValue.hpp"
+#include "common/ValuePeeker.hpp"
 #include "common/serializeio.h"
+#include "common/tabletuple.h"
 #include "common/types.h"
 #include "expressions/expressionutil.h"
 
@@ -88,6 +91,36 @@ AbstractExpression::~AbstractExpression()
     delete m_right;
 }
 
+void AbstractExpression::evalPredicateBatch(const TableTuple* tuples, SelectionVector& selection) const
+{
+    size_t kept = 0;
+    for (size_t ii = 0; ii < selection.size(); ++ii) {
+        if (eval(&tuples[selection[ii]], NULL).isTrue()) {
+            selection[kept++] = selection[ii];
+        }
+    }
+    selection.resize(kept);
+}
+
+bool AbstractExpression::fillScalarBatch(const NValue& value, FixedWidthBatch& out)
+{
+    ValueType type = ValuePeeker::peekValueType(value);
+    if (! isFixedWidthBatchType(type)) {
+        return false;
+    }
+
+    bool isDouble = (type == VALUE_TYPE_DOUBLE);
+    out.reset(isDouble, true);
+    out.nulls.push_back(value.isNull());
+    if (isDouble) {
+        out.doubles.push_back(value.isNull() ? 0.0 : ValuePeeker::peekDouble(value));
+    }
+    else {
+        out.ints.push_back(value.isNull() ? 0 : ValuePeeker::peekAsBigInt(value));
+    }
+    return true;
+}
+
 bool
 AbstractExpression::hasParameter() const
 {
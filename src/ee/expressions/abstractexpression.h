@@ -50,6 +50,7 @@
 #include "common/types.h"
 #include "common/PlannerDomValue.h"
 
+#include <stdint.h>
 #include <string>
 #include <vector>
 
@@ -58,6 +59,35 @@ namespace voltdb {
 class NValue;
 class TableTuple;
 
+/**
+ * Positions, in ascending order, of the tuples in a batch that are
+ * still candidates during batch predicate evaluation.
+ */
+typedef std::vector<uint32_t> SelectionVector;
+
+/**
+ * Fixed-width values produced by AbstractExpression::evalFixedWidthBatch,
+ * either one value per selected tuple or, when isScalar is set, a
+ * single value that applies to every tuple.  TINYINT through BIGINT
+ * and TIMESTAMP values are widened into ints; DOUBLE values are kept
+ * in doubles.
+ */
+struct FixedWidthBatch {
+    bool isDouble;
+    bool isScalar;
+    std::vector<int64_t> ints;
+    std::vector<double> doubles;
+    std::vector<char> nulls;
+
+    void reset(bool asDouble, bool scalar) {
+        isDouble = asDouble;
+        isScalar = scalar;
+        ints.clear();
+        doubles.clear();
+        nulls.clear();
+    }
+};
+
 /**
  * Predicate objects for filtering tuples during query execution.
  */
@@ -73,6 +103,43 @@ class AbstractExpression {
 
     virtual NValue eval(const TableTuple *tuple1 = NULL, const TableTuple *tuple2 = NULL) const = 0;
 
+    /**
+     * Evaluate this expression as a predicate over a batch of tuples
+     * (each as tuple1, with no tuple2).  On entry selection holds the
+     * positions in tuples to consider; on return it holds only those
+     * for which the expression is true, in the same order.  This
+     * default calls eval() for each tuple; comparisons and
+     * conjunctions override it to work a batch at a time.
+     */
+    virtual void evalPredicateBatch(const TableTuple* tuples, SelectionVector& selection) const;
+
+    /**
+     * Fill out with this expression's value for each selected tuple,
+     * if the expression yields a fixed-width numeric value that can be
+     * computed without constructing NValues.  Returns false, leaving
+     * out unspecified, if it cannot.
+     */
+    virtual bool evalFixedWidthBatch(const TableTuple* tuples,
+                                     const SelectionVector& selection,
+                                     FixedWidthBatch& out) const {
+        return false;
+    }
+
+    /** Returns true if values of the type fit in a FixedWidthBatch */
+    static bool isFixedWidthBatchType(ValueType type) {
+        switch (type) {
+        case VALUE_TYPE_TINYINT:
+        case VALUE_TYPE_SMALLINT:
+        case VALUE_TYPE_INTEGER:
+        case VALUE_TYPE_BIGINT:
+        case VALUE_TYPE_TIMESTAMP:
+        case VALUE_TYPE_DOUBLE:
+            return true;
+        default:
+            return false;
+        }
+    }
+
     /** return true if self or descendent should be substitute()'d */
     virtual bool hasParameter() const;
 
@@ -143,6 +210,9 @@ class AbstractExpression {
                        AbstractExpression *left,
                        AbstractExpression *right);
 
+    /** Fill out with a scalar batch holding value, if it has a fixed-width type */
+    static bool fillScalarBatch(const NValue& value, FixedWidthBatch& out);
+
   private:
     static AbstractExpression* buildExpressionTree_recurse(PlannerDomValue obj);
     bool initParamShortCircuits();
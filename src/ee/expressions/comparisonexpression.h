@@ -48,6 +48,7 @@
 
 #include "common/common.h"
 #include "common/serializeio.h"
+#include "common/ValuePeeker.hpp"
 #include "common/valuevector.h"
 
 #include "expressions/abstractexpression.h"
@@ -56,7 +57,10 @@
 #include "expressions/tuplevalueexpression.h"
 
 #include <string>
+#include <vector>
 #include <cassert>
+#include <cmath>
+#include <cstring>
 
 namespace voltdb {
 
@@ -211,6 +215,93 @@ public:
     inline static bool isNullRejecting() { return true; }
 };
 
+// RawCompareResult maps the three-way comparison of two non-null
+// fixed-width values to the outcome of OP, for the operators that
+// ComparisonExpression::evalPredicateBatch can evaluate without NValues.
+template <typename OP>
+struct RawCompareResult {
+    inline static bool supported() { return false; }
+    inline static bool test(int cmp) { return false; }
+    inline static bool compare(int64_t l, int64_t r) { return false; }
+};
+
+template <> struct RawCompareResult<CmpEq> {
+    inline static bool supported() { return true; }
+    inline static bool test(int cmp) { return cmp == VALUE_COMPARE_EQUAL; }
+    inline static bool compare(int64_t l, int64_t r) { return l == r; }
+};
+
+template <> struct RawCompareResult<CmpNe> {
+    inline static bool supported() { return true; }
+    inline static bool test(int cmp) { return cmp != VALUE_COMPARE_EQUAL; }
+    inline static bool compare(int64_t l, int64_t r) { return l != r; }
+};
+
+template <> struct RawCompareResult<CmpLt> {
+    inline static bool supported() { return true; }
+    inline static bool test(int cmp) { return cmp == VALUE_COMPARE_LESSTHAN; }
+    inline static bool compare(int64_t l, int64_t r) { return l < r; }
+};
+
+template <> struct RawCompareResult<CmpGt> {
+    inline static bool supported() { return true; }
+    inline static bool test(int cmp) { return cmp == VALUE_COMPARE_GREATERTHAN; }
+    inline static bool compare(int64_t l, int64_t r) { return l > r; }
+};
+
+template <> struct RawCompareResult<CmpLte> {
+    inline static bool supported() { return true; }
+    inline static bool test(int cmp) { return cmp != VALUE_COMPARE_GREATERTHAN; }
+    inline static bool compare(int64_t l, int64_t r) { return l <= r; }
+};
+
+template <> struct RawCompareResult<CmpGte> {
+    inline static bool supported() { return true; }
+    inline static bool test(int cmp) { return cmp != VALUE_COMPARE_LESSTHAN; }
+    inline static bool compare(int64_t l, int64_t r) { return l >= r; }
+};
+
+// Three-way comparisons of raw values, matching NValue::compare.
+inline int rawCompare(int64_t l, int64_t r)
+{
+    return l < r ? VALUE_COMPARE_LESSTHAN : (l > r ? VALUE_COMPARE_GREATERTHAN : VALUE_COMPARE_EQUAL);
+}
+
+inline int rawCompare(double l, double r)
+{
+    // As in NValue, NaNs are equal to each other and less than
+    // anything else.
+    if (std::isnan(l)) {
+        return std::isnan(r) ? VALUE_COMPARE_EQUAL : VALUE_COMPARE_LESSTHAN;
+    }
+    if (std::isnan(r)) {
+        return VALUE_COMPARE_GREATERTHAN;
+    }
+    return l < r ? VALUE_COMPARE_LESSTHAN : (l > r ? VALUE_COMPARE_GREATERTHAN : VALUE_COMPARE_EQUAL);
+}
+
+// The values of a batch as an array of T, widening integers to
+// doubles when a comparison mixes the two.
+template <typename T>
+inline const T* batchValues(FixedWidthBatch& batch);
+
+template <>
+inline const int64_t* batchValues<int64_t>(FixedWidthBatch& batch)
+{
+    assert( ! batch.isDouble);
+    return &batch.ints[0];
+}
+
+template <>
+inline const double* batchValues<double>(FixedWidthBatch& batch)
+{
+    if ( ! batch.isDouble) {
+        batch.doubles.assign(batch.ints.begin(), batch.ints.end());
+        batch.isDouble = true;
+    }
+    return &batch.doubles[0];
+}
+
 template <typename OP>
 class ComparisonExpression : public AbstractExpression {
 public:
@@ -255,6 +346,23 @@ public:
         return OP::compare(lnv, rnv);
     }
 
+    void evalPredicateBatch(const TableTuple* tuples, SelectionVector& selection) const
+    {
+        if (RawCompareResult<OP>::supported() && ! selection.empty() &&
+            m_left->evalFixedWidthBatch(tuples, selection, m_leftBatch) &&
+            m_right->evalFixedWidthBatch(tuples, selection, m_rightBatch)) {
+            if (m_leftBatch.isDouble || m_rightBatch.isDouble) {
+                filterBatch<double>(selection);
+            }
+            else {
+                filterBatch<int64_t>(selection);
+            }
+            return;
+        }
+
+        AbstractExpression::evalPredicateBatch(tuples, selection);
+    }
+
     inline const char* traceEval(const TableTuple *tuple1, const TableTuple *tuple2) const
     {
         NValue lnv;
@@ -271,9 +379,76 @@ public:
         return (spacer + "ComparisonExpression\n");
     }
 
+protected:
+    // Comparisons of doubles go through rawCompare to get NValue's
+    // NaN semantics.
+    inline static bool compareRaw(int64_t l, int64_t r)
+    {
+        return RawCompareResult<OP>::compare(l, r);
+    }
+
+    inline static bool compareRaw(double l, double r)
+    {
+        return RawCompareResult<OP>::test(rawCompare(l, r));
+    }
+
 private:
+
+    // Keep the selected positions whose operand values compare true;
+    // null operands, as in eval(), never do.  The matches are first
+    // computed into a byte mask by loops without branches, which the
+    // compiler can vectorize, and then used to compact the selection.
+    template <typename T>
+    void filterBatch(SelectionVector& selection) const
+    {
+        const size_t count = selection.size();
+        const T* left = batchValues<T>(m_leftBatch);
+        const T* right = batchValues<T>(m_rightBatch);
+        const char* leftNulls = &m_leftBatch.nulls[0];
+        const char* rightNulls = &m_rightBatch.nulls[0];
+        m_matches.resize(count);
+        char* matches = &m_matches[0];
+
+        if ( ! m_leftBatch.isScalar && m_rightBatch.isScalar) {
+            // The common <column> <op> <constant> case.
+            if (rightNulls[0]) {
+                selection.clear();
+                return;
+            }
+            const T constant = right[0];
+            for (size_t ii = 0; ii < count; ++ii) {
+                matches[ii] = (leftNulls[ii] == 0) & compareRaw(left[ii], constant);
+            }
+        }
+        else if ( ! m_leftBatch.isScalar && ! m_rightBatch.isScalar) {
+            for (size_t ii = 0; ii < count; ++ii) {
+                matches[ii] = ((leftNulls[ii] | rightNulls[ii]) == 0) & compareRaw(left[ii], right[ii]);
+            }
+        }
+        else {
+            for (size_t ii = 0; ii < count; ++ii) {
+                const size_t ll = m_leftBatch.isScalar ? 0 : ii;
+                const size_t rr = m_rightBatch.isScalar ? 0 : ii;
+                matches[ii] = ((leftNulls[ll] | rightNulls[rr]) == 0) & compareRaw(left[ll], right[rr]);
+            }
+        }
+
+        size_t kept = 0;
+        for (size_t ii = 0; ii < count; ++ii) {
+            selection[kept] = selection[ii];
+            kept += matches[ii];
+        }
+        selection.resize(kept);
+    }
+
     AbstractExpression *m_left;
     AbstractExpression *m_right;
+
+    // Scratch space for batch evaluation, kept to avoid reallocating
+    // it for every batch.
+    mutable FixedWidthBatch m_leftBatch;
+    mutable FixedWidthBatch m_rightBatch;
+    mutable std::vector<char> m_matches;
 };
 
 template <typename C, typename L, typename R>
@@ -286,5 +461,103 @@ public:
     {}
 };
 
+// How a raw column value of type T is compared: integers (and
+// TIMESTAMPs) as int64_t, as in NValue, and DOUBLEs as double.
+template <typename T>
+struct RawColumnTraits {
+    typedef int64_t CompareType;
+};
+
+template <>
+struct RawColumnTraits<double> {
+    typedef double CompareType;
+};
+
+inline bool isNullRaw(int8_t value) { return value == INT8_NULL; }
+inline bool isNullRaw(int16_t value) { return value == INT16_NULL; }
+inline bool isNullRaw(int32_t value) { return value == INT32_NULL; }
+inline bool isNullRaw(int64_t value) { return value == INT64_NULL; }
+inline bool isNullRaw(double value) { return value <= DOUBLE_NULL; }
+
+/**
+ * A comparison of a fixed-width column with a constant or parameter
+ * (R) that reads the column's value as a COLUMN_T straight from the
+ * tuple's storage and compares it natively, rather than building and
+ * dispatching on an NValue for it.  If the tuple's column turns out not
+ * to have the type the plan promised, or the other operand is not a
+ * fixed-width value, it falls back to the general comparison.
+ *
+ * Only the operators with a RawCompareResult are specialized this way.
+ */
+template <typename OP, typename COLUMN_T, typename R>
+class FixedWidthComparisonExpression : public ComparisonExpression<OP> {
+public:
+    FixedWidthComparisonExpression(ExpressionType type,
+                                   TupleValueExpression *left,
+                                   R *right)
+        : ComparisonExpression<OP>(type, left, right)
+        , m_tupleIdx(left->getTupleId())
+        , m_columnIdx(left->getColumnId())
+        , m_columnType(left->getValueType())
+        , m_right(right)
+    {}
+
+    inline NValue eval(const TableTuple *tuple1, const TableTuple *tuple2) const
+    {
+        typedef typename RawColumnTraits<COLUMN_T>::CompareType CompareType;
+
+        const TableTuple *tuple = (m_tupleIdx == 0) ? tuple1 : tuple2;
+        if (tuple == NULL) {
+            // Let the general path raise the usual error.
+            return ComparisonExpression<OP>::eval(tuple1, tuple2);
+        }
+
+        const TupleSchema::ColumnInfo *columnInfo = tuple->getSchema()->getColumnInfo(m_columnIdx);
+        if (columnInfo->getVoltType() != m_columnType) {
+            return ComparisonExpression<OP>::eval(tuple1, tuple2);
+        }
+
+        COLUMN_T raw;
+        ::memcpy(&raw, tuple->address() + TUPLE_HEADER_SIZE + columnInfo->offset, sizeof(COLUMN_T));
+        if (isNullRaw(raw)) {
+            return NValue::getNullValue(VALUE_TYPE_BOOLEAN);
+        }
+
+        NValue rnv = m_right->eval(tuple1, tuple2);
+        if (rnv.isNull()) {
+            return NValue::getNullValue(VALUE_TYPE_BOOLEAN);
+        }
+
+        bool result;
+        switch (ValuePeeker::peekValueType(rnv)) {
+        case VALUE_TYPE_TINYINT:
+        case VALUE_TYPE_SMALLINT:
+        case VALUE_TYPE_INTEGER:
+        case VALUE_TYPE_BIGINT:
+        case VALUE_TYPE_TIMESTAMP:
+            result = ComparisonExpression<OP>::compareRaw(static_cast<CompareType>(raw),
+                    static_cast<CompareType>(ValuePeeker::peekAsRawInt64(rnv)));
+            break;
+        case VALUE_TYPE_DOUBLE:
+            result = ComparisonExpression<OP>::compareRaw(static_cast<double>(raw),
+                    ValuePeeker::peekDouble(rnv));
+            break;
+        default:
+            return OP::compare(tuple->getNValue(m_columnIdx), rnv);
+        }
+        return result ? NValue::getTrue() : NValue::getFalse();
+    }
+
+    std::string debugInfo(const std::string &spacer) const {
+        return (spacer + "FixedWidthComparisonExpression\n");
+    }
+
+private:
+    const int m_tupleIdx;
+    const int m_columnIdx;
+    const ValueType m_columnType;
+    const R *m_right;
+};
+
 }
 #endif
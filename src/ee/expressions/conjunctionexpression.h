@@ -52,6 +52,8 @@
 
 #include "expressions/abstractexpression.h"
 
+#include <algorithm>
+#include <iterator>
 #include <string>
 
 namespace voltdb {
@@ -74,6 +76,8 @@ class ConjunctionExpression : public AbstractExpression
 
     NValue eval(const TableTuple *tuple1, const TableTuple *tuple2) const;
 
+    void evalPredicateBatch(const TableTuple* tuples, SelectionVector& selection) const;
+
     std::string debugInfo(const std::string &spacer) const {
         return (spacer + "ConjunctionExpression\n");
     }
@@ -130,5 +134,42 @@ ConjunctionExpression<ConjunctionOr>::eval(const TableTuple *tuple1,
     return NValue::getNullValue(VALUE_TYPE_BOOLEAN);
 }
 
+// A row passes AND exactly when it passes both sides, so the right
+// side only needs to look at what the left side selected.
+template<> inline void
+ConjunctionExpression<ConjunctionAnd>::evalPredicateBatch(const TableTuple* tuples,
+                                                          SelectionVector& selection) const
+{
+    m_left->evalPredicateBatch(tuples, selection);
+    if (! selection.empty()) {
+        m_right->evalPredicateBatch(tuples, selection);
+    }
+}
+
+// A row passes OR when it passes either side; the right side only needs
+// to look at what the left side rejected.
+template<> inline void
+ConjunctionExpression<ConjunctionOr>::evalPredicateBatch(const TableTuple* tuples,
+                                                         SelectionVector& selection) const
+{
+    SelectionVector leftSelection(selection);
+    m_left->evalPredicateBatch(tuples, leftSelection);
+    if (leftSelection.size() == selection.size()) {
+        return;
+    }
+
+    SelectionVector rightSelection;
+    rightSelection.reserve(selection.size() - leftSelection.size());
+    std::set_difference(selection.begin(), selection.end(),
+                        leftSelection.begin(), leftSelection.end(),
+                        std::back_inserter(rightSelection));
+    m_right->evalPredicateBatch(tuples, rightSelection);
+
+    selection.clear();
+    std::merge(leftSelection.begin(), leftSelection.end(),
+               rightSelection.begin(), rightSelection.end(),
+               std::back_inserter(selection));
+}
+
 }
 #endif
@@ -73,6 +73,12 @@ class ConstantValueExpression : public AbstractExpression {
         return this->value;
     }
 
+    virtual bool evalFixedWidthBatch(const TableTuple* tuples,
+                                     const SelectionVector& selection,
+                                     FixedWidthBatch& out) const {
+        return fillScalarBatch(value, out);
+    }
+
     std::string debugInfo(const std::string &spacer) const {
         return spacer + "OptimizedConstantValueExpression:" +
           value.debug() + "\n";
@@ -270,6 +270,54 @@ getMoreSpecialized(ExpressionType c, L* l, R* r)
     }
 }
 
+template <typename COLUMN_T, typename R>
+static AbstractExpression*
+getFixedWidthSpecializedForColumn(ExpressionType c, TupleValueExpression* l, R* r)
+{
+    switch (c) {
+    case (EXPRESSION_TYPE_COMPARE_EQUAL):
+        return new FixedWidthComparisonExpression<CmpEq, COLUMN_T, R>(c, l, r);
+    case (EXPRESSION_TYPE_COMPARE_NOTEQUAL):
+        return new FixedWidthComparisonExpression<CmpNe, COLUMN_T, R>(c, l, r);
+    case (EXPRESSION_TYPE_COMPARE_LESSTHAN):
+        return new FixedWidthComparisonExpression<CmpLt, COLUMN_T, R>(c, l, r);
+    case (EXPRESSION_TYPE_COMPARE_GREATERTHAN):
+        return new FixedWidthComparisonExpression<CmpGt, COLUMN_T, R>(c, l, r);
+    case (EXPRESSION_TYPE_COMPARE_LESSTHANOREQUALTO):
+        return new FixedWidthComparisonExpression<CmpLte, COLUMN_T, R>(c, l, r);
+    case (EXPRESSION_TYPE_COMPARE_GREATERTHANOREQUALTO):
+        return new FixedWidthComparisonExpression<CmpGte, COLUMN_T, R>(c, l, r);
+    default:
+        return NULL;
+    }
+}
+
+/** For a comparison of a column of a fixed-width type with a constant or
+ *  parameter, instantiate an expression specialized on the column's c type
+ *  that compares its raw value.  Returns NULL if there is none. */
+template <typename R>
+static AbstractExpression*
+getFixedWidthSpecialized(ExpressionType c, TupleValueExpression* l, R* r)
+{
+    assert (l);
+    assert (r);
+    switch (l->getValueType()) {
+    case (VALUE_TYPE_TINYINT):
+        return getFixedWidthSpecializedForColumn<int8_t, R>(c, l, r);
+    case (VALUE_TYPE_SMALLINT):
+        return getFixedWidthSpecializedForColumn<int16_t, R>(c, l, r);
+    case (VALUE_TYPE_INTEGER):
+        return getFixedWidthSpecializedForColumn<int32_t, R>(c, l, r);
+    case (VALUE_TYPE_BIGINT):
+    case (VALUE_TYPE_TIMESTAMP):
+        return getFixedWidthSpecializedForColumn<int64_t, R>(c, l, r);
+    case (VALUE_TYPE_DOUBLE):
+        return getFixedWidthSpecializedForColumn<double, R>(c, l, r);
+    default:
+        return NULL;
+    }
+}
+
 /** convert the enumerated value type into a concrete c type for the
  * comparison helper templates. */
 AbstractExpression *
@@ -296,11 +344,28 @@ ExpressionUtil::comparisonFactory(PlannerDomValue obj, ExpressionType et, Abstra
     } else if (l_const != NULL && r_tuple != NULL) { // CONST-TUPLE
         return getMoreSpecialized<ConstantValueExpression, TupleValueExpression>(et, l_const, r_tuple);
     } else if (l_tuple != NULL && r_const != NULL) { // TUPLE-CONST
+        if (AbstractExpression::isFixedWidthBatchType(ValuePeeker::peekValueType(r_const->eval(NULL, NULL)))) {
+            AbstractExpression* fixedWidth = getFixedWidthSpecialized(et, l_tuple, r_const);
+            if (fixedWidth != NULL) {
+                return fixedWidth;
+            }
+        }
         return getMoreSpecialized<TupleValueExpression, ConstantValueExpression >(et, l_tuple, r_const);
     } else if (l_tuple != NULL && r_tuple != NULL) { // TUPLE-TUPLE
         return getMoreSpecialized<TupleValueExpression, TupleValueExpression>(et, l_tuple, r_tuple);
     }
 
+    ParameterValueExpression *r_param =
+        dynamic_cast<ParameterValueExpression*>(rc);
+
+    if (l_tuple != NULL && r_param != NULL) { // TUPLE-PARAM
+        // The parameter's type is only known when the plan is executed.
+        AbstractExpression* fixedWidth = getFixedWidthSpecialized(et, l_tuple, r_param);
+        if (fixedWidth != NULL) {
+            return fixedWidth;
+        }
+    }
+
     SubqueryExpression *l_subquery =
         dynamic_cast<SubqueryExpression*>(lc);
 
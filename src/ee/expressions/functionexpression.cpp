@@ -15,6 +15,8 @@
  * along with VoltDB.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include "common/ValueFactory.hpp"
+#include "common/ValuePeeker.hpp"
 #include "expressions/constantvalueexpression.h"
 #include "expressions/functionexpression.h"
 #include "expressions/geofunctions.h"
@@ -190,6 +192,79 @@ private:
     const std::vector<AbstractExpression *>& m_args;
 };
 
+/*
+ * The FIELD function.  The path is usually a constant or parameter, so
+ * the last path seen is kept parsed rather than parsed for every row.
+ */
+class JsonFieldFunctionExpression : public GeneralFunctionExpression<FUNC_VOLT_FIELD> {
+public:
+    JsonFieldFunctionExpression(const std::vector<AbstractExpression *>& args)
+        : GeneralFunctionExpression<FUNC_VOLT_FIELD>(args)
+        , m_docArg(args[0])
+        , m_pathArg(args[1])
+        , m_pathIsParsed(false) {}
+
+    NValue eval(const TableTuple *tuple1, const TableTuple *tuple2) const {
+        NValue docNVal = m_docArg->eval(tuple1, tuple2);
+        if (docNVal.isNull()) {
+            return docNVal;
+        }
+        NValue pathNVal = m_pathArg->eval(tuple1, tuple2);
+        if (pathNVal.isNull() ||
+            ValuePeeker::peekValueType(docNVal) != VALUE_TYPE_VARCHAR ||
+            ValuePeeker::peekValueType(pathNVal) != VALUE_TYPE_VARCHAR ||
+            ! parsePath(pathNVal)) {
+            // let the general implementation report the error
+            std::vector<NValue> arguments(2);
+            arguments[0] = docNVal;
+            arguments[1] = pathNVal;
+            return NValue::call<FUNC_VOLT_FIELD>(arguments);
+        }
+
+        int32_t lenDoc;
+        const char* docChars = ValuePeeker::peekObject_withoutNull(docNVal, &lenDoc);
+        std::string result;
+        if (getJsonField(docChars, lenDoc, m_path, result)) {
+            return ValueFactory::getTempStringValue(result.c_str(), result.length() - 1);
+        }
+        return ValueFactory::getNullStringValue();
+    }
+
+    std::string debugInfo(const std::string &spacer) const {
+        std::stringstream buffer;
+        buffer << spacer << "JsonFieldFunctionExpression" << std::endl;
+        return (buffer.str());
+    }
+
+private:
+    /** parse the path unless it is the one last parsed, returning whether it is valid */
+    bool parsePath(const NValue& pathNVal) const {
+        int32_t lenPath;
+        const char* pathChars = ValuePeeker::peekObject_withoutNull(pathNVal, &lenPath);
+        if (m_pathIsParsed &&
+            m_pathChars.length() == static_cast<size_t>(lenPath) &&
+            ::memcmp(m_pathChars.data(), pathChars, lenPath) == 0) {
+            return true;
+        }
+        m_pathIsParsed = false;
+        try {
+            m_path = JsonPathParser::parse(pathChars, lenPath);
+        }
+        catch (const SQLException&) {
+            return false;
+        }
+        m_pathChars.assign(pathChars, lenPath);
+        m_pathIsParsed = true;
+        return true;
+    }
+
+    AbstractExpression* const m_docArg;
+    AbstractExpression* const m_pathArg;
+    mutable bool m_pathIsParsed;
+    mutable std::string m_pathChars;
+    mutable std::vector<JsonPathNode> m_path;
+};
+
 /*
  * User-defined scalar function.
  */
@@ -589,7 +664,7 @@ ExpressionUtil::functionFactory(int functionId, const std::vector<AbstractExpres
             ret = new GeneralFunctionExpression<FUNC_VOLT_DATEADD_MICROSECOND>(*arguments);
             break;
         case FUNC_VOLT_FIELD:
-            ret = new GeneralFunctionExpression<FUNC_VOLT_FIELD>(*arguments);
+            ret = new JsonFieldFunctionExpression(*arguments);
             break;
         case FUNC_VOLT_FORMAT_CURRENCY:
             ret = new GeneralFunctionExpression<FUNC_VOLT_FORMAT_CURRENCY>(*arguments);
@@ -23,7 +23,9 @@
 #include <boost/lexical_cast.hpp>
 #include <boost/tokenizer.hpp>
 
+#include "common/PolygonCache.h"
 #include "common/ValueFactory.hpp"
+#include "common/executorcontext.hpp"
 #include "expressions/geofunctions.h"
 
 #include "s2geo/s2latlng.h"
@@ -145,6 +147,23 @@ static double getDistance(const GeographyPointValue &point1,
     S1Angle distance = latLng1.GetDistance(latLng2);
     return distance.radians() * SPHERICAL_EARTH_MEAN_RADIUS_M;
 }
+/**
+ * Return the prepared form of a polygon argument from the executor
+ * context's cache, so that a constant or parameter polygon is only
+ * deserialized once.  Without an executor context (as in some unit
+ * tests) the polygon is prepared in the given local cache instead.
+ */
+static PreparedPolygon* getPreparedPolygon(const GeographyValue& geog,
+                                           boost::scoped_ptr<PolygonCache>& localCache)
+{
+    ExecutorContext* context = ExecutorContext::getExecutorContext();
+    if (context != NULL) {
+        return context->polygonCache()->get(geog);
+    }
+    localCache.reset(new PolygonCache(1));
+    return localCache->get(geog);
+}
+
 template<> NValue NValue::callUnary<FUNC_VOLT_POINTFROMTEXT>() const
 {
     if (isNull()) {
@@ -401,10 +420,10 @@ template<> NValue NValue::call<FUNC_VOLT_CONTAINS>(const std::vector<NValue>& ar
     if (arguments[0].isNull() || arguments[1].isNull())
         return NValue::getNullValue(VALUE_TYPE_BOOLEAN);
 
-    Polygon poly;
-    poly.initFromGeography(arguments[0].getGeographyValue());
+    boost::scoped_ptr<PolygonCache> localCache;
+    PreparedPolygon* poly = getPreparedPolygon(arguments[0].getGeographyValue(), localCache);
     S2Point pt = arguments[1].getGeographyPointValue().toS2Point();
-    return ValueFactory::getBooleanValue(poly.Contains(pt));
+    return ValueFactory::getBooleanValue(poly->contains(pt));
 }
 
 template<> NValue NValue::callUnary<FUNC_VOLT_POLYGON_NUM_INTERIOR_RINGS>() const {
@@ -495,8 +514,8 @@ template<> NValue NValue::call<FUNC_VOLT_DISTANCE_POLYGON_POINT>(const std::vect
         return NValue::getNullValue(VALUE_TYPE_DOUBLE);
     }
 
-    Polygon polygon;
-    polygon.initFromGeography(arguments[0].getGeographyValue());
+    boost::scoped_ptr<PolygonCache> localCache;
+    Polygon& polygon = getPreparedPolygon(arguments[0].getGeographyValue(), localCache)->polygon();
     GeographyPointValue point = arguments[1].getGeographyPointValue();
     NValue retVal(VALUE_TYPE_DOUBLE);
     // distance is in radians, so convert it to meters
@@ -665,15 +684,21 @@ template<> NValue NValue::call<FUNC_VOLT_DWITHIN_POLYGON_POINT>(const std::vecto
         return NValue::getNullValue(VALUE_TYPE_BOOLEAN);
     }
 
-    Polygon polygon;
-    polygon.initFromGeography(arguments[0].getGeographyValue());
     GeographyPointValue point = arguments[1].getGeographyPointValue();
     double withinDistanceOf = arguments[2].castAsDoubleAndGetValue();
     if (withinDistanceOf < 0) {
         throwInvalidDistanceDWithin("Value of DISTANCE argument must be non-negative");
     }
 
-    double polygonToPointDistance = polygon.getDistance(point) * SPHERICAL_EARTH_MEAN_RADIUS_M;
+    boost::scoped_ptr<PolygonCache> localCache;
+    PreparedPolygon* polygon = getPreparedPolygon(arguments[0].getGeographyValue(), localCache);
+    // Points inside the polygon are at distance zero; checking for
+    // that first can use the polygon's cell coverings.
+    if (polygon->contains(point.toS2Point())) {
+        return ValueFactory::getBooleanValue(true);
+    }
+
+    double polygonToPointDistance = polygon->polygon().getDistance(point) * SPHERICAL_EARTH_MEAN_RADIUS_M;
     return ValueFactory::getBooleanValue(polygonToPointDistance <= withinDistanceOf);
 }
 
@@ -27,6 +27,9 @@
 #include <jsoncpp/jsoncpp.h>
 #include <jsoncpp/jsoncpp-forwards.h>
 
+#include "rapidjson/memorystream.h"
+#include "rapidjson/reader.h"
+
 namespace voltdb {
 
 /** a path node is either a field name or an array index */
@@ -34,125 +37,32 @@ struct JsonPathNode {
     JsonPathNode(int32_t arrayIndex) : m_arrayIndex(arrayIndex) {}
     JsonPathNode(const char* field) : m_arrayIndex(-1), m_field(field) {}
 
+    /** the array index of the path '[-1]', meaning the last element */
+    static const int32_t ARRAY_TAIL = -10;
+
     int32_t m_arrayIndex;
     std::string m_field;
 };
 
-/** representation of a JSON document that can be accessed and updated via
-    our path syntax */
-class JsonDocument {
+/** parser for our path syntax */
+class JsonPathParser {
 public:
-    JsonDocument(const char* docChars, int32_t lenDoc) : m_head(NULL), m_tail(NULL) {
-        if (docChars == NULL) {
-            // null documents have null everything, but they turn into objects/arrays
-            // if we try to set their properties
-            m_doc = Json::Value::null;
-        } else if (!m_reader.parse(docChars, docChars + lenDoc, m_doc)) {
-            // we have something real, but it isn't JSON
-            throwJsonFormattingError();
-        }
-    }
-
-    std::string value() { return m_writer.write(m_doc); }
-
-    bool get(const char* pathChars, int32_t lenPath, std::string& serializedValue) {
-        if (m_doc.isNull()) {
-            return false;
-        }
-
-        // get and traverse the path
-        std::vector<JsonPathNode> path = resolveJsonPath(pathChars, lenPath);
-        const Json::Value* node = &m_doc;
-        for (std::vector<JsonPathNode>::const_iterator cit = path.begin(); cit != path.end(); ++cit) {
-            const JsonPathNode& pathNode = *cit;
-            if (pathNode.m_arrayIndex != -1) {
-                // can't access an array index of something that isn't an array
-                if (!node->isArray()) {
-                    return false;
-                }
-                int32_t arrayIndex = pathNode.m_arrayIndex;
-                if (arrayIndex == ARRAY_TAIL) {
-                    unsigned int arraySize = node->size();
-                    arrayIndex = arraySize > 0 ? arraySize - 1 : 0;
-                }
-                node = &((*node)[arrayIndex]);
-                if (node->isNull()) {
-                    return false;
-                }
-            } else {
-                // this is a field. only objects have fields
-                if (!node->isObject()) {
-                    return false;
-                }
-                node = &((*node)[pathNode.m_field]);
-                if (node->isNull()) {
-                    return false;
-                }
-            }
-        }
-
-        // return the string representation of what we have obtained
-        if (node->isConvertibleTo(Json::stringValue)) {
-            // 'append' is to standardize that there's something to remove. quicker
-            // than substr on the other one, which incurs an extra copy
-            serializedValue = node->asString().append(1, '\n');
-        } else {
-            serializedValue = m_writer.write(*node);
-        }
-        return true;
-    }
-
-    void set(const char* pathChars, int32_t lenPath, const char* valueChars, int32_t lenValue) {
-        // translate database nulls into JSON nulls, because that's really all that makes
-        // any semantic sense. otherwise, parse the value as JSON
-        Json::Value value;
-        if (lenValue <= 0) {
-            value = Json::Value::null;
-        } else if (!m_reader.parse(valueChars, valueChars + lenValue, value)) {
-            throwJsonFormattingError();
-        }
-
-        std::vector<JsonPathNode> path = resolveJsonPath(pathChars, lenPath, true /*enforceArrayIndexLimitForSet*/);
-        // the non-const version of the Json::Value [] operator creates a new, null node on attempted
-        // access if none already exists
-        Json::Value* node = &m_doc;
-        for (std::vector<JsonPathNode>::const_iterator cit = path.begin(); cit != path.end(); ++cit) {
-            const JsonPathNode& pathNode = *cit;
-            if (pathNode.m_arrayIndex != -1) {
-                if (!node->isNull() && !node->isArray()) {
-                    // no-op if the update is impossible, I guess?
-                    return;
-                }
-                int32_t arrayIndex = pathNode.m_arrayIndex;
-                if (arrayIndex == ARRAY_TAIL) {
-                    arrayIndex = node->size();
-                }
-                // get or create the specified node
-                node = &((*node)[arrayIndex]);
-            } else {
-                if (!node->isNull() && !node->isObject()) {
-                    return;
-                }
-                node = &((*node)[pathNode.m_field]);
-            }
-        }
-        *node = value;
+    /** parse a path to its vector representation */
+    static std::vector<JsonPathNode> parse(const char* pathChars, int32_t lenPath,
+                                           bool enforceArrayIndexLimitForSet = false) {
+        JsonPathParser parser;
+        return parser.resolveJsonPath(pathChars, lenPath, enforceArrayIndexLimitForSet);
     }
 
 private:
-    Json::Value m_doc;
-    Json::Reader m_reader;
-    Json::FastWriter m_writer;
-
     const char* m_head;
     const char* m_tail;
     int32_t m_pos;
 
-    static const int32_t ARRAY_TAIL = -10;
+    JsonPathParser() : m_head(NULL), m_tail(NULL), m_pos(-1) {}
 
-    /** parse our path to its vector representation */
     std::vector<JsonPathNode> resolveJsonPath(const char* pathChars, int32_t lenPath,
-                                              bool enforceArrayIndexLimitForSet = false) {
+                                              bool enforceArrayIndexLimitForSet) {
         std::vector<JsonPathNode> path;
         // NULL path refers directly to the doc root
         if (pathChars == NULL) {
@@ -222,7 +132,7 @@ private:
                     if (arrayIndex != 1) {
                         throwInvalidPathError("Array index less than -1");
                     }
-                    arrayIndex = ARRAY_TAIL;
+                    arrayIndex = JsonPathNode::ARRAY_TAIL;
                 }
                 path.push_back(static_cast<int32_t>(arrayIndex));
                 expectArrayIndex = false;
@@ -294,6 +204,120 @@ private:
                            data_exception_invalid_parameter,
                            msg);
     }
+};
+
+/** representation of a JSON document that can be accessed and updated via
+    our path syntax */
+class JsonDocument {
+public:
+    JsonDocument(const char* docChars, int32_t lenDoc) {
+        if (docChars == NULL) {
+            // null documents have null everything, but they turn into objects/arrays
+            // if we try to set their properties
+            m_doc = Json::Value::null;
+        } else if (!m_reader.parse(docChars, docChars + lenDoc, m_doc)) {
+            // we have something real, but it isn't JSON
+            throwJsonFormattingError();
+        }
+    }
+
+    std::string value() { return m_writer.write(m_doc); }
+
+    bool get(const char* pathChars, int32_t lenPath, std::string& serializedValue) {
+        if (m_doc.isNull()) {
+            return false;
+        }
+        return get(JsonPathParser::parse(pathChars, lenPath), serializedValue);
+    }
+
+    /** get the value at an already parsed path */
+    bool get(const std::vector<JsonPathNode>& path, std::string& serializedValue) {
+        if (m_doc.isNull()) {
+            return false;
+        }
+
+        // traverse the path
+        const Json::Value* node = &m_doc;
+        for (std::vector<JsonPathNode>::const_iterator cit = path.begin(); cit != path.end(); ++cit) {
+            const JsonPathNode& pathNode = *cit;
+            if (pathNode.m_arrayIndex != -1) {
+                // can't access an array index of something that isn't an array
+                if (!node->isArray()) {
+                    return false;
+                }
+                int32_t arrayIndex = pathNode.m_arrayIndex;
+                if (arrayIndex == JsonPathNode::ARRAY_TAIL) {
+                    unsigned int arraySize = node->size();
+                    arrayIndex = arraySize > 0 ? arraySize - 1 : 0;
+                }
+                node = &((*node)[arrayIndex]);
+                if (node->isNull()) {
+                    return false;
+                }
+            } else {
+                // this is a field. only objects have fields
+                if (!node->isObject()) {
+                    return false;
+                }
+                node = &((*node)[pathNode.m_field]);
+                if (node->isNull()) {
+                    return false;
+                }
+            }
+        }
+
+        // return the string representation of what we have obtained
+        if (node->isConvertibleTo(Json::stringValue)) {
+            // 'append' is to standardize that there's something to remove. quicker
+            // than substr on the other one, which incurs an extra copy
+            serializedValue = node->asString().append(1, '\n');
+        } else {
+            serializedValue = m_writer.write(*node);
+        }
+        return true;
+    }
+
+    void set(const char* pathChars, int32_t lenPath, const char* valueChars, int32_t lenValue) {
+        // translate database nulls into JSON nulls, because that's really all that makes
+        // any semantic sense. otherwise, parse the value as JSON
+        Json::Value value;
+        if (lenValue <= 0) {
+            value = Json::Value::null;
+        } else if (!m_reader.parse(valueChars, valueChars + lenValue, value)) {
+            throwJsonFormattingError();
+        }
+
+        std::vector<JsonPathNode> path = JsonPathParser::parse(pathChars, lenPath, true /*enforceArrayIndexLimitForSet*/);
+        // the non-const version of the Json::Value [] operator creates a new, null node on attempted
+        // access if none already exists
+        Json::Value* node = &m_doc;
+        for (std::vector<JsonPathNode>::const_iterator cit = path.begin(); cit != path.end(); ++cit) {
+            const JsonPathNode& pathNode = *cit;
+            if (pathNode.m_arrayIndex != -1) {
+                if (!node->isNull() && !node->isArray()) {
+                    // no-op if the update is impossible, I guess?
+                    return;
+                }
+                int32_t arrayIndex = pathNode.m_arrayIndex;
+                if (arrayIndex == JsonPathNode::ARRAY_TAIL) {
+                    arrayIndex = node->size();
+                }
+                // get or create the specified node
+                node = &((*node)[arrayIndex]);
+            } else {
+                if (!node->isNull() && !node->isObject()) {
+                    return;
+                }
+                node = &((*node)[pathNode.m_field]);
+            }
+        }
+        *node = value;
+    }
+
+private:
+    Json::Value m_doc;
+    Json::Reader m_reader;
+    Json::FastWriter m_writer;
 
     void throwJsonFormattingError() const {
         char msg[1024];
@@ -306,6 +330,225 @@ private:
     }
 };
 
+/**
+ * Finds the value at a path in a JSON document by streaming through
+ * the document with rapidjson's SAX reader, without building a DOM.
+ *
+ * It only answers when it is sure to give the same result as
+ * JsonDocument::get: the document must parse cleanly, the path must
+ * not end with '[-1]', no key along the path may be repeated, and the
+ * value found must be a string, boolean or integer, whose text does not
+ * depend on how jsoncpp would serialize it.  Otherwise it returns
+ * UNDECIDED and the caller falls back to JsonDocument.
+ */
+class JsonFieldExtractor {
+public:
+    enum Result {
+        FOUND,
+        NOT_FOUND,
+        UNDECIDED
+    };
+
+    /** on FOUND, serializedValue is set as by JsonDocument::get */
+    static Result extract(const char* docChars, int32_t lenDoc,
+                          const std::vector<JsonPathNode>& path,
+                          std::string& serializedValue) {
+        for (std::vector<JsonPathNode>::const_iterator cit = path.begin(); cit != path.end(); ++cit) {
+            if (cit->m_arrayIndex == JsonPathNode::ARRAY_TAIL) {
+                // which element is last is only known at the end of the array
+                return UNDECIDED;
+            }
+        }
+
+        Handler handler(path, serializedValue);
+        rapidjson::Reader reader;
+        rapidjson::MemoryStream stream(docChars, lenDoc);
+        reader.Parse<rapidjson::kParseCommentsFlag |
+                     rapidjson::kParseNumbersAsStringsFlag |
+                     rapidjson::kParseStopWhenDoneFlag>(stream, handler);
+        if (reader.HasParseError() || handler.m_undecided) {
+            return UNDECIDED;
+        }
+        return handler.m_found ? FOUND : NOT_FOUND;
+    }
+
+private:
+    /** an object or array enclosing the current position in the document */
+    struct Container {
+        Container(bool isArray, bool onPath)
+            : m_isArray(isArray), m_onPath(onPath), m_childOnPath(false), m_keySeen(false), m_index(0) {}
+
+        bool m_isArray;
+        /** whether this container is at the path's prefix of its depth */
+        bool m_onPath;
+        /** whether the current member or element is on the path */
+        bool m_childOnPath;
+        /** whether this object's key on the path has been seen */
+        bool m_keySeen;
+        /** index of the next element of an array */
+        int32_t m_index;
+    };
+
+    class Handler : public rapidjson::BaseReaderHandler<rapidjson::UTF8<>, Handler> {
+    public:
+        Handler(const std::vector<JsonPathNode>& path, std::string& serializedValue)
+            : m_path(path), m_serializedValue(serializedValue), m_found(false), m_undecided(false) {}
+
+        bool Null() {
+            // jsoncpp reports a null value as missing
+            startValue();
+            return true;
+        }
+
+        bool Bool(bool b) {
+            if (startValue()) {
+                found(b ? "true" : "false", b ? 4 : 5);
+            }
+            return true;
+        }
+
+        bool RawNumber(const char* str, rapidjson::SizeType length, bool) {
+            if ( ! startValue()) {
+                return true;
+            }
+            // jsoncpp prints integers that fit in 64 bits as they are
+            // written, except for -0; anything else it reformats.
+            const char* digits = (str[0] == '-') ? str + 1 : str;
+            rapidjson::SizeType numDigits = length - static_cast<rapidjson::SizeType>(digits - str);
+            if (numDigits > 18 || (digits != str && digits[0] == '0')) {
+                return undecided();
+            }
+            for (rapidjson::SizeType i = 0; i < numDigits; ++i) {
+                if (digits[i] < '0' || digits[i] > '9') {
+                    return undecided();
+                }
+            }
+            found(str, length);
+            return true;
+        }
+
+        bool String(const char* str, rapidjson::SizeType length, bool) {
+            if (startValue()) {
+                // jsoncpp truncates strings at an embedded NUL
+                if (::memchr(str, '\0', length) != NULL) {
+                    return undecided();
+                }
+                found(str, length);
+            }
+            return true;
+        }
+
+        bool StartObject() {
+            return startContainer(false);
+        }
+
+        bool Key(const char* str, rapidjson::SizeType length, bool) {
+            Container& object = m_containers.back();
+            if ( ! object.m_onPath) {
+                return true;
+            }
+            if (::memchr(str, '\0', length) != NULL) {
+                // jsoncpp compares keys as C strings
+                return undecided();
+            }
+            const std::string& field = m_path[m_containers.size() - 1].m_field;
+            object.m_childOnPath = field.length() == length && ::memcmp(field.data(), str, length) == 0;
+            if (object.m_childOnPath) {
+                if (object.m_keySeen) {
+                    // jsoncpp keeps the last of repeated keys
+                    return undecided();
+                }
+                object.m_keySeen = true;
+            }
+            return true;
+        }
+
+        bool EndObject(rapidjson::SizeType) {
+            m_containers.pop_back();
+            return true;
+        }
+
+        bool StartArray() {
+            return startContainer(true);
+        }
+
+        bool EndArray(rapidjson::SizeType) {
+            m_containers.pop_back();
+            return true;
+        }
+
+        const std::vector<JsonPathNode>& m_path;
+        std::string& m_serializedValue;
+        std::vector<Container> m_containers;
+        bool m_found;
+        bool m_undecided;
+
+    private:
+        /** start a value, returning whether it is the one at the path */
+        bool startValue() {
+            return valueOnPath() && m_containers.size() == m_path.size();
+        }
+
+        bool valueOnPath() {
+            if (m_containers.empty()) {
+                return true;
+            }
+            Container& parent = m_containers.back();
+            if (parent.m_isArray) {
+                parent.m_childOnPath = parent.m_onPath &&
+                    parent.m_index == m_path[m_containers.size() - 1].m_arrayIndex;
+                ++parent.m_index;
+            }
+            return parent.m_childOnPath;
+        }
+
+        bool startContainer(bool isArray) {
+            bool onPath = valueOnPath();
+            size_t depth = m_containers.size();
+            if (onPath && depth == m_path.size()) {
+                // objects and arrays are reformatted by jsoncpp
+                return undecided();
+            }
+            // stay on the path only if the path expects this kind of container here
+            onPath = onPath && (m_path[depth].m_arrayIndex != -1) == isArray;
+            m_containers.push_back(Container(isArray, onPath));
+            return true;
+        }
+
+        void found(const char* str, size_t length) {
+            // as JsonDocument::get, with a trailing newline
+            m_serializedValue.assign(str, length).append(1, '\n');
+            m_found = true;
+        }
+
+        bool undecided() {
+            m_undecided = true;
+            // stop parsing
+            return false;
+        }
+    };
+};
+
+/**
+ * Get the value at an already parsed path in a JSON document, streaming
+ * through the document where possible and otherwise parsing it with
+ * jsoncpp.  Returns false if there is no (non-null) value at the path.
+ */
+inline bool getJsonField(const char* docChars, int32_t lenDoc,
+                         const std::vector<JsonPathNode>& path,
+                         std::string& serializedValue) {
+    switch (JsonFieldExtractor::extract(docChars, lenDoc, path, serializedValue)) {
+    case JsonFieldExtractor::FOUND:
+        return true;
+    case JsonFieldExtractor::NOT_FOUND:
+        return false;
+    default:
+        break;
+    }
+    JsonDocument doc(docChars, lenDoc);
+    return doc.get(path, serializedValue);
+}
+
 /** implement the 2-argument SQL FIELD function */
 template<> inline NValue NValue::call<FUNC_VOLT_FIELD>(const std::vector<NValue>& arguments) {
     assert(arguments.size() == 2);
@@ -329,12 +572,26 @@ template<> inline NValue NValue::call<FUNC_VOLT_FIELD>(const std::vector<NValue>
 
     int32_t lenDoc;
     const char* docChars = docNVal.getObject_withoutNull(&lenDoc);
-    JsonDocument doc(docChars, lenDoc);
-
     int32_t lenPath;
     const char* pathChars = pathNVal.getObject_withoutNull(&lenPath);
     std::string result;
-    if (doc.get(pathChars, lenPath, result)) {
+
+    std::vector<JsonPathNode> path;
+    try {
+        path = JsonPathParser::parse(pathChars, lenPath);
+    }
+    catch (const SQLException&) {
+        // Let JsonDocument decide which error to report (a malformed
+        // document takes precedence) or whether a JSON null document
+        // makes the path moot.
+        JsonDocument doc(docChars, lenDoc);
+        if (doc.get(pathChars, lenPath, result)) {
+            return getTempStringValue(result.c_str(), result.length() - 1);
+        }
+        return getNullStringValue();
+    }
+
+    if (getJsonField(docChars, lenDoc, path, result)) {
         return getTempStringValue(result.c_str(), result.length() - 1);
     }
     return getNullStringValue();
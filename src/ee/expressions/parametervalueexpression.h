@@ -75,6 +75,13 @@ public:
         return *m_paramValue;
     }
 
+    virtual bool evalFixedWidthBatch(const TableTuple* tuples,
+                                     const SelectionVector& selection,
+                                     FixedWidthBatch& out) const {
+        assert(m_paramValue != NULL);
+        return fillScalarBatch(*m_paramValue, out);
+    }
+
     bool hasParameter() const {
         // this class represents a parameter.
         return true;
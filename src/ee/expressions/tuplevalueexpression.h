@@ -49,6 +49,7 @@
 #include "expressions/abstractexpression.h"
 #include "common/tabletuple.h"
 
+#include <cstring>
 #include <string>
 #include <sstream>
 
@@ -83,6 +84,46 @@ class TupleValueExpression : public AbstractExpression {
         }
     }
 
+    virtual bool evalFixedWidthBatch(const TableTuple* tuples,
+                                     const SelectionVector& selection,
+                                     FixedWidthBatch& out) const {
+        if (tuple_idx != 0 || selection.empty()) {
+            return false;
+        }
+
+        // All the tuples in a batch share a schema.
+        const TupleSchema::ColumnInfo* columnInfo = tuples[selection[0]].getSchema()->getColumnInfo(value_idx);
+        const uint32_t offset = TUPLE_HEADER_SIZE + columnInfo->offset;
+        switch (columnInfo->getVoltType()) {
+        case VALUE_TYPE_TINYINT:
+            readIntegralBatch<int8_t>(tuples, selection, offset, INT8_NULL, out);
+            return true;
+        case VALUE_TYPE_SMALLINT:
+            readIntegralBatch<int16_t>(tuples, selection, offset, INT16_NULL, out);
+            return true;
+        case VALUE_TYPE_INTEGER:
+            readIntegralBatch<int32_t>(tuples, selection, offset, INT32_NULL, out);
+            return true;
+        case VALUE_TYPE_BIGINT:
+        case VALUE_TYPE_TIMESTAMP:
+            readIntegralBatch<int64_t>(tuples, selection, offset, INT64_NULL, out);
+            return true;
+        case VALUE_TYPE_DOUBLE:
+            out.reset(true, false);
+            out.doubles.resize(selection.size());
+            out.nulls.resize(selection.size());
+            for (size_t ii = 0; ii < selection.size(); ++ii) {
+                double value;
+                ::memcpy(&value, tuples[selection[ii]].address() + offset, sizeof(double));
+                out.doubles[ii] = value;
+                out.nulls[ii] = value <= DOUBLE_NULL;
+            }
+            return true;
+        default:
+            return false;
+        }
+    }
+
     std::string debugInfo(const std::string &spacer) const {
         std::ostringstream buffer;
         buffer << spacer << "Optimized Column Reference[" << tuple_idx << ", " << value_idx << "]\n";
@@ -91,8 +132,27 @@ class TupleValueExpression : public AbstractExpression {
 
     int getColumnId() const {return this->value_idx;}
 
+    int getTupleId() const {return this->tuple_idx;}
+
   protected:
 
+    template <typename T>
+    static void readIntegralBatch(const TableTuple* tuples,
+                                  const SelectionVector& selection,
+                                  uint32_t offset,
+                                  T nullValue,
+                                  FixedWidthBatch& out) {
+        out.reset(false, false);
+        out.ints.resize(selection.size());
+        out.nulls.resize(selection.size());
+        for (size_t ii = 0; ii < selection.size(); ++ii) {
+            T value;
+            ::memcpy(&value, tuples[selection[ii]].address() + offset, sizeof(T));
+            out.ints[ii] = value;
+            out.nulls[ii] = value == nullValue;
+        }
+    }
+
     const int tuple_idx;           // which tuple. defaults to tuple1
     const int value_idx;           // which (offset) column of the tuple
 };
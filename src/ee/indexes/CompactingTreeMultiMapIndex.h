@@ -46,24 +46,30 @@
 #ifndef COMPACTINGTREEMULTIMAPINDEX_H_
 #define COMPACTINGTREEMULTIMAPINDEX_H_
 
+#include <algorithm>
 #include <iostream>
 #include <cassert>
+#include <type_traits>
 #include "indexes/tableindex.h"
 #include "common/tabletuple.h"
 #include "structures/CompactingMap.h"
+#include "structures/CompactingBTree.h"
 
 namespace voltdb {
 
 /**
  * Index implemented as a Binary Tree Multimap.
+ * The map is either a CompactingMap (a red-black tree) or, for BTREE_INDEX
+ * schemes, a CompactingBTree; both offer the same interface.
  * @see TableIndex
  */
-template<typename KeyValuePair, bool hasRank>
+template<typename KeyValuePair, bool hasRank,
+         template<typename, typename, bool> class Map = CompactingMap>
 class CompactingTreeMultiMapIndex : public TableIndex
 {
     typedef typename KeyValuePair::first_type KeyType;
     typedef typename KeyType::KeyComparator KeyComparator;
-    typedef CompactingMap<KeyValuePair, KeyComparator, hasRank> MapType;
+    typedef Map<KeyValuePair, KeyComparator, hasRank> MapType;
     typedef typename MapType::iterator MapIterator;
     typedef std::pair<MapIterator, MapIterator> MapRange;
 
@@ -83,6 +89,26 @@ class CompactingTreeMultiMapIndex : public TableIndex
         m_entries.insert(setKeyFromTuple(tuple), tuple->address());
     }
 
+    void addEntriesDo(const std::vector<char*> &tupleAddresses)
+    {
+        // Sort the keys and build the map bottom-up, unless the map is
+        // already in use or duplicate keys need the one-at-a-time path.
+        if (m_entries.size() == 0) {
+            std::vector<KeyValuePair> entries(tupleAddresses.size());
+            TableTuple tuple(getTupleSchema());
+            for (size_t i = 0; i < tupleAddresses.size(); ++i) {
+                tuple.move(tupleAddresses[i]);
+                entries[i].setKeyValuePair(setKeyFromTuple(&tuple), tuple.address());
+            }
+            std::sort(entries.begin(), entries.end(), EntryLess(m_cmp));
+            if (m_entries.bulkLoad(entries)) {
+                m_inserts += static_cast<int>(entries.size());
+                return;
+            }
+        }
+        TableIndex::addEntriesDo(tupleAddresses);
+    }
+
     bool deleteEntryDo(const TableTuple *tuple)
     {
         ++m_deletes;
@@ -364,7 +390,13 @@ class CompactingTreeMultiMapIndex : public TableIndex
         return (ret);
     }
 
-    std::string getTypeName() const { return "CompactingTreeMultiMapIndex"; };
+    std::string getTypeName() const
+    {
+        if (std::is_same<MapType, CompactingBTree<KeyValuePair, KeyComparator, hasRank> >::value) {
+            return "CompactingBTreeMultiMapIndex";
+        }
+        return "CompactingTreeMultiMapIndex";
+    }
 
     MapIterator findKey(const TableTuple *searchKey) const {
         KeyType tempKey(searchKey);
@@ -406,6 +438,15 @@ class CompactingTreeMultiMapIndex : public TableIndex
     // comparison stuff
     KeyComparator m_cmp;
 
+    // orders map entries by key for a bulk load
+    struct EntryLess {
+        EntryLess(const KeyComparator &cmp) : m_cmp(cmp) {}
+        bool operator()(const KeyValuePair &lhs, const KeyValuePair &rhs) const {
+            return m_cmp(lhs.getKey(), rhs.getKey()) < 0;
+        }
+        const KeyComparator &m_cmp;
+    };
+
 public:
     CompactingTreeMultiMapIndex(const TupleSchema *keySchema, const TableIndexScheme &scheme) :
         TableIndex(keySchema, scheme),
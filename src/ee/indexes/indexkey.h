@@ -51,7 +51,10 @@
 
 #include "expressions/abstractexpression.h"
 
+#include <algorithm>
 #include <cassert>
+#include <cmath>
+#include <cstring>
 #include <iostream>
 #include <sstream>
 
@@ -644,6 +647,271 @@ private:
     const TupleSchema *m_keySchema;
 };
 
+/**
+ * Encoding of key values into byte strings whose memcmp order is the
+ * order NValue::compare gives the values, used by NormalizedKey.
+ *
+ * Each column is a marker byte (0 for NULL, 1 otherwise) followed by a
+ * fixed width encoding of the value, so NULL sorts first and a column
+ * always starts at the same offset:
+ *   - integers and timestamps are big-endian with the sign bit flipped.
+ *   - doubles are flipped so that negative values sort below positive
+ *     ones, with -0.0 folded into 0.0 and every NaN below -Infinity.
+ *   - decimals are the 128 bit integer, big-endian with the sign bit flipped.
+ *   - strings are their bytes padded with zeros to the column's maximum
+ *     byte length, then a 2 byte big-endian length.  As NValue compares
+ *     VARCHARs with strncmp, only the bytes before the first zero byte
+ *     of a VARCHAR are kept.  A search string that is longer than the
+ *     column keeps only the bytes that fit and a length one past the
+ *     maximum, which still sorts it after every stored value it starts with.
+ */
+struct NormalizedKeyEncoding
+{
+    static const int32_t MAX_STRING_BYTES = 0xFFFE;
+
+    /**
+     * The number of bytes a column of the key schema encodes to, or -1
+     * if the column's type has no normalized encoding.
+     */
+    static int32_t columnLength(const TupleSchema::ColumnInfo *columnInfo) {
+        switch (columnInfo->getVoltType()) {
+        case VALUE_TYPE_TINYINT:
+            return 1 + 1;
+        case VALUE_TYPE_SMALLINT:
+            return 1 + 2;
+        case VALUE_TYPE_INTEGER:
+            return 1 + 4;
+        case VALUE_TYPE_BIGINT:
+        case VALUE_TYPE_TIMESTAMP:
+        case VALUE_TYPE_DOUBLE:
+            return 1 + 8;
+        case VALUE_TYPE_DECIMAL:
+            return 1 + 16;
+        case VALUE_TYPE_VARCHAR:
+        case VALUE_TYPE_VARBINARY: {
+            const int32_t maxBytes = stringBytes(columnInfo);
+            if (maxBytes > MAX_STRING_BYTES) {
+                return -1;
+            }
+            return 1 + maxBytes + 2;
+        }
+        default:
+            return -1;
+        }
+    }
+
+    /**
+     * The number of bytes a key of this schema encodes to, or -1 if any
+     * of its columns has no normalized encoding.
+     */
+    static int32_t keyLength(const TupleSchema *keySchema) {
+        int32_t length = 0;
+        const int columnCount = keySchema->columnCount();
+        for (int ii = 0; ii < columnCount; ++ii) {
+            const int32_t columnBytes = columnLength(keySchema->getColumnInfo(ii));
+            if (columnBytes < 0) {
+                return -1;
+            }
+            length += columnBytes;
+        }
+        return length;
+    }
+
+    /**
+     * Encode the value of a key column at out, returning the position
+     * just past it.
+     */
+    static char *encode(char *out, const NValue &value, const TupleSchema::ColumnInfo *columnInfo) {
+        const ValueType type = columnInfo->getVoltType();
+        if (value.isNull()) {
+            // The marker and the rest of the column are left zeroed.
+            return out + columnLength(columnInfo);
+        }
+        *out++ = 1;
+        switch (type) {
+        case VALUE_TYPE_TINYINT:
+            return putSigned(out, ValuePeeker::peekTinyInt(value), 1);
+        case VALUE_TYPE_SMALLINT:
+            return putSigned(out, ValuePeeker::peekSmallInt(value), 2);
+        case VALUE_TYPE_INTEGER:
+            return putSigned(out, ValuePeeker::peekInteger(value), 4);
+        case VALUE_TYPE_BIGINT:
+            return putSigned(out, ValuePeeker::peekBigInt(value), 8);
+        case VALUE_TYPE_TIMESTAMP:
+            return putSigned(out, ValuePeeker::peekTimestamp(value), 8);
+        case VALUE_TYPE_DOUBLE:
+            return putBigEndian(out, doubleBits(ValuePeeker::peekDouble(value)), 8);
+        case VALUE_TYPE_DECIMAL: {
+            const TTInt decimal = ValuePeeker::peekDecimal(value);
+            out = putBigEndian(out, static_cast<uint64_t>(decimal.table[1]) ^ SIGN_BIT, 8);
+            return putBigEndian(out, static_cast<uint64_t>(decimal.table[0]), 8);
+        }
+        case VALUE_TYPE_VARCHAR:
+        case VALUE_TYPE_VARBINARY: {
+            const int32_t maxBytes = stringBytes(columnInfo);
+            int32_t length;
+            const char *bytes = ValuePeeker::peekObject_withoutNull(value, &length);
+            int32_t kept = std::min(length, maxBytes);
+            if (type == VALUE_TYPE_VARCHAR) {
+                const void *zero = ::memchr(bytes, 0, kept);
+                if (zero != NULL) {
+                    kept = static_cast<int32_t>(static_cast<const char*>(zero) - bytes);
+                }
+            }
+            ::memcpy(out, bytes, kept);
+            return putBigEndian(out + maxBytes, std::min(length, maxBytes + 1), 2);
+        }
+        default:
+            throwFatalException("Normalized index keys do not support column type %s",
+                                getTypeName(type).c_str());
+        }
+        return out;
+    }
+
+private:
+    static const uint64_t SIGN_BIT = 0x8000000000000000ULL;
+
+    static int32_t stringBytes(const TupleSchema::ColumnInfo *columnInfo) {
+        if (columnInfo->inBytes || columnInfo->getVoltType() == VALUE_TYPE_VARBINARY) {
+            return columnInfo->length;
+        }
+        return columnInfo->length * MAX_BYTES_PER_UTF8_CHARACTER;
+    }
+
+    static char *putBigEndian(char *out, uint64_t value, int bytes) {
+        for (int ii = bytes - 1; ii >= 0; --ii) {
+            *out++ = static_cast<char>(value >> (ii * 8));
+        }
+        return out;
+    }
+
+    static char *putSigned(char *out, int64_t value, int bytes) {
+        const uint64_t signBit = 1ULL << (bytes * 8 - 1);
+        return putBigEndian(out, static_cast<uint64_t>(value) ^ signBit, bytes);
+    }
+
+    static uint64_t doubleBits(double value) {
+        if (std::isnan(value)) {
+            return 0;
+        }
+        if (value == 0.0) {
+            value = 0.0;
+        }
+        uint64_t bits;
+        ::memcpy(&bits, &value, sizeof(bits));
+        return (bits & SIGN_BIT) ? ~bits : (bits | SIGN_BIT);
+    }
+};
+
+template <std::size_t keySize> struct NormalizedEqualityChecker;
+template <std::size_t keySize> struct NormalizedComparator;
+template <std::size_t keySize> struct NormalizedHasher;
+
+/**
+ * Key object for indexes of mixed types whose columns all have a
+ * NormalizedKeyEncoding. Keys compare, hash and test for equality on
+ * their bytes alone, without materializing NValues, and strings are
+ * copied into the key rather than referenced.
+ */
+template <std::size_t keySize>
+struct NormalizedKey
+{
+    typedef NormalizedEqualityChecker<keySize> KeyEqualityChecker;
+    typedef NormalizedComparator<keySize> KeyComparator;
+    typedef NormalizedHasher<keySize> KeyHasher;
+
+    static inline bool keyDependsOnTupleAddress() { return false; }
+    static inline bool keyUsesNonInlinedMemory() { return false; }
+
+    NormalizedKey() {
+        ::memset(data, 0, keySize * sizeof(char));
+    }
+
+    NormalizedKey(const TableTuple *tuple) {
+        assert(tuple);
+        ::memset(data, 0, keySize * sizeof(char));
+        const TupleSchema *keySchema = tuple->getSchema();
+        assert(NormalizedKeyEncoding::keyLength(keySchema) <= static_cast<int32_t>(keySize));
+        char *out = data;
+        const int columnCount = keySchema->columnCount();
+        for (int ii = 0; ii < columnCount; ++ii) {
+            out = NormalizedKeyEncoding::encode(out, tuple->getNValue(ii), keySchema->getColumnInfo(ii));
+        }
+    }
+
+    NormalizedKey(const TableTuple *tuple, const std::vector<int> &indices,
+                  const std::vector<AbstractExpression*> &indexed_expressions, const TupleSchema *keySchema) {
+        assert(tuple);
+        ::memset(data, 0, keySize * sizeof(char));
+        char *out = data;
+        const int columnCount = keySchema->columnCount();
+        if (indexed_expressions.size() > 0) {
+            for (int ii = 0; ii < columnCount; ++ii) {
+                const TupleSchema::ColumnInfo *columnInfo = keySchema->getColumnInfo(ii);
+                NValue value = indexed_expressions[ii]->eval(tuple, NULL);
+                const ValueType type = columnInfo->getVoltType();
+                if (ValuePeeker::peekValueType(value) != type) {
+                    value = value.castAs(type);
+                }
+                // Only search keys may be truncated; an indexed value
+                // that does not fit the key column is an error, as it
+                // is for GenericKey.
+                if (type == VALUE_TYPE_VARCHAR || type == VALUE_TYPE_VARBINARY) {
+                    value.checkFitsVariableLengthColumn(columnInfo->length, columnInfo->inBytes);
+                }
+                out = NormalizedKeyEncoding::encode(out, value, columnInfo);
+            }
+            return;
+        } // else take advantage of columns-only optimization
+        for (int ii = 0; ii < columnCount; ++ii) {
+            out = NormalizedKeyEncoding::encode(out, tuple->getNValue(indices[ii]), keySchema->getColumnInfo(ii));
+        }
+    }
+
+    // encoded columns, zero padded to keySize.
+    char data[keySize];
+};
+
+/**
+ * Required by CompactingMap keyed by NormalizedKey<>
+ */
+template <std::size_t keySize>
+struct NormalizedComparator
+{
+    NormalizedComparator(const TupleSchema *unused_keySchema) {}
+
+    inline int operator()(const NormalizedKey<keySize> &lhs, const NormalizedKey<keySize> &rhs) const {
+        const int result = ::memcmp(lhs.data, rhs.data, keySize);
+        return (result > 0) - (result < 0);
+    }
+};
+
+/**
+ * Required by CompactingHashTable keyed by NormalizedKey<>
+ */
+template <std::size_t keySize>
+struct NormalizedEqualityChecker
+{
+    NormalizedEqualityChecker(const TupleSchema *unused_keySchema) {}
+
+    inline bool operator()(const NormalizedKey<keySize> &lhs, const NormalizedKey<keySize> &rhs) const {
+        return ::memcmp(lhs.data, rhs.data, keySize) == 0;
+    }
+};
+
+/**
+ * Required by CompactingHashTable keyed by NormalizedKey<>
+ */
+template <std::size_t keySize>
+struct NormalizedHasher
+{
+    NormalizedHasher(const TupleSchema *unused_keySchema) {}
+
+    inline size_t operator()(NormalizedKey<keySize> const &p) const {
+        return boost::hash_range(p.data, p.data + keySize);
+    }
+};
+
 struct TupleKeyComparator;
 
 /*
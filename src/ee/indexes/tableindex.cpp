@@ -43,6 +43,7 @@
  * OTHER DEALINGS IN THE SOFTWARE.
  */
 
+#include <algorithm>
 #include <iostream>
 #include "indexes/tableindex.h"
 #include "expressions/abstractexpression.h"
@@ -173,6 +174,33 @@ void TableIndex::addEntry(const TableTuple *tuple, TableTuple *conflictTuple)
     addEntryDo(tuple, conflictTuple);
 }
 
+void TableIndex::addEntries(std::vector<char*> &tupleAddresses)
+{
+    if (isPartialIndex()) {
+        // Keep only the tuples that pass the predicate.
+        TableTuple tuple(getTupleSchema());
+        size_t kept = 0;
+        for (size_t i = 0; i < tupleAddresses.size(); ++i) {
+            tuple.move(tupleAddresses[i]);
+            if (getPredicate()->eval(&tuple, NULL).isTrue()) {
+                tupleAddresses[kept++] = tupleAddresses[i];
+            }
+        }
+        tupleAddresses.resize(kept);
+    }
+    addEntriesDo(tupleAddresses);
+}
+
+void TableIndex::addEntriesDo(const std::vector<char*> &tupleAddresses)
+{
+    ensureCapacity(static_cast<uint32_t>(std::min<size_t>(tupleAddresses.size(), UINT32_MAX)));
+    TableTuple tuple(getTupleSchema());
+    for (size_t i = 0; i < tupleAddresses.size(); ++i) {
+        tuple.move(tupleAddresses[i]);
+        addEntryDo(&tuple, NULL);
+    }
+}
+
 bool TableIndex::deleteEntry(const TableTuple *tuple)
 {
     if (isPartialIndex() && !getPredicate()->eval(tuple, NULL).isTrue()) {
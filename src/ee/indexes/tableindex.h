@@ -222,6 +222,13 @@ public:
      */
     void addEntry(const TableTuple *tuple, TableTuple *conflictTuple);
 
+    /**
+     * adds index entries for all of the given tuples, as when building
+     * an index for a table that already has rows. Tuples that fail a
+     * partial index's predicate are removed from tupleAddresses.
+     */
+    void addEntries(std::vector<char*> &tupleAddresses);
+
     /**
      * removes the index entry linked to given value (and tuple
      * pointer, if it's non-unique index).
@@ -545,6 +552,8 @@ protected:
 protected:
     // Index specific implementations
     virtual void addEntryDo(const TableTuple *tuple, TableTuple *conflictTuple) = 0;
+    // By default adds each entry in turn; tree indexes build their map in one pass.
+    virtual void addEntriesDo(const std::vector<char*> &tupleAddresses);
     virtual bool deleteEntryDo(const TableTuple *tuple) = 0;
     virtual bool replaceEntryNoKeyChangeDo(const TableTuple &destinationTuple,
                                          const TableTuple &originalTuple) = 0;
@@ -63,28 +63,41 @@ namespace voltdb {
 
 class TableIndexPicker
 {
-    template <class TKeyType>
-    TableIndex *getInstanceForKeyType() const
+    template <class TKeyType, template<typename, typename, bool> class Map>
+    TableIndex *getTreeInstanceForKeyType() const
     {
         if (m_scheme.unique) {
-            if (m_type != BALANCED_TREE_INDEX) {
-                return new CompactingHashUniqueIndex<TKeyType >(m_keySchema, m_scheme);
-            } else if (m_scheme.countable) {
-                return new CompactingTreeUniqueIndex<NormalKeyValuePair<TKeyType>, true>(m_keySchema, m_scheme);
+            if (m_scheme.countable) {
+                return new CompactingTreeUniqueIndex<NormalKeyValuePair<TKeyType>, true, Map>(m_keySchema, m_scheme);
             } else {
-                return new CompactingTreeUniqueIndex<NormalKeyValuePair<TKeyType>, false>(m_keySchema, m_scheme);
+                return new CompactingTreeUniqueIndex<NormalKeyValuePair<TKeyType>, false, Map>(m_keySchema, m_scheme);
             }
         } else {
-            if (m_type != BALANCED_TREE_INDEX) {
-                return new CompactingHashMultiMapIndex<TKeyType >(m_keySchema, m_scheme);
-            } else if (m_scheme.countable) {
-                return new CompactingTreeMultiMapIndex<PointerKeyValuePair<TKeyType>, true>(m_keySchema, m_scheme);
+            if (m_scheme.countable) {
+                return new CompactingTreeMultiMapIndex<PointerKeyValuePair<TKeyType>, true, Map>(m_keySchema, m_scheme);
             } else {
-                return new CompactingTreeMultiMapIndex<PointerKeyValuePair<TKeyType>, false>(m_keySchema, m_scheme);
+                return new CompactingTreeMultiMapIndex<PointerKeyValuePair<TKeyType>, false, Map>(m_keySchema, m_scheme);
             }
         }
     }
 
+    template <class TKeyType>
+    TableIndex *getInstanceForKeyType() const
+    {
+        if (m_type == HASH_TABLE_INDEX) {
+            if (m_scheme.unique) {
+                return new CompactingHashUniqueIndex<TKeyType >(m_keySchema, m_scheme);
+            } else {
+                return new CompactingHashMultiMapIndex<TKeyType >(m_keySchema, m_scheme);
+            }
+        }
+        // BTREE_INDEX trees are B+trees rather than red-black trees.
+        if (m_type == BTREE_INDEX) {
+            return getTreeInstanceForKeyType<TKeyType, CompactingBTree>();
+        }
+        return getTreeInstanceForKeyType<TKeyType, CompactingMap>();
+    }
+
     template <std::size_t KeySize>
     TableIndex *getInstanceIfKeyFits()
     {
@@ -114,6 +127,17 @@ class TableIndexPicker
         return getInstanceForKeyType<GenericPersistentKey<KeySize> >();
     }
 
+    template <std::size_t KeySize>
+    TableIndex *getNormalizedInstanceIfKeyFits()
+    {
+        if (m_normalizedKeySize > static_cast<int>(KeySize)) {
+            return NULL;
+        }
+        // Normalized keys hash and test for equality on their bytes,
+        // so unlike GenericKey they can back a hash index.
+        return getInstanceForKeyType<NormalizedKey<KeySize> >();
+    }
+
     template <int ColCount>
     TableIndex *getInstanceForHashedGenericColumns() const
     {
@@ -144,6 +168,26 @@ public:
         }
 */
 
+        // Keys that are not all integers, or that are too wide to pack into
+        // an IntsKey, compare as bytes if their normalized form is small.
+        if (m_normalizedKeySize > 0 && ( ! m_intsOnly || m_keySize > 32)) {
+            if ((result = getNormalizedInstanceIfKeyFits<16>())) {
+                return result;
+            }
+            if ((result = getNormalizedInstanceIfKeyFits<24>())) {
+                return result;
+            }
+            if ((result = getNormalizedInstanceIfKeyFits<32>())) {
+                return result;
+            }
+            if ((result = getNormalizedInstanceIfKeyFits<48>())) {
+                return result;
+            }
+            if ((result = getNormalizedInstanceIfKeyFits<MAX_NORMALIZED_KEY_SIZE>())) {
+                return result;
+            }
+        }
+
         if ((result = getInstanceIfKeyFits<4>())) {
             return result;
         }
@@ -183,18 +227,10 @@ public:
             return result;
         }
 
-        if (m_scheme.unique) {
-            if (m_scheme.countable) {
-                return new CompactingTreeUniqueIndex<NormalKeyValuePair<TupleKey>, true >(m_keySchema, m_scheme);
-            } else {
-                return new CompactingTreeUniqueIndex<NormalKeyValuePair<TupleKey>, false>(m_keySchema, m_scheme);
-            }
-        }
-        if (m_scheme.countable) {
-            return new CompactingTreeMultiMapIndex<PointerKeyValuePair<TupleKey>, true >(m_keySchema, m_scheme);
-        } else {
-            return new CompactingTreeMultiMapIndex<PointerKeyValuePair<TupleKey>, false>(m_keySchema, m_scheme);
+        if (m_type == BTREE_INDEX) {
+            return getTreeInstanceForKeyType<TupleKey, CompactingBTree>();
         }
+        return getTreeInstanceForKeyType<TupleKey, CompactingMap>();
     }
 
     TableIndexPicker(const TupleSchema *keySchema, bool intsOnly, bool inlinesOrColumnsOnly,
@@ -204,15 +240,25 @@ public:
         m_keySize(keySchema->tupleLength()),
         m_intsOnly(intsOnly),
         m_inlinesOrColumnsOnly(inlinesOrColumnsOnly),
+        m_normalizedKeySize(NormalizedKeyEncoding::keyLength(keySchema)),
         m_type(scheme.type)
-    {}
+    {
+        // Normalized keys copy strings in, so wide ones are better
+        // left referenced from a GenericKey.
+        if (m_normalizedKeySize > static_cast<int>(MAX_NORMALIZED_KEY_SIZE)) {
+            m_normalizedKeySize = -1;
+        }
+    }
 
 private:
+    static const std::size_t MAX_NORMALIZED_KEY_SIZE = 64;
+
     const TableIndexScheme &m_scheme;
     const TupleSchema *m_keySchema;
     const int m_keySize;
     bool m_intsOnly;
     bool m_inlinesOrColumnsOnly;
+    int m_normalizedKeySize;
     TableIndexType m_type;
 };
 
@@ -0,0 +1,92 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2018 VoltDB Inc.
+ *
+ * This file contains original code and/or modifications of original code.
+ * Any modifications made by VoltDB Inc. are licensed under the following
+ * terms and conditions:
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with VoltDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/* Copyright (C) 2008 by H-Store Project
+ * Brown University
+ * Massachusetts Institute of Technology
+ * Yale University
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT
+ * IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "mergejoinnode.h"
+
+#include "common/SerializableEEException.h"
+#include "expressions/abstractexpression.h"
+
+#include <sstream>
+
+namespace voltdb {
+
+MergeJoinPlanNode::~MergeJoinPlanNode() { }
+
+PlanNodeType MergeJoinPlanNode::getPlanNodeType() const { return PLAN_NODE_TYPE_MERGEJOIN; }
+
+std::string MergeJoinPlanNode::debugInfo(const std::string& spacer) const
+{
+    std::ostringstream buffer;
+    buffer << AbstractJoinPlanNode::debugInfo(spacer);
+    buffer << spacer << "MergeKeys[" << m_outerKeyExpressions.size() << "] "
+           << sortDirectionToString(m_sortDirection) << "\n";
+    for (int ctr = 0, cnt = (int)m_outerKeyExpressions.size(); ctr < cnt; ctr++)
+    {
+        buffer << spacer << "  [" << ctr << "] "
+               << m_outerKeyExpressions[ctr]->debug()
+               << " = " << m_innerKeyExpressions[ctr]->debug() << "\n";
+    }
+    return buffer.str();
+}
+
+void MergeJoinPlanNode::loadFromJSONObject(PlannerDomValue obj)
+{
+    AbstractJoinPlanNode::loadFromJSONObject(obj);
+
+    m_outerKeyExpressions.loadExpressionArrayFromJSONObject("OUTER_KEY_EXPRESSIONS", obj);
+    m_innerKeyExpressions.loadExpressionArrayFromJSONObject("INNER_KEY_EXPRESSIONS", obj);
+    if (m_outerKeyExpressions.size() != m_innerKeyExpressions.size()) {
+        throwSerializableEEException("MergeJoinPlanNode: mismatched outer (%d) and inner (%d) key counts",
+                                     (int)m_outerKeyExpressions.size(),
+                                     (int)m_innerKeyExpressions.size());
+    }
+    if (obj.hasNonNullKey("SORT_DIRECTION")) {
+        m_sortDirection = stringToSortDirection(obj.valueForKey("SORT_DIRECTION").asStr());
+    }
+    if (m_sortDirection != SORT_DIRECTION_TYPE_ASC && m_sortDirection != SORT_DIRECTION_TYPE_DESC) {
+        throwSerializableEEException("MergeJoinPlanNode: invalid sort direction");
+    }
+}
+
+} // namespace voltdb
@@ -0,0 +1,179 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2018 VoltDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with VoltDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "BinaryLogPipeline.h"
+
+#include "storage/DRTupleStream.h"
+#include "common/FatalException.hpp"
+#include "common/serializeio.h"
+
+#include <algorithm>
+
+namespace voltdb {
+
+BinaryLogPipeline::BinaryLogPipeline(std::size_t depth)
+    : m_txns(std::max<std::size_t>(depth, 1)),
+      m_threadStarted(false),
+      m_logs(NULL),
+      m_length(0),
+      m_nextTxn(0),
+      m_decodedTxns(0),
+      m_holdingTxn(false),
+      m_decoding(false),
+      m_cancelled(false),
+      m_stopping(false)
+{
+    pthread_mutex_init(&m_mutex, NULL);
+    pthread_cond_init(&m_workAvailable, NULL);
+    pthread_cond_init(&m_txnReady, NULL);
+    m_threadStarted = pthread_create(&m_thread, NULL, helperMain, this) == 0;
+}
+
+BinaryLogPipeline::~BinaryLogPipeline()
+{
+    pthread_mutex_lock(&m_mutex);
+    m_stopping = true;
+    m_cancelled = true;
+    pthread_cond_broadcast(&m_workAvailable);
+    pthread_mutex_unlock(&m_mutex);
+    if (m_threadStarted) {
+        pthread_join(m_thread, NULL);
+    }
+    pthread_cond_destroy(&m_txnReady);
+    pthread_cond_destroy(&m_workAvailable);
+    pthread_mutex_destroy(&m_mutex);
+}
+
+void BinaryLogPipeline::start(const char *logs, std::size_t length)
+{
+    pthread_mutex_lock(&m_mutex);
+    if (m_decoding) {
+        pthread_mutex_unlock(&m_mutex);
+        throwFatalException("BinaryLogPipeline::start() was called before the last buffer was finished.");
+    }
+    m_logs = logs;
+    m_length = length;
+    m_nextTxn = 0;
+    m_decodedTxns = 0;
+    m_holdingTxn = false;
+    m_cancelled = false;
+    m_failure = std::exception_ptr();
+    m_decoding = true;
+    pthread_cond_broadcast(&m_workAvailable);
+    pthread_mutex_unlock(&m_mutex);
+}
+
+BinaryLogSink::DRTxn *BinaryLogPipeline::next()
+{
+    pthread_mutex_lock(&m_mutex);
+    if (m_holdingTxn) {
+        m_holdingTxn = false;
+        pthread_cond_signal(&m_workAvailable);
+    }
+    while (m_decodedTxns == 0 && m_decoding) {
+        pthread_cond_wait(&m_txnReady, &m_mutex);
+    }
+    BinaryLogSink::DRTxn *txn = NULL;
+    if (m_decodedTxns > 0) {
+        txn = &m_txns[m_nextTxn];
+        m_nextTxn = (m_nextTxn + 1) % m_txns.size();
+        --m_decodedTxns;
+        m_holdingTxn = true;
+    }
+    std::exception_ptr failure = m_failure;
+    pthread_mutex_unlock(&m_mutex);
+
+    if (txn == NULL && failure) {
+        std::rethrow_exception(failure);
+    }
+    return txn;
+}
+
+void BinaryLogPipeline::finish()
+{
+    pthread_mutex_lock(&m_mutex);
+    m_cancelled = true;
+    m_holdingTxn = false;
+    pthread_cond_broadcast(&m_workAvailable);
+    while (m_decoding) {
+        pthread_cond_wait(&m_txnReady, &m_mutex);
+    }
+    m_logs = NULL;
+    m_length = 0;
+    m_nextTxn = 0;
+    m_decodedTxns = 0;
+    m_failure = std::exception_ptr();
+    pthread_mutex_unlock(&m_mutex);
+}
+
+void *BinaryLogPipeline::helperMain(void *pipeline)
+{
+    BinaryLogPipeline *self = static_cast<BinaryLogPipeline*>(pipeline);
+    pthread_mutex_lock(&self->m_mutex);
+    while (true) {
+        while (!self->m_stopping && !self->m_decoding) {
+            pthread_cond_wait(&self->m_workAvailable, &self->m_mutex);
+        }
+        if (self->m_stopping) {
+            break;
+        }
+        self->decodeLocked();
+    }
+    pthread_mutex_unlock(&self->m_mutex);
+    return NULL;
+}
+
+void BinaryLogPipeline::decodeLocked()
+{
+    // Only this thread reads the buffer until m_decoding is cleared.
+    ReferenceSerializeInputLE taskInfo(m_logs, m_length);
+    while (!m_cancelled && taskInfo.hasRemaining()) {
+        // Leave alone the transaction the caller is applying.
+        while (!m_cancelled && m_decodedTxns + (m_holdingTxn ? 1 : 0) == m_txns.size()) {
+            pthread_cond_wait(&m_workAvailable, &m_mutex);
+        }
+        if (m_cancelled) {
+            break;
+        }
+        BinaryLogSink::DRTxn &txn = m_txns[(m_nextTxn + m_decodedTxns) % m_txns.size()];
+
+        pthread_mutex_unlock(&m_mutex);
+        std::exception_ptr failure;
+        try {
+            const char* recordStart = taskInfo.getRawPointer();
+            const uint8_t drVersion = taskInfo.readByte();
+            if (drVersion < DRTupleStream::COMPATIBLE_PROTOCOL_VERSION) {
+                throwFatalException("Unsupported DR version %d", drVersion);
+            }
+            BinaryLogSink::decodeTxn(&taskInfo, recordStart, txn);
+        } catch (...) {
+            failure = std::current_exception();
+        }
+        pthread_mutex_lock(&m_mutex);
+
+        if (failure) {
+            m_failure = failure;
+            break;
+        }
+        ++m_decodedTxns;
+        pthread_cond_signal(&m_txnReady);
+    }
+    m_decoding = false;
+    pthread_cond_broadcast(&m_txnReady);
+}
+
+}
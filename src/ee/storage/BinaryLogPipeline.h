@@ -0,0 +1,102 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2018 VoltDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with VoltDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef BINARYLOGPIPELINE_H
+#define BINARYLOGPIPELINE_H
+
+#include "storage/BinaryLogSink.h"
+
+#include <cstddef>
+#include <exception>
+#include <vector>
+#include <pthread.h>
+
+namespace voltdb {
+
+/**
+ * A helper thread that reads the transactions of a binary log buffer, and
+ * checks their CRCs, ahead of the site thread applying them.  A bounded
+ * ring of decoded transactions sits between the two, and the site thread
+ * takes them in log order.
+ *
+ * The helper only ever reads the log buffer.  Deserializing the rows
+ * allocates from the site's string pool and the tables' temp tuples, so it
+ * is left to the site thread as it applies each transaction.
+ */
+class BinaryLogPipeline {
+public:
+    /** depth is the most transactions decoded ahead of the site thread. */
+    explicit BinaryLogPipeline(std::size_t depth);
+    ~BinaryLogPipeline();
+
+    /** False if the helper thread could not be started. */
+    bool hasHelper() const {
+        return m_threadStarted;
+    }
+
+    /** Start decoding the transactions of a buffer of binary logs. */
+    void start(const char *logs, std::size_t length);
+
+    /**
+     * Wait for the next transaction of the buffer.  Return NULL at the end
+     * of the buffer.  If decoding failed, rethrow its exception once the
+     * transactions before the failure have been returned.  The transaction
+     * belongs to the caller until the next call.
+     */
+    BinaryLogSink::DRTxn *next();
+
+    /**
+     * Stop decoding the buffer and wait for the helper to let go of it.
+     * Must be called before the buffer is reused, even if next() threw.
+     */
+    void finish();
+
+private:
+    static void *helperMain(void *pipeline);
+
+    /** Decode the current buffer.  Called, and returns, with m_mutex held. */
+    void decodeLocked();
+
+    std::vector<BinaryLogSink::DRTxn> m_txns;
+    pthread_t m_thread;
+    bool m_threadStarted;
+    pthread_mutex_t m_mutex;
+    // signalled when a buffer is started, a transaction is handed back, or on cancel
+    pthread_cond_t m_workAvailable;
+    // signalled when a transaction is decoded or the helper is done with the buffer
+    pthread_cond_t m_txnReady;
+
+    // The current buffer, all guarded by m_mutex.
+    const char *m_logs;
+    std::size_t m_length;
+    // the next transaction next() returns, and the number decoded from there
+    std::size_t m_nextTxn;
+    std::size_t m_decodedTxns;
+    // whether the caller still has the last transaction next() returned
+    bool m_holdingTxn;
+    bool m_decoding;
+    bool m_cancelled;
+    bool m_stopping;
+    std::exception_ptr m_failure;
+
+    // No implicit copies
+    BinaryLogPipeline(const BinaryLogPipeline&);
+    BinaryLogPipeline& operator=(const BinaryLogPipeline&);
+};
+
+}
+#endif
@@ -36,6 +36,8 @@
 
 #include <crc/crc32c.h>
 
+#include <algorithm>
+#include <cstring>
 #include <string>
 
 namespace voltdb {
@@ -484,47 +486,139 @@ bool handleConflict(VoltDBEngine *engine, PersistentTable *drTable, Pool *pool,
     return true;
 }
 
+/**
+ * Orders positions in a run by the primary key of their expected tuples.
+ */
+class PrimaryKeyOrder {
+public:
+    PrimaryKeyOrder(const std::vector<int> &columns, const std::vector<TableTuple> &tuples)
+        : m_columns(columns), m_tuples(tuples)
+    {
+    }
+
+    bool operator()(size_t lhs, size_t rhs) const {
+        BOOST_FOREACH(int column, m_columns) {
+            int comparison = m_tuples[lhs].getNValue(column).compare(m_tuples[rhs].getNValue(column));
+            if (comparison != 0) {
+                return comparison < 0;
+            }
+        }
+        return false;
+    }
+
+private:
+    const std::vector<int> &m_columns;
+    const std::vector<TableTuple> &m_tuples;
+};
+
+/**
+ * A hash of the tuple's storage that is the same for any two tuples
+ * BinaryLogSink::lookupRun() counts as equal.  Tuples without object
+ * columns are compared byte for byte, so all their bytes are hashed.
+ * Others are compared value by value, where equal strings or doubles
+ * need not have equal bytes, so only their integer and decimal columns
+ * are hashed.
+ */
+size_t lookupHash(const TableTuple &tuple, bool compareObjects) {
+    const TupleSchema *schema = tuple.getSchema();
+    const char *data = tuple.address() + TUPLE_HEADER_SIZE;
+    if (!compareObjects) {
+        return boost::hash_range(data, data + schema->tupleLength());
+    }
+    size_t seed = 0;
+    for (int i = 0; i < schema->columnCount(); ++i) {
+        const TupleSchema::ColumnInfo *columnInfo = schema->getColumnInfo(i);
+        const ValueType type = columnInfo->getVoltType();
+        switch (type) {
+        case VALUE_TYPE_TINYINT:
+        case VALUE_TYPE_SMALLINT:
+        case VALUE_TYPE_INTEGER:
+        case VALUE_TYPE_BIGINT:
+        case VALUE_TYPE_TIMESTAMP:
+        case VALUE_TYPE_DECIMAL: {
+            const char *value = data + columnInfo->offset;
+            boost::hash_range(seed, value, value + NValue::getTupleStorageSize(type));
+            break;
+        }
+        default:
+            break;
+        }
+    }
+    return seed;
+}
+
 } //end of anonymous namespace
 
-BinaryLogSink::BinaryLogSink() {}
+BinaryLogSink::BinaryLogSink() : m_batchApply(false) {}
 
 int64_t BinaryLogSink::applyTxn(ReferenceSerializeInputLE *taskInfo,
                                 boost::unordered_map<int64_t, PersistentTable*> &tables,
                                 Pool *pool, VoltDBEngine *engine, int32_t remoteClusterId,
                                 const char *txnStart,
                                 int64_t localUniqueId) {
-    int64_t      rowCount = 0;
+    decodeTxn(taskInfo, txnStart, m_txn);
+    return applyDecodedTxn(m_txn, tables, pool, engine, remoteClusterId, localUniqueId);
+}
+
+void BinaryLogSink::decodeTxn(ReferenceSerializeInputLE *taskInfo, const char *txnStart, DRTxn &txn) {
     DRRecordType type;
-    int64_t      uniqueId;
-    int64_t      sequenceNumber;
     int32_t      partitionHash;
-    bool         isCurrentTxnForReplicatedTable;
     bool         isCurrentRecordForReplicatedTable;
-    bool         isForLocalPartition;
-    bool         skipWrongHashRows;
 
     type = static_cast<DRRecordType>(taskInfo->readByte());
     assert(type == DR_RECORD_BEGIN_TXN);
-    uniqueId = taskInfo->readLong();
-    sequenceNumber = taskInfo->readLong();
+    txn.m_uniqueId = taskInfo->readLong();
+    txn.m_sequenceNumber = taskInfo->readLong();
 
     int8_t rawHashFlag = taskInfo->readByte();
     isCurrentRecordForReplicatedTable = rawHashFlag & REPLICATED_TABLE_MASK;
-    DRTxnPartitionHashFlag hashFlag = static_cast<DRTxnPartitionHashFlag>(rawHashFlag & ~REPLICATED_TABLE_MASK);
-    isCurrentTxnForReplicatedTable = hashFlag == TXN_PAR_HASH_REPLICATED;
+    txn.m_hashFlag = static_cast<DRTxnPartitionHashFlag>(rawHashFlag & ~REPLICATED_TABLE_MASK);
     taskInfo->readInt();  // txnLength
     partitionHash = taskInfo->readInt();
-    bool isLocalMpTxn = UniqueId::isMpUniqueId(localUniqueId);
-    bool isLocalRegularSpTxn = !isLocalMpTxn && (hashFlag == TXN_PAR_HASH_SINGLE || hashFlag == TXN_PAR_HASH_MULTI);
-    bool isLocalRegularMpTxn = isLocalMpTxn && (hashFlag == TXN_PAR_HASH_SINGLE || hashFlag == TXN_PAR_HASH_MULTI);
+    txn.m_records.clear();
     // Read the whole txn since there is only one version number at the beginning
     type = static_cast<DRRecordType>(taskInfo->readByte());
     while (type != DR_RECORD_END_TXN) {
+        txn.m_records.push_back(DRRecord());
+        DRRecord &record = txn.m_records.back();
+        record.m_partitionHash = partitionHash;
+        record.m_forReplicatedTable = isCurrentRecordForReplicatedTable;
+        readRecord(taskInfo, type, record);
+        int8_t rawType = taskInfo->readByte();
+        type = static_cast<DRRecordType>(rawType & ~REPLICATED_TABLE_MASK);
+        if (type == DR_RECORD_HASH_DELIMITER) {
+            isCurrentRecordForReplicatedTable = rawType & REPLICATED_TABLE_MASK;
+            partitionHash = taskInfo->readInt();
+            type = static_cast<DRRecordType>(taskInfo->readByte());
+        }
+    }
+
+    int64_t tempSequenceNumber = taskInfo->readLong();
+    if (tempSequenceNumber != txn.m_sequenceNumber) {
+        throwFatalException("Closing the wrong transaction inside a binary log segment. Expected %jd but found %jd",
+                            (intmax_t)txn.m_sequenceNumber, (intmax_t)tempSequenceNumber);
+    }
+    uint32_t checksum = taskInfo->readInt();
+    validateChecksum(checksum, txnStart, taskInfo->getRawPointer());
+}
+
+int64_t BinaryLogSink::applyDecodedTxn(DRTxn &txn,
+                                       boost::unordered_map<int64_t, PersistentTable*> &tables,
+                                       Pool *pool, VoltDBEngine *engine, int32_t remoteClusterId,
+                                       int64_t localUniqueId) {
+    int64_t      rowCount = 0;
+    bool         isForLocalPartition;
+
+    bool isCurrentTxnForReplicatedTable = txn.m_hashFlag == TXN_PAR_HASH_REPLICATED;
+    bool isLocalMpTxn = UniqueId::isMpUniqueId(localUniqueId);
+    bool isLocalRegularSpTxn = !isLocalMpTxn && (txn.m_hashFlag == TXN_PAR_HASH_SINGLE || txn.m_hashFlag == TXN_PAR_HASH_MULTI);
+    bool isLocalRegularMpTxn = isLocalMpTxn && (txn.m_hashFlag == TXN_PAR_HASH_SINGLE || txn.m_hashFlag == TXN_PAR_HASH_MULTI);
+    BOOST_FOREACH(DRRecord &record, txn.m_records) {
         // fast path for replicated table change, save calls to VoltDBEngine::isLocalSite()
-        if (isCurrentTxnForReplicatedTable || isCurrentRecordForReplicatedTable) {
-            skipWrongHashRows = false;
+        if (isCurrentTxnForReplicatedTable || record.m_forReplicatedTable) {
+            record.m_skipRow = false;
         } else {
-            isForLocalPartition = engine->isLocalSite(partitionHash);
+            isForLocalPartition = engine->isLocalSite(record.m_partitionHash);
             // - Remote MP txns are always executed as local MP txns. Skip hashes that don't match for these.
             // - Remote single-hash SP txns must throw mispartitioned exception for hashes that don't match.
             // - Remote SP txns with multihash will be routed as MP txns for mixed size clusters.
@@ -540,58 +634,86 @@ int64_t BinaryLogSink::applyTxn(ReferenceSerializeInputLE *taskInfo,
                 /** temporary debug stmts **/
                 /*
                 VOLT_ERROR("Throwing mispartitioned from site with partitionId=%d", engine->getPartitionId());
-                VOLT_ERROR("hashFlag=%d, partitionHash=%d, drRecordType=%d", (int) hashFlag, partitionHash, (int) type);
+                VOLT_ERROR("hashFlag=%d, partitionHash=%d, drRecordType=%d", (int) txn.m_hashFlag, record.m_partitionHash, (int) record.m_type);
                 */
                 throw SerializableEEException(VOLT_EE_EXCEPTION_TYPE_TXN_MISPARTITIONED,
                     "Binary log txns were sent to the wrong partition");
             }
-            skipWrongHashRows = (!isForLocalPartition && isLocalRegularMpTxn);
+            record.m_skipRow = (!isForLocalPartition && isLocalRegularMpTxn);
         }
-        rowCount += apply(taskInfo, type, tables, pool, engine, remoteClusterId,
-                txnStart, sequenceNumber, uniqueId, skipWrongHashRows);
-        int8_t rawType = taskInfo->readByte();
-        type = static_cast<DRRecordType>(rawType & ~REPLICATED_TABLE_MASK);
-        if (type == DR_RECORD_HASH_DELIMITER) {
-            isCurrentRecordForReplicatedTable = rawType & REPLICATED_TABLE_MASK;
-            partitionHash = taskInfo->readInt();
-            type = static_cast<DRRecordType>(taskInfo->readByte());
+        if (!m_batchApply) {
+            rowCount += apply(record, tables, pool, engine, remoteClusterId, txn.m_sequenceNumber, txn.m_uniqueId);
         }
     }
 
-    int64_t tempSequenceNumber = taskInfo->readLong();
-    if (tempSequenceNumber != sequenceNumber) {
-        throwFatalException("Closing the wrong transaction inside a binary log segment. Expected %jd but found %jd",
-                            (intmax_t)sequenceNumber, (intmax_t)tempSequenceNumber);
+    if (m_batchApply) {
+        rowCount += applyBatch(txn.m_records, tables, pool, engine, remoteClusterId,
+                               txn.m_sequenceNumber, txn.m_uniqueId);
     }
-    uint32_t checksum = taskInfo->readInt();
-    validateChecksum(checksum, txnStart, taskInfo->getRawPointer());
 
     return rowCount;
 }
 
-int64_t BinaryLogSink::apply(ReferenceSerializeInputLE *taskInfo, const DRRecordType type,
+void BinaryLogSink::readRecord(ReferenceSerializeInputLE *taskInfo, const DRRecordType type, DRRecord &record) {
+    record.m_type = type;
+    record.m_skipRow = false;
+    switch (type) {
+    case DR_RECORD_INSERT:
+    case DR_RECORD_DELETE: {
+        record.m_tableHandle = taskInfo->readLong();
+        record.m_rowLength = taskInfo->readInt();
+        record.m_rowData = reinterpret_cast<const char *>(taskInfo->getRawPointer(record.m_rowLength));
+        break;
+    }
+    case DR_RECORD_UPDATE: {
+        record.m_tableHandle = taskInfo->readLong();
+        record.m_rowLength = taskInfo->readInt();
+        record.m_rowData = reinterpret_cast<const char *>(taskInfo->getRawPointer(record.m_rowLength));
+        record.m_newRowLength = taskInfo->readInt();
+        record.m_newRowData = reinterpret_cast<const char *>(taskInfo->getRawPointer(record.m_newRowLength));
+        break;
+    }
+    case DR_RECORD_DELETE_BY_INDEX: {
+        throwSerializableEEException("Delete by index is not supported for DR");
+    }
+    case DR_RECORD_UPDATE_BY_INDEX: {
+        throwSerializableEEException("Update by index is not supported for DR");
+    }
+    case DR_RECORD_TRUNCATE_TABLE: {
+        record.m_tableHandle = taskInfo->readLong();
+        record.m_tableName = taskInfo->readTextString();
+        break;
+    }
+    case DR_RECORD_BEGIN_TXN: {
+        throwFatalException("Unexpected BEGIN_TXN before END_TXN");
+        break;
+    }
+    default:
+        throwFatalException("Unrecognized DR record type %d", type);
+        break;
+    }
+}
+
+int64_t BinaryLogSink::apply(const DRRecord &record,
                              boost::unordered_map<int64_t, PersistentTable*> &tables,
                              Pool *pool, VoltDBEngine *engine, int32_t remoteClusterId,
-                             const char *txnStart, int64_t sequenceNumber, int64_t uniqueId, bool skipRow) {
-    switch (type) {
+                             int64_t sequenceNumber, int64_t uniqueId) {
+    switch (record.m_type) {
     case DR_RECORD_INSERT: {
-        int64_t tableHandle = taskInfo->readLong();
-        int32_t rowLength = taskInfo->readInt();
-        const char *rowData = reinterpret_cast<const char *>(taskInfo->getRawPointer(rowLength));
-        if (skipRow) {
+        if (record.m_skipRow) {
             break;
         }
 
-        boost::unordered_map<int64_t, PersistentTable*>::iterator tableIter = tables.find(tableHandle);
+        boost::unordered_map<int64_t, PersistentTable*>::iterator tableIter = tables.find(record.m_tableHandle);
         if (tableIter == tables.end()) {
             throwSerializableEEException("Unable to find table hash %jd while applying a binary log insert record",
-                                         (intmax_t)tableHandle);
+                                         (intmax_t)record.m_tableHandle);
         }
         PersistentTable *table = tableIter->second;
 
         TableTuple tempTuple = table->tempTuple();
 
-        ReferenceSerializeInputLE rowInput(rowData, rowLength);
+        ReferenceSerializeInputLE rowInput(record.m_rowData, record.m_rowLength);
         try {
             tempTuple.deserializeFromDR(rowInput, pool);
         } catch (SerializableEEException &e) {
@@ -613,23 +735,20 @@ int64_t BinaryLogSink::apply(ReferenceSerializeInputLE *taskInfo, const DRRecord
         break;
     }
     case DR_RECORD_DELETE: {
-        int64_t tableHandle = taskInfo->readLong();
-        int32_t rowLength = taskInfo->readInt();
-        const char *rowData = reinterpret_cast<const char *>(taskInfo->getRawPointer(rowLength));
-        if (skipRow) {
+        if (record.m_skipRow) {
             break;
         }
 
-        boost::unordered_map<int64_t, PersistentTable*>::iterator tableIter = tables.find(tableHandle);
+        boost::unordered_map<int64_t, PersistentTable*>::iterator tableIter = tables.find(record.m_tableHandle);
         if (tableIter == tables.end()) {
             throwSerializableEEException("Unable to find table hash %jd while applying a binary log delete record",
-                                         (intmax_t)tableHandle);
+                                         (intmax_t)record.m_tableHandle);
         }
         PersistentTable *table = tableIter->second;
 
         TableTuple tempTuple = table->tempTuple();
 
-        ReferenceSerializeInputLE rowInput(rowData, rowLength);
+        ReferenceSerializeInputLE rowInput(record.m_rowData, record.m_rowLength);
         try {
             tempTuple.deserializeFromDR(rowInput, pool);
         } catch (SerializableEEException &e) {
@@ -638,53 +757,24 @@ int64_t BinaryLogSink::apply(ReferenceSerializeInputLE *taskInfo, const DRRecord
         }
 
         TableTuple deleteTuple = table->lookupTupleForDR(tempTuple);
-        if (deleteTuple.isNullTuple()) {
-            if (engine->getIsActiveActiveDREnabled()) {
-                if (handleConflict(engine, table, pool, NULL, &tempTuple, NULL, uniqueId, remoteClusterId, DR_RECORD_DELETE, CONFLICT_EXPECTED_ROW_MISSING, NO_CONFLICT)) {
-                    break;
-                }
-            }
-            throwSerializableEEException("Unable to find tuple for deletion: binary log type (%d), DR ID (%jd), unique ID (%jd), tuple %s\n",
-                                             type, (intmax_t)sequenceNumber, (intmax_t)uniqueId, tempTuple.debug(table->name()).c_str());
-        }
-
-        // we still run in risk of having timestamp mismatch, need to check.
-        if (engine->getIsActiveActiveDREnabled()) {
-            NValue localHiddenColumn = deleteTuple.getHiddenNValue(table->getDRTimestampColumnIndex());
-            int64_t localTimestamp = ExecutorContext::getDRTimestampFromHiddenNValue(localHiddenColumn);
-            NValue remoteHiddenColumn = tempTuple.getHiddenNValue(table->getDRTimestampColumnIndex());
-            int64_t remoteTimestamp = ExecutorContext::getDRTimestampFromHiddenNValue(remoteHiddenColumn);
-            if (localTimestamp != remoteTimestamp) {
-                // timestamp mismatch conflict
-                if (handleConflict(engine, table, pool, &deleteTuple, &tempTuple, NULL, uniqueId, remoteClusterId, DR_RECORD_DELETE, CONFLICT_EXPECTED_ROW_MISMATCH, NO_CONFLICT)) {
-                    break;
-                }
-            }
-        }
-
-        table->deleteTuple(deleteTuple, true);
+        applyDelete(table, tempTuple, deleteTuple, pool, engine, remoteClusterId, sequenceNumber, uniqueId);
         break;
     }
     case DR_RECORD_UPDATE: {
-        int64_t tableHandle = taskInfo->readLong();
-        int32_t oldRowLength = taskInfo->readInt();
-        const char *oldRowData = reinterpret_cast<const char*>(taskInfo->getRawPointer(oldRowLength));
-        int32_t newRowLength = taskInfo->readInt();
-        const char *newRowData = reinterpret_cast<const char*>(taskInfo->getRawPointer(newRowLength));
-        if (skipRow) {
+        if (record.m_skipRow) {
             break;
         }
 
-        boost::unordered_map<int64_t, PersistentTable*>::iterator tableIter = tables.find(tableHandle);
+        boost::unordered_map<int64_t, PersistentTable*>::iterator tableIter = tables.find(record.m_tableHandle);
         if (tableIter == tables.end()) {
             throwSerializableEEException("Unable to find table hash %jd while applying a binary log update record",
-                                         (intmax_t)tableHandle);
+                                         (intmax_t)record.m_tableHandle);
         }
         PersistentTable *table = tableIter->second;
 
         TableTuple tempTuple = table->tempTuple();
 
-        ReferenceSerializeInputLE oldRowInput(oldRowData, oldRowLength);
+        ReferenceSerializeInputLE oldRowInput(record.m_rowData, record.m_rowLength);
         try {
             tempTuple.deserializeFromDR(oldRowInput, pool);
         } catch (SerializableEEException &e) {
@@ -698,7 +788,7 @@ int64_t BinaryLogSink::apply(ReferenceSerializeInputLE *taskInfo, const DRRecord
         expectedTuple.move(expectedData.get());
         expectedTuple.copyForPersistentInsert(tempTuple, pool);
 
-        ReferenceSerializeInputLE newRowInput(newRowData, newRowLength);
+        ReferenceSerializeInputLE newRowInput(record.m_newRowData, record.m_newRowLength);
         try {
             tempTuple.deserializeFromDR(newRowInput, pool);
         } catch (SerializableEEException &e) {
@@ -707,82 +797,300 @@ int64_t BinaryLogSink::apply(ReferenceSerializeInputLE *taskInfo, const DRRecord
         }
 
         TableTuple oldTuple = table->lookupTupleForDR(expectedTuple);
-        if (oldTuple.isNullTuple()) {
-            if (engine->getIsActiveActiveDREnabled()) {
-                if (handleConflict(engine, table, pool, NULL, &expectedTuple,
-                                   &tempTuple, uniqueId, remoteClusterId,
-                                   DR_RECORD_UPDATE, CONFLICT_EXPECTED_ROW_MISSING,
-                                   NO_CONFLICT)) {
-                    break;
-                }
+        applyUpdate(table, expectedTuple, tempTuple, oldTuple, pool, engine, remoteClusterId, sequenceNumber, uniqueId);
+        break;
+    }
+    case DR_RECORD_TRUNCATE_TABLE: {
+        // ignore the value of skipRow for truncate table record
+
+        boost::unordered_map<int64_t, PersistentTable*>::iterator tableIter = tables.find(record.m_tableHandle);
+        if (tableIter == tables.end()) {
+            throwSerializableEEException("Unable to find table %s hash %jd while applying binary log for truncate record",
+                                         record.m_tableName.c_str(), (intmax_t)record.m_tableHandle);
+        }
+
+        PersistentTable *table = tableIter->second;
+
+        table->truncateTable(engine, true);
+
+        break;
+    }
+    default:
+        // readRecord() has rejected the other types
+        assert(false);
+        break;
+    }
+    return static_cast<int64_t>(rowCostForDRRecord(record.m_type));
+}
+
+bool BinaryLogSink::applyDelete(PersistentTable *table, TableTuple &expectedTuple, TableTuple &deleteTuple,
+                                Pool *pool, VoltDBEngine *engine, int32_t remoteClusterId,
+                                int64_t sequenceNumber, int64_t uniqueId) {
+    if (deleteTuple.isNullTuple()) {
+        if (engine->getIsActiveActiveDREnabled()) {
+            if (handleConflict(engine, table, pool, NULL, &expectedTuple, NULL, uniqueId, remoteClusterId, DR_RECORD_DELETE, CONFLICT_EXPECTED_ROW_MISSING, NO_CONFLICT)) {
+                return true;
+            }
+        }
+        throwSerializableEEException("Unable to find tuple for deletion: binary log type (%d), DR ID (%jd), unique ID (%jd), tuple %s\n",
+                                     DR_RECORD_DELETE, (intmax_t)sequenceNumber, (intmax_t)uniqueId, expectedTuple.debug(table->name()).c_str());
+    }
+
+    // we still run in risk of having timestamp mismatch, need to check.
+    if (engine->getIsActiveActiveDREnabled()) {
+        NValue localHiddenColumn = deleteTuple.getHiddenNValue(table->getDRTimestampColumnIndex());
+        int64_t localTimestamp = ExecutorContext::getDRTimestampFromHiddenNValue(localHiddenColumn);
+        NValue remoteHiddenColumn = expectedTuple.getHiddenNValue(table->getDRTimestampColumnIndex());
+        int64_t remoteTimestamp = ExecutorContext::getDRTimestampFromHiddenNValue(remoteHiddenColumn);
+        if (localTimestamp != remoteTimestamp) {
+            // timestamp mismatch conflict
+            if (handleConflict(engine, table, pool, &deleteTuple, &expectedTuple, NULL, uniqueId, remoteClusterId, DR_RECORD_DELETE, CONFLICT_EXPECTED_ROW_MISMATCH, NO_CONFLICT)) {
+                return true;
             }
-            throwSerializableEEException("Unable to find tuple for update: binary log type (%d), DR ID (%jd), unique ID (%jd), tuple %s\n",
-                                     type, (intmax_t)sequenceNumber, (intmax_t)uniqueId, tempTuple.debug(table->name()).c_str());
         }
+    }
 
-        // Timestamp mismatch conflict
+    table->deleteTuple(deleteTuple, true);
+    return false;
+}
+
+bool BinaryLogSink::applyUpdate(PersistentTable *table, TableTuple &expectedTuple, TableTuple &newTuple,
+                                TableTuple &oldTuple, Pool *pool, VoltDBEngine *engine, int32_t remoteClusterId,
+                                int64_t sequenceNumber, int64_t uniqueId) {
+    if (oldTuple.isNullTuple()) {
         if (engine->getIsActiveActiveDREnabled()) {
-            NValue localHiddenColumn = oldTuple.getHiddenNValue(table->getDRTimestampColumnIndex());
-            int64_t localTimestamp = ExecutorContext::getDRTimestampFromHiddenNValue(localHiddenColumn);
-            NValue remoteHiddenColumn = expectedTuple.getHiddenNValue(table->getDRTimestampColumnIndex());
-            int64_t remoteTimestamp = ExecutorContext::getDRTimestampFromHiddenNValue(remoteHiddenColumn);
-            if (localTimestamp != remoteTimestamp) {
-                if (handleConflict(engine, table, pool, &oldTuple, &expectedTuple,
-                                   &tempTuple, uniqueId, remoteClusterId,
-                                   DR_RECORD_UPDATE, CONFLICT_EXPECTED_ROW_MISMATCH,
-                                   NO_CONFLICT)) {
-                    break;
-                }
+            if (handleConflict(engine, table, pool, NULL, &expectedTuple,
+                               &newTuple, uniqueId, remoteClusterId,
+                               DR_RECORD_UPDATE, CONFLICT_EXPECTED_ROW_MISSING,
+                               NO_CONFLICT)) {
+                return true;
             }
         }
+        throwSerializableEEException("Unable to find tuple for update: binary log type (%d), DR ID (%jd), unique ID (%jd), tuple %s\n",
+                                     DR_RECORD_UPDATE, (intmax_t)sequenceNumber, (intmax_t)uniqueId, newTuple.debug(table->name()).c_str());
+    }
 
-        try {
-            table->updateTupleWithSpecificIndexes(oldTuple, tempTuple, table->allIndexes(), true, false);
-        } catch (ConstraintFailureException &e) {
-            if (engine->getIsActiveActiveDREnabled()) {
-                if (handleConflict(engine, table, pool, NULL, e.getOriginalTuple(),
-                                   const_cast<TableTuple *>(e.getConflictTuple()),
-                                   uniqueId, remoteClusterId, DR_RECORD_UPDATE,
-                                   NO_CONFLICT, CONFLICT_CONSTRAINT_VIOLATION)) {
-                    break;
-                }
+    // Timestamp mismatch conflict
+    if (engine->getIsActiveActiveDREnabled()) {
+        NValue localHiddenColumn = oldTuple.getHiddenNValue(table->getDRTimestampColumnIndex());
+        int64_t localTimestamp = ExecutorContext::getDRTimestampFromHiddenNValue(localHiddenColumn);
+        NValue remoteHiddenColumn = expectedTuple.getHiddenNValue(table->getDRTimestampColumnIndex());
+        int64_t remoteTimestamp = ExecutorContext::getDRTimestampFromHiddenNValue(remoteHiddenColumn);
+        if (localTimestamp != remoteTimestamp) {
+            if (handleConflict(engine, table, pool, &oldTuple, &expectedTuple,
+                               &newTuple, uniqueId, remoteClusterId,
+                               DR_RECORD_UPDATE, CONFLICT_EXPECTED_ROW_MISMATCH,
+                               NO_CONFLICT)) {
+                return true;
             }
-            throw;
         }
-        break;
     }
-    case DR_RECORD_DELETE_BY_INDEX: {
-        throwSerializableEEException("Delete by index is not supported for DR");
+
+    try {
+        table->updateTupleWithSpecificIndexes(oldTuple, newTuple, table->allIndexes(), true, false);
+    } catch (ConstraintFailureException &e) {
+        if (engine->getIsActiveActiveDREnabled()) {
+            if (handleConflict(engine, table, pool, NULL, e.getOriginalTuple(),
+                               const_cast<TableTuple *>(e.getConflictTuple()),
+                               uniqueId, remoteClusterId, DR_RECORD_UPDATE,
+                               NO_CONFLICT, CONFLICT_CONSTRAINT_VIOLATION)) {
+                return true;
+            }
+        }
+        throw;
     }
-    case DR_RECORD_UPDATE_BY_INDEX: {
-        throwSerializableEEException("Update by index is not supported for DR");
+    return false;
+}
+
+int64_t BinaryLogSink::applyBatch(const std::vector<DRRecord> &records,
+                                  boost::unordered_map<int64_t, PersistentTable*> &tables,
+                                  Pool *pool, VoltDBEngine *engine, int32_t remoteClusterId,
+                                  int64_t sequenceNumber, int64_t uniqueId) {
+    int64_t rowCount = 0;
+    size_t next = 0;
+    while (next < records.size()) {
+        const DRRecord &record = records[next];
+        size_t end = next + 1;
+        if (record.m_type == DR_RECORD_DELETE || record.m_type == DR_RECORD_UPDATE) {
+            while (end < records.size() &&
+                   records[end].m_type == record.m_type &&
+                   records[end].m_tableHandle == record.m_tableHandle) {
+                ++end;
+            }
+        }
+        if (end - next > 1) {
+            rowCount += applyRun(records, next, end, tables, pool, engine, remoteClusterId, sequenceNumber, uniqueId);
+        }
+        else {
+            rowCount += apply(record, tables, pool, engine, remoteClusterId, sequenceNumber, uniqueId);
+        }
+        next = end;
     }
-    case DR_RECORD_TRUNCATE_TABLE: {
-        int64_t tableHandle = taskInfo->readLong();
-        std::string tableName = taskInfo->readTextString();
-        // ignore the value of skipRow for truncate table record
+    return rowCount;
+}
 
-        boost::unordered_map<int64_t, PersistentTable*>::iterator tableIter = tables.find(tableHandle);
-        if (tableIter == tables.end()) {
-            throwSerializableEEException("Unable to find table %s hash %jd while applying binary log for truncate record",
-                                         tableName.c_str(), (intmax_t)tableHandle);
+int64_t BinaryLogSink::applyRun(const std::vector<DRRecord> &records, size_t first, size_t end,
+                                boost::unordered_map<int64_t, PersistentTable*> &tables,
+                                Pool *pool, VoltDBEngine *engine, int32_t remoteClusterId,
+                                int64_t sequenceNumber, int64_t uniqueId) {
+    const DRRecordType type = records[first].m_type;
+    const int64_t rowCost = static_cast<int64_t>(rowCostForDRRecord(type));
+    int64_t rowCount = 0;
+
+    std::vector<size_t> positions;
+    positions.reserve(end - first);
+    for (size_t position = first; position < end; ++position) {
+        if (records[position].m_skipRow) {
+            rowCount += rowCost;
+        }
+        else {
+            positions.push_back(position);
         }
+    }
+    if (positions.empty()) {
+        return rowCount;
+    }
 
-        PersistentTable *table = tableIter->second;
+    const int64_t tableHandle = records[first].m_tableHandle;
+    boost::unordered_map<int64_t, PersistentTable*>::iterator tableIter = tables.find(tableHandle);
+    if (tableIter == tables.end()) {
+        throwSerializableEEException("Unable to find table hash %jd while applying a binary log %s record",
+                                     (intmax_t)tableHandle, type == DR_RECORD_DELETE ? "delete" : "update");
+    }
+    PersistentTable *table = tableIter->second;
+
+    // Deserialize the rows each record expects to find.
+    const size_t tupleLength = table->getTupleLength();
+    m_runTupleData.assign(positions.size() * tupleLength, 0);
+    std::vector<TableTuple> expectedTuples(positions.size(), TableTuple(table->schema()));
+    for (size_t i = 0; i < positions.size(); ++i) {
+        const DRRecord &record = records[positions[i]];
+        expectedTuples[i].move(&m_runTupleData[i * tupleLength]);
+        ReferenceSerializeInputLE rowInput(record.m_rowData, record.m_rowLength);
+        try {
+            expectedTuples[i].deserializeFromDR(rowInput, pool);
+        } catch (SerializableEEException &e) {
+            e.appendContextToMessage(type == DR_RECORD_DELETE ?
+                                     " DR binary log delete on table " + table->name() :
+                                     " DR binary log update (old tuple) on table " + table->name());
+            throw;
+        }
+    }
 
-        table->truncateTable(engine, true);
+    std::vector<char*> matches(positions.size(), static_cast<char*>(NULL));
+    lookupRun(table, expectedTuples, matches);
+
+    // Apply the records in log order.  A row found above is still the one
+    // lookupTupleForDR() would return unless an earlier record of the run
+    // deleted or updated it; an update may also have produced a row that
+    // was missing.  Look those up again.
+    boost::unordered_set<char*> changedRows;
+    for (size_t i = 0; i < positions.size(); ++i) {
+        const DRRecord &record = records[positions[i]];
+        TableTuple localTuple(table->schema());
+        if (matches[i] != NULL && changedRows.find(matches[i]) == changedRows.end()) {
+            localTuple.move(matches[i]);
+        }
+        else if (matches[i] != NULL || (type == DR_RECORD_UPDATE && !changedRows.empty())) {
+            localTuple = table->lookupTupleForDR(expectedTuples[i]);
+        }
+        if (!localTuple.isNullTuple()) {
+            changedRows.insert(localTuple.address());
+        }
 
-        break;
+        bool conflictHandled;
+        if (type == DR_RECORD_DELETE) {
+            conflictHandled = applyDelete(table, expectedTuples[i], localTuple, pool, engine, remoteClusterId,
+                                          sequenceNumber, uniqueId);
+        }
+        else {
+            TableTuple tempTuple = table->tempTuple();
+            ReferenceSerializeInputLE newRowInput(record.m_newRowData, record.m_newRowLength);
+            try {
+                tempTuple.deserializeFromDR(newRowInput, pool);
+            } catch (SerializableEEException &e) {
+                e.appendContextToMessage(" DR binary log update (new tuple) on table " + table->name());
+                throw;
+            }
+            conflictHandled = applyUpdate(table, expectedTuples[i], tempTuple, localTuple, pool, engine,
+                                          remoteClusterId, sequenceNumber, uniqueId);
+        }
+        rowCount += rowCost;
+
+        if (conflictHandled) {
+            // Resolving the conflict may have changed any row of the table,
+            // so the rows found for the rest of the run can't be trusted.
+            for (++i; i < positions.size(); ++i) {
+                rowCount += apply(records[positions[i]], tables, pool, engine, remoteClusterId,
+                                  sequenceNumber, uniqueId);
+            }
+            break;
+        }
     }
-    case DR_RECORD_BEGIN_TXN: {
-        throwFatalException("Unexpected BEGIN_TXN before END_TXN");
-        break;
+    return rowCount;
+}
+
+void BinaryLogSink::lookupRun(PersistentTable *table, const std::vector<TableTuple> &expectedTuples,
+                              std::vector<char*> &matches) {
+    TableIndex *pkeyIndex = table->primaryKeyIndex();
+    if (pkeyIndex) {
+        // Probe the primary key index in key order, so that neighbouring
+        // probes of a tree index share most of their path.
+        std::vector<size_t> order(expectedTuples.size());
+        for (size_t i = 0; i < order.size(); ++i) {
+            order[i] = i;
+        }
+        if (pkeyIndex->getIndexedExpressions().empty()) {
+            std::stable_sort(order.begin(), order.end(),
+                             PrimaryKeyOrder(pkeyIndex->getColumnIndices(), expectedTuples));
+        }
+        BOOST_FOREACH(size_t i, order) {
+            TableTuple match = table->lookupTupleForDR(expectedTuples[i]);
+            if (!match.isNullTuple()) {
+                matches[i] = match.address();
+            }
+        }
+        return;
     }
-    default:
-        throwFatalException("Unrecognized DR record type %d", type);
-        break;
+
+    // Without a primary key every lookup is a table scan.  Find all the
+    // run's rows in one scan instead, comparing them the way
+    // PersistentTable::lookupTuple() does, and take the first match of each.
+    // The rows are bucketed by a hash that agrees with that comparison;
+    // TableTuple::hashCode() does not, e.g. for VARCHARs that differ only
+    // after an embedded zero byte.
+    const TupleSchema *schema = table->schema();
+    const bool compareObjects = schema->getUninlinedObjectColumnCount() != 0;
+    const size_t length = schema->tupleLength();
+    boost::unordered_multimap<size_t, size_t> expectedByHash;
+    for (size_t i = 0; i < expectedTuples.size(); ++i) {
+        expectedByHash.insert(std::make_pair(lookupHash(expectedTuples[i], compareObjects), i));
+    }
+
+    size_t unmatched = expectedTuples.size();
+    TableTuple tableTuple(schema);
+    TableIterator iter = table->iterator();
+    while (unmatched > 0 && iter.next(tableTuple)) {
+        std::pair<boost::unordered_multimap<size_t, size_t>::iterator,
+                  boost::unordered_multimap<size_t, size_t>::iterator> candidates =
+            expectedByHash.equal_range(lookupHash(tableTuple, compareObjects));
+        for (boost::unordered_multimap<size_t, size_t>::iterator candidate = candidates.first;
+             candidate != candidates.second; ++candidate) {
+            size_t i = candidate->second;
+            if (matches[i] != NULL) {
+                continue;
+            }
+            const TableTuple &expectedTuple = expectedTuples[i];
+            bool equal = compareObjects ?
+                tableTuple.equalsNoSchemaCheck(expectedTuple, true) :
+                ::memcmp(tableTuple.address() + TUPLE_HEADER_SIZE,
+                         expectedTuple.address() + TUPLE_HEADER_SIZE, length) == 0;
+            if (equal) {
+                matches[i] = tableTuple.address();
+                --unmatched;
+            }
+        }
     }
-    return static_cast<int64_t>(rowCostForDRRecord(type));
 }
 
 }
@@ -19,14 +19,19 @@
 #define BINARYLOGSINK_H
 
 #include "common/serializeio.h"
+#include "common/types.h"
 
 #include <boost/unordered_map.hpp>
 #include <boost/shared_ptr.hpp>
 
+#include <string>
+#include <vector>
+
 namespace voltdb {
 
 class PersistentTable;
 class Pool;
+class TableTuple;
 class VoltDBEngine;
 
 /*
@@ -34,6 +39,39 @@ class VoltDBEngine;
  */
 class BinaryLogSink {
 public:
+    /**
+     * A record of a transaction, as read from the binary log.  The rows
+     * point into the log buffer.
+     */
+    struct DRRecord {
+        DRRecordType m_type;
+        int64_t m_tableHandle;
+        // the row, or the old row of an update
+        const char *m_rowData;
+        int32_t m_rowLength;
+        // the new row of an update
+        const char *m_newRowData;
+        int32_t m_newRowLength;
+        // the table name of a truncate
+        std::string m_tableName;
+        // the partition hash in effect for the record
+        int32_t m_partitionHash;
+        bool m_forReplicatedTable;
+        // set when the transaction is applied
+        bool m_skipRow;
+    };
+
+    /**
+     * A transaction read from the binary log and checked against its CRC,
+     * but not yet applied.
+     */
+    struct DRTxn {
+        int64_t m_uniqueId;
+        int64_t m_sequenceNumber;
+        DRTxnPartitionHashFlag m_hashFlag;
+        std::vector<DRRecord> m_records;
+    };
+
     BinaryLogSink();
     int64_t applyTxn(ReferenceSerializeInputLE *taskInfo,
                      boost::unordered_map<int64_t, PersistentTable*> &tables,
@@ -41,11 +79,72 @@ public:
                      const char *txnStart,
                      int64_t localUniqueId);
 
+    /**
+     * Read the transaction that starts at txnStart, after its version byte,
+     * and check its CRC.  This touches nothing but the log buffer, so it
+     * may run on any thread.
+     */
+    static void decodeTxn(ReferenceSerializeInputLE *taskInfo, const char *txnStart, DRTxn &txn);
+
+    int64_t applyDecodedTxn(DRTxn &txn,
+                            boost::unordered_map<int64_t, PersistentTable*> &tables,
+                            Pool *pool, VoltDBEngine *engine, int32_t remoteClusterId,
+                            int64_t localUniqueId);
+
+    /**
+     * Consecutive deletes or updates of one table are looked up together
+     * instead of one index probe or table scan apiece.
+     */
+    void setBatchApply(bool batchApply) {
+        m_batchApply = batchApply;
+    }
+
 private:
-    int64_t apply(ReferenceSerializeInputLE *taskInfo, const DRRecordType type,
+    static void readRecord(ReferenceSerializeInputLE *taskInfo, const DRRecordType type, DRRecord &record);
+
+    int64_t apply(const DRRecord &record,
                   boost::unordered_map<int64_t, PersistentTable*> &tables,
                   Pool *pool, VoltDBEngine *engine, int32_t remoteClusterId,
-                  const char *txnStart, int64_t sequenceNumber, int64_t uniqueId, bool skipRow);
+                  int64_t sequenceNumber, int64_t uniqueId);
+
+    int64_t applyBatch(const std::vector<DRRecord> &records,
+                       boost::unordered_map<int64_t, PersistentTable*> &tables,
+                       Pool *pool, VoltDBEngine *engine, int32_t remoteClusterId,
+                       int64_t sequenceNumber, int64_t uniqueId);
+
+    /**
+     * Apply records[first, end), which are all deletes or all updates
+     * of one table.
+     */
+    int64_t applyRun(const std::vector<DRRecord> &records, size_t first, size_t end,
+                     boost::unordered_map<int64_t, PersistentTable*> &tables,
+                     Pool *pool, VoltDBEngine *engine, int32_t remoteClusterId,
+                     int64_t sequenceNumber, int64_t uniqueId);
+
+    /**
+     * Find the rows the run expects, in primary key order or with a single
+     * table scan.  A row that isn't there gets NULL.
+     */
+    void lookupRun(PersistentTable *table, const std::vector<TableTuple> &expectedTuples,
+                   std::vector<char*> &matches);
+
+    /**
+     * Delete or update the local row, or report the conflict.  Return true
+     * if a conflict was handled, which may have changed any row of the table.
+     */
+    bool applyDelete(PersistentTable *table, TableTuple &expectedTuple, TableTuple &deleteTuple,
+                     Pool *pool, VoltDBEngine *engine, int32_t remoteClusterId,
+                     int64_t sequenceNumber, int64_t uniqueId);
+    bool applyUpdate(PersistentTable *table, TableTuple &expectedTuple, TableTuple &newTuple,
+                     TableTuple &oldTuple, Pool *pool, VoltDBEngine *engine, int32_t remoteClusterId,
+                     int64_t sequenceNumber, int64_t uniqueId);
+
+    bool m_batchApply;
+
+    // the transaction applyTxn() is applying
+    DRTxn m_txn;
+    // storage for the expected rows of a run
+    std::vector<char> m_runTupleData;
 };
 
 
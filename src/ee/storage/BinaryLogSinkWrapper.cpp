@@ -23,9 +23,46 @@
 using namespace std;
 using namespace voltdb;
 
+// Transactions the helper may decode ahead of the site thread.
+static const size_t PIPELINE_DEPTH = 4;
+
+namespace {
+
+/** Makes sure the helper lets go of the caller's buffer, even if applying throws. */
+class PipelineFinisher {
+public:
+    explicit PipelineFinisher(BinaryLogPipeline &pipeline) : m_pipeline(pipeline) {}
+
+    ~PipelineFinisher() {
+        m_pipeline.finish();
+    }
+
+private:
+    BinaryLogPipeline &m_pipeline;
+};
+
+} // anonymous namespace
+
+void BinaryLogSinkWrapper::setPipelinedApply(bool pipelinedApply)
+{
+    if (!pipelinedApply) {
+        m_pipeline.reset();
+    }
+    else if (m_pipeline == NULL) {
+        m_pipeline.reset(new BinaryLogPipeline(PIPELINE_DEPTH));
+        if (!m_pipeline->hasHelper()) {
+            m_pipeline.reset();
+        }
+    }
+}
+
 int64_t BinaryLogSinkWrapper::apply(const char* taskParams, boost::unordered_map<int64_t, PersistentTable*> &tables,
                                     Pool *pool, VoltDBEngine *engine, int32_t remoteClusterId, int64_t localUniqueId)
 {
+    if (m_pipeline != NULL) {
+        return applyPipelined(taskParams, tables, pool, engine, remoteClusterId, localUniqueId);
+    }
+
     ReferenceSerializeInputLE taskInfo(taskParams + 4, ntohl(*reinterpret_cast<const int32_t*>(taskParams)));
 
     int64_t __attribute__ ((unused)) uniqueId = 0;
@@ -45,3 +82,19 @@ int64_t BinaryLogSinkWrapper::apply(const char* taskParams, boost::unordered_map
     }
     return rowCount;
 }
+
+int64_t BinaryLogSinkWrapper::applyPipelined(const char* taskParams,
+                                             boost::unordered_map<int64_t, PersistentTable*> &tables,
+                                             Pool *pool, VoltDBEngine *engine, int32_t remoteClusterId,
+                                             int64_t localUniqueId)
+{
+    PipelineFinisher finisher(*m_pipeline);
+    m_pipeline->start(taskParams + 4, ntohl(*reinterpret_cast<const int32_t*>(taskParams)));
+
+    int64_t rowCount = 0;
+    while (BinaryLogSink::DRTxn *txn = m_pipeline->next()) {
+        pool->purge();
+        rowCount += m_sink.applyDecodedTxn(*txn, tables, pool, engine, remoteClusterId, localUniqueId);
+    }
+    return rowCount;
+}
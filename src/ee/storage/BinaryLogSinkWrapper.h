@@ -17,9 +17,11 @@
 #ifndef BINARYLOGSINKWRAPPER_H
 #define BINARYLOGSINKWRAPPER_H
 
+#include "storage/BinaryLogPipeline.h"
 #include "storage/BinaryLogSink.h"
 
 #include <boost/unordered_map.hpp>
+#include <boost/scoped_ptr.hpp>
 #include <boost/shared_ptr.hpp>
 
 namespace voltdb {
@@ -33,12 +35,31 @@ class VoltDBEngine;
  */
 class BinaryLogSinkWrapper {
 public:
+    /**
+     * Batch apply and pipelined apply start off; VoltDBEngine turns them
+     * on from the options it is initialized with.
+     */
     BinaryLogSinkWrapper() {}
 
     int64_t apply(const char* taskParams, boost::unordered_map<int64_t, PersistentTable*> &tables,
                   Pool *pool, VoltDBEngine *engine, int32_t remoteClusterId, int64_t localUniqueId);
+
+    void setBatchApply(bool batchApply) {
+        m_sink.setBatchApply(batchApply);
+    }
+
+    /**
+     * Read and check the transactions of each buffer on a helper thread,
+     * ahead of the site thread applying them.
+     */
+    void setPipelinedApply(bool pipelinedApply);
 private:
+    int64_t applyPipelined(const char* taskParams, boost::unordered_map<int64_t, PersistentTable*> &tables,
+                           Pool *pool, VoltDBEngine *engine, int32_t remoteClusterId, int64_t localUniqueId);
+
     BinaryLogSink m_sink;
+    // NULL unless pipelined apply is on
+    boost::scoped_ptr<BinaryLogPipeline> m_pipeline;
 };
 
 
@@ -108,7 +108,8 @@ int64_t CopyOnWriteContext::handleStreamMore(TupleOutputStreamProcessor &outputS
                        getMaxTupleLength(),
                        getPartitionId(),
                        getPredicates(),
-                       getPredicateDeleteFlags());
+                       getPredicateDeleteFlags(),
+                       getPredicateCompressFlags());
 
     //=== Tuple processing loop
 
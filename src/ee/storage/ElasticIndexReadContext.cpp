@@ -130,7 +130,8 @@ int64_t ElasticIndexReadContext::handleStreamMore(
                                getMaxTupleLength(),
                                getPartitionId(),
                                getPredicates(),
-                               getPredicateDeleteFlags());
+                               getPredicateDeleteFlags(),
+                               getPredicateCompressFlags());
 
             // Set to true to break out of the loop after the tuples dry up
             // or the byte count threshold is hit.
@@ -15,12 +15,191 @@
  * along with VoltDB.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <algorithm>
+#include <deque>
+#include <queue>
+
 #include "common/LargeTempTableBlockCache.h"
 #include "storage/LargeTempTable.h"
 #include "storage/LargeTempTableBlock.h"
 
 namespace voltdb {
 
+namespace {
+
+/** A sorted run is a chain of block ids whose tuples, read front to
+    back, are in sort order. */
+typedef std::vector<int64_t> SortRun;
+
+/** Appends tuples to a new run of freshly allocated blocks.  Blocks
+    not yet handed off via finish() are released when the writer is
+    destroyed. */
+class SortRunWriter {
+public:
+    SortRunWriter(LargeTempTableBlockCache* cache, TupleSchema* schema)
+        : m_cache(cache)
+        , m_schema(schema)
+        , m_run()
+        , m_block(NULL)
+    {
+    }
+
+    ~SortRunWriter() {
+        unpinCurrentBlock();
+        BOOST_FOREACH(int64_t blockId, m_run) {
+            m_cache->releaseBlock(blockId);
+        }
+    }
+
+    void insert(const TableTuple& tuple) {
+        if (m_block != NULL && m_block->insertTuple(tuple)) {
+            return;
+        }
+
+        unpinCurrentBlock();
+        m_block = m_cache->getEmptyBlock(m_schema);
+        m_run.push_back(m_block->id());
+        if (! m_block->insertTuple(tuple)) {
+            throwSerializableEEException("Failed to insert tuple into empty LTT block");
+        }
+    }
+
+    SortRun finish() {
+        unpinCurrentBlock();
+        SortRun run;
+        run.swap(m_run);
+        return run;
+    }
+
+private:
+    void unpinCurrentBlock() {
+        if (m_block != NULL) {
+            m_block->unpin();
+            m_block = NULL;
+        }
+    }
+
+    LargeTempTableBlockCache* m_cache;
+    TupleSchema* m_schema;
+    SortRun m_run;
+    LargeTempTableBlock* m_block;
+};
+
+/** Reads a run back one tuple at a time, keeping only the block
+    being read pinned and releasing each block once it has been
+    consumed.  Unread blocks are released when the reader is
+    destroyed. */
+class SortRunReader {
+public:
+    SortRunReader(LargeTempTableBlockCache* cache, const TupleSchema* schema, const SortRun& run)
+        : m_cache(cache)
+        , m_run(run)
+        , m_blockIndex(0)
+        , m_block(NULL)
+        , m_tupleIndex(0)
+        , m_tuple(schema)
+    {
+    }
+
+    ~SortRunReader() {
+        if (m_block != NULL) {
+            m_block->unpin();
+        }
+
+        for (size_t i = m_blockIndex; i < m_run.size(); ++i) {
+            m_cache->releaseBlock(m_run[i]);
+        }
+    }
+
+    /** Move to the next tuple in the run; returns false when the run
+        is exhausted. */
+    bool advance() {
+        while (m_block == NULL || m_tupleIndex >= m_block->activeTupleCount()) {
+            if (m_block != NULL) {
+                m_block->unpin();
+                m_block = NULL;
+                m_cache->releaseBlock(m_run[m_blockIndex]);
+                ++m_blockIndex;
+            }
+
+            if (m_blockIndex >= m_run.size()) {
+                return false;
+            }
+
+            m_block = m_cache->fetchBlock(m_run[m_blockIndex]);
+            m_tupleIndex = 0;
+        }
+
+        m_tuple.move(m_block->address() + m_tuple.tupleLength() * m_tupleIndex);
+        ++m_tupleIndex;
+        return true;
+    }
+
+    const TableTuple& current() const {
+        return m_tuple;
+    }
+
+private:
+    LargeTempTableBlockCache* m_cache;
+    SortRun m_run;
+    size_t m_blockIndex;
+    LargeTempTableBlock* m_block;
+    int64_t m_tupleIndex;
+    TableTuple m_tuple;
+};
+
+/** Orders readers so that a priority queue yields the reader whose
+    current tuple sorts first. */
+class SortRunReaderGreater {
+public:
+    SortRunReaderGreater(const TupleComparer& comparer)
+        : m_comparer(comparer)
+    {
+    }
+
+    bool operator()(const SortRunReader* a, const SortRunReader* b) const {
+        return m_comparer(b->current(), a->current());
+    }
+
+private:
+    const TupleComparer& m_comparer;
+};
+
+/** Merge the given runs into writer, stopping after limit tuples if
+    limit is non-negative.  The input runs are consumed. */
+void mergeRuns(LargeTempTableBlockCache* cache,
+               const TupleSchema* schema,
+               const TupleComparer& comparer,
+               int limit,
+               const std::vector<SortRun>& runs,
+               SortRunWriter& writer) {
+    std::vector<std::unique_ptr<SortRunReader> > readers;
+    BOOST_FOREACH(const SortRun& run, runs) {
+        readers.emplace_back(new SortRunReader(cache, schema, run));
+    }
+
+    std::priority_queue<SortRunReader*, std::vector<SortRunReader*>, SortRunReaderGreater>
+        queue{SortRunReaderGreater(comparer)};
+    BOOST_FOREACH(auto& reader, readers) {
+        if (reader->advance()) {
+            queue.push(reader.get());
+        }
+    }
+
+    int count = 0;
+    while (! queue.empty() && (limit < 0 || count < limit)) {
+        SortRunReader* reader = queue.top();
+        queue.pop();
+        writer.insert(reader->current());
+        ++count;
+        if (reader->advance()) {
+            queue.push(reader);
+        }
+    }
+}
+
+} // end anonymous namespace
+
 LargeTempTable::LargeTempTable()
     : AbstractTempTable(LargeTempTableBlock::BLOCK_SIZE_IN_BYTES)
     , m_blockIds()
@@ -98,6 +277,93 @@ TableIterator LargeTempTable::iterator() {
     return m_iter;
 }
 
+void LargeTempTable::sort(const TupleComparer& comparer, int limit) {
+    if (m_blockForWriting != NULL) {
+        throwSerializableEEException("Attempt to sort large temp table before finishInserts() is called");
+    }
+
+    if (m_blockIds.empty()) {
+        return;
+    }
+
+    LargeTempTableBlockCache* lttBlockCache = ExecutorContext::getExecutorContext()->lttBlockCache();
+
+    // Runs not yet merged are released if we throw.
+    std::deque<SortRun> runs;
+    struct RunReleaser {
+        LargeTempTableBlockCache* m_cache;
+        std::deque<SortRun>& m_runs;
+        ~RunReleaser() {
+            BOOST_FOREACH(const SortRun& run, m_runs) {
+                BOOST_FOREACH(int64_t blockId, run) {
+                    m_cache->releaseBlock(blockId);
+                }
+            }
+        }
+    } runReleaser{lttBlockCache, runs};
+
+    // Sort the contents of each block into its own run.  With a
+    // limit, no run needs more than the first limit tuples.
+    std::vector<TableTuple> tuples;
+    while (! m_blockIds.empty()) {
+        LargeTempTableBlock* block = lttBlockCache->fetchBlock(m_blockIds.front());
+        tuples.clear();
+        TableTuple tuple(m_schema);
+        for (int64_t i = 0; i < block->activeTupleCount(); ++i) {
+            tuple.move(block->address() + tuple.tupleLength() * i);
+            tuples.push_back(tuple);
+        }
+
+        try {
+            std::vector<TableTuple>::iterator end = tuples.end();
+            if (limit >= 0 && static_cast<size_t>(limit) < tuples.size()) {
+                end = tuples.begin() + limit;
+                std::partial_sort(tuples.begin(), end, tuples.end(), comparer);
+            }
+            else {
+                std::sort(tuples.begin(), tuples.end(), comparer);
+            }
+
+            SortRunWriter writer(lttBlockCache, m_schema);
+            for (auto it = tuples.begin(); it != end; ++it) {
+                writer.insert(*it);
+            }
+            runs.push_back(writer.finish());
+        }
+        catch (...) {
+            block->unpin();
+            throw;
+        }
+
+        block->unpin();
+        releaseBlock(m_blockIds.begin());
+    }
+
+    // Each reader pins one block and the writer pins one more, so
+    // merge as many runs at once as leaves room for the writer and for
+    // the blocks other large temp tables, e.g. the input of the
+    // executor being sorted for, have pinned already.
+    int64_t cacheBlocks = lttBlockCache->maxCacheSizeInBytes() / LargeTempTableBlock::BLOCK_SIZE_IN_BYTES;
+    int64_t pinnedBlocks = static_cast<int64_t>(lttBlockCache->numPinnedEntries());
+    size_t fanIn = static_cast<size_t>(std::max<int64_t>(2, cacheBlocks - pinnedBlocks - 1));
+    while (runs.size() > 1) {
+        size_t mergeCount = std::min(fanIn, runs.size());
+        std::vector<SortRun> toMerge(runs.begin(), runs.begin() + mergeCount);
+        runs.erase(runs.begin(), runs.begin() + mergeCount);
+
+        SortRunWriter writer(lttBlockCache, m_schema);
+        mergeRuns(lttBlockCache, m_schema, comparer, limit, toMerge, writer);
+        runs.push_back(writer.finish());
+    }
+
+    m_blockIds.swap(runs.front());
+    runs.clear();
+
+    m_tupleCount = 0;
+    BOOST_FOREACH(int64_t blockId, m_blockIds) {
+        m_tupleCount += lttBlockCache->getBlockTupleCount(blockId);
+    }
+}
 
 void LargeTempTable::deleteAllTempTuples() {
     finishInserts();
@@ -19,6 +19,7 @@
 #define VOLTDB_LARGETEMPTABLE_H
 
 #include "common/LargeTempTableBlockCache.h"
+#include "common/TupleComparer.h"
 #include "storage/AbstractTempTable.hpp"
 #include "storage/tableiterator.h"
 
@@ -85,6 +86,13 @@ public:
         complete. */
     virtual void finishInserts();
 
+    /** Sort the tuples in this table using an external merge sort:
+        each block is sorted into its own run, and the runs are then
+        merged, as many at a time as the block cache can hold.  If
+        limit is non-negative, only the first limit tuples in sort
+        order are retained.  Must be called after finishInserts(). */
+    void sort(const TupleComparer& comparer, int limit);
+
     /** Releases the specified block.  Called by delete-as-you-go
         iterators.  Returns an iterator pointing to the next block
         id. */
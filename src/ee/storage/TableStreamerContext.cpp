@@ -62,7 +62,10 @@ void TableStreamerContext::updatePredicates(const std::vector<std::string> &pred
     // Throws an exception to be handled by caller on errors.
     std::ostringstream errmsg;
     m_predicates.clear();
-    if (!m_predicates.parseStrings(predicateStrings, errmsg, m_predicateDeleteFlags)) {
+    m_predicateDeleteFlags.clear();
+    m_predicateCompressFlags.clear();
+    if (!m_predicates.parseStrings(predicateStrings, errmsg, m_predicateDeleteFlags,
+                                    m_predicateCompressFlags)) {
         const char* details = errmsg.str().c_str();
         throwFatalException("TableStreamerContext() failed to parse predicate strings: %s", details);
     }
@@ -184,6 +184,14 @@ protected:
         return m_predicateDeleteFlags;
     }
 
+    /**
+     * Predicate compress flags accessor.
+     */
+    std::vector<bool> &getPredicateCompressFlags()
+    {
+        return m_predicateCompressFlags;
+    }
+
     PersistentTableSurgeon &m_surgeon;
 
     /**
@@ -203,6 +211,11 @@ private:
      */
     std::vector<bool> m_predicateDeleteFlags;
 
+    /**
+     * Per-predicate compress the rows of its output stream flags.
+     */
+    std::vector<bool> m_predicateCompressFlags;
+
     /**
      * Maximum serialized length of a tuple
      */
@@ -16,8 +16,8 @@
  */
 #include "storage/TupleBlock.h"
 #include "storage/table.h"
-#include <sys/mman.h>
-#include <errno.h>
+#include <algorithm>
+#include "common/PageAllocator.h"
 #include "common/ThreadLocalPool.h"
 
 namespace voltdb {
@@ -26,6 +26,7 @@ volatile int tupleBlocksAllocated = 0;
 
 TupleBlock::TupleBlock(Table *table, TBBucketPtr bucket) :
         m_storage(NULL),
+        m_storageSize(table->m_tableAllocationSize),
         m_references(0),
         m_tupleLength(table->m_tupleLength),
         m_tuplesPerBlock(table->m_tuplesPerBlock),
@@ -33,33 +34,85 @@ TupleBlock::TupleBlock(Table *table, TBBucketPtr bucket) :
         m_nextFreeTuple(0),
         m_lastCompactionOffset(0),
         m_bucket(bucket),
-        m_bucketIndex(0)
+        m_bucketIndex(0),
+        m_zoneMap(),
+        m_zoneMapValid(false)
 {
-#ifdef USE_MMAP
-    size_t tableAllocationSize = static_cast<size_t> (m_tupleLength * m_tuplesPerBlock);
-    m_storage = static_cast<char*>(::mmap( 0, tableAllocationSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANON, -1, 0 ));
-    if (m_storage == MAP_FAILED) {
-        std::cout << strerror( errno ) << std::endl;
-        throwFatalException("Failed mmap");
-    }
+#ifdef MEMCHECK
+    m_storage = new char[m_storageSize];
 #else
-    m_storage = new char[table->m_tableAllocationSize];
+    m_storage = static_cast<char*>(PageAllocator::allocate(m_storageSize));
 #endif
     tupleBlocksAllocated++;
 }
 
 TupleBlock::~TupleBlock() {
-#ifdef USE_MMAP
-    size_t tableAllocationSize = static_cast<size_t> (m_tupleLength * m_tuplesPerBlock);
-    if (::munmap( m_storage, tableAllocationSize) != 0) {
-        std::cout << strerror( errno ) << std::endl;
-        throwFatalException("Failed munmap");
-    }
-#else
+#ifdef MEMCHECK
     delete []m_storage;
+#else
+    PageAllocator::deallocate(m_storage, m_storageSize);
 #endif
 }
 
+/**
+ * Read an integer column's value, returning false if it is null.
+ */
+static bool readZoneMapValue(TableTuple const& tuple, int column, int64_t& value) {
+    TupleSchema::ColumnInfo const* columnInfo = tuple.getSchema()->getColumnInfo(column);
+    char const* data = tuple.address() + TUPLE_HEADER_SIZE + columnInfo->offset;
+    switch (columnInfo->getVoltType()) {
+    case VALUE_TYPE_TINYINT: {
+        int8_t raw;
+        ::memcpy(&raw, data, sizeof(raw));
+        value = raw;
+        return raw != INT8_NULL;
+    }
+    case VALUE_TYPE_SMALLINT: {
+        int16_t raw;
+        ::memcpy(&raw, data, sizeof(raw));
+        value = raw;
+        return raw != INT16_NULL;
+    }
+    case VALUE_TYPE_INTEGER: {
+        int32_t raw;
+        ::memcpy(&raw, data, sizeof(raw));
+        value = raw;
+        return raw != INT32_NULL;
+    }
+    case VALUE_TYPE_BIGINT:
+    case VALUE_TYPE_TIMESTAMP:
+        ::memcpy(&value, data, sizeof(value));
+        return value != INT64_NULL;
+    default:
+        throwFatalException("Column %d of type %s has no zone map", column,
+                            getTypeName(columnInfo->getVoltType()).c_str());
+    }
+}
+
+ZoneMapRange const* TupleBlock::zoneMap(TupleSchema const* schema, std::vector<int> const& columns) {
+    if (!m_zoneMapValid || m_zoneMap.size() != columns.size()) {
+        ZoneMapRange emptyRange = { INT64_MAX, INT64_MIN };
+        m_zoneMap.assign(columns.size(), emptyRange);
+        // Tuples pending delete still count, since an undo may bring them back.
+        TableTuple tuple(schema);
+        for (uint32_t ii = 0; ii < m_nextFreeTuple; ++ii) {
+            tuple.move(m_storage + m_tupleLength * ii);
+            if (!tuple.isActive()) {
+                continue;
+            }
+            for (size_t jj = 0; jj < columns.size(); ++jj) {
+                int64_t value;
+                if (readZoneMapValue(tuple, columns[jj], value)) {
+                    m_zoneMap[jj].m_min = std::min(m_zoneMap[jj].m_min, value);
+                    m_zoneMap[jj].m_max = std::max(m_zoneMap[jj].m_max, value);
+                }
+            }
+        }
+        m_zoneMapValid = true;
+    }
+    return m_zoneMap.empty() ? NULL : &m_zoneMap[0];
+}
+
 std::pair<int, int> TupleBlock::merge(Table *table, TBPtr source, TupleMovementListener *listener) {
     assert(source != this);
     /*
@@ -83,6 +83,15 @@ typedef boost::shared_ptr<TBBucket> TBBucketPtr;
 typedef std::vector<TBBucketPtr> TBBucketPtrVector;
 const int TUPLE_BLOCK_NUM_BUCKETS = 20;
 
+/**
+ * The smallest and largest non-null value of an integer column over
+ * the tuples of a block.  A range with m_min > m_max is empty.
+ */
+struct ZoneMapRange {
+    int64_t m_min;
+    int64_t m_max;
+};
+
 /**
  * This class represents a fixed-size container of tuples.  The tuples
  * it contains are also fixed-size, with pointers to non-inlined data
@@ -172,6 +181,8 @@ public:
      */
     inline std::pair<char*, int> nextFreeTuple() {
         char *retval = NULL;
+        // The caller is about to fill in values the zone map hasn't seen.
+        m_zoneMapValid = false;
         if (!m_freeList.empty()) {
             m_lastCompactionOffset = 0;
             retval = m_storage;
@@ -278,8 +289,26 @@ public:
     inline int64_t getAllocatedMemory() {
         return m_tupleLength * m_tuplesPerBlock;
     }
+
+    /** Mark the zone map out of date, for a tuple whose values were
+        changed in place. */
+    inline void invalidateZoneMap() {
+        m_zoneMapValid = false;
+    }
+
+    /**
+     * Return the ranges of the given integer columns over the active
+     * tuples of this block, in the order of the columns.  They are
+     * recomputed only if a tuple was added or changed since the last
+     * call.  Deletes leave them as they were, which can only make them
+     * wider than they need to be.
+     */
+    ZoneMapRange const* zoneMap(TupleSchema const* schema, std::vector<int> const& columns);
 private:
     char*   m_storage;
+    /** Size of the region at m_storage, which may be more than the
+        tuples use, to round it up to the table's allocation size. */
+    uint32_t m_storageSize;
     uint32_t m_references;
     uint32_t m_tupleLength;
     uint32_t m_tuplesPerBlock;
@@ -298,6 +327,62 @@ private:
 
     TBBucketPtr m_bucket;
     int m_bucketIndex;
+
+    std::vector<ZoneMapRange> m_zoneMap;
+    bool m_zoneMapValid;
+};
+
+/**
+ * Ranges of values that a scan predicate requires of some of a
+ * persistent table's zone-mapped columns.  Blocks whose zone maps show
+ * that none of their tuples can satisfy all of them need not be scanned.
+ */
+class ZoneMapFilter {
+public:
+    /** zoneMapColumns are the columns the table keeps zone maps for. */
+    ZoneMapFilter(TupleSchema const* schema, std::vector<int> const& zoneMapColumns)
+        : m_schema(schema)
+        , m_zoneMapColumns(zoneMapColumns)
+    {}
+
+    /**
+     * Narrow the range required of a column to [min, max].  Returns
+     * false if the table keeps no zone map for the column.
+     */
+    bool addRange(int column, int64_t min, int64_t max) {
+        for (size_t ii = 0; ii < m_zoneMapColumns.size(); ++ii) {
+            if (m_zoneMapColumns[ii] == column) {
+                m_slots.push_back(ii);
+                ZoneMapRange range = { min, max };
+                m_ranges.push_back(range);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool isEmpty() const {
+        return m_slots.empty();
+    }
+
+    /** Returns false if no tuple of the block can satisfy the ranges. */
+    bool mayMatch(TupleBlock& block) const {
+        ZoneMapRange const* zoneMap = block.zoneMap(m_schema, m_zoneMapColumns);
+        for (size_t ii = 0; ii < m_slots.size(); ++ii) {
+            ZoneMapRange const& blockRange = zoneMap[m_slots[ii]];
+            if (blockRange.m_max < m_ranges[ii].m_min || blockRange.m_min > m_ranges[ii].m_max) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+private:
+    TupleSchema const* m_schema;
+    std::vector<int> const& m_zoneMapColumns;
+    // For each range, the index of its column in the zone maps.
+    std::vector<size_t> m_slots;
+    std::vector<ZoneMapRange> m_ranges;
 };
 
 /**
@@ -23,6 +23,7 @@
 #include "common/ValuePeeker.hpp"
 #include "common/tabletuple.h"
 #include "common/ExportSerializeIo.h"
+#include "common/StreamBufferPool.h"
 #include "common/executorcontext.hpp"
 #include "storage/TupleStreamException.h"
 
@@ -39,6 +40,19 @@ using namespace voltdb;
 
 const int MAX_BUFFER_AGE = 4000;
 
+/**
+ * Take block buffers from the site's pool.  A stream made before its
+ * site's ExecutorContext, or in a test without one, allocates them.
+ */
+static char* acquireBlockBuffer(size_t size)
+{
+    ExecutorContext* context = ExecutorContext::getExecutorContext();
+    if (context == NULL) {
+        return StreamBufferPool::allocateUnpooled(size);
+    }
+    return context->streamBufferPool()->acquire(size);
+}
+
 TupleStreamBase::TupleStreamBase(size_t defaultBufferSize, size_t extraHeaderSpace /*= 0*/, int maxBufferSize /*= -1*/)
     : m_flushInterval(MAX_BUFFER_AGE),
       m_lastFlush(0), m_defaultCapacity(defaultBufferSize),
@@ -257,7 +271,7 @@ void TupleStreamBase::rollbackTo(size_t mark, size_t)
 void TupleStreamBase::discardBlock(StreamBlock *sb)
 {
     if (sb != NULL) {
-        delete [] sb->rawPtr();
+        StreamBufferPool::release(sb->rawPtr());
         delete sb;
     }
 }
@@ -295,10 +309,7 @@ void TupleStreamBase::extendBufferChain(size_t minLength)
         throw TupleStreamException(SQLException::volt_output_buffer_overflow, "Transaction is bigger than DR Buffer size");
     }
 
-    char *buffer = new char[blockSize];
-    if (!buffer) {
-        throwFatalException("Failed to claim managed buffer for Export.");
-    }
+    char *buffer = acquireBlockBuffer(blockSize);
     m_currBlock = new StreamBlock(buffer, m_headerSpace, blockSize, uso);
     if (blockSize > m_defaultCapacity) {
         m_currBlock->setType(LARGE_STREAM_BLOCK);
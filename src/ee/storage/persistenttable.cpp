@@ -145,6 +145,9 @@ PersistentTable::PersistentTable(int partitionColumn,
     , m_smallestUniqueIndex(NULL)
     , m_smallestUniqueIndexCrc(0)
     , m_drTimestampColumnIndex(-1)
+    , m_tupleChecksum(0)
+    , m_buildingIndex(NULL)
+    , m_buildingIndexCursor(NULL)
     , m_pkeyIndex(NULL)
     , m_mvHandler(NULL)
     , m_viewHandlers()
@@ -182,6 +185,21 @@ void PersistentTable::initializeWithColumns(TupleSchema* schema,
         m_allowNulls[i] = columnInfo->allowNull;
     }
 
+    m_zoneMapColumns.clear();
+    for (int i = 0; i < m_columnCount; ++i) {
+        switch (m_schema->columnType(i)) {
+        case VALUE_TYPE_TINYINT:
+        case VALUE_TYPE_SMALLINT:
+        case VALUE_TYPE_INTEGER:
+        case VALUE_TYPE_BIGINT:
+        case VALUE_TYPE_TIMESTAMP:
+            m_zoneMapColumns.push_back(i);
+            break;
+        default:
+            break;
+        }
+    }
+
     // Also clear some used block state. this structure doesn't have
     // an block ownership semantics - it's just a cache. I think.
     m_blocksWithSpace.clear();
@@ -215,6 +233,7 @@ PersistentTable::~PersistentTable() {
     BOOST_FOREACH (auto index, m_indexes) {
         delete index;
     }
+    delete m_buildingIndex;
 
     // free up the materialized view handler if this is a view table.
     delete m_mvHandler;
@@ -646,6 +665,9 @@ void PersistentTable::swapTable(PersistentTable* otherTable,
         std::vector<std::string> const& otherIndexNames,
         bool fallible,
         bool isUndo) {
+    // Both tables' index lists must be complete to be matched up.
+    finishIndexBuild();
+    otherTable->finishIndexBuild();
     assert(hasNameIntegrity(name(), theIndexNames));
     assert(hasNameIntegrity(otherTable->name(), otherIndexNames));
     CompiledSwap compiled(*this, *otherTable,
@@ -878,6 +900,7 @@ void PersistentTable::insertTupleCommon(TableTuple& source, TableTuple& target,
     if (!conflict.isNullTuple()) {
         throw ConstraintFailureException(this, source, conflict, CONSTRAINT_TYPE_UNIQUE);
     }
+    m_tupleChecksum += target.hashCode();
 
     // this is skipped for inserts that are never expected to fail,
     // like some (initially, all) cases of tuple migration on schema change
@@ -939,6 +962,7 @@ void PersistentTable::insertTupleForUndo(char* tuple) {
                             " unique constraint violation\n%s\n", m_name.c_str(),
                             target.debugNoHeader().c_str());
     }
+    m_tupleChecksum += target.hashCode();
 }
 
 /*
@@ -1036,6 +1060,8 @@ void PersistentTable::updateTupleWithSpecificIndexes(TableTuple& targetTupleToUp
         }
     }
 
+    deleteFromBuildingIndex(&targetTupleToUpdate);
+
     // handle any materialized views, we first insert the tuple into delta table,
     // then hide the tuple from the scan temporarily.
     // (Cannot do in reversed order because the pending delete flag will also be copied)
@@ -1083,7 +1109,10 @@ void PersistentTable::updateTupleWithSpecificIndexes(TableTuple& targetTupleToUp
     std::vector<char*> newObjects;
 
     // this is the actual write of the new values
+    m_tupleChecksum -= targetTupleToUpdate.hashCode();
     targetTupleToUpdate.copyForPersistentUpdate(sourceTupleWithNewValues, oldObjects, newObjects);
+    m_tupleChecksum += targetTupleToUpdate.hashCode();
+    invalidateZoneMap(targetTupleToUpdate);
 
     if (uq) {
         /*
@@ -1091,9 +1120,13 @@ void PersistentTable::updateTupleWithSpecificIndexes(TableTuple& targetTupleToUp
          * and the "before" and "after" object pointers for non-inlined columns that changed.
          */
         char* newTupleData = uq->allocatePooledCopy(targetTupleToUpdate.address(), tupleLength);
+        // An index being built saw the update too, and may be finished
+        // and installed by index() before this quantum is undone, so
+        // then every index has to be reverted.
+        bool revertIndexes = someIndexGotUpdated || m_buildingIndex != NULL;
         uq->registerUndoAction(new (*uq) PersistentTableUndoUpdateAction(oldTupleData, newTupleData,
                                                                          oldObjects, newObjects,
-                                                                         &m_surgeon, someIndexGotUpdated));
+                                                                         &m_surgeon, revertIndexes));
     }
     else {
         // This is normally handled by the Undo Action's release (i.e. when there IS an Undo Action)
@@ -1118,6 +1151,7 @@ void PersistentTable::updateTupleWithSpecificIndexes(TableTuple& targetTupleToUp
                                 m_name.c_str(), index->getName().c_str());
         }
     }
+    insertIntoBuildingIndex(&targetTupleToUpdate);
 
     // Note that inserting into the delta table is guaranteed to
     // succeed, since we checked constraints above.
@@ -1166,6 +1200,9 @@ void PersistentTable::updateTupleForUndo(char* tupleWithUnwantedValues,
         }
     }
 
+    // The building index saw the update whether or not the others did.
+    deleteFromBuildingIndex(&targetTupleToUpdate);
+
     if (m_schema->getUninlinedObjectColumnCount() != 0) {
         decreaseStringMemCount(targetTupleToUpdate.getNonInlinedMemorySizeForPersistentTable());
         increaseStringMemCount(sourceTupleWithNewValues.getNonInlinedMemorySizeForPersistentTable());
@@ -1173,7 +1210,10 @@ void PersistentTable::updateTupleForUndo(char* tupleWithUnwantedValues,
 
     bool dirty = targetTupleToUpdate.isDirty();
     // this is the actual in-place revert to the old version
+    m_tupleChecksum -= targetTupleToUpdate.hashCode();
     targetTupleToUpdate.copy(sourceTupleWithNewValues);
+    m_tupleChecksum += targetTupleToUpdate.hashCode();
+    invalidateZoneMap(targetTupleToUpdate);
     if (dirty) {
         targetTupleToUpdate.setDirtyTrue();
     }
@@ -1192,6 +1232,7 @@ void PersistentTable::updateTupleForUndo(char* tupleWithUnwantedValues,
             }
         }
     }
+    insertIntoBuildingIndex(&targetTupleToUpdate);
 }
 
 void PersistentTable::deleteTuple(TableTuple& target, bool fallible) {
@@ -1222,6 +1263,7 @@ void PersistentTable::deleteTuple(TableTuple& target, bool fallible) {
 
     // Just like insert, we want to remove this tuple from all of our indexes
     deleteFromAllIndexes(&target);
+    m_tupleChecksum -= target.hashCode();
 
     if (createUndoAction) {
         target.setPendingDeleteOnUndoReleaseTrue();
@@ -1355,6 +1397,7 @@ void PersistentTable::deleteTupleForUndo(char* tupleData, bool skipLookup) {
     assert(target.isActive());
 
     deleteFromAllIndexes(&target);
+    m_tupleChecksum -= target.hashCode();
     deleteTupleFinalize(target); // also frees object columns
 }
 
@@ -1413,6 +1456,7 @@ void PersistentTable::insertIntoAllIndexes(TableTuple* tuple) {
                     "Failed to insert tuple in Table: %s Index %s", m_name.c_str(), index->getName().c_str());
         }
     }
+    insertIntoBuildingIndex(tuple);
 }
 
 void PersistentTable::deleteFromAllIndexes(TableTuple* tuple) {
@@ -1423,6 +1467,7 @@ void PersistentTable::deleteFromAllIndexes(TableTuple* tuple) {
                     m_name.c_str(), index->getName().c_str());
         }
     }
+    deleteFromBuildingIndex(tuple);
 }
 
 void PersistentTable::tryInsertOnAllIndexes(TableTuple* tuple, TableTuple* conflict) {
@@ -1438,6 +1483,29 @@ void PersistentTable::tryInsertOnAllIndexes(TableTuple* tuple, TableTuple* confl
             return;
         }
     }
+    insertIntoBuildingIndex(tuple);
+}
+
+void PersistentTable::invalidateZoneMap(TableTuple const& tuple) {
+    if (!m_zoneMapColumns.empty()) {
+        findBlock(tuple.address(), m_data, m_tableAllocationSize)->invalidateZoneMap();
+    }
+}
+
+void PersistentTable::insertIntoBuildingIndex(TableTuple* tuple) {
+    if (m_buildingIndex != NULL && tuple->address() < m_buildingIndexCursor) {
+        m_buildingIndex->addEntry(tuple, NULL);
+    }
+}
+
+void PersistentTable::deleteFromBuildingIndex(TableTuple* tuple) {
+    if (m_buildingIndex != NULL && tuple->address() < m_buildingIndexCursor) {
+        if (!m_buildingIndex->deleteEntry(tuple)) {
+            throwFatalException(
+                    "Failed to delete tuple in Table: %s Index %s",
+                    m_name.c_str(), m_buildingIndex->getName().c_str());
+        }
+    }
 }
 
 bool PersistentTable::checkUpdateOnUniqueIndexes(TableTuple& targetTupleToUpdate,
@@ -1655,32 +1723,6 @@ void PersistentTable::processRecoveryMessage(RecoveryProtoMsg* message, Pool* po
     }
 }
 
-/**
- * Create a tree index on the primary key and then iterate it and hash
- * the tuple data.
- */
-size_t PersistentTable::hashCode() {
-    boost::scoped_ptr<TableIndex> pkeyIndex(TableIndexFactory::cloneEmptyTreeIndex(*m_pkeyIndex));
-    TableIterator iter(this, m_data.begin());
-    TableTuple tuple(schema());
-    while (iter.next(tuple)) {
-        pkeyIndex->addEntry(&tuple, NULL);
-    }
-
-    IndexCursor indexCursor(pkeyIndex->getTupleSchema());
-    pkeyIndex->moveToEnd(true, indexCursor);
-
-    size_t hashCode = 0;
-    while (true) {
-         tuple = pkeyIndex->nextValue(indexCursor);
-         if (tuple.isNullTuple()) {
-             break;
-         }
-         tuple.hashCode(hashCode);
-    }
-    return hashCode;
-}
-
 void PersistentTable::notifyBlockWasCompactedAway(TBPtr block) {
     if (m_blocksNotPendingSnapshot.find(block) == m_blocksNotPendingSnapshot.end()) {
         // do not find block in not pending snapshot container
@@ -1730,6 +1772,9 @@ void PersistentTable::swapTuples(TableTuple& originalTuple,
                                     m_name.c_str(), index->getName().c_str());
             }
         }
+        // The move may cross the building index's cursor in either direction.
+        deleteFromBuildingIndex(&originalTuple);
+        insertIntoBuildingIndex(&destinationTuple);
     }
 }
 
@@ -2071,12 +2116,18 @@ static bool isExistingTableIndex(std::vector<TableIndex*>& indexes, TableIndex*
 }
 #endif
 
-TableIndex* PersistentTable::index(std::string const& name) const {
+TableIndex* PersistentTable::index(std::string const& name) {
     BOOST_FOREACH (auto index, m_indexes) {
         if (index->getName().compare(name) == 0) {
             return index;
         }
     }
+    if (m_buildingIndex != NULL && m_buildingIndex->getName().compare(name) == 0) {
+        // A plan wants the index before the idle ticks have finished it.
+        TableIndex* index = m_buildingIndex;
+        finishIndexBuild();
+        return index;
+    }
     std::stringstream errorString;
     errorString << "Could not find Index with name " << name << " among {";
     char const* sep = "";
@@ -2091,13 +2142,76 @@ TableIndex* PersistentTable::index(std::string const& name) const {
 void PersistentTable::addIndex(TableIndex* index) {
     assert(!isExistingTableIndex(m_indexes, index));
 
-    // fill the index with tuples... potentially the slow bit
+    // fill the index with tuples... potentially the slow bit,
+    // so hand the index every tuple at once to build in bulk
+    std::vector<char*> tupleAddresses;
+    tupleAddresses.reserve(activeTupleCount());
     TableTuple tuple(m_schema);
     TableIterator iter = iterator();
     while (iter.next(tuple)) {
-        index->addEntry(&tuple, NULL);
+        tupleAddresses.push_back(tuple.address());
+    }
+    index->addEntries(tupleAddresses);
+    installIndex(index);
+}
+
+void PersistentTable::addIndexIncrementally(TableIndex* index) {
+    assert(!isExistingTableIndex(m_indexes, index));
+
+    // Replicated tables are shared by every site's ticks, and views track
+    // their table's indexes directly, so those are built right away.
+    if (index->isUniqueIndex() || isReplicatedTable() || m_isMaterialized ||
+            activeTupleCount() == 0) {
+        addIndex(index);
+        return;
+    }
+    finishIndexBuild();
+    m_buildingIndex = index;
+    m_buildingIndexCursor = NULL;
+    // View handlers are rebuilt with the catalog update that added the index.
+    polluteViews();
+}
+
+bool PersistentTable::continueIndexBuild(size_t maxTuples) {
+    if (m_buildingIndex == NULL) {
+        return false;
     }
+    TableTuple tuple(m_schema);
+    size_t scanned = 0;
+    while (scanned < maxTuples) {
+        // Blocks come and go between chunks, so find the block holding the
+        // cursor again, moving on to the next block once this one is done.
+        TBMapI next = m_data.upper_bound(m_buildingIndexCursor);
+        char* blockEnd = NULL;
+        if (next != m_data.begin()) {
+            TBMapI current = next;
+            --current;
+            TBPtr block = current.data();
+            blockEnd = block->address() + block->unusedTupleBoundary() * m_tupleLength;
+        }
+        if (m_buildingIndexCursor >= blockEnd) {
+            if (next == m_data.end()) {
+                TableIndex* index = m_buildingIndex;
+                m_buildingIndex = NULL;
+                m_buildingIndexCursor = NULL;
+                installIndex(index);
+                return false;
+            }
+            m_buildingIndexCursor = next.key();
+            continue;
+        }
+        for (; m_buildingIndexCursor < blockEnd && scanned < maxTuples; ++scanned) {
+            tuple.move(m_buildingIndexCursor);
+            m_buildingIndexCursor += m_tupleLength;
+            if (tuple.isActive() && !tuple.isPendingDelete() && !tuple.isPendingDeleteOnUndoRelease()) {
+                m_buildingIndex->addEntry(&tuple, NULL);
+            }
+        }
+    }
+    return true;
+}
 
+void PersistentTable::installIndex(TableIndex* index) {
     // add the index to the table
     if (index->isUniqueIndex()) {
         m_uniqueIndexes.push_back(index);
@@ -2111,6 +2225,12 @@ void PersistentTable::addIndex(TableIndex* index) {
 }
 
 void PersistentTable::removeIndex(TableIndex* index) {
+    if (index == m_buildingIndex) {
+        m_buildingIndex = NULL;
+        m_buildingIndexCursor = NULL;
+        delete index;
+        return;
+    }
     assert(isExistingTableIndex(m_indexes, index));
 
     std::vector<TableIndex*>::iterator iter;
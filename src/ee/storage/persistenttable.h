@@ -49,6 +49,7 @@
 #include <string>
 #include <vector>
 #include <cassert>
+#include <limits>
 #include <iostream>
 #include <boost/scoped_ptr.hpp>
 #include <boost/shared_ptr.hpp>
@@ -72,6 +73,8 @@
 
 class CompactionTest_BasicCompaction;
 class CompactionTest_CompactionWithCopyOnWrite;
+class CompactionTest_IncrementalIndexBuild;
+class CompactionTest_ZoneMapBlockSkipping;
 class CopyOnWriteTest;
 
 namespace catalog {
@@ -205,6 +208,8 @@ class PersistentTable : public Table, public UndoQuantumReleaseInterest,
     friend class ::CopyOnWriteTest;
     friend class ::CompactionTest_BasicCompaction;
     friend class ::CompactionTest_CompactionWithCopyOnWrite;
+    friend class ::CompactionTest_IncrementalIndexBuild;
+    friend class ::CompactionTest_ZoneMapBlockSkipping;
     friend class CoveringCellIndexTest_TableCompaction;
     friend class MaterializedViewHandler;
     friend class ScopedDeltaTableContext;
@@ -309,14 +314,29 @@ public:
     // returned via shallow vector copy -- seems good enough.
     std::vector<TableIndex*> const& allIndexes() const { return m_indexes; }
 
-    TableIndex* index(std::string const& name) const;
+    // Completes an incremental build of the named index before returning it.
+    TableIndex* index(std::string const& name);
 
     TableIndex* primaryKeyIndex() const { return m_pkeyIndex; }
 
+    // The integer columns whose per-block ranges are kept for scans
+    // to skip blocks with; see ZoneMapFilter.
+    std::vector<int> const& zoneMapColumns() const { return m_zoneMapColumns; }
+
     void configureIndexStats();
 
     // mutating indexes
     void addIndex(TableIndex* index);
+    // Like addIndex, but the rows of a populated partitioned table are
+    // indexed a chunk at a time by continueIndexBuild(). A non-unique index
+    // only joins allIndexes() once every row is in it; unique indexes are
+    // built right away since they enforce constraints.
+    void addIndexIncrementally(TableIndex* index);
+    // Index up to maxTuples more rows of the index being built.
+    // Returns true while rows remain.
+    bool continueIndexBuild(size_t maxTuples);
+    void finishIndexBuild() { continueIndexBuild(std::numeric_limits<size_t>::max()); }
+    bool isBuildingIndex() const { return m_buildingIndex != NULL; }
     void removeIndex(TableIndex* index);
     void setPrimaryKeyIndex(TableIndex* index);
 
@@ -410,10 +430,11 @@ public:
     void processRecoveryMessage(RecoveryProtoMsg* message, Pool* pool);
 
     /**
-     * Create a tree index on the primary key and then iterate it and hash
-     * the tuple data.
+     * Return an order-independent checksum of the visible tuples' data,
+     * maintained as tuples are inserted, updated, deleted and restored
+     * by undo.
      */
-    size_t hashCode();
+    size_t hashCode() const { return m_tupleChecksum; }
 
     size_t getBlocksNotPendingSnapshotCount() {
         return m_blocksNotPendingSnapshot.size();
@@ -598,6 +619,16 @@ private:
 
     void tryInsertOnAllIndexes(TableTuple* tuple, TableTuple* conflict);
 
+    // Only rows the building index has already scanned past are maintained here.
+    void insertIntoBuildingIndex(TableTuple* tuple);
+
+    void deleteFromBuildingIndex(TableTuple* tuple);
+
+    // For a tuple whose values were changed in place.
+    void invalidateZoneMap(TableTuple const& tuple);
+
+    void installIndex(TableIndex* index);
+
     bool checkUpdateOnUniqueIndexes(TableTuple& targetTupleToUpdate,
                                     TableTuple const& sourceTupleWithNewValues,
                                     std::vector<TableIndex*> const& indexesToUpdate);
@@ -774,9 +805,20 @@ private:
 
     int m_drTimestampColumnIndex;
 
+    // sum of the visible tuples' TableTuple::hashCode() values
+    size_t m_tupleChecksum;
+
+    std::vector<int> m_zoneMapColumns;
+
     // indexes
     std::vector<TableIndex*> m_indexes;
 
+    // An index being filled by continueIndexBuild() and the address of the
+    // next row it will scan. The index holds exactly the rows stored below
+    // the cursor; mutations keep that true through the *BuildingIndex methods.
+    TableIndex* m_buildingIndex;
+    char* m_buildingIndexCursor;
+
     std::vector<TableIndex*> m_uniqueIndexes;
 
     TableIndex* m_pkeyIndex;
@@ -48,6 +48,7 @@
 #include <cstdio>
 #include <boost/foreach.hpp>
 #include <boost/scoped_array.hpp>
+#include <boost/scoped_ptr.hpp>
 
 #include "table.h"
 #include "common/debuglog.h"
@@ -56,6 +57,8 @@
 #include "common/tabletuple.h"
 #include "common/Pool.hpp"
 #include "common/FatalException.hpp"
+#include "common/LZ4Block.h"
+#include "common/TupleOutputStream.h"
 #include "indexes/tableindex.h"
 #include "storage/tableiterator.h"
 #include "storage/persistenttable.h"
@@ -462,6 +465,32 @@ void Table::loadTuplesFromNoHeader(SerializeInputBE &serialInput,
                                    ReferenceSerializeOutput *uniqueViolationOutput,
                                    bool shouldDRStreamRow) {
     int tupleCount = serialInput.readInt();
+
+    // Table streams may compress their rows, marking the frame where the
+    // first row's length would be.  Decompress them in one go and read the
+    // tuples from there.
+    SerializeInputBE* rowInput = &serialInput;
+    boost::scoped_array<char> decompressedRows;
+    boost::scoped_ptr<ReferenceSerializeInputBE> decompressedInput;
+    if (tupleCount > 0 && serialInput.readInt() == TupleOutputStream::COMPRESSED_ROWS_MARKER) {
+        int32_t rowsLength = serialInput.readInt();
+        int32_t compressedLength = serialInput.readInt();
+        if (rowsLength < 0 || compressedLength < 0) {
+            throw SerializableEEException(VOLT_EE_EXCEPTION_TYPE_EEEXCEPTION,
+                                          "Invalid lengths for compressed rows");
+        }
+        const char* compressed = serialInput.getRawPointer(compressedLength);
+        decompressedRows.reset(new char[rowsLength]);
+        if (!LZ4Block::decompress(compressed, compressedLength, decompressedRows.get(), rowsLength)) {
+            throw SerializableEEException(VOLT_EE_EXCEPTION_TYPE_EEEXCEPTION,
+                                          "Compressed rows are corrupt");
+        }
+        decompressedInput.reset(new ReferenceSerializeInputBE(decompressedRows.get(), rowsLength));
+        rowInput = decompressedInput.get();
+    }
+    else if (tupleCount > 0) {
+        serialInput.unread(sizeof(int32_t));
+    }
     assert(tupleCount >= 0);
 
     TableTuple target(m_schema);
@@ -482,7 +511,7 @@ void Table::loadTuplesFromNoHeader(SerializeInputBE &serialInput,
         target.setPendingDeleteFalse();
         target.setPendingDeleteOnUndoReleaseFalse();
 
-        target.deserializeFrom(serialInput, stringPool);
+        target.deserializeFrom(*rowInput, stringPool);
 
         processLoadedTuple(target, uniqueViolationOutput, serializedTupleCount, tupleCountPosition, shouldDRStreamRow);
     }
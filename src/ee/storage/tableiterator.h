@@ -90,6 +90,28 @@ public:
     bool hasNext();
     uint32_t getLocation() const;
 
+    /**
+     * Returns true if the tuple last returned by next() is the last
+     * one in its block (or in the table), so that the next call to
+     * next() moves on to another block.  For temp and large temp
+     * tables that may free or unpin the block, so callers that hold
+     * on to several tuples at once must stop there.
+     */
+    bool atBlockBoundary() const {
+        return m_foundTuples >= m_activeTuples
+            || m_dataPtr == NULL
+            || m_dataPtr + m_tupleLength >= m_dataEndPtr;
+    }
+
+    /**
+     * Skip the blocks of a persistent table that the filter rules out,
+     * without visiting their tuples.  The filter must outlive the scan.
+     * (Has no effect on temp tables.)
+     */
+    void setZoneMapFilter(ZoneMapFilter const* filter) {
+        m_zoneMapFilter = filter;
+    }
+
     void setTempTableDeleteAsGo(bool flag) {
         switch (m_iteratorType) {
         case TEMP:
@@ -284,6 +306,9 @@ private:
     /** The type of iterator based on the kind of table that we're scanning. */
     IteratorType m_iteratorType;
 
+    /** Blocks of a persistent table that need not be scanned, if any. */
+    ZoneMapFilter const* m_zoneMapFilter;
+
     /** State that is specific to the type of table we're iterating
         over: */
     TypeSpecificState m_state;
@@ -298,6 +323,7 @@ inline TableIterator::TableIterator(Table *parent, TBMapI start)
     , m_dataPtr(NULL)
     , m_dataEndPtr(NULL)
     , m_iteratorType(PERSISTENT)
+    , m_zoneMapFilter(NULL)
     , m_state(start)
 {
 }
@@ -311,6 +337,7 @@ inline TableIterator::TableIterator(Table *parent, std::vector<TBPtr>::iterator
     , m_dataPtr(NULL)
     , m_dataEndPtr(NULL)
     , m_iteratorType(TEMP)
+    , m_zoneMapFilter(NULL)
     , m_state(start, false)
 {
 }
@@ -324,6 +351,7 @@ inline TableIterator::TableIterator(Table *parent, std::vector<int64_t>::iterato
     , m_dataPtr(NULL)
     , m_dataEndPtr(NULL)
     , m_iteratorType(LARGE_TEMP)
+    , m_zoneMapFilter(NULL)
     , m_state(start, false)
 {
 }
@@ -337,6 +365,7 @@ inline TableIterator::TableIterator(const TableIterator &that)
     , m_dataPtr(that.m_dataPtr)
     , m_dataEndPtr(that.m_dataEndPtr)
     , m_iteratorType(that.m_iteratorType)
+    , m_zoneMapFilter(that.m_zoneMapFilter)
     , m_state(that.m_state)
 {
     // This assertion could fail if we are copying an invalid iterator
@@ -361,6 +390,7 @@ inline TableIterator& TableIterator::operator=(const TableIterator& that) {
         m_dataPtr = that.m_dataPtr;
         m_dataEndPtr = that.m_dataEndPtr;
         m_iteratorType = that.m_iteratorType;
+        m_zoneMapFilter = that.m_zoneMapFilter;
         m_state = that.m_state;
     }
 
@@ -434,6 +464,16 @@ inline bool TableIterator::persistentNext(TableTuple &out) {
         if (m_dataPtr == NULL || m_dataPtr >= m_dataEndPtr) {
             // We are either before first tuple (m_dataPtr is null)
             // or at the end of a block.
+            if (m_zoneMapFilter != NULL) {
+                while (!m_zoneMapFilter->mayMatch(*m_state.m_persBlockIterator.data())) {
+                    // Count the block's tuples as found, as if it had been scanned.
+                    m_foundTuples += m_state.m_persBlockIterator.data()->activeTuples();
+                    m_state.m_persBlockIterator++;
+                    if (m_foundTuples >= m_activeTuples) {
+                        return false;
+                    }
+                }
+            }
             m_dataPtr = m_state.m_persBlockIterator.key();
 
             uint32_t unusedTupleBoundary = m_state.m_persBlockIterator.data()->unusedTupleBoundary();
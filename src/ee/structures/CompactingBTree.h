@@ -0,0 +1,1131 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2018 VoltDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with VoltDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef COMPACTINGBTREE_H_
+#define COMPACTINGBTREE_H_
+
+#include "ContiguousAllocator.h"
+#include "CompactingMap.h" // for NormalKeyValuePair, setPointerValue and MAXPOINTER
+
+#include <cassert>
+#include <cstdio>
+#include <cstring>
+#include <new>
+#include <stdint.h>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace voltdb {
+
+/**
+ * The number of slots in a B+tree node: enough to fill about nodeBytes,
+ * but never so few that the tree gets deep for wide keys, nor so many
+ * that shifting slots on insert and delete dominates.
+ */
+inline constexpr int compactingBTreeCapacity(std::size_t nodeBytes, std::size_t slotBytes)
+{
+    return (nodeBytes / slotBytes < 8) ? 8 :
+           (nodeBytes / slotBytes > 128) ? 128 : static_cast<int>(nodeBytes / slotBytes);
+}
+
+/**
+ * A B+tree with the same stl::map-like interface as CompactingMap, so that
+ * the tree indexes can be built on either.
+ *
+ * Entries are kept in wide leaves, sorted and stored contiguously, and the
+ * leaves are chained in both directions, so lookups touch one node per
+ * level and range scans read memory sequentially. Internal nodes keep their
+ * separator keys contiguously as well and, when hasRank is set, the number
+ * of entries under each child, which makes rank lookups logarithmic.
+ *
+ * As in CompactingMap, leaves and internal nodes are packed into two
+ * ContiguousAllocators. When a node is freed, the most recently allocated
+ * node of the same kind is moved into the hole and the pointers to it are
+ * fixed up, so memory stays contiguous and can be returned as the tree
+ * shrinks.
+ *
+ * Separator keys are bitwise copies of the first key under the child to
+ * their right, never constructed or destroyed as keys. Keys may refer to
+ * tuple or object storage that only lives as long as the entry they were
+ * copied from, so the tree keeps every separator in step with a live entry
+ * rather than letting it go stale when that entry is deleted. This also
+ * means keys must stay comparable when copied bitwise, which holds for the
+ * index key types but not for, say, std::string.
+ *
+ * The caveats of CompactingMap apply: entries are moved around with their
+ * assignment operators, and any mutation invalidates all iterators.
+ */
+template<typename KeyValuePair, typename Compare, bool hasRank=false>
+class CompactingBTree {
+    typedef typename KeyValuePair::first_type Key;
+    typedef typename KeyValuePair::second_type Data;
+    typedef typename std::aligned_storage<sizeof(Key), alignof(Key)>::type KeyStorage;
+
+    static const std::size_t NODE_BYTES = 1024;
+    static const int NODES_PER_BLOCK = 128;
+
+public:
+    static const int LEAF_CAPACITY = compactingBTreeCapacity(NODE_BYTES, sizeof(KeyValuePair));
+    static const int INTERNAL_CAPACITY =
+        compactingBTreeCapacity(NODE_BYTES, sizeof(Key) + sizeof(void*) + (hasRank ? sizeof(int64_t) : 0));
+
+protected:
+    // Nodes with fewer slots in use than this are merged with, or take
+    // slots from, a sibling when an entry is deleted from under them.
+    static const int MIN_LEAF_COUNT = LEAF_CAPACITY / 4;
+    static const int MIN_INTERNAL_COUNT = INTERNAL_CAPACITY / 4;
+
+    struct Internal;
+
+    struct Node {
+        Internal *parent;
+        // Entries in a leaf, children of an internal node
+        int32_t count;
+        bool leaf;
+
+        explicit Node(bool isLeaf) : parent(NULL), count(0), leaf(isLeaf) {}
+    };
+
+    // Slots at or beyond count always hold default-constructed pairs, so
+    // that keys which own memory (see GenericPersistentKey) move into and
+    // out of them without leaking or freeing anything.
+    struct Leaf : public Node {
+        Leaf *prev;
+        Leaf *next;
+        KeyValuePair entries[LEAF_CAPACITY];
+
+        Leaf() : Node(true), prev(NULL), next(NULL) {}
+
+        const Key &key(int slot) const { return entries[slot].getKey(); }
+    };
+
+    struct Internal : public Node {
+        // keys[i] is a copy of the first key under children[i + 1].
+        KeyStorage keys[INTERNAL_CAPACITY - 1];
+        Node *children[INTERNAL_CAPACITY];
+        // Entries under each child, maintained only with hasRank.
+        int64_t counts[hasRank ? INTERNAL_CAPACITY : 1];
+
+        Internal() : Node(false) {}
+
+        const Key &key(int i) const { return *reinterpret_cast<const Key*>(&keys[i]); }
+        Key &key(int i) { return *reinterpret_cast<Key*>(&keys[i]); }
+        void setKey(int i, const Key &key) { ::memcpy(&keys[i], reinterpret_cast<const char*>(&key), sizeof(Key)); }
+    };
+
+    int64_t m_count;
+    Node *m_root;
+    Leaf *m_first;
+    Leaf *m_last;
+    ContiguousAllocator m_leafAllocator;
+    ContiguousAllocator m_internalAllocator;
+    bool m_unique;
+
+    // templated comparison function object
+    // follows STL conventions
+    Compare m_comper;
+
+    // What an end iterator's key() returns.
+    static const KeyValuePair &endPair()
+    {
+        static const KeyValuePair nil;
+        return nil;
+    }
+
+public:
+    // A leaf and a slot in it: small enough to live in an IndexCursor.
+    class iterator {
+        friend class CompactingBTree<KeyValuePair, Compare, hasRank>;
+    protected:
+        Leaf *m_leaf;
+        int32_t m_slot;
+        iterator(Leaf *leaf, int32_t slot) : m_leaf(leaf), m_slot(slot) {}
+    public:
+        iterator() : m_leaf(NULL), m_slot(0) {}
+        const Key &key() const { return m_leaf ? m_leaf->key(m_slot) : endPair().getKey(); }
+        const Data &value() const { return m_leaf->entries[m_slot].getValue(); }
+        void setValue(const Data &value) { m_leaf->entries[m_slot].setValue(value); }
+        void moveNext()
+        {
+            assert(m_leaf);
+            if (++m_slot == m_leaf->count) {
+                m_leaf = m_leaf->next;
+                m_slot = 0;
+            }
+        }
+        void movePrev()
+        {
+            assert(m_leaf);
+            if (m_slot > 0) {
+                --m_slot;
+            }
+            else {
+                m_leaf = m_leaf->prev;
+                m_slot = m_leaf ? m_leaf->count - 1 : 0;
+            }
+        }
+        bool isEnd() const { return m_leaf == NULL; }
+        bool equals(const iterator &iter) const {
+            if (isEnd()) {
+                return iter.isEnd();
+            }
+            return m_leaf == iter.m_leaf && m_slot == iter.m_slot;
+        }
+    };
+
+    CompactingBTree(bool unique, Compare comper);
+    ~CompactingBTree();
+
+    // Returns the data of the conflicting entry if the insert failed on a unique tree.
+    const Data *insert(const Key &key, const Data &data);
+    // Fill an empty tree from entries already sorted by the tree's comparator,
+    // with the same contract as CompactingMap::bulkLoad.
+    bool bulkLoad(std::vector<KeyValuePair> &sortedEntries);
+    bool erase(const Key &key);
+    bool erase(iterator &iter);
+
+    iterator find(const Key &key) const;
+    iterator findRank(int64_t ith) const;
+    int64_t size() const { return m_count; }
+    iterator begin() const { return iterator(m_first, 0); }
+    iterator rbegin() const
+    {
+        if (m_last == NULL) {
+            return iterator();
+        }
+        return iterator(m_last, m_last->count - 1);
+    }
+
+    iterator lowerBound(const Key &key) const { return bound(key, false); }
+    iterator upperBound(const Key &key) const;
+
+    std::pair<iterator, iterator> equalRange(const Key &key) const
+    {
+        return std::pair<iterator, iterator>(lowerBound(key), upperBound(key));
+    }
+
+    size_t bytesAllocated() const
+    {
+        return m_leafAllocator.bytesAllocated() + m_internalAllocator.bytesAllocated();
+    }
+
+    // Must pass a key that already in map, or else return -1
+    int64_t rankAsc(const Key& key) const;
+    int64_t rankUpper(const Key& key) const;
+
+    /**
+     * For debugging: verify the B+tree invariants are met. SLOW.
+     */
+    bool verify() const;
+    bool verifyRank() const;
+
+protected:
+    Leaf *newLeaf() { return new (m_leafAllocator.alloc()) Leaf(); }
+    Internal *newInternal() { return new (m_internalAllocator.alloc()) Internal(); }
+    void freeLeaf(Leaf *hole);
+    void freeInternal(Internal *hole, Internal **tracked);
+
+    int childFor(const Internal *node, const Key &key, bool upper) const;
+    int slotFor(const Leaf *leaf, const Key &key, bool upper) const;
+    Leaf *descend(const Key &key, bool upper, int64_t *before) const;
+    iterator bound(const Key &key, bool upper) const;
+    int64_t boundRank(const Key &key, bool upper) const;
+
+    static int childIndex(const Internal *parent, const Node *child);
+    static int64_t subtreeCount(const Node *node);
+    void addToCounts(Node *node, int64_t delta);
+    void refreshSeparator(Leaf *leaf);
+
+    void insertChild(Internal *node, int pos, const Key &separator, Node *child);
+    void insertIntoParent(Node *left, const Key &separator, Node *right, bool appending);
+    void eraseAt(Leaf *leaf, int slot);
+    void rebalance(Node *node);
+    Internal *merge(Internal *parent, int leftIndex);
+    void redistribute(Internal *parent, int leftIndex);
+
+    int64_t verify(const Node *node, const Key *low, int depth, int &leafDepth) const;
+};
+
+template<typename KeyValuePair, typename Compare, bool hasRank>
+CompactingBTree<KeyValuePair, Compare, hasRank>::CompactingBTree(bool unique, Compare comper)
+    : m_count(0),
+      m_root(NULL),
+      m_first(NULL),
+      m_last(NULL),
+      m_leafAllocator(static_cast<int>(sizeof(Leaf)), NODES_PER_BLOCK),
+      m_internalAllocator(static_cast<int>(sizeof(Internal)), NODES_PER_BLOCK),
+      m_unique(unique),
+      m_comper(comper)
+{ }
+
+template<typename KeyValuePair, typename Compare, bool hasRank>
+CompactingBTree<KeyValuePair, Compare, hasRank>::~CompactingBTree()
+{
+    // Internal nodes hold no constructed keys, so only the leaves need destroying.
+    while (m_leafAllocator.count() > 0) {
+        static_cast<Leaf*>(m_leafAllocator.last())->~Leaf();
+        m_leafAllocator.trim();
+    }
+}
+
+template<typename KeyValuePair, typename Compare, bool hasRank>
+int CompactingBTree<KeyValuePair, Compare, hasRank>::childFor(const Internal *node, const Key &key,
+                                                              bool upper) const
+{
+    // The first child whose separator (the key before it) is not below the
+    // key, or for an upper bound, is above it.
+    int lo = 0;
+    int hi = node->count - 1;
+    while (lo < hi) {
+        int mid = (lo + hi) / 2;
+        int cmp = m_comper(node->key(mid), key);
+        if (cmp < 0 || (upper && cmp == 0)) {
+            lo = mid + 1;
+        }
+        else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+template<typename KeyValuePair, typename Compare, bool hasRank>
+int CompactingBTree<KeyValuePair, Compare, hasRank>::slotFor(const Leaf *leaf, const Key &key,
+                                                             bool upper) const
+{
+    int lo = 0;
+    int hi = leaf->count;
+    while (lo < hi) {
+        int mid = (lo + hi) / 2;
+        int cmp = m_comper(leaf->key(mid), key);
+        if (cmp < 0 || (upper && cmp == 0)) {
+            lo = mid + 1;
+        }
+        else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+template<typename KeyValuePair, typename Compare, bool hasRank>
+typename CompactingBTree<KeyValuePair, Compare, hasRank>::Leaf*
+CompactingBTree<KeyValuePair, Compare, hasRank>::descend(const Key &key, bool upper, int64_t *before) const
+{
+    // Find the leaf that holds the bound, or whose last slot precedes it.
+    // Optionally count the entries in the leaves to its left.
+    const Node *x = m_root;
+    while ( ! x->leaf) {
+        const Internal *node = static_cast<const Internal*>(x);
+        int i = childFor(node, key, upper);
+        if (hasRank && before != NULL) {
+            for (int j = 0; j < i; ++j) {
+                *before += node->counts[j];
+            }
+        }
+        x = node->children[i];
+    }
+    return static_cast<Leaf*>(const_cast<Node*>(x));
+}
+
+template<typename KeyValuePair, typename Compare, bool hasRank>
+typename CompactingBTree<KeyValuePair, Compare, hasRank>::iterator
+CompactingBTree<KeyValuePair, Compare, hasRank>::bound(const Key &key, bool upper) const
+{
+    if (m_root == NULL) {
+        return iterator();
+    }
+    Leaf *leaf = descend(key, upper, NULL);
+    int slot = slotFor(leaf, key, upper);
+    if (slot == leaf->count) {
+        return iterator(leaf->next, 0);
+    }
+    return iterator(leaf, slot);
+}
+
+template<typename KeyValuePair, typename Compare, bool hasRank>
+int64_t CompactingBTree<KeyValuePair, Compare, hasRank>::boundRank(const Key &key, bool upper) const
+{
+    // The 1-based rank of the bound; one past the last rank at the end.
+    if (m_root == NULL) {
+        return 1;
+    }
+    int64_t before = 0;
+    Leaf *leaf = descend(key, upper, &before);
+    return before + slotFor(leaf, key, upper) + 1;
+}
+
+template<typename KeyValuePair, typename Compare, bool hasRank>
+typename CompactingBTree<KeyValuePair, Compare, hasRank>::iterator
+CompactingBTree<KeyValuePair, Compare, hasRank>::upperBound(const Key &key) const
+{
+    // Work on a bitwise copy, which (unlike a copy-constructed key) never
+    // takes over any memory the key owns.
+    KeyStorage tmpKey;
+    ::memcpy(&tmpKey, reinterpret_cast<const char*>(&key), sizeof(Key));
+    setPointerValue(*reinterpret_cast<Key*>(&tmpKey), MAXPOINTER);
+    return bound(*reinterpret_cast<const Key*>(&tmpKey), true);
+}
+
+template<typename KeyValuePair, typename Compare, bool hasRank>
+typename CompactingBTree<KeyValuePair, Compare, hasRank>::iterator
+CompactingBTree<KeyValuePair, Compare, hasRank>::find(const Key &key) const
+{
+    iterator iter = lowerBound(key);
+    if ( ! iter.isEnd() && m_comper(iter.key(), key) == 0) {
+        return iter;
+    }
+    return iterator();
+}
+
+template<typename KeyValuePair, typename Compare, bool hasRank>
+typename CompactingBTree<KeyValuePair, Compare, hasRank>::iterator
+CompactingBTree<KeyValuePair, Compare, hasRank>::findRank(int64_t ith) const
+{
+    if (( ! hasRank) || ith < 1 || ith > m_count) {
+        return iterator();
+    }
+    const Node *x = m_root;
+    while ( ! x->leaf) {
+        const Internal *node = static_cast<const Internal*>(x);
+        int i = 0;
+        while (ith > node->counts[i]) {
+            ith -= node->counts[i];
+            ++i;
+        }
+        assert(i < node->count);
+        x = node->children[i];
+    }
+    return iterator(static_cast<Leaf*>(const_cast<Node*>(x)), static_cast<int32_t>(ith - 1));
+}
+
+template<typename KeyValuePair, typename Compare, bool hasRank>
+int64_t CompactingBTree<KeyValuePair, Compare, hasRank>::rankAsc(const Key& key) const
+{
+    if ( ! hasRank) {
+        return -1;
+    }
+    // return -1 if the key passed in is not in the map
+    if (find(key).isEnd()) {
+        return -1;
+    }
+    if (m_unique) {
+        return boundRank(key, false);
+    }
+    // Rank the first entry that matches regardless of its tuple pointer.
+    KeyStorage tmpKey;
+    ::memcpy(&tmpKey, reinterpret_cast<const char*>(&key), sizeof(Key));
+    setPointerValue(*reinterpret_cast<Key*>(&tmpKey), NULL);
+    return boundRank(*reinterpret_cast<const Key*>(&tmpKey), false);
+}
+
+template<typename KeyValuePair, typename Compare, bool hasRank>
+int64_t CompactingBTree<KeyValuePair, Compare, hasRank>::rankUpper(const Key& key) const
+{
+    if ( ! hasRank) {
+        return -1;
+    }
+    if (m_unique) {
+        return rankAsc(key);
+    }
+    // return -1 if the key passed in is not in the map
+    if (find(key).isEnd()) {
+        return -1;
+    }
+    KeyStorage tmpKey;
+    ::memcpy(&tmpKey, reinterpret_cast<const char*>(&key), sizeof(Key));
+    setPointerValue(*reinterpret_cast<Key*>(&tmpKey), MAXPOINTER);
+    return boundRank(*reinterpret_cast<const Key*>(&tmpKey), true) - 1;
+}
+
+template<typename KeyValuePair, typename Compare, bool hasRank>
+int CompactingBTree<KeyValuePair, Compare, hasRank>::childIndex(const Internal *parent, const Node *child)
+{
+    int i = 0;
+    while (parent->children[i] != child) {
+        ++i;
+        assert(i < parent->count);
+    }
+    return i;
+}
+
+template<typename KeyValuePair, typename Compare, bool hasRank>
+int64_t CompactingBTree<KeyValuePair, Compare, hasRank>::subtreeCount(const Node *node)
+{
+    if (node->leaf) {
+        return node->count;
+    }
+    const Internal *internal = static_cast<const Internal*>(node);
+    int64_t sum = 0;
+    for (int i = 0; i < internal->count; ++i) {
+        sum += internal->counts[i];
+    }
+    return sum;
+}
+
+template<typename KeyValuePair, typename Compare, bool hasRank>
+void CompactingBTree<KeyValuePair, Compare, hasRank>::addToCounts(Node *node, int64_t delta)
+{
+    if ( ! hasRank) {
+        return;
+    }
+    for (; node->parent != NULL; node = node->parent) {
+        node->parent->counts[childIndex(node->parent, node)] += delta;
+    }
+}
+
+template<typename KeyValuePair, typename Compare, bool hasRank>
+void CompactingBTree<KeyValuePair, Compare, hasRank>::refreshSeparator(Leaf *leaf)
+{
+    // The leaf's first key is copied into the lowest ancestor that has the
+    // leaf's subtree somewhere other than as its first child.
+    assert(leaf->count > 0);
+    Node *x = leaf;
+    while (x->parent != NULL) {
+        Internal *parent = x->parent;
+        int i = childIndex(parent, x);
+        if (i > 0) {
+            parent->setKey(i - 1, leaf->key(0));
+            return;
+        }
+        x = parent;
+    }
+}
+
+template<typename KeyValuePair, typename Compare, bool hasRank>
+bool CompactingBTree<KeyValuePair, Compare, hasRank>::bulkLoad(std::vector<KeyValuePair> &sortedEntries)
+{
+    if (m_count != 0) {
+        return false;
+    }
+    const size_t count = sortedEntries.size();
+    if (m_unique) {
+        for (size_t i = 1; i < count; ++i) {
+            if (m_comper(sortedEntries[i - 1].getKey(), sortedEntries[i].getKey()) == 0) {
+                return false;
+            }
+        }
+    }
+    // Sorted entries always land past the last entry, where leaves split
+    // by starting a new leaf rather than moving half of the full one.
+    for (size_t i = 0; i < count; ++i) {
+        insert(sortedEntries[i].getKey(), sortedEntries[i].getValue());
+    }
+    return true;
+}
+
+template<typename KeyValuePair, typename Compare, bool hasRank>
+const typename CompactingBTree<KeyValuePair, Compare, hasRank>::Data *
+CompactingBTree<KeyValuePair, Compare, hasRank>::insert(const Key &key, const Data &value)
+{
+    if (m_root == NULL) {
+        Leaf *leaf = newLeaf();
+        m_root = m_first = m_last = leaf;
+    }
+
+    Leaf *leaf = descend(key, false, NULL);
+    int slot = slotFor(leaf, key, false);
+    if (m_unique) {
+        // Inserting exact matches fails for unique indexes. The first entry
+        // not below the key may also be the first one in the next leaf.
+        const KeyValuePair *candidate = NULL;
+        if (slot < leaf->count) {
+            candidate = &leaf->entries[slot];
+        }
+        else if (leaf->next != NULL) {
+            candidate = &leaf->next->entries[0];
+        }
+        if (candidate != NULL && m_comper(candidate->getKey(), key) == 0) {
+            return &candidate->getValue();
+        }
+    }
+
+    m_count++;
+    addToCounts(leaf, 1);
+
+    if (leaf->count < LEAF_CAPACITY) {
+        for (int i = leaf->count; i > slot; --i) {
+            leaf->entries[i] = leaf->entries[i - 1];
+        }
+        leaf->entries[slot].setKeyValuePair(key, value);
+        leaf->count++;
+        if (slot == 0) {
+            refreshSeparator(leaf);
+        }
+        return NULL;
+    }
+
+    // Split the full leaf. Appending past the last entry in the tree leaves
+    // the old leaf full, so ascending keys fill their leaves completely.
+    bool appending = (leaf->next == NULL && slot == leaf->count);
+    int split = appending ? LEAF_CAPACITY : LEAF_CAPACITY / 2;
+    Leaf *right = newLeaf();
+    for (int i = split; i < leaf->count; ++i) {
+        right->entries[i - split] = leaf->entries[i];
+    }
+    right->count = leaf->count - split;
+    leaf->count = split;
+
+    right->prev = leaf;
+    right->next = leaf->next;
+    if (leaf->next != NULL) {
+        leaf->next->prev = right;
+    }
+    else {
+        m_last = right;
+    }
+    leaf->next = right;
+
+    Leaf *target = leaf;
+    if (appending || slot > split) {
+        target = right;
+        slot -= split;
+    }
+    for (int i = target->count; i > slot; --i) {
+        target->entries[i] = target->entries[i - 1];
+    }
+    target->entries[slot].setKeyValuePair(key, value);
+    target->count++;
+
+    insertIntoParent(leaf, right->key(0), right, appending);
+    if (target == leaf && slot == 0) {
+        refreshSeparator(leaf);
+    }
+    return NULL;
+}
+
+template<typename KeyValuePair, typename Compare, bool hasRank>
+void CompactingBTree<KeyValuePair, Compare, hasRank>::insertChild(Internal *node, int pos,
+                                                                  const Key &separator, Node *child)
+{
+    assert(pos > 0 && node->count < INTERNAL_CAPACITY);
+    for (int i = node->count; i > pos; --i) {
+        node->children[i] = node->children[i - 1];
+        if (hasRank) {
+            node->counts[i] = node->counts[i - 1];
+        }
+    }
+    for (int i = node->count - 1; i >= pos; --i) {
+        node->keys[i] = node->keys[i - 1];
+    }
+    node->setKey(pos - 1, separator);
+    node->children[pos] = child;
+    child->parent = node;
+    node->count++;
+    if (hasRank) {
+        node->counts[pos - 1] = subtreeCount(node->children[pos - 1]);
+        node->counts[pos] = subtreeCount(child);
+    }
+}
+
+template<typename KeyValuePair, typename Compare, bool hasRank>
+void CompactingBTree<KeyValuePair, Compare, hasRank>::insertIntoParent(Node *left, const Key &separator,
+                                                                       Node *right, bool appending)
+{
+    Internal *parent = left->parent;
+    if (parent == NULL) {
+        Internal *root = newInternal();
+        root->count = 2;
+        root->setKey(0, separator);
+        root->children[0] = left;
+        root->children[1] = right;
+        left->parent = root;
+        right->parent = root;
+        if (hasRank) {
+            root->counts[0] = subtreeCount(left);
+            root->counts[1] = subtreeCount(right);
+        }
+        m_root = root;
+        return;
+    }
+
+    int index = childIndex(parent, left);
+    if (parent->count < INTERNAL_CAPACITY) {
+        insertChild(parent, index + 1, separator, right);
+        return;
+    }
+
+    // Split the full parent, promoting the separator between its halves.
+    int split = appending ? INTERNAL_CAPACITY - 1 : INTERNAL_CAPACITY / 2;
+    Internal *sibling = newInternal();
+    KeyStorage promoted = parent->keys[split - 1];
+    for (int i = split; i < parent->count; ++i) {
+        sibling->children[i - split] = parent->children[i];
+        sibling->children[i - split]->parent = sibling;
+        if (hasRank) {
+            sibling->counts[i - split] = parent->counts[i];
+        }
+        if (i > split) {
+            sibling->keys[i - split - 1] = parent->keys[i - 1];
+        }
+    }
+    sibling->count = parent->count - split;
+    parent->count = split;
+
+    if (index < split) {
+        insertChild(parent, index + 1, separator, right);
+    }
+    else {
+        insertChild(sibling, index - split + 1, separator, right);
+    }
+    insertIntoParent(parent, *reinterpret_cast<const Key*>(&promoted), sibling, appending);
+}
+
+template<typename KeyValuePair, typename Compare, bool hasRank>
+bool CompactingBTree<KeyValuePair, Compare, hasRank>::erase(const Key &key)
+{
+    iterator iter = find(key);
+    if (iter.isEnd()) {
+        return false;
+    }
+    eraseAt(iter.m_leaf, iter.m_slot);
+    return true;
+}
+
+template<typename KeyValuePair, typename Compare, bool hasRank>
+bool CompactingBTree<KeyValuePair, Compare, hasRank>::erase(iterator &iter)
+{
+    assert( ! iter.isEnd());
+    eraseAt(iter.m_leaf, iter.m_slot);
+    return true;
+}
+
+template<typename KeyValuePair, typename Compare, bool hasRank>
+void CompactingBTree<KeyValuePair, Compare, hasRank>::eraseAt(Leaf *leaf, int slot)
+{
+    // Shifting the later entries down carries the deleted one to the end,
+    // where it is released by assigning it a default pair.
+    for (int i = slot + 1; i < leaf->count; ++i) {
+        leaf->entries[i - 1] = leaf->entries[i];
+    }
+    leaf->count--;
+    leaf->entries[leaf->count] = KeyValuePair();
+    m_count--;
+    addToCounts(leaf, -1);
+    if (slot == 0 && leaf->count > 0) {
+        refreshSeparator(leaf);
+    }
+    rebalance(leaf);
+}
+
+template<typename KeyValuePair, typename Compare, bool hasRank>
+void CompactingBTree<KeyValuePair, Compare, hasRank>::rebalance(Node *node)
+{
+    while (node != m_root) {
+        int minimum = MIN_INTERNAL_COUNT;
+        int capacity = INTERNAL_CAPACITY;
+        if (node->leaf) {
+            minimum = MIN_LEAF_COUNT;
+            capacity = LEAF_CAPACITY;
+        }
+        if (node->count >= minimum) {
+            return;
+        }
+        Internal *parent = node->parent;
+        int index = childIndex(parent, node);
+        int leftIndex = (index > 0) ? index - 1 : 0;
+        Node *left = parent->children[leftIndex];
+        Node *right = parent->children[leftIndex + 1];
+        if (left->count + right->count > capacity) {
+            redistribute(parent, leftIndex);
+            return;
+        }
+        node = merge(parent, leftIndex);
+    }
+
+    if (node->leaf) {
+        if (node->count == 0) {
+            m_root = m_first = m_last = NULL;
+            freeLeaf(static_cast<Leaf*>(node));
+        }
+    }
+    else if (node->count == 1) {
+        // Collapse a root with a single child.
+        Internal *root = static_cast<Internal*>(node);
+        m_root = root->children[0];
+        m_root->parent = NULL;
+        freeInternal(root, NULL);
+    }
+}
+
+template<typename KeyValuePair, typename Compare, bool hasRank>
+typename CompactingBTree<KeyValuePair, Compare, hasRank>::Internal*
+CompactingBTree<KeyValuePair, Compare, hasRank>::merge(Internal *parent, int leftIndex)
+{
+    // Move everything in the right node into the left one and free the
+    // right one. Returns the parent, which may have moved in memory.
+    Node *leftNode = parent->children[leftIndex];
+    Node *rightNode = parent->children[leftIndex + 1];
+    if (leftNode->leaf) {
+        Leaf *left = static_cast<Leaf*>(leftNode);
+        Leaf *right = static_cast<Leaf*>(rightNode);
+        for (int i = 0; i < right->count; ++i) {
+            left->entries[left->count + i] = right->entries[i];
+        }
+        left->count += right->count;
+        right->count = 0;
+        left->next = right->next;
+        if (right->next != NULL) {
+            right->next->prev = left;
+        }
+        else {
+            m_last = left;
+        }
+    }
+    else {
+        Internal *left = static_cast<Internal*>(leftNode);
+        Internal *right = static_cast<Internal*>(rightNode);
+        left->keys[left->count - 1] = parent->keys[leftIndex];
+        for (int i = 0; i < right->count; ++i) {
+            left->children[left->count + i] = right->children[i];
+            left->children[left->count + i]->parent = left;
+            if (hasRank) {
+                left->counts[left->count + i] = right->counts[i];
+            }
+            if (i > 0) {
+                left->keys[left->count + i - 1] = right->keys[i - 1];
+            }
+        }
+        left->count += right->count;
+        right->count = 0;
+    }
+
+    if (hasRank) {
+        parent->counts[leftIndex] += parent->counts[leftIndex + 1];
+    }
+    for (int i = leftIndex + 1; i < parent->count - 1; ++i) {
+        parent->children[i] = parent->children[i + 1];
+        if (hasRank) {
+            parent->counts[i] = parent->counts[i + 1];
+        }
+        parent->keys[i - 1] = parent->keys[i];
+    }
+    parent->count--;
+
+    if (leftNode->leaf) {
+        freeLeaf(static_cast<Leaf*>(rightNode));
+        // The merged leaf may have been moved, and may have been emptied
+        // before taking over its sibling's entries.
+        Leaf *merged = static_cast<Leaf*>(parent->children[leftIndex]);
+        if (merged->count > 0) {
+            refreshSeparator(merged);
+        }
+    }
+    else {
+        freeInternal(static_cast<Internal*>(rightNode), &parent);
+    }
+    return parent;
+}
+
+template<typename KeyValuePair, typename Compare, bool hasRank>
+void CompactingBTree<KeyValuePair, Compare, hasRank>::redistribute(Internal *parent, int leftIndex)
+{
+    // Even out the slots used by two adjacent children.
+    Node *leftNode = parent->children[leftIndex];
+    Node *rightNode = parent->children[leftIndex + 1];
+    int target = (leftNode->count + rightNode->count) / 2;
+    if (leftNode->leaf) {
+        Leaf *left = static_cast<Leaf*>(leftNode);
+        Leaf *right = static_cast<Leaf*>(rightNode);
+        if (left->count > target) {
+            int moving = left->count - target;
+            for (int i = right->count - 1; i >= 0; --i) {
+                right->entries[i + moving] = right->entries[i];
+            }
+            for (int i = 0; i < moving; ++i) {
+                right->entries[i] = left->entries[target + i];
+            }
+            left->count = target;
+            right->count += moving;
+        }
+        else {
+            int moving = target - left->count;
+            for (int i = 0; i < moving; ++i) {
+                left->entries[left->count + i] = right->entries[i];
+            }
+            for (int i = moving; i < right->count; ++i) {
+                right->entries[i - moving] = right->entries[i];
+            }
+            left->count = target;
+            right->count -= moving;
+            // An emptied left leaf has a new first key.
+            if (moving == target) {
+                refreshSeparator(left);
+            }
+        }
+        parent->setKey(leftIndex, right->key(0));
+    }
+    else {
+        // Children rotate through the parent's separator.
+        Internal *left = static_cast<Internal*>(leftNode);
+        Internal *right = static_cast<Internal*>(rightNode);
+        if (left->count > target) {
+            int moving = left->count - target;
+            for (int i = right->count - 1; i >= 0; --i) {
+                right->children[i + moving] = right->children[i];
+                if (hasRank) {
+                    right->counts[i + moving] = right->counts[i];
+                }
+            }
+            for (int i = right->count - 2; i >= 0; --i) {
+                right->keys[i + moving] = right->keys[i];
+            }
+            right->keys[moving - 1] = parent->keys[leftIndex];
+            for (int i = 0; i < moving; ++i) {
+                right->children[i] = left->children[target + i];
+                right->children[i]->parent = right;
+                if (hasRank) {
+                    right->counts[i] = left->counts[target + i];
+                }
+                if (i < moving - 1) {
+                    right->keys[i] = left->keys[target + i];
+                }
+            }
+            parent->keys[leftIndex] = left->keys[target - 1];
+            left->count = target;
+            right->count += moving;
+        }
+        else {
+            int moving = target - left->count;
+            left->keys[left->count - 1] = parent->keys[leftIndex];
+            for (int i = 0; i < moving; ++i) {
+                left->children[left->count + i] = right->children[i];
+                left->children[left->count + i]->parent = left;
+                if (hasRank) {
+                    left->counts[left->count + i] = right->counts[i];
+                }
+                if (i < moving - 1) {
+                    left->keys[left->count + i] = right->keys[i];
+                }
+            }
+            parent->keys[leftIndex] = right->keys[moving - 1];
+            for (int i = moving; i < right->count; ++i) {
+                right->children[i - moving] = right->children[i];
+                if (hasRank) {
+                    right->counts[i - moving] = right->counts[i];
+                }
+                if (i < right->count - 1) {
+                    right->keys[i - moving] = right->keys[i];
+                }
+            }
+            left->count = target;
+            right->count -= moving;
+        }
+    }
+    if (hasRank) {
+        parent->counts[leftIndex] = subtreeCount(leftNode);
+        parent->counts[leftIndex + 1] = subtreeCount(rightNode);
+    }
+}
+
+template<typename KeyValuePair, typename Compare, bool hasRank>
+void CompactingBTree<KeyValuePair, Compare, hasRank>::freeLeaf(Leaf *hole)
+{
+    // The hole must already be unlinked from the tree.
+    hole->~Leaf();
+    Leaf *last = static_cast<Leaf*>(m_leafAllocator.last());
+    if (last != hole) {
+        // Move the last leaf into the hole and point its neighbours at it.
+        new (hole) Leaf(*last);
+        if (hole->parent != NULL) {
+            hole->parent->children[childIndex(hole->parent, last)] = hole;
+        }
+        else {
+            m_root = hole;
+        }
+        if (hole->prev != NULL) {
+            hole->prev->next = hole;
+        }
+        else {
+            m_first = hole;
+        }
+        if (hole->next != NULL) {
+            hole->next->prev = hole;
+        }
+        else {
+            m_last = hole;
+        }
+        last->~Leaf();
+    }
+    m_leafAllocator.trim();
+}
+
+template<typename KeyValuePair, typename Compare, bool hasRank>
+void CompactingBTree<KeyValuePair, Compare, hasRank>::freeInternal(Internal *hole, Internal **tracked)
+{
+    // The hole must already be unlinked from the tree. If the node that
+    // *tracked points to is moved, *tracked is updated.
+    Internal *last = static_cast<Internal*>(m_internalAllocator.last());
+    if (last != hole) {
+        ::memcpy(static_cast<void*>(hole), static_cast<const void*>(last), sizeof(Internal));
+        if (hole->parent != NULL) {
+            hole->parent->children[childIndex(hole->parent, last)] = hole;
+        }
+        else {
+            m_root = hole;
+        }
+        for (int i = 0; i < hole->count; ++i) {
+            hole->children[i]->parent = hole;
+        }
+        if (tracked != NULL && *tracked == last) {
+            *tracked = hole;
+        }
+    }
+    m_internalAllocator.trim();
+}
+
+template<typename KeyValuePair, typename Compare, bool hasRank>
+int64_t CompactingBTree<KeyValuePair, Compare, hasRank>::verify(const Node *node, const Key *low,
+                                                                int depth, int &leafDepth) const
+{
+    // Returns the number of entries under the node, or -1 if it is broken.
+    // low is the node's separator: the first key under it, if it has one.
+    if (node != m_root && node->count < 1) {
+        printf("empty non-root node at depth %d\n", depth);
+        return -1;
+    }
+    if (node->leaf) {
+        const Leaf *leaf = static_cast<const Leaf*>(node);
+        if (leafDepth < 0) {
+            leafDepth = depth;
+        }
+        else if (leafDepth != depth) {
+            printf("leaves at depths %d and %d\n", leafDepth, depth);
+            return -1;
+        }
+        if (low != NULL && m_comper(*low, leaf->key(0)) != 0) {
+            printf("separator does not match the first key of its leaf\n");
+            return -1;
+        }
+        return leaf->count;
+    }
+
+    const Internal *internal = static_cast<const Internal*>(node);
+    if (internal->count < 2) {
+        printf("internal node with %d children\n", internal->count);
+        return -1;
+    }
+    int64_t total = 0;
+    for (int i = 0; i < internal->count; ++i) {
+        const Node *child = internal->children[i];
+        if (child->parent != internal) {
+            printf("bad parent pointer at depth %d\n", depth);
+            return -1;
+        }
+        int64_t count = verify(child, (i == 0) ? low : &internal->key(i - 1), depth + 1, leafDepth);
+        if (count < 0) {
+            return -1;
+        }
+        if (hasRank && internal->counts[i] != count) {
+            printf("child count %ld, but %ld entries under it\n", (long)internal->counts[i], (long)count);
+            return -1;
+        }
+        total += count;
+    }
+    return total;
+}
+
+template<typename KeyValuePair, typename Compare, bool hasRank>
+bool CompactingBTree<KeyValuePair, Compare, hasRank>::verify() const
+{
+    if (m_root == NULL) {
+        if (m_count != 0 || m_first != NULL || m_last != NULL) {
+            printf("empty tree with entries or leaves\n");
+            return false;
+        }
+        return m_leafAllocator.count() == 0 && m_internalAllocator.count() == 0;
+    }
+    if (m_root->parent != NULL) {
+        printf("root has a parent\n");
+        return false;
+    }
+    int leafDepth = -1;
+    int64_t total = verify(m_root, NULL, 0, leafDepth);
+    if (total != m_count) {
+        printf("%ld entries under the root, expected %ld\n", (long)total, (long)m_count);
+        return false;
+    }
+
+    // The leaf chain holds every entry in order.
+    int64_t chained = 0;
+    int64_t leaves = 0;
+    const Leaf *prev = NULL;
+    for (const Leaf *leaf = m_first; leaf != NULL; leaf = leaf->next) {
+        if (leaf->prev != prev) {
+            printf("bad prev link in leaf chain\n");
+            return false;
+        }
+        for (int i = 0; i < leaf->count; ++i) {
+            const Key *before = NULL;
+            if (i > 0) {
+                before = &leaf->key(i - 1);
+            }
+            else if (prev != NULL) {
+                before = &prev->key(prev->count - 1);
+            }
+            if (before != NULL) {
+                int cmp = m_comper(*before, leaf->key(i));
+                if (cmp > 0 || (m_unique && cmp == 0)) {
+                    printf("leaf entries out of order\n");
+                    return false;
+                }
+            }
+        }
+        chained += leaf->count;
+        ++leaves;
+        prev = leaf;
+    }
+    if (prev != m_last) {
+        printf("last leaf is not at the end of the chain\n");
+        return false;
+    }
+    if (chained != m_count || leaves != m_leafAllocator.count()) {
+        printf("%ld entries in %ld chained leaves, expected %ld in %ld\n",
+               (long)chained, (long)leaves, (long)m_count, (long)m_leafAllocator.count());
+        return false;
+    }
+    return true;
+}
+
+template<typename KeyValuePair, typename Compare, bool hasRank>
+bool CompactingBTree<KeyValuePair, Compare, hasRank>::verifyRank() const
+{
+    if ( ! hasRank) {
+        return true;
+    }
+    iterator iter = begin();
+    for (int64_t i = 1; i <= m_count; i++, iter.moveNext()) {
+        iterator ranked = findRank(i);
+        if ( ! ranked.equals(iter)) {
+            printf("false: rank %ld is not the %ldth entry\n", (long)i, (long)i);
+            return false;
+        }
+        int64_t rkasc = rankAsc(iter.key());
+        int64_t rkUpper = rankUpper(iter.key());
+        if (m_unique ? (rkasc != i) : (rkasc > i || rkUpper < i)) {
+            printf("false: rank %ld between rankAsc %ld and rankUpper %ld\n",
+                   (long)i, (long)rkasc, (long)rkUpper);
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace voltdb
+
+#endif // COMPACTINGBTREE_H_
@@ -19,14 +19,15 @@
 #define COMPACTINGHASHTABLE_H_
 
 #include "ContiguousAllocator.h"
+#include "common/PageAllocator.h"
 
+#include <algorithm>
 #include <cstdlib>
 #include <utility>
 #include <cassert>
 #include <climits>
 #include <iostream>
 #include <cstring>
-#include <sys/mman.h>
 #include <boost/functional/hash.hpp>
 #include <stdint.h>
 
@@ -46,6 +47,10 @@ namespace voltdb {
      *    doesn't support iteration over all values.
      * 4. It allocates over a megabyte when it only contains a single value. It's not as useful for
      *    smaller, more general usage.
+     * 5. It grows and shrinks incrementally. A resize allocates the new bucket array and then
+     *    each later insert or erase migrates a few of the old buckets into it, so no single
+     *    operation has to rehash the whole table. Until the migration completes, a key lives in
+     *    its old bucket if that bucket has not been migrated yet and in its new bucket otherwise.
      */
     template<class K, class T, class H = boost::hash<K>, class EK = std::equal_to<K>, class ET = std::equal_to<T> >
     class CompactingHashTable {
@@ -63,8 +68,12 @@ namespace voltdb {
         // shrink when the hash table is 15% full
         // (new hash will be 30% full)
         static const uint64_t MIN_LOAD_FACTOR = 15; // %
+        // old buckets migrated by each insert or erase during a resize,
+        // enough to finish before the new table can need resizing again
+        static const uint64_t REHASH_BUCKETS_PER_OPERATION = 32;
 
         static const uint64_t TABLE_SIZES[];
+        static const int TABLE_SIZES_COUNT = 32;
 
 #ifndef MEMCHECK
 
@@ -117,6 +126,10 @@ namespace voltdb {
         uint64_t m_count;                 // number of items in the hash
         uint64_t m_uniqueCount;           // number of unique keys
         int m_sizeIndex;                  // current bucket count (from array)
+        HashNode **m_oldBuckets;          // buckets being migrated by a resize, or NULL
+        int m_oldSizeIndex;               // old bucket count (from array)
+        uint64_t m_migratedBuckets;       // old buckets already migrated
+        int m_minSizeIndex;               // don't shrink below this (see reserve)
         ContiguousAllocator m_allocator;  // allocator supporting compaction
         Hasher m_hasher;                  // instance of the hashing function
         KeyEqChecker m_keyEq;             // instance of the key eq checker
@@ -173,8 +186,20 @@ namespace voltdb {
         /** STL-ish size() method */
         size_t size() const { return m_count; }
 
+        /** size the buckets for count unique keys ahead of a batch of inserts */
+        void reserve(uint64_t count);
+
         /** Return bytes used for this index */
-        size_t bytesAllocated() const { return m_allocator.bytesAllocated() + TABLE_SIZES[m_sizeIndex] * sizeof(HashNode*); }
+        size_t bytesAllocated() const {
+            size_t bytes = m_allocator.bytesAllocated() + TABLE_SIZES[m_sizeIndex] * sizeof(HashNode*);
+            if (m_oldBuckets) {
+                bytes += TABLE_SIZES[m_oldSizeIndex] * sizeof(HashNode*);
+            }
+            return bytes;
+        }
+
+        /** Is a resize still migrating buckets?  This is used in testing. */
+        bool isResizing() const { return m_oldBuckets != NULL; }
 
         /** verification for debugging and testing */
         bool verify();
@@ -182,6 +207,8 @@ namespace voltdb {
         bool hasCachedLastBuffer() const { return (m_allocator.hasCachedLastBuffer()); }
 
     protected:
+        /** the bucket that holds (or would hold) nodes with this hash */
+        HashNode **bucketFor(uint64_t hash) const;
         /** find, given a bucket/key */
         HashNode *find(const HashNode *bucket, const Key &key) const;
         /** find and exact match, given a bucket */
@@ -197,12 +224,14 @@ namespace voltdb {
 
         /** see if the hash needs to grow or shrink */
         void checkLoadFactor();
-        /** grow/shrink the hash table */
+        /** start growing/shrinking the hash table */
         void resize(int newSizeIndex);
+        /** migrate up to maxBuckets old buckets, freeing the old array when done */
+        void migrateBuckets(uint64_t maxBuckets);
     };
 
     template<class K, class T, class H, class EK, class ET>
-    const uint64_t CompactingHashTable<K, T, H, EK, ET>::TABLE_SIZES[] = {
+    const uint64_t CompactingHashTable<K, T, H, EK, ET>::TABLE_SIZES[TABLE_SIZES_COUNT] = {
         3,
         7,
         13,
@@ -250,20 +279,28 @@ namespace voltdb {
     m_count(0),
     m_uniqueCount(0),
     m_sizeIndex(BUCKET_INITIAL_INDEX),
+    m_oldBuckets(NULL),
+    m_oldSizeIndex(BUCKET_INITIAL_INDEX),
+    m_migratedBuckets(0),
+    m_minSizeIndex(BUCKET_INITIAL_INDEX),
     m_allocator((int32_t)(unique ? sizeof(HashNodeSmall) : sizeof(HashNode)), ALLOCATOR_CHUNK_SIZE),
     m_hasher(hasher),
     m_keyEq(keyEq),
     m_dataEq(dataEq)
     {
         // allocate the hash table and bzero it (bzero is crucial)
-        void *memory = mmap(NULL, sizeof(HashNode*) * TABLE_SIZES[m_sizeIndex], PROT_WRITE, MAP_PRIVATE | MAP_ANON, -1, 0);
-        assert(memory);
+        void *memory = PageAllocator::allocate(sizeof(HashNode*) * TABLE_SIZES[m_sizeIndex]);
         m_buckets = reinterpret_cast<HashNode**>(memory);
         memset(m_buckets, 0, sizeof(HashNode*) * TABLE_SIZES[m_sizeIndex]);
     }
 
     template<class K, class T, class H, class EK, class ET>
     CompactingHashTable<K, T, H, EK, ET>::~CompactingHashTable() {
+        // put every node in the current buckets, so they are all unlinked below
+        if (m_oldBuckets) {
+            migrateBuckets(TABLE_SIZES[m_oldSizeIndex]);
+        }
+
         // unlink all of the nodes, which will call destructors correctly
         for (size_t i = 0; i < TABLE_SIZES[m_sizeIndex]; ++i) {
             while (m_buckets[i]) {
@@ -279,7 +316,7 @@ namespace voltdb {
         }
 
         // delete the hashtable
-        munmap(m_buckets, sizeof(HashNode*) * TABLE_SIZES[m_sizeIndex]);
+        PageAllocator::deallocate(m_buckets, sizeof(HashNode*) * TABLE_SIZES[m_sizeIndex]);
 
         // when the allocator gets cleaned up, it will
         // free the memory used for nodes
@@ -288,25 +325,21 @@ namespace voltdb {
     template<class K, class T, class H, class EK, class ET>
     typename CompactingHashTable<K, T, H, EK, ET>::iterator CompactingHashTable<K, T, H, EK, ET>::find(const Key &key) const {
         uint64_t hash = m_hasher(key);
-        uint64_t bucketOffset = hash % TABLE_SIZES[m_sizeIndex];
-        const HashNode *foundNode = find(m_buckets[bucketOffset], key);
+        const HashNode *foundNode = find(*bucketFor(hash), key);
         return iterator(foundNode);
     }
 
     template<class K, class T, class H, class EK, class ET>
     typename CompactingHashTable<K, T, H, EK, ET>::iterator CompactingHashTable<K, T, H, EK, ET>::find(const Key &key, const Data &value) const {
         uint64_t hash = m_hasher(key);
-        uint64_t bucketOffset = hash % TABLE_SIZES[m_sizeIndex];
-        const HashNode *foundNode = find(m_buckets[bucketOffset], key, value);
+        const HashNode *foundNode = find(*bucketFor(hash), key, value);
         return iterator(foundNode);
     }
 
     template<class K, class T, class H, class EK, class ET>
     const typename CompactingHashTable<K, T, H, EK, ET>::Data *CompactingHashTable<K, T, H, EK, ET>::insert(const Key &key, const Data &value) {
         uint64_t hash = m_hasher(key);
-
-        uint64_t bucketOffset = hash % TABLE_SIZES[m_sizeIndex];
-        return insert(&(m_buckets[bucketOffset]), hash, key, value);
+        return insert(bucketFor(hash), hash, key, value);
     }
 
     template<class K, class T, class H, class EK, class ET>
@@ -314,11 +347,11 @@ namespace voltdb {
         assert(m_unique);
         HashNode *prevBucketNode = NULL;
         uint64_t hash = m_hasher(key);
-        uint64_t bucketOffset = hash % TABLE_SIZES[m_sizeIndex];
+        HashNode **bucket = bucketFor(hash);
 
-        for (HashNode *node = m_buckets[bucketOffset]; node; node = node->nextInBucket) {
+        for (HashNode *node = *bucket; node; node = node->nextInBucket) {
             if (m_keyEq(node->key, key)) {
-                removeUnique(&(m_buckets[bucketOffset]), prevBucketNode, node);
+                removeUnique(bucket, prevBucketNode, node);
                 deleteAndFixup(node);
                 checkLoadFactor();
                 return true;
@@ -333,13 +366,13 @@ namespace voltdb {
     bool CompactingHashTable<K, T, H, EK, ET>::erase(const Key &key, const Data &value) {
         HashNode *prevBucketNode = NULL, *keyHeadNode = NULL, *prevKeyNode = NULL;
         uint64_t hash = m_hasher(key);
-        uint64_t bucketOffset = hash % TABLE_SIZES[m_sizeIndex];
+        HashNode **bucket = bucketFor(hash);
 
-        for (HashNode *node = m_buckets[bucketOffset]; node; node = node->nextInBucket) {
+        for (HashNode *node = *bucket; node; node = node->nextInBucket) {
             if (m_keyEq(node->key, key)) {
                 if (m_unique) {
                     if (!m_dataEq(node->value, value)) return false;
-                    removeUnique(&(m_buckets[bucketOffset]), prevBucketNode, node);
+                    removeUnique(bucket, prevBucketNode, node);
                     deleteAndFixup(node);
                     checkLoadFactor();
                     return true;
@@ -347,7 +380,7 @@ namespace voltdb {
                 keyHeadNode = node;
                 for (node = keyHeadNode; node; node = node->nextWithKey) {
                     if (m_dataEq(node->value, value)) {
-                        remove(&(m_buckets[bucketOffset]), prevBucketNode, keyHeadNode, prevKeyNode, node);
+                        remove(bucket, prevBucketNode, keyHeadNode, prevKeyNode, node);
                         deleteAndFixup(node);
                         checkLoadFactor();
                         return true;
@@ -368,6 +401,17 @@ namespace voltdb {
         else return erase(iter.key(), iter.value());
     }
 
+    template<class K, class T, class H, class EK, class ET>
+    typename CompactingHashTable<K, T, H, EK, ET>::HashNode **CompactingHashTable<K, T, H, EK, ET>::bucketFor(uint64_t hash) const {
+        if (m_oldBuckets) {
+            uint64_t oldOffset = hash % TABLE_SIZES[m_oldSizeIndex];
+            if (oldOffset >= m_migratedBuckets) {
+                return &(m_oldBuckets[oldOffset]);
+            }
+        }
+        return &(m_buckets[hash % TABLE_SIZES[m_sizeIndex]]);
+    }
+
     template<class K, class T, class H, class EK, class ET>
     typename CompactingHashTable<K, T, H, EK, ET>::HashNode *CompactingHashTable<K, T, H, EK, ET>::find(const HashNode *bucket, const Key &key) const {
         for (HashNode *node = const_cast<HashNode*>(bucket); node; node = node->nextInBucket) {
@@ -514,11 +558,11 @@ namespace voltdb {
         }
 
         // find the bucket for the last node
-        uint64_t bucketOffset = last->hash % TABLE_SIZES[m_sizeIndex];
+        HashNode **bucket = bucketFor(last->hash);
 
         // find the last node and what points to it
         HashNode *prevBucketNode = NULL, *keyHeadNode = NULL, *prevKeyNode = NULL;
-        for (HashNode *n = m_buckets[bucketOffset]; n; n = n->nextInBucket) {
+        for (HashNode *n = *bucket; n; n = n->nextInBucket) {
             prevKeyNode = NULL;
             keyHeadNode = n;
             if (m_unique) {
@@ -532,7 +576,7 @@ namespace voltdb {
                     prevBucketNode->nextInBucket = node;
                 }
                 else {
-                    m_buckets[bucketOffset] = node;
+                    *bucket = node;
                 }
 
                 // copy the last node over the deleted node
@@ -566,7 +610,7 @@ namespace voltdb {
                             prevBucketNode->nextInBucket = node;
                         }
                         else {
-                            m_buckets[bucketOffset] = node;
+                            *bucket = node;
                         }
                     }
 
@@ -595,6 +639,10 @@ namespace voltdb {
 
     template<class K, class T, class H, class EK, class ET>
     void CompactingHashTable<K, T, H, EK, ET>::checkLoadFactor() {
+        if (m_oldBuckets) {
+            migrateBuckets(REHASH_BUCKETS_PER_OPERATION);
+        }
+
         uint64_t lf = (m_uniqueCount * 100) / TABLE_SIZES[m_sizeIndex];
         int newSizeIndex = m_sizeIndex;
         if (lf > MAX_LOAD_FACTOR) {
@@ -602,71 +650,97 @@ namespace voltdb {
         }
         else if(lf < MIN_LOAD_FACTOR) {
             // make sure the hash doesn't over-shrink
-            if (newSizeIndex != BUCKET_INITIAL_INDEX) {
+            if (newSizeIndex > m_minSizeIndex) {
                 newSizeIndex--;
             }
         }
+        else {
+            // a reservation lasts until the keys it was made for arrive
+            m_minSizeIndex = BUCKET_INITIAL_INDEX;
+        }
         if (newSizeIndex != m_sizeIndex) {
             resize(newSizeIndex);
         }
     }
 
+    template<class K, class T, class H, class EK, class ET>
+    void CompactingHashTable<K, T, H, EK, ET>::reserve(uint64_t count) {
+        const int maxSizeIndex = TABLE_SIZES_COUNT - 1;
+        int newSizeIndex = m_sizeIndex;
+        while (newSizeIndex < maxSizeIndex && (count * 100) / TABLE_SIZES[newSizeIndex] > MAX_LOAD_FACTOR) {
+            newSizeIndex++;
+        }
+        if (newSizeIndex == m_sizeIndex) {
+            return;
+        }
+        m_minSizeIndex = newSizeIndex;
+        resize(newSizeIndex);
+        // the caller is about to insert; don't make those inserts pay for the migration
+        migrateBuckets(TABLE_SIZES[m_oldSizeIndex]);
+    }
+
     template<class K, class T, class H, class EK, class ET>
     void CompactingHashTable<K, T, H, EK, ET>::resize(int newSizeIndex) {
-        //std::cout << "DEBUG SIZING BUFFER" << newSizeIndex << std::endl;
-        //std::cout.flush();
+        // only one resize can be in flight, so finish any earlier one
+        if (m_oldBuckets) {
+            migrateBuckets(TABLE_SIZES[m_oldSizeIndex]);
+        }
 
         // create new double size buffer
-        void *memory = mmap(NULL, sizeof(HashNode*) * TABLE_SIZES[newSizeIndex], PROT_WRITE, MAP_PRIVATE | MAP_ANON, -1, 0);
-        assert(memory);
+        void *memory = PageAllocator::allocate(sizeof(HashNode*) * TABLE_SIZES[newSizeIndex]);
         HashNode **newBuckets = reinterpret_cast<HashNode**>(memory);
         memset(newBuckets, 0, TABLE_SIZES[newSizeIndex] * sizeof(HashNode*));
 
-        // move all of the existing values
-        for (uint32_t i = 0; i < TABLE_SIZES[m_sizeIndex]; ++i) {
-            while (m_buckets[i]) {
-                HashNode *node = m_buckets[i];
-                m_buckets[i] = node->nextInBucket;
+        // the existing values move over a few buckets at a time
+        m_oldBuckets = m_buckets;
+        m_oldSizeIndex = m_sizeIndex;
+        m_migratedBuckets = 0;
+        m_buckets = newBuckets;
+        m_sizeIndex = newSizeIndex;
+    }
 
-                uint64_t bucketOffset = node->hash % TABLE_SIZES[newSizeIndex];
-                node->nextInBucket = newBuckets[bucketOffset];
-                newBuckets[bucketOffset] = node;
+    template<class K, class T, class H, class EK, class ET>
+    void CompactingHashTable<K, T, H, EK, ET>::migrateBuckets(uint64_t maxBuckets) {
+        assert(m_oldBuckets);
+        const uint64_t oldSize = TABLE_SIZES[m_oldSizeIndex];
+        const uint64_t end = std::min(oldSize, m_migratedBuckets + maxBuckets);
+        for (uint64_t i = m_migratedBuckets; i < end; ++i) {
+            while (m_oldBuckets[i]) {
+                HashNode *node = m_oldBuckets[i];
+                m_oldBuckets[i] = node->nextInBucket;
+
+                uint64_t bucketOffset = node->hash % TABLE_SIZES[m_sizeIndex];
+                node->nextInBucket = m_buckets[bucketOffset];
+                m_buckets[bucketOffset] = node;
             }
         }
+        m_migratedBuckets = end;
 
-        // swap the table buffers
-        munmap(m_buckets, TABLE_SIZES[m_sizeIndex] * sizeof(HashNode*));
-        m_buckets = newBuckets;
-        m_sizeIndex = newSizeIndex;
+        if (m_migratedBuckets == oldSize) {
+            PageAllocator::deallocate(m_oldBuckets, oldSize * sizeof(HashNode*));
+            m_oldBuckets = NULL;
+            m_migratedBuckets = 0;
+        }
     }
 
     template<class K, class T, class H, class EK, class ET>
     bool CompactingHashTable<K, T, H, EK, ET> ::verify() {
         size_t manualCount = 0;
 
-        for (uint64_t bucketi = 0; bucketi < TABLE_SIZES[m_sizeIndex]; ++bucketi) {
-            for (HashNode *node = m_buckets[bucketi]; node; node = node->nextInBucket) {
-                if (m_unique) {
-                    uint64_t hash = m_hasher(node->key);
-                    if (hash != node->hash) {
-                        printf("Node hash doesn't match expected value.\n");
-                        return false;
-                    }
-                    if ((hash % TABLE_SIZES[m_sizeIndex]) != bucketi) {
-                        printf("Node hash doesn't match expected bucket index.\n");
-                        return false;
-                    }
-
-                    ++manualCount;
-                }
-                else {
-                    for (HashNode *node2 = node; node2; node2 = node2->nextWithKey) {
+        // during a resize the nodes are split between the two bucket arrays
+        HashNode **arrays[2] = { m_buckets, m_oldBuckets };
+        const int sizeIndexes[2] = { m_sizeIndex, m_oldSizeIndex };
+        for (int arrayi = 0; arrayi < 2 && arrays[arrayi]; ++arrayi) {
+            HashNode **buckets = arrays[arrayi];
+            for (uint64_t bucketi = 0; bucketi < TABLE_SIZES[sizeIndexes[arrayi]]; ++bucketi) {
+                for (HashNode *node = buckets[bucketi]; node; node = node->nextInBucket) {
+                    for (HashNode *node2 = node; node2; node2 = m_unique ? NULL : node2->nextWithKey) {
                         uint64_t hash = m_hasher(node2->key);
                         if (hash != node2->hash) {
                             printf("Node hash doesn't match expected value.\n");
                             return false;
                         }
-                        if ((hash % TABLE_SIZES[m_sizeIndex]) != bucketi) {
+                        if (bucketFor(hash) != &(buckets[bucketi])) {
                             printf("Node hash doesn't match expected bucket index.\n");
                             return false;
                         }
@@ -25,6 +25,7 @@
 #include <utility>
 #include <limits>
 #include <cassert>
+#include <vector>
 
 typedef u_int32_t NodeCount;
 
@@ -199,6 +200,11 @@ public:
     bool insert(std::pair<Key, Data> value) { return (insert(value.first, value.second) == NULL); };
     // A syntactically convenient analog to CompactingHashTable's insert function
     const Data *insert(const Key &key, const Data &data);
+    // Fill an empty map, in linear time, from entries already sorted by the
+    // map's comparator. The entries' keys are assigned into the map.
+    // Returns false, leaving the map empty, if the map was not empty or
+    // a unique map's entries contain equal keys.
+    bool bulkLoad(std::vector<KeyValuePair> &sortedEntries);
     bool erase(const Key &key);
     bool erase(iterator &iter);
 
@@ -244,6 +250,8 @@ protected:
     void erase(TreeNode *z);
     TreeNode *lookup(const Key &key) const;
     TreeNode *lookupRank(int64_t ith) const;
+    TreeNode *buildSubtree(std::vector<KeyValuePair> &sortedEntries, int64_t lo, int64_t hi,
+                           TreeNode *parent, int depth, int redDepth);
 
     inline int64_t getSubct(const TreeNode* x) const;
     inline void incSubct(TreeNode* x);
@@ -292,6 +300,59 @@ CompactingMap<KeyValuePair, Compare, hasRank>::~CompactingMap()
     }
 }
 
+template<typename KeyValuePair, typename Compare, bool hasRank>
+bool CompactingMap<KeyValuePair, Compare, hasRank>::bulkLoad(std::vector<KeyValuePair> &sortedEntries)
+{
+    if (m_count != 0) {
+        return false;
+    }
+    const int64_t count = static_cast<int64_t>(sortedEntries.size());
+    if (count == 0) {
+        return true;
+    }
+    if (m_unique) {
+        for (int64_t i = 1; i < count; ++i) {
+            if (m_comper(sortedEntries[i - 1].getKey(), sortedEntries[i].getKey()) == 0) {
+                return false;
+            }
+        }
+    }
+
+    // Rooting each range at its middle entry puts every leaf on the
+    // bottom two levels. Coloring only the bottom level red then gives
+    // every path from the root the same number of black nodes.
+    int redDepth = 0;
+    while ((static_cast<int64_t>(2) << redDepth) <= count) {
+        ++redDepth;
+    }
+    m_root = buildSubtree(sortedEntries, 0, count, &NIL, 0, redDepth);
+    m_root->color = BLACK;
+    m_count = count;
+    assert(m_allocator.count() == m_count);
+    return true;
+}
+
+template<typename KeyValuePair, typename Compare, bool hasRank>
+typename CompactingMap<KeyValuePair, Compare, hasRank>::TreeNode *
+CompactingMap<KeyValuePair, Compare, hasRank>::buildSubtree(std::vector<KeyValuePair> &sortedEntries,
+                                                            int64_t lo, int64_t hi,
+                                                            TreeNode *parent, int depth, int redDepth)
+{
+    if (lo >= hi) {
+        return &NIL;
+    }
+    const int64_t mid = lo + (hi - lo) / 2;
+    TreeNode *z = new (m_allocator) TreeNode(&NIL, parent);
+    z->kv.setKeyValuePair(sortedEntries[mid].getKey(), sortedEntries[mid].getValue());
+    z->color = (depth == redDepth) ? RED : BLACK;
+    z->left = buildSubtree(sortedEntries, lo, mid, z, depth + 1, redDepth);
+    z->right = buildSubtree(sortedEntries, mid + 1, hi, z, depth + 1, redDepth);
+    if (hasRank) {
+        updateSubct(z);
+    }
+    return z;
+}
+
 template<typename KeyValuePair, typename Compare, bool hasRank>
 bool CompactingMap<KeyValuePair, Compare, hasRank>::erase(const Key &key)
 {
@@ -0,0 +1,280 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2018 VoltDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with VoltDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef FLATHASHMAP_H_
+#define FLATHASHMAP_H_
+
+#include <cassert>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <utility>
+#include <vector>
+#include <stdint.h>
+#include <boost/functional/hash.hpp>
+
+namespace voltdb {
+
+    /**
+     * FlatHashMap is an open-addressing hash map with linear probing,
+     * templated on the key and value.  It supports the subset of the
+     * boost::unordered_map interface used by hash aggregation.
+     *
+     * It is special in that:
+     * 1. All entries live in one contiguous array of slots, each
+     *    holding the key, the value and the key's (pre modded) hash,
+     *    so a probe touches consecutive memory and most mismatches are
+     *    rejected by comparing hashes without calling the equality
+     *    checker on the keys.
+     * 2. Growing re-uses the stored hashes and never re-hashes a key.
+     * 3. clear() keeps the slot array (unless it is much larger than
+     *    what was last used), so a map that is repeatedly filled and
+     *    cleared does not reallocate.
+     * 4. It does not support erasing individual entries, and keys and
+     *    values are expected to be cheap to copy (e.g., TableTuples
+     *    and pointers).
+     */
+    template<class K, class T, class H = boost::hash<K>, class EK = std::equal_to<K> >
+    class FlatHashMap {
+    public:
+        typedef K key_type;
+        typedef T mapped_type;
+        typedef std::pair<K, T> value_type;
+        typedef H hasher;
+        typedef EK key_equal;
+
+        // grow when the table is 75% full
+        static const size_t MAX_LOAD_FACTOR = 75; // %
+        static const size_t INITIAL_CAPACITY = 16;
+
+    private:
+        /**
+         * A hash of zero marks an empty slot; keys that really hash
+         * to zero are stored with a hash of one instead.
+         */
+        struct Slot {
+            uint64_t hash;
+            value_type entry;
+        };
+
+        template <class SlotType, class ValueType>
+        class IteratorBase : public std::iterator<std::forward_iterator_tag, ValueType> {
+            friend class FlatHashMap;
+        public:
+            IteratorBase() : m_slot(NULL), m_end(NULL) { }
+
+            // allow iterator to const_iterator conversion
+            template <class S, class V>
+            IteratorBase(const IteratorBase<S, V>& other) : m_slot(other.m_slot), m_end(other.m_end) { }
+
+            ValueType& operator*() const { return m_slot->entry; }
+            ValueType* operator->() const { return &(m_slot->entry); }
+
+            IteratorBase& operator++() {
+                ++m_slot;
+                skipEmpty();
+                return *this;
+            }
+
+            IteratorBase operator++(int) {
+                IteratorBase result(*this);
+                ++(*this);
+                return result;
+            }
+
+            template <class S, class V>
+            bool operator==(const IteratorBase<S, V>& other) const { return m_slot == other.m_slot; }
+            template <class S, class V>
+            bool operator!=(const IteratorBase<S, V>& other) const { return m_slot != other.m_slot; }
+
+        private:
+            template <class S, class V> friend class IteratorBase;
+
+            IteratorBase(SlotType* slot, SlotType* end) : m_slot(slot), m_end(end) {
+                skipEmpty();
+            }
+
+            void skipEmpty() {
+                while (m_slot != m_end && m_slot->hash == 0) {
+                    ++m_slot;
+                }
+            }
+
+            SlotType* m_slot;
+            SlotType* m_end;
+        };
+
+    public:
+        typedef IteratorBase<Slot, value_type> iterator;
+        typedef IteratorBase<const Slot, const value_type> const_iterator;
+
+        FlatHashMap() : m_slots(), m_size(0), m_mask(0), m_shift(64) { }
+
+        size_t size() const { return m_size; }
+        bool empty() const { return m_size == 0; }
+
+        /** The number of slots in the slot array */
+        size_t bucket_count() const { return m_slots.size(); }
+
+        /** The number of bytes used by the slot array */
+        size_t allocatedMemory() const { return m_slots.capacity() * sizeof(Slot); }
+
+        iterator begin() { return iterator(slotsBegin(), slotsEnd()); }
+        iterator end() { return iterator(slotsEnd(), slotsEnd()); }
+        const_iterator begin() const { return const_iterator(slotsBegin(), slotsEnd()); }
+        const_iterator end() const { return const_iterator(slotsEnd(), slotsEnd()); }
+
+        iterator find(const K& key) {
+            if (m_size == 0) {
+                return end();
+            }
+            uint64_t hash = hashKey(key);
+            size_t index = findIndex(key, hash);
+            if (m_slots[index].hash == 0) {
+                return end();
+            }
+            return iterator(&m_slots[index], slotsEnd());
+        }
+
+        const_iterator find(const K& key) const {
+            return const_cast<FlatHashMap*>(this)->find(key);
+        }
+
+        /**
+         * Insert the pair if its key is not already present.  Returns
+         * the entry for the key, and whether the pair was inserted.
+         */
+        std::pair<iterator, bool> insert(const value_type& value) {
+            if ((m_size + 1) * 100 > m_slots.size() * MAX_LOAD_FACTOR) {
+                grow();
+            }
+
+            uint64_t hash = hashKey(value.first);
+            size_t index = findIndex(value.first, hash);
+            Slot& slot = m_slots[index];
+            if (slot.hash != 0) {
+                return std::make_pair(iterator(&slot, slotsEnd()), false);
+            }
+
+            slot.hash = hash;
+            slot.entry = value;
+            ++m_size;
+            return std::make_pair(iterator(&slot, slotsEnd()), true);
+        }
+
+        /** Remove all the entries. */
+        void clear() {
+            if (m_slots.size() > INITIAL_CAPACITY && m_size * 100 < m_slots.size() * MAX_LOAD_FACTOR / 8) {
+                // The slot array is much larger than it needed to be
+                // this time around; size it for what was used instead.
+                size_t capacity = INITIAL_CAPACITY;
+                while (m_size * 100 > capacity * MAX_LOAD_FACTOR) {
+                    capacity *= 2;
+                }
+                std::vector<Slot>().swap(m_slots);
+                allocate(capacity);
+            }
+            else if (m_size > 0) {
+                for (size_t i = 0; i < m_slots.size(); ++i) {
+                    m_slots[i].hash = 0;
+                }
+            }
+            m_size = 0;
+        }
+
+        void swap(FlatHashMap& other) {
+            m_slots.swap(other.m_slots);
+            std::swap(m_size, other.m_size);
+            std::swap(m_mask, other.m_mask);
+            std::swap(m_shift, other.m_shift);
+            std::swap(m_hasher, other.m_hasher);
+            std::swap(m_keyEq, other.m_keyEq);
+        }
+
+    private:
+        Slot* slotsBegin() { return m_slots.empty() ? NULL : &m_slots[0]; }
+        Slot* slotsEnd() { return slotsBegin() + m_slots.size(); }
+        const Slot* slotsBegin() const { return m_slots.empty() ? NULL : &m_slots[0]; }
+        const Slot* slotsEnd() const { return slotsBegin() + m_slots.size(); }
+
+        uint64_t hashKey(const K& key) const {
+            uint64_t hash = static_cast<uint64_t>(m_hasher(key));
+            return hash == 0 ? 1 : hash;
+        }
+
+        /**
+         * The slot index for a hash.  Multiplying by 2^64 / phi and
+         * taking the high bits spreads hashers whose low bits are
+         * poorly distributed.
+         */
+        size_t homeIndex(uint64_t hash) const {
+            return static_cast<size_t>((hash * 0x9E3779B97F4A7C15ULL) >> m_shift) & m_mask;
+        }
+
+        /** The slot holding the key, or the empty slot where it belongs. */
+        size_t findIndex(const K& key, uint64_t hash) const {
+            size_t index = homeIndex(hash);
+            while (true) {
+                const Slot& slot = m_slots[index];
+                if (slot.hash == 0 || (slot.hash == hash && m_keyEq(slot.entry.first, key))) {
+                    return index;
+                }
+                index = (index + 1) & m_mask;
+            }
+        }
+
+        void allocate(size_t capacity) {
+            assert((capacity & (capacity - 1)) == 0);
+            Slot empty;
+            empty.hash = 0;
+            m_slots.assign(capacity, empty);
+            m_mask = capacity - 1;
+            m_shift = 64;
+            for (size_t c = capacity; c > 1; c >>= 1) {
+                --m_shift;
+            }
+        }
+
+        void grow() {
+            std::vector<Slot> old;
+            old.swap(m_slots);
+            allocate(old.empty() ? INITIAL_CAPACITY : old.size() * 2);
+
+            for (size_t i = 0; i < old.size(); ++i) {
+                if (old[i].hash == 0) {
+                    continue;
+                }
+                // Keys are unique, so just find the first empty slot.
+                size_t index = homeIndex(old[i].hash);
+                while (m_slots[index].hash != 0) {
+                    index = (index + 1) & m_mask;
+                }
+                m_slots[index] = old[i];
+            }
+        }
+
+        std::vector<Slot> m_slots;
+        size_t m_size;
+        size_t m_mask;
+        int m_shift;
+        H m_hasher;
+        EK m_keyEq;
+    };
+
+} // namespace voltdb
+
+#endif // FLATHASHMAP_H_
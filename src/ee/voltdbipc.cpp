@@ -29,9 +29,11 @@
 #include "storage/table.h"
 
 #include "common/ElasticHashinator.h"
+#include "common/PageAllocator.h"
 #include "common/RecoveryProtoMessage.h"
 #include "common/serializeio.h"
 #include "common/SegvException.hpp"
+#include "common/StreamBufferPool.h"
 #include "common/types.h"
 
 #include <signal.h>
@@ -191,6 +193,10 @@ private:
 
     void threadLocalPoolAllocations();
 
+    void pageAllocatorStats();
+
+    void streamBufferPoolStats();
+
     void applyBinaryLog(struct ipc_command*);
 
     void executeTask(struct ipc_command*);
@@ -543,6 +549,14 @@ bool VoltDBIPC::execute(struct ipc_command *cmd) {
           applyBinaryLog(cmd);
           result = kErrorCode_None;
           break;
+      case 30:
+          pageAllocatorStats();
+          result = kErrorCode_None;
+          break;
+      case 31:
+          streamBufferPoolStats();
+          result = kErrorCode_None;
+          break;
       default:
         result = stub(cmd);
     }
@@ -632,6 +646,7 @@ int8_t VoltDBIPC::initialize(struct ipc_command *cmd) {
         int64_t logLevels;
         int64_t tempTableMemory;
         int32_t createDrReplicatedStream;
+        int32_t options;
         int32_t hostnameLength;
         char data[0];
     }__attribute__((packed));
@@ -651,6 +666,7 @@ int8_t VoltDBIPC::initialize(struct ipc_command *cmd) {
     cs->tempTableMemory = ntohll(cs->tempTableMemory);
     cs->createDrReplicatedStream = ntohl(cs->createDrReplicatedStream);
     bool createDrReplicatedStream = cs->createDrReplicatedStream != 0;
+    cs->options = ntohl(cs->options);
     cs->hostnameLength = ntohl(cs->hostnameLength);
 
     std::string hostname(cs->data, cs->hostnameLength);
@@ -680,7 +696,9 @@ int8_t VoltDBIPC::initialize(struct ipc_command *cmd) {
                              cs->drClusterId,
                              cs->defaultDrBufferSize,
                              cs->tempTableMemory,
-                             createDrReplicatedStream);
+                             createDrReplicatedStream,
+                             DEFAULT_COMPACTION_THRESHOLD,
+                             cs->options);
         return kErrorCode_Success;
     }
     catch (const FatalException &e) {
@@ -1442,6 +1460,27 @@ void VoltDBIPC::tableHashCode( struct ipc_command *cmd) {
     writeOrDie(m_fd, (unsigned char*)response, 9);
 }
 
+void VoltDBIPC::pageAllocatorStats() {
+    PageAllocator::Stats stats = PageAllocator::threadStats();
+    char response[25];
+    response[0] = kErrorCode_Success;
+    *reinterpret_cast<int64_t*>(&response[1]) = htonll(stats.m_mappedBytes);
+    *reinterpret_cast<int64_t*>(&response[9]) = htonll(stats.m_hugePageBytes);
+    *reinterpret_cast<int64_t*>(&response[17]) = htonll(stats.m_numaLocalBytes);
+    writeOrDie(m_fd, (unsigned char*)response, 25);
+}
+
+void VoltDBIPC::streamBufferPoolStats() {
+    StreamBufferPool::Stats stats = m_engine->getExecutorContext()->streamBufferPool()->stats();
+    char response[33];
+    response[0] = kErrorCode_Success;
+    *reinterpret_cast<int64_t*>(&response[1]) = htonll(stats.m_hits);
+    *reinterpret_cast<int64_t*>(&response[9]) = htonll(stats.m_misses);
+    *reinterpret_cast<int64_t*>(&response[17]) = htonll(stats.m_outstandingBytes);
+    *reinterpret_cast<int64_t*>(&response[25]) = htonll(stats.m_pooledBytes);
+    writeOrDie(m_fd, (unsigned char*)response, 33);
+}
+
 void VoltDBIPC::exportAction(struct ipc_command *cmd) {
     export_action *action = (export_action*)cmd;
 
@@ -1594,8 +1633,8 @@ void VoltDBIPC::pushExportBuffer(
         // Memset the first 8 bytes to initialize the MAGIC_HEADER_SPACE_FOR_JAVA
         ::memset(block->rawPtr(), 0, 8);
         writeOrDie(m_fd, (unsigned char*)block->rawPtr(), block->rawLength());
-        // Need the delete in the if statement for valgrind
-        delete [] block->rawPtr();
+        // Need the release in the if statement for valgrind
+        voltdb::StreamBufferPool::release(block->rawPtr());
     } else {
         *reinterpret_cast<int32_t*>(&m_reusedResultBuffer[index]) = htonl(0);
         writeOrDie(m_fd, (unsigned char*)m_reusedResultBuffer, index + 4);
@@ -1655,14 +1694,14 @@ void VoltDBIPC::applyBinaryLog(struct ipc_command *cmd) {
 
 int64_t VoltDBIPC::pushDRBuffer(int32_t partitionId, voltdb::StreamBlock *block) {
     if (block != NULL) {
-        delete []block->rawPtr();
+        voltdb::StreamBufferPool::release(block->rawPtr());
     }
     return -1;
 }
 
 void VoltDBIPC::pushPoisonPill(int32_t partitionId, std::string& reason, voltdb::StreamBlock *block) {
     if (block != NULL) {
-        delete []block->rawPtr();
+        voltdb::StreamBufferPool::release(block->rawPtr());
     }
 }
 
@@ -106,7 +106,9 @@
 #include "common/TheHashinator.h"
 #include "common/Pool.hpp"
 #include "common/FatalException.hpp"
+#include "common/PageAllocator.h"
 #include "common/SegvException.hpp"
+#include "common/StreamBufferPool.h"
 #include "common/RecoveryProtoMessage.h"
 #include "common/ElasticHashinator.h"
 #include "storage/DRTupleStream.h"
@@ -267,7 +269,8 @@ SHAREDLIB_JNIEXPORT jint JNICALL Java_org_voltdb_jni_ExecutionEngine_nativeIniti
     jint defaultDrBufferSize,
     jlong tempTableMemory,
     jboolean createDrReplicatedStream,
-    jint compactionThreshold)
+    jint compactionThreshold,
+    jint options)
 {
     VOLT_DEBUG("nativeInitialize() start");
     VoltDBEngine *engine = castToEngine(enginePtr);
@@ -294,7 +297,8 @@ SHAREDLIB_JNIEXPORT jint JNICALL Java_org_voltdb_jni_ExecutionEngine_nativeIniti
                            defaultDrBufferSize,
                            tempTableMemory,
                            createDrReplicatedStream,
-                           static_cast<int32_t>(compactionThreshold));
+                           static_cast<int32_t>(compactionThreshold),
+                           static_cast<int32_t>(options));
         VOLT_DEBUG("initialize succeeded");
         return org_voltdb_jni_ExecutionEngine_ERRORCODE_SUCCESS;
     }
@@ -1256,6 +1260,42 @@ SHAREDLIB_JNIEXPORT jlong JNICALL Java_org_voltdb_jni_ExecutionEngine_nativeGetT
     return ThreadLocalPool::getPoolAllocationSize();
 }
 
+/*
+ * Class:     org_voltdb_jni_ExecutionEngine
+ * Method:    nativeGetStreamBufferPoolStats
+ * Signature: (J)[J
+ */
+SHAREDLIB_JNIEXPORT jlongArray JNICALL Java_org_voltdb_jni_ExecutionEngine_nativeGetStreamBufferPoolStats
+  (JNIEnv *env, jobject obj, jlong engine_ptr) {
+    VoltDBEngine *engine = castToEngine(engine_ptr);
+    StreamBufferPool::Stats stats = engine->getExecutorContext()->streamBufferPool()->stats();
+    jlong data[4];
+    data[0] = stats.m_hits;
+    data[1] = stats.m_misses;
+    data[2] = stats.m_outstandingBytes;
+    data[3] = stats.m_pooledBytes;
+    jlongArray retval = env->NewLongArray(4);
+    env->SetLongArrayRegion(retval, 0, 4, data);
+    return retval;
+}
+
+/*
+ * Class:     org_voltdb_jni_ExecutionEngine
+ * Method:    nativeGetPageAllocatorStats
+ * Signature: ()[J
+ */
+SHAREDLIB_JNIEXPORT jlongArray JNICALL Java_org_voltdb_jni_ExecutionEngine_nativeGetPageAllocatorStats
+  (JNIEnv *env, jclass) {
+    PageAllocator::Stats stats = PageAllocator::threadStats();
+    jlong data[3];
+    data[0] = stats.m_mappedBytes;
+    data[1] = stats.m_hugePageBytes;
+    data[2] = stats.m_numaLocalBytes;
+    jlongArray retval = env->NewLongArray(3);
+    env->SetLongArrayRegion(retval, 0, 3, data);
+    return retval;
+}
+
 /*
  * Class:     org_voltdb_jni_ExecutionEngine
  * Method:    nativeGetRSS
@@ -1291,7 +1331,9 @@ SHAREDLIB_JNIEXPORT jlong JNICALL Java_org_voltdb_jni_ExecutionEngine_nativeGetR
  */
 SHAREDLIB_JNIEXPORT void JNICALL Java_org_voltcore_utils_DBBPool_nativeDeleteCharArrayMemory
   (JNIEnv *env, jclass clazz, jlong ptr) {
-    delete[] reinterpret_cast<char*>(ptr);
+    // Export and DR stream buffers go back to their site's pool, and
+    // unsafe byte buffers are freed.
+    StreamBufferPool::release(reinterpret_cast<char*>(ptr));
 }
 
 /*
@@ -1301,7 +1343,9 @@ SHAREDLIB_JNIEXPORT void JNICALL Java_org_voltcore_utils_DBBPool_nativeDeleteCha
  */
 SHAREDLIB_JNIEXPORT jobject JNICALL Java_org_voltcore_utils_DBBPool_nativeAllocateUnsafeByteBuffer
   (JNIEnv *jniEnv, jclass, jlong size) {
-    char *memory = new char[size];
+    // Allocated so that nativeDeleteCharArrayMemory can tell it from a
+    // pooled stream buffer.
+    char *memory = StreamBufferPool::allocateUnpooled(size);
     jobject buffer = jniEnv->NewDirectByteBuffer( memory, size);
     if (buffer == NULL) {
         jniEnv->ExceptionDescribe();
@@ -34,6 +34,13 @@ public class MemoryStats extends StatsSource {
         long indexMem = 0;
         long stringMem = 0;
         long pooledMem = 0;
+        long mappedMem = 0;
+        long hugePageMem = 0;
+        long numaLocalMem = 0;
+        long streamBufferHits = 0;
+        long streamBufferMisses = 0;
+        long streamBufferOutstanding = 0;
+        long streamBufferPooled = 0;
     }
     Map<Long, PartitionMemRow> m_memoryStats = new TreeMap<Long, PartitionMemRow>();
 
@@ -82,6 +89,13 @@ public class MemoryStats extends StatsSource {
         columns.add(new VoltTable.ColumnInfo("POOLEDMEMORY", VoltType.BIGINT));
         columns.add(new VoltTable.ColumnInfo("PHYSICALMEMORY", VoltType.BIGINT));
         columns.add(new VoltTable.ColumnInfo("JAVAMAXHEAP", VoltType.INTEGER));
+        columns.add(new VoltTable.ColumnInfo("MAPPEDMEMORY", VoltType.BIGINT));
+        columns.add(new VoltTable.ColumnInfo("HUGEPAGEMEMORY", VoltType.BIGINT));
+        columns.add(new VoltTable.ColumnInfo("NUMALOCALMEMORY", VoltType.BIGINT));
+        columns.add(new VoltTable.ColumnInfo("STREAMBUFFERHITS", VoltType.BIGINT));
+        columns.add(new VoltTable.ColumnInfo("STREAMBUFFERMISSES", VoltType.BIGINT));
+        columns.add(new VoltTable.ColumnInfo("STREAMBUFFEROUTSTANDING", VoltType.BIGINT));
+        columns.add(new VoltTable.ColumnInfo("STREAMBUFFERPOOLED", VoltType.BIGINT));
     }
 
     @Override
@@ -95,6 +109,13 @@ public class MemoryStats extends StatsSource {
             totals.indexMem += pmr.indexMem;
             totals.stringMem += pmr.stringMem;
             totals.pooledMem += pmr.pooledMem;
+            totals.mappedMem += pmr.mappedMem;
+            totals.hugePageMem += pmr.hugePageMem;
+            totals.numaLocalMem += pmr.numaLocalMem;
+            totals.streamBufferHits += pmr.streamBufferHits;
+            totals.streamBufferMisses += pmr.streamBufferMisses;
+            totals.streamBufferOutstanding += pmr.streamBufferOutstanding;
+            totals.streamBufferPooled += pmr.streamBufferPooled;
         }
 
         // get system statistics
@@ -119,6 +140,13 @@ public class MemoryStats extends StatsSource {
         //in kb to make math simpler with other mem values.
         rowValues[columnNameToIndex.get("PHYSICALMEMORY")] = PlatformProperties.getPlatformProperties().ramInMegabytes * 1024;
         rowValues[columnNameToIndex.get("JAVAMAXHEAP")] = Runtime.getRuntime().maxMemory() / 1024;
+        rowValues[columnNameToIndex.get("MAPPEDMEMORY")] = totals.mappedMem / 1024;
+        rowValues[columnNameToIndex.get("HUGEPAGEMEMORY")] = totals.hugePageMem / 1024;
+        rowValues[columnNameToIndex.get("NUMALOCALMEMORY")] = totals.numaLocalMem / 1024;
+        rowValues[columnNameToIndex.get("STREAMBUFFERHITS")] = totals.streamBufferHits;
+        rowValues[columnNameToIndex.get("STREAMBUFFERMISSES")] = totals.streamBufferMisses;
+        rowValues[columnNameToIndex.get("STREAMBUFFEROUTSTANDING")] = totals.streamBufferOutstanding / 1024;
+        rowValues[columnNameToIndex.get("STREAMBUFFERPOOLED")] = totals.streamBufferPooled / 1024;
         super.updateStatsRow(rowKey, rowValues);
     }
 
@@ -128,7 +156,9 @@ public class MemoryStats extends StatsSource {
                                               long tupleAllocatedMem,
                                               long indexMem,
                                               long stringMem,
-                                              long pooledMemory) {
+                                              long pooledMemory,
+                                              long[] pageAllocatorStats,
+                                              long[] streamBufferPoolStats) {
         PartitionMemRow pmr = new PartitionMemRow();
         pmr.tupleCount = tupleCount;
         pmr.tupleDataMem = tupleDataMem;
@@ -136,6 +166,13 @@ public class MemoryStats extends StatsSource {
         pmr.indexMem = indexMem;
         pmr.stringMem = stringMem;
         pmr.pooledMem = pooledMemory;
+        pmr.mappedMem = pageAllocatorStats[0];
+        pmr.hugePageMem = pageAllocatorStats[1];
+        pmr.numaLocalMem = pageAllocatorStats[2];
+        pmr.streamBufferHits = streamBufferPoolStats[0];
+        pmr.streamBufferMisses = streamBufferPoolStats[1];
+        pmr.streamBufferOutstanding = streamBufferPoolStats[2];
+        pmr.streamBufferPooled = streamBufferPoolStats[3];
         m_memoryStats.put(siteId, pmr);
     }
 }
@@ -21,18 +21,21 @@ package org.voltdb;
  * Supported snapshot formats
  */
 public enum SnapshotFormat {
-    NATIVE (true,  true,  TableStreamType.SNAPSHOT),
-    CSV    (true,  true,  TableStreamType.SNAPSHOT),
-    STREAM (false, false, TableStreamType.SNAPSHOT),
-    INDEX  (false, false, TableStreamType.ELASTIC_INDEX);
+    NATIVE (true,  true,  TableStreamType.SNAPSHOT, Boolean.getBoolean("SNAPSHOT_COMPRESS_NATIVE_ROWS")),
+    CSV    (true,  true,  TableStreamType.SNAPSHOT, false),
+    STREAM (false, false, TableStreamType.SNAPSHOT, Boolean.getBoolean("SNAPSHOT_COMPRESS_STREAM_ROWS")),
+    INDEX  (false, false, TableStreamType.ELASTIC_INDEX, false);
 
     private final boolean m_isFileBased;
     private final boolean m_canCloseEarly;
     private final TableStreamType m_streamType;
-    private SnapshotFormat(boolean isFileBased, boolean canCloseEarly, TableStreamType streamType) {
+    private final boolean m_compressRows;
+    private SnapshotFormat(boolean isFileBased, boolean canCloseEarly, TableStreamType streamType,
+                           boolean compressRows) {
         m_isFileBased = isFileBased;
         m_canCloseEarly = canCloseEarly;
         m_streamType = streamType;
+        m_compressRows = compressRows;
     }
 
     /**
@@ -58,6 +61,18 @@ public enum SnapshotFormat {
         return m_streamType;
     }
 
+    /**
+     * Whether the EE compresses the rows of the buffers it streams for this
+     * format, see {@link org.voltdb.utils.CompressedRows}. Off unless the
+     * format's system property is set: SNAPSHOT_COMPRESS_NATIVE_ROWS for
+     * native snapshot files, SNAPSHOT_COMPRESS_STREAM_ROWS for rejoin and
+     * elastic join streams. CSV snapshots convert the rows in Java and
+     * index streams have no rows, so they are never compressed.
+     */
+    public boolean compressRows() {
+        return m_compressRows;
+    }
+
     /**
      * Get the snapshot format enum from the string. Letter case of the string
      * doesn't matter.
@@ -474,7 +474,7 @@ public class SnapshotSiteProcessor {
                 tablesAndPredicates.put(task.m_table.getRelativeIndex(), predicates);
             }
 
-            predicates.addPredicate(task.m_predicate, task.m_deleteTuples);
+            predicates.addPredicate(task.m_predicate, task.m_deleteTuples, task.m_compressRows);
         }
 
         for (Map.Entry<Integer, SnapshotPredicates> e : tablesAndPredicates.entrySet()) {
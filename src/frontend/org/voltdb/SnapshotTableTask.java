@@ -30,6 +30,7 @@ public class SnapshotTableTask
     public final SnapshotDataFilter m_filters[];
     public final AbstractExpression m_predicate;
     public final boolean m_deleteTuples;
+    public final boolean m_compressRows;
 
     volatile SnapshotDataTarget m_target;
 
@@ -37,12 +38,14 @@ public class SnapshotTableTask
             final Table table,
             final SnapshotDataFilter filters[],
             final AbstractExpression predicate,
-            final boolean deleteTuples)
+            final boolean deleteTuples,
+            final boolean compressRows)
     {
         m_table = table;
         m_filters = filters;
         m_predicate = predicate;
         m_deleteTuples = deleteTuples;
+        m_compressRows = compressRows;
     }
 
     public void setTarget(SnapshotDataTarget target)
@@ -71,7 +74,8 @@ public class SnapshotTableTask
     {
         return ("SnapshotTableTask for " + m_table.getTypeName() +
                 " replicated " + m_table.getIsreplicated() +
-                ", delete " + m_deleteTuples);
+                ", delete " + m_deleteTuples +
+                ", compress " + m_compressRows);
     }
 }
 
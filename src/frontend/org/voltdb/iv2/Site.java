@@ -1348,7 +1348,9 @@ public class Site implements Runnable, SiteProcedureConnection, SiteSnapshotConn
                                             tupleAllocatedMem,
                                             indexMem,
                                             stringMem,
-                                            m_ee.getThreadLocalPoolAllocations());
+                                            m_ee.getThreadLocalPoolAllocations(),
+                                            m_ee.getPageAllocatorStats(),
+                                            m_ee.getStreamBufferPoolStats());
             }
         }
     }
@@ -124,6 +124,30 @@ public abstract class ExecutionEngine implements FastDeserializer.Deserializatio
     /** For now sync this value with the value in the EE C++ code to get good stats. */
     public static final int EE_PLAN_CACHE_SIZE = 1000;
 
+    /*
+     * Optional EE features, passed to the EE as a bit mask when it is
+     * initialized.  Keep these in sync with EngineOption in VoltDBEngine.h.
+     */
+    public static final int EE_OPTION_HUGE_PAGES = 1 << 0;
+    public static final int EE_OPTION_NUMA_BIND = 1 << 1;
+    public static final int EE_OPTION_DR_BATCH_APPLY = 1 << 2;
+    public static final int EE_OPTION_DR_PIPELINE_APPLY = 1 << 3;
+
+    /*
+     * The options every EE in this process is initialized with.  Each is
+     * off unless its system property is set to true:
+     *
+     * EE_HUGE_PAGES        map tuple storage with huge pages
+     * EE_NUMA_BIND         prefer the site thread's NUMA node for tuple storage
+     * EE_DR_BATCH_APPLY    batch index lookups when applying DR binary logs
+     * EE_DR_PIPELINE_APPLY decode DR binary logs on a helper thread
+     */
+    public static final int EE_OPTIONS =
+        (Boolean.getBoolean("EE_HUGE_PAGES") ? EE_OPTION_HUGE_PAGES : 0) |
+        (Boolean.getBoolean("EE_NUMA_BIND") ? EE_OPTION_NUMA_BIND : 0) |
+        (Boolean.getBoolean("EE_DR_BATCH_APPLY") ? EE_OPTION_DR_BATCH_APPLY : 0) |
+        (Boolean.getBoolean("EE_DR_PIPELINE_APPLY") ? EE_OPTION_DR_PIPELINE_APPLY : 0);
+
     /** Partition ID */
     protected final int m_partitionId;
 
@@ -726,6 +750,18 @@ public abstract class ExecutionEngine implements FastDeserializer.Deserializatio
 
     public abstract long getThreadLocalPoolAllocations();
 
+    /**
+     * The bytes of tuple storage this site's thread has mapped: in all,
+     * with huge pages, and on its own NUMA node, in that order.
+     */
+    public abstract long[] getPageAllocatorStats();
+
+    /**
+     * The hits, misses, outstanding bytes and pooled bytes of the pool
+     * behind this site's export and DR buffers, in that order.
+     */
+    public abstract long[] getStreamBufferPoolStats();
+
     public abstract byte[] loadTable(
         int tableId, VoltTable table, long txnId, long spHandle,
         long lastCommittedSpHandle, long uniqueId, boolean returnUniqueViolations, boolean shouldDRStream,
@@ -901,7 +937,8 @@ public abstract class ExecutionEngine implements FastDeserializer.Deserializatio
             int defaultDrBufferSize,
             long tempTableMemory,
             boolean createDrReplicatedStream,
-            int compactionThreshold);
+            int compactionThreshold,
+            int options);
 
     /**
      * Sets (or re-sets) all the shared direct byte buffers in the EE.
@@ -1050,6 +1087,13 @@ public abstract class ExecutionEngine implements FastDeserializer.Deserializatio
      */
     protected static native long nativeGetThreadLocalPoolAllocations();
 
+    /**
+     * Retrieve the thread local counters of mapped, huge page and NUMA-local
+     * tuple storage
+     * @return
+     */
+    protected static native long[] nativeGetPageAllocatorStats();
+
     /**
      * @param nextUndoToken The undo token to associate with future work
      * @return true for success false for failure
@@ -1145,6 +1189,14 @@ public abstract class ExecutionEngine implements FastDeserializer.Deserializatio
             long seqNo,
             byte mTableSignature[]);
 
+    /**
+     * Get the statistics of the engine's export and DR buffer pool.
+     *
+     * @param pointer Pointer to an engine instance
+     * @return Hits, misses, outstanding bytes and pooled bytes
+     */
+    public native long[] nativeGetStreamBufferPoolStats(long pointer);
+
     /**
      * Get the USO for an export table. This is primarily used for recovery.
      *
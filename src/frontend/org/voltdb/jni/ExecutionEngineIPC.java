@@ -130,7 +130,9 @@ public class ExecutionEngineIPC extends ExecutionEngine {
         GetUSOs(25),
         updateHashinator(27),
         executeTask(28),
-        applyBinaryLog(29);
+        applyBinaryLog(29),
+        GetPageAllocatorStats(30),
+        GetStreamBufferPoolStats(31);
         Commands(final int id) {
             m_id = id;
         }
@@ -916,6 +918,7 @@ public class ExecutionEngineIPC extends ExecutionEngine {
         m_data.putLong(EELoggers.getLogLevels());
         m_data.putLong(tempTableMemory);
         m_data.putInt(createDrReplicatedStream ? 1 : 0);
+        m_data.putInt(EE_OPTIONS);
         m_data.putInt((short)hostname.length());
         m_data.put(hostname.getBytes(Charsets.UTF_8));
         try {
@@ -1740,6 +1743,54 @@ public class ExecutionEngineIPC extends ExecutionEngine {
         }
     }
 
+    @Override
+    public long[] getPageAllocatorStats() {
+        m_data.clear();
+        m_data.putInt(Commands.GetPageAllocatorStats.m_id);
+        try {
+            m_data.flip();
+            m_connection.write();
+
+            m_connection.readStatusByte();
+            ByteBuffer stats = ByteBuffer.allocate(24);
+            while (stats.hasRemaining()) {
+                int read = m_connection.m_socketChannel.read(stats);
+                if (read <= 0) {
+                    throw new EOFException();
+                }
+            }
+            stats.flip();
+            return new long[] { stats.getLong(), stats.getLong(), stats.getLong() };
+        } catch (final Exception e) {
+            System.out.println("Exception: " + e.getMessage());
+            throw new RuntimeException(e);
+        }
+    }
+
+    @Override
+    public long[] getStreamBufferPoolStats() {
+        m_data.clear();
+        m_data.putInt(Commands.GetStreamBufferPoolStats.m_id);
+        try {
+            m_data.flip();
+            m_connection.write();
+
+            m_connection.readStatusByte();
+            ByteBuffer stats = ByteBuffer.allocate(32);
+            while (stats.hasRemaining()) {
+                int read = m_connection.m_socketChannel.read(stats);
+                if (read <= 0) {
+                    throw new EOFException();
+                }
+            }
+            stats.flip();
+            return new long[] { stats.getLong(), stats.getLong(), stats.getLong(), stats.getLong() };
+        } catch (final Exception e) {
+            System.out.println("Exception: " + e.getMessage());
+            throw new RuntimeException(e);
+        }
+    }
+
     @Override
     public byte[] executeTask(TaskType taskType, ByteBuffer task) {
         m_data.clear();
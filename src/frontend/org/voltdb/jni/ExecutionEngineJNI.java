@@ -180,7 +180,8 @@ public class ExecutionEngineJNI extends ExecutionEngine {
                     defaultDrBufferSize,
                     tempTableMemory * 1024 * 1024,
                     createDrReplicatedStream,
-                    EE_COMPACTION_THRESHOLD);
+                    EE_COMPACTION_THRESHOLD,
+                    EE_OPTIONS);
         checkErrorCode(errorCode);
 
         setupPsetBuffer(smallBufferSize);
@@ -745,6 +746,16 @@ public class ExecutionEngineJNI extends ExecutionEngine {
         return nativeGetThreadLocalPoolAllocations();
     }
 
+    @Override
+    public long[] getPageAllocatorStats() {
+        return nativeGetPageAllocatorStats();
+    }
+
+    @Override
+    public long[] getStreamBufferPoolStats() {
+        return nativeGetStreamBufferPoolStats(pointer);
+    }
+
     /*
      * Instead of using the reusable output buffer to get results for the next batch,
      * use this buffer allocated by the EE. This is for one time use.
@@ -236,6 +236,16 @@ public class MockExecutionEngine extends ExecutionEngine {
         return 0L;
     }
 
+    @Override
+    public long[] getPageAllocatorStats() {
+        return new long[3];
+    }
+
+    @Override
+    public long[] getStreamBufferPoolStats() {
+        return new long[4];
+    }
+
     @Override
     public byte[] executeTask(TaskType taskType, ByteBuffer task) {
         throw new UnsupportedOperationException();
@@ -162,7 +162,9 @@ public class StreamSnapshotSink {
 
     /**
      * Assemble the chunk so that it can be used to construct the VoltTable that
-     * will be passed to EE.
+     * will be passed to EE. The rows may be in a compressed rows frame, see
+     * {@link org.voltdb.utils.CompressedRows}, which the EE expands when it
+     * loads the table.
      *
      * @param buf
      * @return
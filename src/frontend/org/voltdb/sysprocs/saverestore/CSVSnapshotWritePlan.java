@@ -131,7 +131,8 @@ public class CSVSnapshotWritePlan extends SnapshotWritePlan
                             table,
                             filters.toArray(new SnapshotDataFilter[filters.size()]),
                             null,
-                            false);
+                            false,
+                            SnapshotFormat.CSV.compressRows());
 
             if (table.getIsreplicated()) {
                 replicatedSnapshotTasks.add(task);
@@ -156,7 +156,8 @@ public class IndexSnapshotWritePlan extends SnapshotWritePlan {
                     new SnapshotTableTask(table,
                                           new SnapshotDataFilter[0],
                                           createIndexExpressionForTable(table, partitionRange.ranges),
-                                          false);
+                                          false,
+                                          SnapshotFormat.INDEX.compressRows());
                 task.setTarget(dataTarget);
 
                 placeTask(task, Arrays.asList(localHSId));
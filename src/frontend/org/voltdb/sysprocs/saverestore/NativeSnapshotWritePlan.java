@@ -123,7 +123,8 @@ public class NativeSnapshotWritePlan extends SnapshotWritePlan
                             table,
                             new SnapshotDataFilter[0],
                             null,
-                            false);
+                            false,
+                            SnapshotFormat.NATIVE.compressRows());
 
             SNAP_LOG.debug("ADDING TASK: " + task);
 
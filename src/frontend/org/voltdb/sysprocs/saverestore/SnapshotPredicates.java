@@ -35,15 +35,18 @@ public class SnapshotPredicates {
     public final int m_tableId;
     private final List<Pair<AbstractExpression, Boolean>> m_predicates =
             new ArrayList<Pair<AbstractExpression, Boolean>>();
+    // Whether the EE compresses the rows it streams for each predicate
+    private final List<Boolean> m_compressRows = new ArrayList<Boolean>();
 
     public SnapshotPredicates(int tableId)
     {
         m_tableId = tableId;
     }
 
-    public void addPredicate(AbstractExpression predicate, boolean deleteTuples)
+    public void addPredicate(AbstractExpression predicate, boolean deleteTuples, boolean compressRows)
     {
         m_predicates.add(Pair.of(predicate, deleteTuples));
+        m_compressRows.add(compressRows);
     }
 
     public byte[] toBytes()
@@ -57,6 +60,7 @@ public class SnapshotPredicates {
                 JSONStringer stringer = new JSONStringer();
                 stringer.object();
                 stringer.keySymbolValuePair("triggersDelete", p.getSecond());
+                stringer.keySymbolValuePair("compressRows", m_compressRows.get(i));
                 // If the predicate is null, EE will serialize all rows to the corresponding data
                 // target. It's the same as passing an always-true expression,
                 // but without the overhead of the evaluating the expression. This avoids the
@@ -305,7 +305,8 @@ public class StreamSnapshotWritePlan extends SnapshotWritePlan
                 new SnapshotTableTask(table,
                                       new SnapshotDataFilter[0], // This task no longer needs partition filtering
                                       null,
-                                      false);
+                                      false,
+                                      SnapshotFormat.STREAM.compressRows());
             task.setTarget(targetInfo.dataTarget);
 
             tasks.put(targetInfo.srcHSId, task);
@@ -45,6 +45,7 @@ import org.voltcore.utils.DBBPool;
 import org.voltcore.utils.DBBPool.BBContainer;
 import org.voltdb.EELibraryLoader;
 import org.voltdb.messaging.FastDeserializer;
+import org.voltdb.utils.CompressedRows;
 import org.voltdb.utils.CompressionService;
 import org.voltdb.utils.PosixAdvise;
 
@@ -705,6 +706,8 @@ public class TableSaveFile
                         buf.put(m_tableHeader);
                         //Doesn't move buffer position, does change the limit
                         CompressionService.decompressBuffer(fileInputBuffer, buf);
+                        //Readers of the chunk expect plain rows, expand them if the EE compressed them
+                        CompressedRows.decompress(buf, m_tableHeader.capacity());
                         completedRead = true;
                     } finally {
                         if (!completedRead) {
@@ -0,0 +1,106 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2018 VoltDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with VoltDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+package org.voltdb.utils;
+
+import java.io.IOException;
+import java.nio.ByteBuffer;
+
+import net.jpountz.lz4.LZ4Exception;
+import net.jpountz.lz4.LZ4Factory;
+import net.jpountz.lz4.LZ4SafeDecompressor;
+
+/**
+ * Reads the compressed rows frame that the EE writes into table stream
+ * buffers for snapshot formats that ask for it, see
+ * {@link org.voltdb.SnapshotFormat#compressRows()}. The frame replaces the
+ * rows that follow the row count:
+ *
+ * <pre>
+ * int    COMPRESSED_ROWS_MARKER, where the first row's length would be
+ * int    length of the rows
+ * int    length of the compressed rows
+ * byte[] the rows as a single LZ4 block
+ * </pre>
+ *
+ * The row count is left in place, so a buffer with a compressed frame is
+ * still a well formed VoltTable as far as its row count goes. loadTable()
+ * in the EE reads the frame itself; only Java code that looks at the rows
+ * needs to decompress them first. Keep this in sync with
+ * TupleOutputStream::compressRows() in the EE.
+ */
+public class CompressedRows {
+    public static final int COMPRESSED_ROWS_MARKER = -1;
+    public static final int COMPRESSED_ROWS_HEADER_SIZE = 12;
+
+    private static final LZ4SafeDecompressor m_decompressor =
+            LZ4Factory.fastestInstance().safeDecompressor();
+
+    /**
+     * Whether the rows after the row count at rowCountOffset in buf are in a
+     * compressed rows frame.
+     */
+    public static boolean isCompressed(ByteBuffer buf, int rowCountOffset) {
+        return buf.limit() >= rowCountOffset + 8 &&
+               buf.getInt(rowCountOffset) > 0 &&
+               buf.getInt(rowCountOffset + 4) == COMPRESSED_ROWS_MARKER;
+    }
+
+    /**
+     * Decompress the rows after the row count at rowCountOffset in buf in
+     * place of their frame. The limit is moved to the end of the rows and
+     * the position is left where it was. Rows that are not compressed are
+     * left alone.
+     *
+     * @throws IOException if the frame is corrupt or the rows do not fit in buf
+     */
+    public static void decompress(ByteBuffer buf, int rowCountOffset) throws IOException {
+        if (!isCompressed(buf, rowCountOffset)) {
+            return;
+        }
+
+        final int rowsOffset = rowCountOffset + 4;
+        final int rowsLength = buf.getInt(rowsOffset + 4);
+        final int compressedLength = buf.getInt(rowsOffset + 8);
+        if (rowsLength < 0 || compressedLength < 0 ||
+                compressedLength > buf.limit() - rowsOffset - COMPRESSED_ROWS_HEADER_SIZE) {
+            throw new IOException("Invalid lengths for compressed rows");
+        }
+        if (rowsLength > buf.capacity() - rowsOffset) {
+            throw new IOException("No room to decompress " + rowsLength + " bytes of rows");
+        }
+
+        final byte compressed[] = new byte[compressedLength];
+        final ByteBuffer in = buf.duplicate();
+        in.position(rowsOffset + COMPRESSED_ROWS_HEADER_SIZE);
+        in.get(compressed);
+
+        final byte rows[] = new byte[rowsLength];
+        try {
+            if (m_decompressor.decompress(compressed, 0, compressedLength, rows, 0, rowsLength) != rowsLength) {
+                throw new IOException("Compressed rows are corrupt");
+            }
+        } catch (LZ4Exception e) {
+            throw new IOException("Compressed rows are corrupt", e);
+        }
+
+        buf.limit(rowsOffset + rowsLength);
+        final ByteBuffer out = buf.duplicate();
+        out.position(rowsOffset);
+        out.put(rows);
+    }
+}
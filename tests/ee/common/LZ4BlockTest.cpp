@@ -0,0 +1,111 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2018 VoltDB Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "harness.h"
+#include "common/LZ4Block.h"
+
+using namespace voltdb;
+
+class LZ4BlockTest : public Test {
+};
+
+static std::string roundTrip(const std::string& input, size_t* compressedLength = NULL) {
+    std::vector<char> compressed(LZ4Block::compressBound(input.size()));
+    size_t length = LZ4Block::compress(input.data(), input.size(), &compressed[0], compressed.size());
+    if (compressedLength != NULL) {
+        *compressedLength = length;
+    }
+    if (length == 0) {
+        return "<did not fit>";
+    }
+    std::string output(input.size(), '\0');
+    if (!LZ4Block::decompress(&compressed[0], length, &output[0], output.size())) {
+        return "<corrupt>";
+    }
+    return output;
+}
+
+TEST_F(LZ4BlockTest, RoundTrip) {
+    EXPECT_EQ(std::string(), roundTrip(std::string()));
+    EXPECT_EQ(std::string("short"), roundTrip("short"));
+
+    std::string repetitive;
+    for (int i = 0; i < 1000; ++i) {
+        repetitive += "varchar string:";
+        repetitive += static_cast<char>('0' + i % 7);
+    }
+    size_t compressedLength = 0;
+    EXPECT_EQ(repetitive, roundTrip(repetitive, &compressedLength));
+    EXPECT_TRUE(compressedLength < repetitive.size() / 10);
+
+    // Long runs need the extra length bytes for both literals and matches.
+    std::string runs(100000, 'a');
+    for (size_t i = 0; i < 400; ++i) {
+        runs[i] = static_cast<char>(i * 7);
+    }
+    EXPECT_EQ(runs, roundTrip(runs));
+
+    // Random bytes do not compress, but still fit in compressBound().
+    srand(42);
+    std::string noise(70000, '\0');
+    for (size_t i = 0; i < noise.size(); ++i) {
+        noise[i] = static_cast<char>(rand());
+    }
+    EXPECT_EQ(noise, roundTrip(noise, &compressedLength));
+    EXPECT_TRUE(compressedLength <= LZ4Block::compressBound(noise.size()));
+}
+
+TEST_F(LZ4BlockTest, TooSmallDestination) {
+    std::string noise(1000, '\0');
+    for (size_t i = 0; i < noise.size(); ++i) {
+        noise[i] = static_cast<char>(i * 131 + i / 7);
+    }
+    std::vector<char> compressed(noise.size() / 2);
+    EXPECT_EQ(0, LZ4Block::compress(noise.data(), noise.size(), &compressed[0], compressed.size()));
+}
+
+TEST_F(LZ4BlockTest, Decompress) {
+    // A block as the LZ4 library writes it: one literal, a match of 19
+    // that overlaps its own output, and five trailing literals.
+    const char block[] = { 0x1f, 'a', 0x01, 0x00, 0x00, 0x50, 'a', 'a', 'a', 'a', 'a' };
+    char output[25];
+    ASSERT_TRUE(LZ4Block::decompress(block, sizeof(block), output, sizeof(output)));
+    EXPECT_EQ(std::string(25, 'a'), std::string(output, sizeof(output)));
+
+    // The wrong size, truncations and offsets before the start are rejected.
+    EXPECT_FALSE(LZ4Block::decompress(block, sizeof(block), output, 24));
+    for (size_t length = 0; length < sizeof(block); ++length) {
+        EXPECT_FALSE(LZ4Block::decompress(block, length, output, sizeof(output)));
+    }
+    const char badOffset[] = { 0x1f, 'a', 0x02, 0x00, 0x00, 0x50, 'a', 'a', 'a', 'a', 'a' };
+    EXPECT_FALSE(LZ4Block::decompress(badOffset, sizeof(badOffset), output, sizeof(output)));
+}
+
+int main() {
+    return TestSuite::globalInstance()->runAll();
+}
@@ -0,0 +1,122 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2018 VoltDB Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#include <stdint.h>
+#include "harness.h"
+#include "common/PageAllocator.h"
+
+using namespace voltdb;
+
+class PageAllocatorTest : public Test {
+public:
+    PageAllocatorTest() {
+        PageAllocator::configure(false, false);
+    }
+
+    ~PageAllocatorTest() {
+        PageAllocator::configure(false, false);
+    }
+};
+
+static bool isZeroFilled(const char* memory, size_t size) {
+    for (size_t i = 0; i < size; ++i) {
+        if (memory[i] != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+TEST_F(PageAllocatorTest, DefaultPolicy) {
+    PageAllocator::Stats before = PageAllocator::threadStats();
+    char* small = static_cast<char*>(PageAllocator::allocate(4096));
+    char* large = static_cast<char*>(PageAllocator::allocate(PageAllocator::HUGE_PAGE_SIZE + 1));
+    ASSERT_TRUE(small != NULL);
+    ASSERT_TRUE(large != NULL);
+    EXPECT_TRUE(isZeroFilled(small, 4096));
+    EXPECT_TRUE(isZeroFilled(large, PageAllocator::HUGE_PAGE_SIZE + 1));
+    small[4095] = 1;
+    large[PageAllocator::HUGE_PAGE_SIZE] = 1;
+
+    // The large region is mapped in whole huge pages, but not with them.
+    PageAllocator::Stats stats = PageAllocator::threadStats();
+    EXPECT_EQ(before.m_mappedBytes + 4096 + 2 * PageAllocator::HUGE_PAGE_SIZE, stats.m_mappedBytes);
+    EXPECT_EQ(before.m_hugePageBytes, stats.m_hugePageBytes);
+    EXPECT_EQ(before.m_numaLocalBytes, stats.m_numaLocalBytes);
+
+    PageAllocator::deallocate(small, 4096);
+    PageAllocator::deallocate(large, PageAllocator::HUGE_PAGE_SIZE + 1);
+    stats = PageAllocator::threadStats();
+    EXPECT_EQ(before.m_mappedBytes, stats.m_mappedBytes);
+}
+
+TEST_F(PageAllocatorTest, HugePages) {
+    PageAllocator::configure(true, false);
+    const size_t size = 3 * PageAllocator::HUGE_PAGE_SIZE;
+
+    // Too small to be worth a huge page.
+    char* small = static_cast<char*>(PageAllocator::allocate(4096));
+    ASSERT_TRUE(small != NULL);
+    EXPECT_TRUE(isZeroFilled(small, 4096));
+
+    // Whether the kernel backs it with reserved or transparent huge pages
+    // depends on the host, but either way the region starts on a huge
+    // page boundary.
+    char* large = static_cast<char*>(PageAllocator::allocate(size));
+    ASSERT_TRUE(large != NULL);
+    EXPECT_TRUE(isZeroFilled(large, size));
+    EXPECT_EQ(0, reinterpret_cast<uintptr_t>(large) % PageAllocator::HUGE_PAGE_SIZE);
+    large[size - 1] = 1;
+
+    // Only the large region counts as huge pages.  Hosts without either
+    // kind of huge page leave it out altogether.
+    PageAllocator::Stats stats = PageAllocator::threadStats();
+    EXPECT_EQ(4096 + size, stats.m_mappedBytes);
+    EXPECT_TRUE(stats.m_hugePageBytes == 0 || stats.m_hugePageBytes == size);
+
+    // Turning huge pages off does not change how the region is freed.
+    PageAllocator::configure(false, false);
+    PageAllocator::deallocate(large, size);
+    PageAllocator::deallocate(small, 4096);
+    stats = PageAllocator::threadStats();
+    EXPECT_EQ(0, stats.m_mappedBytes);
+    EXPECT_EQ(0, stats.m_hugePageBytes);
+}
+
+TEST_F(PageAllocatorTest, LocalNode) {
+    PageAllocator::configure(false, true);
+    char* memory = static_cast<char*>(PageAllocator::allocate(65536));
+    ASSERT_TRUE(memory != NULL);
+    EXPECT_TRUE(isZeroFilled(memory, 65536));
+    memory[65535] = 1;
+    // Only a NUMA kernel can take the preference.
+    PageAllocator::Stats stats = PageAllocator::threadStats();
+    EXPECT_TRUE(stats.m_numaLocalBytes == 0 || stats.m_numaLocalBytes == 65536);
+    PageAllocator::deallocate(memory, 65536);
+    EXPECT_EQ(0, PageAllocator::threadStats().m_numaLocalBytes);
+}
+
+int main() {
+    return TestSuite::globalInstance()->runAll();
+}
@@ -0,0 +1,154 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2018 VoltDB Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <sstream>
+#include <string>
+
+#include "boost/scoped_ptr.hpp"
+
+#include "common/NValue.hpp"
+#include "common/PolygonCache.h"
+#include "common/Pool.hpp"
+#include "common/ValueFactory.hpp"
+#include "common/ValuePeeker.hpp"
+#include "common/executorcontext.hpp"
+#include "expressions/functionexpression.h"
+#include "storage/DRTupleStream.h"
+
+#include "harness.h"
+
+using namespace voltdb;
+
+class PolygonCacheTest : public Test {
+public:
+    PolygonCacheTest() {
+        m_testPool.reset(new Pool());
+        m_drStream.reset(new DRTupleStream(0, 1024));
+        m_executorContext.reset(new ExecutorContext(0,                // siteId
+                                                    0,                // partitionId
+                                                    NULL,             // undoQuantum
+                                                    NULL,             // topend
+                                                    m_testPool.get(), // tempStringPool
+                                                    NULL,             // engine
+                                                    "",               // hostname
+                                                    0,                // hostId
+                                                    m_drStream.get(), // drTupleStream
+                                                    NULL,             // drReplicatedStream
+                                                    0));              // drClusterId
+    }
+
+protected:
+    static NValue polygonWktToNval(const std::string& wkt) {
+        NValue input = ValueFactory::getTempStringValue(wkt);
+        return input.callUnary<FUNC_VOLT_POLYGONFROMTEXT>();
+    }
+
+    static NValue point(double lng, double lat) {
+        std::ostringstream wkt;
+        wkt << "POINT(" << lng << " " << lat << ")";
+        NValue input = ValueFactory::getTempStringValue(wkt.str());
+        return input.callUnary<FUNC_VOLT_POINTFROMTEXT>();
+    }
+
+private:
+    boost::scoped_ptr<Pool> m_testPool;
+    boost::scoped_ptr<DRTupleStream> m_drStream;
+    boost::scoped_ptr<ExecutorContext> m_executorContext;
+};
+
+// A square with a square hole, whose edges pass through the grid of
+// points tested below.
+static const char* SQUARE_WITH_HOLE =
+    "POLYGON((0 0, 10 0, 10 10, 0 10, 0 0), (4 4, 4 6, 6 6, 6 4, 4 4))";
+
+TEST_F(PolygonCacheTest, ContainsMatchesPolygon) {
+    NValue geog = polygonWktToNval(SQUARE_WITH_HOLE);
+    Polygon expected;
+    expected.initFromGeography(ValuePeeker::peekGeographyValue(geog));
+
+    PolygonCache cache;
+    PreparedPolygon* prepared = cache.get(ValuePeeker::peekGeographyValue(geog));
+    // Test enough points that the coverings are built and used.
+    int inside = 0;
+    for (double lng = -2.0; lng <= 12.0; lng += 0.25) {
+        for (double lat = -2.0; lat <= 12.0; lat += 0.25) {
+            S2Point pt = GeographyPointValue(lng, lat).toS2Point();
+            bool contains = expected.Contains(pt);
+            EXPECT_EQ(contains, prepared->contains(pt));
+            inside += contains;
+        }
+    }
+    EXPECT_TRUE(inside > 0);
+    EXPECT_EQ(1, cache.size());
+}
+
+TEST_F(PolygonCacheTest, Eviction) {
+    NValue first = polygonWktToNval("POLYGON((0 0, 1 0, 1 1, 0 1, 0 0))");
+    NValue second = polygonWktToNval("POLYGON((0 0, 2 0, 2 2, 0 2, 0 0))");
+    NValue third = polygonWktToNval("POLYGON((0 0, 3 0, 3 3, 0 3, 0 0))");
+
+    PolygonCache cache(2);
+    PreparedPolygon* firstPrepared = cache.get(ValuePeeker::peekGeographyValue(first));
+    EXPECT_EQ(firstPrepared, cache.get(ValuePeeker::peekGeographyValue(first)));
+    cache.get(ValuePeeker::peekGeographyValue(second));
+    EXPECT_EQ(2, cache.size());
+    EXPECT_EQ(ValuePeeker::peekGeographyValue(first).length() + ValuePeeker::peekGeographyValue(second).length(), cache.bytes());
+
+    // The first polygon was used least recently, so it is evicted.
+    EXPECT_EQ(firstPrepared, cache.get(ValuePeeker::peekGeographyValue(first)));
+    cache.get(ValuePeeker::peekGeographyValue(third));
+    EXPECT_EQ(2, cache.size());
+    EXPECT_EQ(firstPrepared, cache.get(ValuePeeker::peekGeographyValue(first)));
+    EXPECT_TRUE(cache.get(ValuePeeker::peekGeographyValue(third))->contains(GeographyPointValue(2.5, 2.5).toS2Point()));
+
+    // A cache too small for even one polygon still keeps the last one.
+    PolygonCache tiny(2, 1);
+    PreparedPolygon* prepared = tiny.get(ValuePeeker::peekGeographyValue(first));
+    EXPECT_EQ(prepared, tiny.get(ValuePeeker::peekGeographyValue(first)));
+    tiny.get(ValuePeeker::peekGeographyValue(second));
+    EXPECT_EQ(1, tiny.size());
+
+    cache.clear();
+    EXPECT_EQ(0, cache.size());
+    EXPECT_EQ(0, cache.bytes());
+}
+
+TEST_F(PolygonCacheTest, GeoFunctions) {
+    NValue geog = polygonWktToNval(SQUARE_WITH_HOLE);
+    NValue distance = ValueFactory::getDoubleValue(1000.0);
+    for (int i = 0; i < 2 * PreparedPolygon::USES_BEFORE_COVERING; ++i) {
+        EXPECT_TRUE(ValuePeeker::peekBoolean(NValue::call<FUNC_VOLT_CONTAINS>({geog, point(1.0, 1.0)})));
+        EXPECT_FALSE(ValuePeeker::peekBoolean(NValue::call<FUNC_VOLT_CONTAINS>({geog, point(5.0, 5.0)})));
+        EXPECT_FALSE(ValuePeeker::peekBoolean(NValue::call<FUNC_VOLT_CONTAINS>({geog, point(20.0, 20.0)})));
+        EXPECT_TRUE(ValuePeeker::peekBoolean(NValue::call<FUNC_VOLT_DWITHIN_POLYGON_POINT>({geog, point(1.0, 1.0), distance})));
+        EXPECT_FALSE(ValuePeeker::peekBoolean(NValue::call<FUNC_VOLT_DWITHIN_POLYGON_POINT>({geog, point(5.0, 5.0), distance})));
+    }
+    // The hole's edge is about 111km from its centre.
+    NValue farEnough = ValueFactory::getDoubleValue(200 * 1000.0);
+    EXPECT_TRUE(ValuePeeker::peekBoolean(NValue::call<FUNC_VOLT_DWITHIN_POLYGON_POINT>({geog, point(5.0, 5.0), farEnough})));
+    EXPECT_EQ(1, ExecutorContext::getExecutorContext()->polygonCache()->size());
+}
+
+int main() {
+    return TestSuite::globalInstance()->runAll();
+}
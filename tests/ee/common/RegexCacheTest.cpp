@@ -0,0 +1,109 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2018 VoltDB Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <cstring>
+#include <string>
+#include "harness.h"
+#include "common/RegexCache.h"
+
+using namespace voltdb;
+
+class RegexCacheTest : public Test {
+};
+
+static const RegexCache::CompiledRegex* getRegex(RegexCache& cache, const std::string& pattern,
+                                                 uint32_t options = 0) {
+    int errorCode = 0;
+    return cache.get(pattern.data(), pattern.size(), options, &errorCode);
+}
+
+static int matchPosition(const RegexCache::CompiledRegex* regex, const std::string& subject) {
+    int rc = pcre2_match(regex->code,
+                         reinterpret_cast<PCRE2_SPTR>(subject.data()),
+                         subject.size(),
+                         0,
+                         0,
+                         regex->matchData,
+                         NULL);
+    if (rc < 0) {
+        return -1;
+    }
+    return static_cast<int>(pcre2_get_ovector_pointer(regex->matchData)[0]);
+}
+
+TEST_F(RegexCacheTest, HitsAndEviction) {
+    RegexCache cache(2);
+    const RegexCache::CompiledRegex* abc = getRegex(cache, "b+c");
+    ASSERT_TRUE(abc != NULL);
+    EXPECT_EQ(1, cache.size());
+    EXPECT_EQ(1, matchPosition(abc, "abbc"));
+
+    // The same pattern and options return the same compiled code.
+    pcre2_code* abcCode = abc->code;
+    EXPECT_EQ(abcCode, getRegex(cache, "b+c")->code);
+    EXPECT_EQ(1, cache.size());
+
+    // Different options make a different entry.
+    const RegexCache::CompiledRegex* caseless = getRegex(cache, "b+c", PCRE2_CASELESS);
+    ASSERT_TRUE(caseless != NULL);
+    EXPECT_NE(abcCode, caseless->code);
+    EXPECT_EQ(2, cache.size());
+    EXPECT_EQ(1, matchPosition(caseless, "aBBC"));
+    EXPECT_EQ(-1, matchPosition(getRegex(cache, "b+c"), "aBBC"));
+
+    // "b+c" was used most recently, so adding a third pattern evicts
+    // the caseless one.
+    EXPECT_EQ(2, matchPosition(getRegex(cache, "[0-9]+"), "ab42"));
+    EXPECT_EQ(2, cache.size());
+    EXPECT_EQ(abcCode, getRegex(cache, "b+c")->code);
+
+    cache.clear();
+    EXPECT_EQ(0, cache.size());
+    EXPECT_EQ(3, matchPosition(getRegex(cache, "b+c"), "aaabc"));
+}
+
+TEST_F(RegexCacheTest, PrefixPatterns) {
+    // A pattern that is a prefix of the most recently used one must
+    // not be mistaken for it.
+    RegexCache cache;
+    EXPECT_EQ(0, matchPosition(getRegex(cache, "ab"), "abc"));
+    EXPECT_EQ(-1, matchPosition(getRegex(cache, "a"), "bbb"));
+    EXPECT_EQ(1, matchPosition(getRegex(cache, "ab"), "aab"));
+    EXPECT_EQ(2, cache.size());
+}
+
+TEST_F(RegexCacheTest, CompileError) {
+    RegexCache cache;
+    const char* bad = "a(b";
+    int errorCode = 0;
+    EXPECT_TRUE(cache.get(bad, strlen(bad), 0, &errorCode) == NULL);
+    EXPECT_NE(0, errorCode);
+    EXPECT_EQ(0, cache.size());
+
+    // The cache is still usable afterwards.
+    EXPECT_EQ(1, matchPosition(getRegex(cache, "b"), "ab"));
+}
+
+int main() {
+    return TestSuite::globalInstance()->runAll();
+}
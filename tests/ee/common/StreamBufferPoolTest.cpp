@@ -0,0 +1,138 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2018 VoltDB Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#include "harness.h"
+#include "common/StreamBufferPool.h"
+
+#include <pthread.h>
+
+using namespace voltdb;
+
+class StreamBufferPoolTest : public Test {
+public:
+    StreamBufferPoolTest() : m_pool(new StreamBufferPool()) {}
+
+    ~StreamBufferPoolTest() {
+        m_pool->close();
+    }
+
+protected:
+    StreamBufferPool* m_pool;
+};
+
+TEST_F(StreamBufferPoolTest, ReuseReleasedBuffers) {
+    char* first = m_pool->acquire(1024);
+    char* second = m_pool->acquire(1024);
+    ASSERT_TRUE(first != second);
+    EXPECT_EQ(2048, m_pool->stats().m_outstandingBytes);
+
+    StreamBufferPool::release(first);
+    EXPECT_EQ(1024, m_pool->stats().m_pooledBytes);
+    EXPECT_EQ(1024, m_pool->stats().m_outstandingBytes);
+
+    // A buffer of the same size comes from the pool; another size does not.
+    char* reused = m_pool->acquire(1024);
+    EXPECT_EQ(first, reused);
+    char* other = m_pool->acquire(2048);
+    StreamBufferPool::Stats stats = m_pool->stats();
+    EXPECT_EQ(1, stats.m_hits);
+    EXPECT_EQ(3, stats.m_misses);
+    EXPECT_EQ(0, stats.m_pooledBytes);
+    EXPECT_EQ(4096, stats.m_outstandingBytes);
+
+    StreamBufferPool::release(reused);
+    StreamBufferPool::release(second);
+    StreamBufferPool::release(other);
+    stats = m_pool->stats();
+    EXPECT_EQ(4096, stats.m_pooledBytes);
+    EXPECT_EQ(0, stats.m_outstandingBytes);
+}
+
+TEST_F(StreamBufferPoolTest, UnpooledBuffers) {
+    char* buffer = StreamBufferPool::allocateUnpooled(64);
+    buffer[63] = 1;
+    StreamBufferPool::release(buffer);
+    StreamBufferPool::release(NULL);
+    EXPECT_EQ(0, m_pool->stats().m_pooledBytes);
+}
+
+TEST_F(StreamBufferPoolTest, Capacity) {
+    m_pool->setCapacity(3000);
+    EXPECT_EQ(3000, m_pool->capacity());
+    char* buffers[3];
+    for (int i = 0; i < 3; ++i) {
+        buffers[i] = m_pool->acquire(1000);
+    }
+    for (int i = 0; i < 3; ++i) {
+        StreamBufferPool::release(buffers[i]);
+    }
+    EXPECT_EQ(3000, m_pool->stats().m_pooledBytes);
+
+    // Past its capacity the pool frees what is released.
+    char* extra[4];
+    for (int i = 0; i < 4; ++i) {
+        extra[i] = m_pool->acquire(1000);
+    }
+    EXPECT_EQ(0, m_pool->stats().m_pooledBytes);
+    for (int i = 0; i < 4; ++i) {
+        StreamBufferPool::release(extra[i]);
+    }
+    EXPECT_EQ(3000, m_pool->stats().m_pooledBytes);
+
+    // Shrinking the pool frees pooled buffers.
+    m_pool->setCapacity(1500);
+    EXPECT_EQ(1000, m_pool->stats().m_pooledBytes);
+    m_pool->setCapacity(0);
+    EXPECT_EQ(0, m_pool->stats().m_pooledBytes);
+}
+
+static void* releaseBuffer(void* buffer) {
+    StreamBufferPool::release(static_cast<char*>(buffer));
+    return NULL;
+}
+
+TEST_F(StreamBufferPoolTest, ReleaseOnAnotherThread) {
+    char* buffer = m_pool->acquire(4096);
+    pthread_t thread;
+    ASSERT_EQ(0, pthread_create(&thread, NULL, releaseBuffer, buffer));
+    pthread_join(thread, NULL);
+    EXPECT_EQ(4096, m_pool->stats().m_pooledBytes);
+    EXPECT_EQ(buffer, m_pool->acquire(4096));
+    StreamBufferPool::release(buffer);
+}
+
+TEST_F(StreamBufferPoolTest, ReleaseAfterClose) {
+    // Java can hold a site's buffers after the site has shut down.
+    StreamBufferPool* pool = new StreamBufferPool();
+    char* pooled = pool->acquire(512);
+    char* outstanding = pool->acquire(512);
+    StreamBufferPool::release(pooled);
+    pool->close();
+    outstanding[511] = 1;
+    StreamBufferPool::release(outstanding);
+}
+
+int main() {
+    return TestSuite::globalInstance()->runAll();
+}
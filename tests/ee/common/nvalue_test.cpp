@@ -33,6 +33,7 @@
 
 #include <cfloat>
 #include <limits>
+#include <set>
 
 #include "boost/scoped_ptr.hpp"
 
@@ -2882,6 +2883,57 @@ TEST_F(NValueTest, TestDedupAndSort) {
     arrayValue.free();
 }
 
+/*
+ * Lists long enough to keep a sorted copy must give the same answers,
+ * including after their elements are replaced.
+ */
+TEST_F(NValueTest, TestLongInList)
+{
+    assert(ExecutorContext::getExecutorContext() == NULL);
+    Pool* testPool = new Pool();
+    getExecutorContextForTest(testPool);
+
+    const int length = 500;
+    std::vector<NValue> vectorValues;
+    NValue arrayValue = ValueFactory::getArrayValueFromSizeAndType(length, VALUE_TYPE_BIGINT);
+
+    for (int round = 0; round < 3; round++) {
+        // Even numbers, some of them repeated, in no particular order,
+        // and a few nulls; shifted each round.
+        std::set<int64_t> members;
+        vectorValues.clear();
+        for (int ii = 0; ii < length; ii++) {
+            if (ii % 97 == 0) {
+                vectorValues.push_back(ValueFactory::getNullValue());
+                continue;
+            }
+            int64_t value = ((ii * 7919) % 300) * 2 + round;
+            members.insert(value);
+            vectorValues.push_back(ValueFactory::getBigIntValue(value));
+        }
+        arrayValue.setArrayElements(vectorValues);
+
+        for (int64_t probe = -10; probe < 620; probe++) {
+            bool expected = members.find(probe) != members.end();
+            EXPECT_EQ(expected, ValueFactory::getBigIntValue(probe).inList(arrayValue));
+            EXPECT_EQ(expected, ValueFactory::getIntegerValue(static_cast<int32_t>(probe)).inList(arrayValue));
+            EXPECT_EQ(expected, ValueFactory::getDoubleValue(static_cast<double>(probe)).inList(arrayValue));
+        }
+        EXPECT_FALSE(ValueFactory::getDoubleValue(round + 0.5).inList(arrayValue));
+        EXPECT_FALSE(NValue::getNullValue(VALUE_TYPE_BIGINT).inList(arrayValue));
+
+        // The index scan path shares the sorted copy.
+        vectorValues.clear();
+        arrayValue.castAndSortAndDedupArrayForInList(VALUE_TYPE_BIGINT, vectorValues);
+        EXPECT_TRUE(checkValueVector(vectorValues));
+        // The nulls collapse into one leading null.
+        EXPECT_EQ(members.size() + 1, vectorValues.size());
+        EXPECT_TRUE(vectorValues[0].isNull());
+    }
+
+    arrayValue.free();
+}
+
 TEST_F(NValueTest, TestTimestampStringParse)
 {
     assert(ExecutorContext::getExecutorContext() == NULL);
@@ -0,0 +1,254 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2018 VoltDB Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <algorithm>
+#include <sstream>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "harness.h"
+
+#include "test_utils/LargeTempTableTopend.hpp"
+#include "test_utils/Tools.hpp"
+#include "test_utils/UniqueEngine.hpp"
+
+#include "common/executorcontext.hpp"
+#include "common/LargeTempTableBlockCache.h"
+#include "common/tabletuple.h"
+#include "common/ValuePeeker.hpp"
+#include "execution/ExecutorVector.h"
+#include "storage/AbstractTempTable.hpp"
+#include "storage/table.h"
+#include "storage/tableiterator.h"
+
+using namespace voltdb;
+
+// Catalog for the following DDL:
+//
+// CREATE TABLE T (
+//     G INTEGER NOT NULL,
+//     V INTEGER NOT NULL,
+//     S VARCHAR(1000) NOT NULL
+// );
+static const std::string catalogPayload =
+    "add / clusters cluster\n"
+    "set /clusters#cluster localepoch 1199145600\n"
+    "set $PREV securityEnabled false\n"
+    "set $PREV httpdportno -1\n"
+    "set $PREV jsonapi true\n"
+    "set $PREV networkpartition false\n"
+    "set $PREV heartbeatTimeout 90\n"
+    "set $PREV useddlschema false\n"
+    "set $PREV drConsumerEnabled false\n"
+    "set $PREV drProducerEnabled true\n"
+    "set $PREV drRole \"master\"\n"
+    "set $PREV drClusterId 0\n"
+    "set $PREV drProducerPort 5555\n"
+    "set $PREV drMasterHost \"\"\n"
+    "set $PREV drFlushInterval 1000\n"
+    "set $PREV preferredSource 0\n"
+    "add /clusters#cluster databases database\n"
+    "set /clusters#cluster/databases#database isActiveActiveDRed false\n"
+    "set $PREV securityprovider \"hash\"\n"
+    "add /clusters#cluster/databases#database tables T\n"
+    "set /clusters#cluster/databases#database/tables#T isreplicated true\n"
+    "set $PREV partitioncolumn null\n"
+    "set $PREV estimatedtuplecount 0\n"
+    "set $PREV materializer null\n"
+    "set $PREV signature \"T|iiv\"\n"
+    "set $PREV tuplelimit 2147483647\n"
+    "set $PREV isDRed false\n"
+    "add /clusters#cluster/databases#database/tables#T columns G\n"
+    "set /clusters#cluster/databases#database/tables#T/columns#G index 0\n"
+    "set $PREV type 5\n"
+    "set $PREV size 4\n"
+    "set $PREV nullable false\n"
+    "set $PREV name \"G\"\n"
+    "set $PREV defaultvalue null\n"
+    "set $PREV defaulttype 0\n"
+    "set $PREV aggregatetype 0\n"
+    "set $PREV matviewsource null\n"
+    "set $PREV matview null\n"
+    "set $PREV inbytes false\n"
+    "add /clusters#cluster/databases#database/tables#T columns V\n"
+    "set /clusters#cluster/databases#database/tables#T/columns#V index 1\n"
+    "set $PREV type 5\n"
+    "set $PREV size 4\n"
+    "set $PREV nullable false\n"
+    "set $PREV name \"V\"\n"
+    "set $PREV defaultvalue null\n"
+    "set $PREV defaulttype 0\n"
+    "set $PREV aggregatetype 0\n"
+    "set $PREV matviewsource null\n"
+    "set $PREV matview null\n"
+    "set $PREV inbytes false\n"
+    "add /clusters#cluster/databases#database/tables#T columns S\n"
+    "set /clusters#cluster/databases#database/tables#T/columns#S index 2\n"
+    "set $PREV type 9\n"
+    "set $PREV size 1000\n"
+    "set $PREV nullable false\n"
+    "set $PREV name \"S\"\n"
+    "set $PREV defaultvalue null\n"
+    "set $PREV defaulttype 0\n"
+    "set $PREV aggregatetype 0\n"
+    "set $PREV matviewsource null\n"
+    "set $PREV matview null\n"
+    "set $PREV inbytes false\n"
+    "add /clusters#cluster deployment deployment\n"
+    "set /clusters#cluster/deployment#deployment kfactor 0\n"
+    "add /clusters#cluster/deployment#deployment systemsettings systemsettings\n"
+    "set /clusters#cluster/deployment#deployment/systemsettings#systemsettings temptablemaxsize 100\n"
+    "set $PREV snapshotpriority 6\n"
+    "set $PREV elasticduration 50\n"
+    "set $PREV elasticthroughput 2\n"
+    "set $PREV querytimeout 10000\n"
+    "add /clusters#cluster logconfig log\n"
+    "set /clusters#cluster/logconfig#log enabled false\n"
+    "set $PREV synchronous false\n"
+    "set $PREV fsyncInterval 200\n"
+    "set $PREV maxTxns 2147483647\n"
+    "set $PREV logSize 1024\n";
+
+// A plan similar to what the planner would produce for
+//
+// SELECT G, COUNT(*), SUM(V), COUNT(DISTINCT V) FROM T GROUP BY G, S;
+//
+// using hash aggregation.  The large version of the plan copies T into
+// a large temp table through an inline projection, as the planner does
+// for large queries; the other version aggregates T directly.
+static std::string hashAggregatePlan(bool isLargeQuery)
+{
+    std::ostringstream json;
+    json << "{\"PLAN_NODES\":["
+         << "{\"ID\":1,\"PLAN_NODE_TYPE\":\"HASHAGGREGATE\",\"CHILDREN_IDS\":[2],"
+         << "\"OUTPUT_SCHEMA\":["
+         << "{\"COLUMN_NAME\":\"G\",\"EXPRESSION\":{\"TYPE\":32,\"VALUE_TYPE\":5,\"COLUMN_IDX\":0}},"
+         << "{\"COLUMN_NAME\":\"C1\",\"EXPRESSION\":{\"TYPE\":32,\"VALUE_TYPE\":6,\"COLUMN_IDX\":1}},"
+         << "{\"COLUMN_NAME\":\"C2\",\"EXPRESSION\":{\"TYPE\":32,\"VALUE_TYPE\":6,\"COLUMN_IDX\":2}},"
+         << "{\"COLUMN_NAME\":\"C3\",\"EXPRESSION\":{\"TYPE\":32,\"VALUE_TYPE\":6,\"COLUMN_IDX\":3}}],"
+         << "\"AGGREGATE_COLUMNS\":["
+         << "{\"AGGREGATE_TYPE\":\"AGGREGATE_COUNT_STAR\",\"AGGREGATE_DISTINCT\":0,\"AGGREGATE_OUTPUT_COLUMN\":1},"
+         << "{\"AGGREGATE_TYPE\":\"AGGREGATE_SUM\",\"AGGREGATE_DISTINCT\":0,\"AGGREGATE_OUTPUT_COLUMN\":2,"
+         << "\"AGGREGATE_EXPRESSION\":{\"TYPE\":32,\"VALUE_TYPE\":5,\"COLUMN_IDX\":1}},"
+         << "{\"AGGREGATE_TYPE\":\"AGGREGATE_COUNT\",\"AGGREGATE_DISTINCT\":1,\"AGGREGATE_OUTPUT_COLUMN\":3,"
+         << "\"AGGREGATE_EXPRESSION\":{\"TYPE\":32,\"VALUE_TYPE\":5,\"COLUMN_IDX\":1}}],"
+         << "\"GROUPBY_EXPRESSIONS\":["
+         << "{\"TYPE\":32,\"VALUE_TYPE\":5,\"COLUMN_IDX\":0},"
+         << "{\"TYPE\":32,\"VALUE_TYPE\":9,\"VALUE_SIZE\":1000,\"COLUMN_IDX\":2}]},"
+         << "{\"ID\":2,\"PLAN_NODE_TYPE\":\"SEQSCAN\",";
+    if (isLargeQuery) {
+        json << "\"INLINE_NODES\":[{\"ID\":3,\"PLAN_NODE_TYPE\":\"PROJECTION\",\"OUTPUT_SCHEMA\":["
+             << "{\"COLUMN_NAME\":\"G\",\"EXPRESSION\":{\"TYPE\":32,\"VALUE_TYPE\":5,\"COLUMN_IDX\":0}},"
+             << "{\"COLUMN_NAME\":\"V\",\"EXPRESSION\":{\"TYPE\":32,\"VALUE_TYPE\":5,\"COLUMN_IDX\":1}},"
+             << "{\"COLUMN_NAME\":\"S\",\"EXPRESSION\":{\"TYPE\":32,\"VALUE_TYPE\":9,\"VALUE_SIZE\":1000,\"COLUMN_IDX\":2}}"
+             << "]}],";
+    }
+    json << "\"TARGET_TABLE_NAME\":\"T\",\"TARGET_TABLE_ALIAS\":\"T\"}"
+         << "],"
+         << "\"EXECUTE_LIST\":[2,1],"
+         << "\"IS_LARGE_QUERY\":" << (isLargeQuery ? "true" : "false") << "}";
+    return json.str();
+}
+
+class HashAggregateExecutorTest : public Test {
+public:
+    // G, COUNT(*), SUM(V), COUNT(DISTINCT V)
+    typedef std::tuple<int32_t, int64_t, int64_t, int64_t> Group;
+
+    std::vector<Group> execute(VoltDBEngine* engine, const std::string& jsonPlan) {
+        std::vector<Group> groups;
+        auto ev = ExecutorVector::fromJsonPlan(engine, jsonPlan, 0);
+        UniqueTempTableResult result = engine->executePlanFragment(ev.get(), NULL);
+        TableTuple tuple(result->schema());
+        TableIterator iter = result->iterator();
+        while (iter.next(tuple)) {
+            groups.push_back(Group(ValuePeeker::peekInteger(tuple.getNValue(0)),
+                                   ValuePeeker::peekBigInt(tuple.getNValue(1)),
+                                   ValuePeeker::peekBigInt(tuple.getNValue(2)),
+                                   ValuePeeker::peekBigInt(tuple.getNValue(3))));
+        }
+        result.reset();
+        ExecutorContext::getExecutorContext()->cleanupAllExecutors();
+        std::sort(groups.begin(), groups.end());
+        return groups;
+    }
+};
+
+/*
+ * Aggregate more groups than fit in the memory a large query may use, so
+ * that the groups seen last are spilled into partitions and aggregated
+ * after the others, and check the result against the expected groups and
+ * against the same query aggregated entirely in memory.
+ */
+TEST_F(HashAggregateExecutorTest, SpilledGroupsMatchInMemoryGroups)
+{
+    std::unique_ptr<Topend> topend{new LargeTempTableTopend()};
+
+    // An LTT block cache that holds four blocks leaves room for two
+    // spill partitions and lets the groups use 16 MB.
+    int64_t tempTableMemoryLimitInBytes = 32 * 1024 * 1024;
+    UniqueEngine engine = UniqueEngineBuilder()
+        .setTopend(std::move(topend))
+        .setTempTableMemoryLimit(tempTableMemoryLimitInBytes)
+        .build();
+    ASSERT_TRUE(engine->loadCatalog(0, catalogPayload));
+
+    // Each group keeps its own copy of a 500 byte key string, so 32000
+    // groups need half again as much memory as the budget allows.
+    const int NUM_GROUPS = 32000;
+    Table* table = engine->getTableByName("T");
+    StandAloneTupleStorage storage(table->schema());
+    TableTuple tuple = storage.tuple();
+    std::vector<Group> expected;
+    for (int g = 0; g < NUM_GROUPS; ++g) {
+        std::ostringstream key;
+        key << g << ' ' << std::string(500, 'k');
+        // Every group has two rows, whose values differ for odd groups.
+        int32_t v1 = g % 5;
+        int32_t v2 = v1 + g % 2;
+        Tools::setTupleValues(&tuple, g, v1, key.str());
+        table->insertTuple(tuple);
+        Tools::setTupleValues(&tuple, g, v2, key.str());
+        table->insertTuple(tuple);
+        expected.push_back(Group(g, 2, v1 + v2, 1 + g % 2));
+    }
+
+    std::vector<Group> inMemory = execute(engine.get(), hashAggregatePlan(false));
+    ASSERT_EQ(expected.size(), inMemory.size());
+    ASSERT_TRUE(expected == inMemory);
+
+    std::vector<Group> spilled = execute(engine.get(), hashAggregatePlan(true));
+    ASSERT_EQ(expected.size(), spilled.size());
+    ASSERT_TRUE(expected == spilled);
+
+    LargeTempTableBlockCache* lttBlockCache = ExecutorContext::getExecutorContext()->lttBlockCache();
+    ASSERT_EQ(0, lttBlockCache->totalBlockCount());
+    LargeTempTableTopend* theTopend =
+        dynamic_cast<LargeTempTableTopend*>(ExecutorContext::getExecutorContext()->getTopend());
+    ASSERT_EQ(0, theTopend->storedBlockCount());
+}
+
+int main() {
+    return TestSuite::globalInstance()->runAll();
+}
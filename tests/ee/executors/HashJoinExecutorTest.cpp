@@ -0,0 +1,130 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2018 VoltDB Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <algorithm>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include <boost/optional.hpp>
+
+#include "test_utils/JoinExecutorTestBase.hpp"
+
+using namespace voltdb;
+
+class HashJoinExecutorTest : public JoinExecutorTestBase {
+public:
+    void loadTables();
+
+    /**
+     * Execute the plan and return the (OUTER_T.ID, INNER_T.ID) pairs
+     * sorted, since the hash table does not preserve any order.
+     */
+    std::vector<IdPair> executeSorted(const std::string& jsonPlan)
+    {
+        std::vector<IdPair> ids = execute(jsonPlan);
+        std::sort(ids.begin(), ids.end());
+        return ids;
+    }
+
+    static std::string hashJoinPlan(const std::string& joinType, int outerKeyColumn, int innerKeyColumn);
+};
+
+// A plan similar to what the planner would produce for
+//
+// SELECT * FROM OUTER_T <joinType> JOIN INNER_T
+//     ON OUTER_T.K = INNER_T.<innerKeyColumn>;
+//
+// with the join carried out by a hash join.
+std::string HashJoinExecutorTest::hashJoinPlan(const std::string& joinType,
+                                               int outerKeyColumn,
+                                               int innerKeyColumn)
+{
+    return joinPlan("HASHJOIN",
+                    "\"JOIN_TYPE\":\"" + joinType + "\","
+                    "\"PRE_JOIN_PREDICATE\":null,\"JOIN_PREDICATE\":null,\"WHERE_PREDICATE\":null,"
+                    "\"OUTER_HASH_EXPRESSIONS\":[" + keyJson(OUTER_TYPES[outerKeyColumn], outerKeyColumn) + "],"
+                    "\"INNER_HASH_EXPRESSIONS\":[" + keyJson(INNER_TYPES[innerKeyColumn], innerKeyColumn) + "]");
+}
+
+void HashJoinExecutorTest::loadTables()
+{
+    typedef std::tuple<int32_t, boost::optional<int32_t>> OuterRow;
+    insertRows("OUTER_T", std::vector<OuterRow>{
+        OuterRow{1, 1},
+        OuterRow{2, 2},
+        OuterRow{3, boost::none},
+        OuterRow{4, 5}
+    });
+    // Inner rows 11 and 12 share the FLOAT build key 1.0.
+    // Row 10's FLOAT key would equal OUTER_T.K = 1 if truncated to INTEGER,
+    // and its BIGINT key is out of the INTEGER range.
+    typedef std::tuple<int32_t, boost::optional<int32_t>,
+                       boost::optional<double>, boost::optional<int64_t>> InnerRow;
+    insertRows("INNER_T", std::vector<InnerRow>{
+        InnerRow{10, boost::none, 1.5, 3000000000LL},
+        InnerRow{11, boost::none, 1.0, 1},
+        InnerRow{12, boost::none, 1.0, 2},
+        InnerRow{13, boost::none, 2.0, boost::none},
+        InnerRow{14, boost::none, boost::none, 5}
+    });
+}
+
+/*
+ * INTEGER outer keys equated to FLOAT inner keys are compared as FLOAT:
+ * 1.5 matches nothing, the duplicate build key 1.0 matches twice,
+ * and NULL keys on either side never match.
+ */
+TEST_F(HashJoinExecutorTest, LeftJoinOnMixedTypeKey)
+{
+    loadTables();
+    std::vector<IdPair> expected{
+        IdPair(1, 11),
+        IdPair(1, 12),
+        IdPair(2, 13),
+        IdPair(3, NULL_ID),
+        IdPair(4, NULL_ID)
+    };
+    verify(expected, executeSorted(hashJoinPlan("LEFT", 1, 2)));
+}
+
+/*
+ * INTEGER outer keys equated to BIGINT inner keys are compared as BIGINT,
+ * so an inner key beyond the INTEGER range simply does not match.
+ * The inner join builds over the smaller outer input and probes it with
+ * the BIGINT keys.
+ */
+TEST_F(HashJoinExecutorTest, InnerJoinOnWiderKey)
+{
+    loadTables();
+    std::vector<IdPair> expected{
+        IdPair(1, 11),
+        IdPair(2, 12),
+        IdPair(4, 14)
+    };
+    verify(expected, executeSorted(hashJoinPlan("INNER", 1, 3)));
+}
+
+int main() {
+    return TestSuite::globalInstance()->runAll();
+}
@@ -0,0 +1,135 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2018 VoltDB Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include <boost/optional.hpp>
+
+#include "test_utils/JoinExecutorTestBase.hpp"
+
+using namespace voltdb;
+
+class MergeJoinExecutorTest : public JoinExecutorTestBase {
+public:
+    void loadTables();
+
+    static std::string mergeJoinPlan(const std::string& joinType);
+};
+
+// A plan similar to what the planner would produce for
+//
+// SELECT * FROM OUTER_T <joinType> JOIN INNER_T ON OUTER_T.K = INNER_T.K;
+//
+// with the join carried out by a merge join over inputs scanned in K order.
+std::string MergeJoinExecutorTest::mergeJoinPlan(const std::string& joinType)
+{
+    return joinPlan("MERGEJOIN",
+                    "\"JOIN_TYPE\":\"" + joinType + "\","
+                    "\"PRE_JOIN_PREDICATE\":null,\"JOIN_PREDICATE\":null,\"WHERE_PREDICATE\":null,"
+                    "\"OUTER_KEY_EXPRESSIONS\":[" + keyJson(OUTER_TYPES[1], 1) + "],"
+                    "\"INNER_KEY_EXPRESSIONS\":[" + keyJson(INNER_TYPES[1], 1) + "],"
+                    "\"SORT_DIRECTION\":\"ASC\"");
+}
+
+void MergeJoinExecutorTest::loadTables()
+{
+    // Both tables are loaded in K order, NULLs first, so that their scans
+    // produce the ordered inputs a merge join expects.
+    // Key 2 is duplicated on both sides.
+    typedef std::tuple<int32_t, boost::optional<int32_t>> OuterRow;
+    insertRows("OUTER_T", std::vector<OuterRow>{
+        OuterRow{1, boost::none},
+        OuterRow{2, 1},
+        OuterRow{3, 2},
+        OuterRow{4, 2},
+        OuterRow{5, 4}
+    });
+    typedef std::tuple<int32_t, boost::optional<int32_t>,
+                       boost::optional<double>, boost::optional<int64_t>> InnerRow;
+    insertRows("INNER_T", std::vector<InnerRow>{
+        InnerRow{10, boost::none, boost::none, boost::none},
+        InnerRow{11, 2, boost::none, boost::none},
+        InnerRow{12, 2, boost::none, boost::none},
+        InnerRow{13, 3, boost::none, boost::none},
+        InnerRow{14, 4, boost::none, boost::none}
+    });
+}
+
+/*
+ * Each outer tuple with key 2 joins the whole run of inner tuples with
+ * key 2, and NULL keys on either side never match.
+ */
+TEST_F(MergeJoinExecutorTest, InnerJoin)
+{
+    loadTables();
+    std::vector<IdPair> expected{
+        IdPair(3, 11),
+        IdPair(3, 12),
+        IdPair(4, 11),
+        IdPair(4, 12),
+        IdPair(5, 14)
+    };
+    verify(expected, execute(mergeJoinPlan("INNER")));
+}
+
+TEST_F(MergeJoinExecutorTest, LeftJoin)
+{
+    loadTables();
+    std::vector<IdPair> expected{
+        IdPair(1, NULL_ID),
+        IdPair(2, NULL_ID),
+        IdPair(3, 11),
+        IdPair(3, 12),
+        IdPair(4, 11),
+        IdPair(4, 12),
+        IdPair(5, 14)
+    };
+    verify(expected, execute(mergeJoinPlan("LEFT")));
+}
+
+/*
+ * The unmatched inner tuples, including the one with a NULL key,
+ * follow the outer tuples null-padded.
+ */
+TEST_F(MergeJoinExecutorTest, FullJoin)
+{
+    loadTables();
+    std::vector<IdPair> expected{
+        IdPair(1, NULL_ID),
+        IdPair(2, NULL_ID),
+        IdPair(3, 11),
+        IdPair(3, 12),
+        IdPair(4, 11),
+        IdPair(4, 12),
+        IdPair(5, 14),
+        IdPair(NULL_ID, 10),
+        IdPair(NULL_ID, 13)
+    };
+    verify(expected, execute(mergeJoinPlan("FULL")));
+}
+
+int main() {
+    return TestSuite::globalInstance()->runAll();
+}
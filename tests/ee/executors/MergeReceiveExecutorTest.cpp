@@ -90,7 +90,7 @@ public:
         return m_keys;
     }
 
-    void validateResults(AbstractExecutor::TupleComparer comp,
+    void validateResults(TupleComparer comp,
         std::vector<TableTuple>& srcTuples, int limit = -1, int offset = 0) {
 
         std::size_t size = (limit == -1) ? srcTuples.size() : limit;
@@ -140,7 +140,7 @@ TEST_F(MergeReceiveExecutorTest, emptyResultSetTest)
     std::vector<int64_t> partitionTupleCounts;
     std::vector<AbstractExpression*> keys;
     std::vector<SortDirectionType> dirs;
-    AbstractExecutor::TupleComparer comp(keys, dirs);
+    TupleComparer comp(keys, dirs);
     int limit = -1;
     int offset = 0;
     // Init the postfilter to evaluate LIMIT/OFFSET conditions
@@ -172,7 +172,7 @@ TEST_F(MergeReceiveExecutorTest, singlePartitionTest)
         addPartitionData(values, tuples, partitionTupleCounts));
 
     std::vector<SortDirectionType> dirs(1, SORT_DIRECTION_TYPE_ASC);
-    AbstractExecutor::TupleComparer comp(getSortKeys(), dirs);
+    TupleComparer comp(getSortKeys(), dirs);
     int limit = -1;
     int offset = 0;
     // Init the postfilter to evaluate LIMIT/OFFSET conditions
@@ -205,7 +205,7 @@ TEST_F(MergeReceiveExecutorTest, singlePartitionLimitOffsetTest)
         addPartitionData(values, tuples, partitionTupleCounts));
 
     std::vector<SortDirectionType> dirs(1, SORT_DIRECTION_TYPE_ASC);
-    AbstractExecutor::TupleComparer comp(getSortKeys(), dirs);
+    TupleComparer comp(getSortKeys(), dirs);
     int limit = 2;
     int offset = 1;
     // Init the postfilter to evaluate LIMIT/OFFSET conditions
@@ -238,7 +238,7 @@ TEST_F(MergeReceiveExecutorTest, singlePartitionBigOffsetTest)
         addPartitionData(values, tuples, partitionTupleCounts));
 
     std::vector<SortDirectionType> dirs(1, SORT_DIRECTION_TYPE_ASC);
-    AbstractExecutor::TupleComparer comp(getSortKeys(), dirs);
+    TupleComparer comp(getSortKeys(), dirs);
     int limit = -1;
     int offset = 10;
     // Init the postfilter to evaluate LIMIT/OFFSET conditions
@@ -278,7 +278,7 @@ TEST_F(MergeReceiveExecutorTest, twoNonOverlapPartitionsTest)
         addPartitionData(values2, tuples, partitionTupleCounts));
 
     std::vector<SortDirectionType> dirs(1, SORT_DIRECTION_TYPE_ASC);
-    AbstractExecutor::TupleComparer comp(getSortKeys(), dirs);
+    TupleComparer comp(getSortKeys(), dirs);
     int limit = -1;
     int offset = 0;
     // Init the postfilter to evaluate LIMIT/OFFSET conditions
@@ -334,7 +334,7 @@ TEST_F(MergeReceiveExecutorTest, multipleOverlapPartitionsTest)
         addPartitionData(values3, tuples, partitionTupleCounts));
 
     std::vector<SortDirectionType> dirs(1, SORT_DIRECTION_TYPE_ASC);
-    AbstractExecutor::TupleComparer comp(getSortKeys(), dirs);
+    TupleComparer comp(getSortKeys(), dirs);
     int limit = -1;
     int offset = 0;
     // Init the postfilter to evaluate LIMIT/OFFSET conditions
@@ -61,6 +61,7 @@
 
 #include "expressions/abstractexpression.h"
 #include "expressions/expressions.h"
+#include "expressions/expressionutil.h"
 #include "common/types.h"
 #include "common/ValuePeeker.hpp"
 #include "common/PlannerDomValue.h"
@@ -473,6 +474,185 @@ TEST_F(ExpressionTest, HashRange) {
     TupleSchema::freeTupleSchema(schema);
 }
 
+/*
+ * Build a schema of nullable BIGINT, INTEGER and DOUBLE columns and
+ * fill numTuples tuples in storage with a mix of values, NULLs and NaNs.
+ */
+static TupleSchema* buildFixedWidthTuples(int numTuples,
+                                          boost::scoped_array<char>& tupleStorage,
+                                          vector<TableTuple>& tuples) {
+    vector<int32_t> columnSizes;
+    columnSizes.push_back(8);
+    columnSizes.push_back(4);
+    columnSizes.push_back(8);
+
+    vector<bool> allowNull(3, true);
+
+    vector<voltdb::ValueType> types;
+    types.push_back(voltdb::VALUE_TYPE_BIGINT);
+    types.push_back(voltdb::VALUE_TYPE_INTEGER);
+    types.push_back(voltdb::VALUE_TYPE_DOUBLE);
+
+    TupleSchema *schema = TupleSchema::createTupleSchemaForTest(types,columnSizes,allowNull);
+
+    const int tupleLength = schema->tupleLength() + TUPLE_HEADER_SIZE;
+    tupleStorage.reset(new char[tupleLength * numTuples]);
+    for (int ii = 0; ii < numTuples; ii++) {
+        TableTuple t(tupleStorage.get() + ii * tupleLength, schema);
+        t.setNValue(0, (ii % 17 == 0) ? NValue::getNullValue(VALUE_TYPE_BIGINT) :
+                    ValueFactory::getBigIntValue(ii % 50 - 25));
+        t.setNValue(1, (ii % 13 == 0) ? NValue::getNullValue(VALUE_TYPE_INTEGER) :
+                    ValueFactory::getIntegerValue(ii % 40 - 20));
+        double d = (ii % 11 == 0) ? std::numeric_limits<double>::quiet_NaN() : (ii % 30) - 15.5;
+        t.setNValue(2, (ii % 19 == 0) ? NValue::getNullValue(VALUE_TYPE_DOUBLE) :
+                    ValueFactory::getDoubleValue(d));
+        tuples.push_back(t);
+    }
+    return schema;
+}
+
+/*
+ * Show that batch evaluation of predicates selects the same rows as
+ * evaluating them one tuple at a time, including for NULLs and NaNs.
+ */
+TEST_F(ExpressionTest, BatchPredicate) {
+    const int numTuples = 500;
+    boost::scoped_array<char> tupleStorage;
+    vector<TableTuple> tuples;
+    TupleSchema *schema = buildFixedWidthTuples(numTuples, tupleStorage, tuples);
+
+    vector<AbstractExpression*> predicates;
+    // BIGINT > constant
+    predicates.push_back(new ComparisonExpression<CmpGt>(EXPRESSION_TYPE_COMPARE_GREATERTHAN,
+                                                         new TupleValueExpression(0, 0),
+                                                         new ConstantValueExpression(ValueFactory::getBigIntValue(3))));
+    // INTEGER <= BIGINT
+    predicates.push_back(new ComparisonExpression<CmpLte>(EXPRESSION_TYPE_COMPARE_LESSTHANOREQUALTO,
+                                                          new TupleValueExpression(0, 1),
+                                                          new TupleValueExpression(0, 0)));
+    // DOUBLE <> INTEGER
+    predicates.push_back(new ComparisonExpression<CmpNe>(EXPRESSION_TYPE_COMPARE_NOTEQUAL,
+                                                         new TupleValueExpression(0, 2),
+                                                         new TupleValueExpression(0, 1)));
+    // constant < DOUBLE AND BIGINT = INTEGER
+    predicates.push_back(new ConjunctionExpression<ConjunctionAnd>(EXPRESSION_TYPE_CONJUNCTION_AND,
+        new ComparisonExpression<CmpLt>(EXPRESSION_TYPE_COMPARE_LESSTHAN,
+                                        new ConstantValueExpression(ValueFactory::getDoubleValue(-4.5)),
+                                        new TupleValueExpression(0, 2)),
+        new ComparisonExpression<CmpEq>(EXPRESSION_TYPE_COMPARE_EQUAL,
+                                        new TupleValueExpression(0, 0),
+                                        new TupleValueExpression(0, 1))));
+    // BIGINT >= NULL OR DOUBLE < constant OR INTEGER = constant
+    predicates.push_back(new ConjunctionExpression<ConjunctionOr>(EXPRESSION_TYPE_CONJUNCTION_OR,
+        new ComparisonExpression<CmpGte>(EXPRESSION_TYPE_COMPARE_GREATERTHANOREQUALTO,
+                                         new TupleValueExpression(0, 0),
+                                         new ConstantValueExpression(NValue::getNullValue(VALUE_TYPE_BIGINT))),
+        new ConjunctionExpression<ConjunctionOr>(EXPRESSION_TYPE_CONJUNCTION_OR,
+            new ComparisonExpression<CmpLt>(EXPRESSION_TYPE_COMPARE_LESSTHAN,
+                                            new TupleValueExpression(0, 2),
+                                            new ConstantValueExpression(ValueFactory::getDoubleValue(0.0))),
+            new ComparisonExpression<CmpEq>(EXPRESSION_TYPE_COMPARE_EQUAL,
+                                            new TupleValueExpression(0, 1),
+                                            new ConstantValueExpression(ValueFactory::getIntegerValue(7))))));
+
+    for (int pp = 0; pp < predicates.size(); pp++) {
+        boost::scoped_ptr<AbstractExpression> predicate(predicates[pp]);
+
+        // Start from every other tuple, so the selection has gaps.
+        SelectionVector selection;
+        for (uint32_t ii = 0; ii < numTuples; ii += 2) {
+            selection.push_back(ii);
+        }
+        predicate->evalPredicateBatch(&tuples[0], selection);
+
+        SelectionVector expected;
+        for (uint32_t ii = 0; ii < numTuples; ii += 2) {
+            if (predicate->eval(&tuples[ii], NULL).isTrue()) {
+                expected.push_back(ii);
+            }
+        }
+        ASSERT_EQ(expected.size(), selection.size());
+        for (int ii = 0; ii < expected.size(); ii++) {
+            ASSERT_EQ(expected[ii], selection[ii]);
+        }
+    }
+    TupleSchema::freeTupleSchema(schema);
+}
+
+/*
+ * Show that comparisons of fixed-width columns with constants and
+ * parameters get specialized on the column type, and give the same
+ * results as the general comparisons.
+ */
+TEST_F(ExpressionTest, FixedWidthComparison) {
+    const int numTuples = 200;
+    boost::scoped_array<char> tupleStorage;
+    vector<TableTuple> tuples;
+    TupleSchema *schema = buildFixedWidthTuples(numTuples, tupleStorage, tuples);
+    ValueType columnTypes[] = { VALUE_TYPE_BIGINT, VALUE_TYPE_INTEGER, VALUE_TYPE_DOUBLE };
+
+    ExpressionType comparisons[] = {
+        EXPRESSION_TYPE_COMPARE_EQUAL,
+        EXPRESSION_TYPE_COMPARE_NOTEQUAL,
+        EXPRESSION_TYPE_COMPARE_LESSTHAN,
+        EXPRESSION_TYPE_COMPARE_GREATERTHAN,
+        EXPRESSION_TYPE_COMPARE_LESSTHANOREQUALTO,
+        EXPRESSION_TYPE_COMPARE_GREATERTHANOREQUALTO
+    };
+
+    vector<NValue> operands;
+    operands.push_back(ValueFactory::getBigIntValue(3));
+    operands.push_back(ValueFactory::getIntegerValue(-7));
+    operands.push_back(ValueFactory::getTinyIntValue(0));
+    operands.push_back(ValueFactory::getDoubleValue(2.5));
+    operands.push_back(ValueFactory::getDoubleValue(std::numeric_limits<double>::quiet_NaN()));
+    operands.push_back(NValue::getNullValue(VALUE_TYPE_BIGINT));
+    operands.push_back(ValueFactory::getDecimalValue(1.5));
+
+    PlannerDomRoot domRoot("{}");
+    PlannerDomValue obj = domRoot.rootObject();
+    for (int col = 0; col < 3; col++) {
+        for (int cc = 0; cc < sizeof(comparisons) / sizeof(comparisons[0]); cc++) {
+            for (int oo = 0; oo < operands.size(); oo++) {
+                NValue paramValue = operands[oo];
+                bool isFixedWidthOperand = AbstractExpression::isFixedWidthBatchType(ValuePeeker::peekValueType(paramValue));
+
+                // Without a known column type, the comparison is not specialized.
+                TupleValueExpression* generalColumn = new TupleValueExpression(0, col);
+                boost::scoped_ptr<AbstractExpression> general(
+                    ExpressionUtil::comparisonFactory(obj, comparisons[cc], generalColumn,
+                                                      new ConstantValueExpression(paramValue)));
+                ASSERT_EQ(string::npos, general->debugInfo("").find("FixedWidth"));
+
+                TupleValueExpression* column = new TupleValueExpression(0, col);
+                column->setValueType(columnTypes[col]);
+                boost::scoped_ptr<AbstractExpression> withConstant(
+                    ExpressionUtil::comparisonFactory(obj, comparisons[cc], column,
+                                                      new ConstantValueExpression(paramValue)));
+                ASSERT_EQ(isFixedWidthOperand, withConstant->debugInfo("").find("FixedWidth") != string::npos);
+
+                column = new TupleValueExpression(0, col);
+                column->setValueType(columnTypes[col]);
+                boost::scoped_ptr<AbstractExpression> withParameter(
+                    ExpressionUtil::comparisonFactory(obj, comparisons[cc], column,
+                                                      new ParameterValueExpression(0, &paramValue)));
+                ASSERT_NE(string::npos, withParameter->debugInfo("").find("FixedWidth"));
+
+                for (int ii = 0; ii < numTuples; ii++) {
+                    NValue expected = general->eval(&tuples[ii], NULL);
+                    NValue actual = withConstant->eval(&tuples[ii], NULL);
+                    ASSERT_EQ(expected.isNull(), actual.isNull());
+                    ASSERT_EQ(expected.isTrue(), actual.isTrue());
+                    actual = withParameter->eval(&tuples[ii], NULL);
+                    ASSERT_EQ(expected.isNull(), actual.isNull());
+                    ASSERT_EQ(expected.isTrue(), actual.isTrue());
+                }
+            }
+        }
+    }
+    TupleSchema::freeTupleSchema(schema);
+}
+
 TEST_F(ExpressionTest, Timestamp) {
     int64_t epoch_micros = -8881540068000000; // timestamp from "1688-07-21 09:32:12"
     boost::posix_time::ptime input_ptime = EPOCH + boost::posix_time::microseconds(epoch_micros);
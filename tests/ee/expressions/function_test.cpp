@@ -753,6 +753,56 @@ TEST_F(FunctionTest, RegularExpressionMatch) {
     ASSERT_EQ(testBinary(FUNC_VOLT_REGEXP_POSITION, testUTF8String, "[a-z]家", 0), 0);
 }
 
+TEST_F(FunctionTest, JsonField) {
+    std::string doc("{\"a\": {\"b\": [10, \"x\", true, {\"c\": -3}], \"d\": null}, \"e\": \"f\\\"g\"}");
+    ASSERT_EQ(testBinary(FUNC_VOLT_FIELD, doc, "a.b[0]", "10"), 0);
+    ASSERT_EQ(testBinary(FUNC_VOLT_FIELD, doc, "a.b[1]", "x"), 0);
+    ASSERT_EQ(testBinary(FUNC_VOLT_FIELD, doc, "a.b[2]", "true"), 0);
+    ASSERT_EQ(testBinary(FUNC_VOLT_FIELD, doc, "a.b[3].c", "-3"), 0);
+    ASSERT_EQ(testBinary(FUNC_VOLT_FIELD, doc, "a.b[-1].c", "-3"), 0);
+    ASSERT_EQ(testBinary(FUNC_VOLT_FIELD, doc, "e", "f\"g"), 0);
+    ASSERT_EQ(testBinary(FUNC_VOLT_FIELD, doc, "a.b[3]", "{\"c\":-3}"), 0);
+    ASSERT_EQ(testBinary(FUNC_VOLT_FIELD, doc, "a.d", "", true), 0);
+    ASSERT_EQ(testBinary(FUNC_VOLT_FIELD, doc, "a.b[4]", "", true), 0);
+    ASSERT_EQ(testBinary(FUNC_VOLT_FIELD, doc, "a.x", "", true), 0);
+    ASSERT_EQ(testBinary(FUNC_VOLT_FIELD, doc, "e.x", "", true), 0);
+
+    ASSERT_EQ("success", testBinaryThrows(FUNC_VOLT_FIELD, std::string("{\"a\": 1,"), "a", "Invalid JSON"));
+    ASSERT_EQ("success", testBinaryThrows(FUNC_VOLT_FIELD, doc, "a[x]", "Invalid JSON path"));
+    // a malformed document is reported ahead of a malformed path
+    ASSERT_EQ("success", testBinaryThrows(FUNC_VOLT_FIELD, std::string("{\"a\""), "a[x]", "Invalid JSON * Line"));
+
+    // The streaming extractor must agree with the full parse wherever
+    // it gives an answer.
+    const char* docs[] = {
+        "{\"a\": {\"b\": {\"c\": 1}}, \"b\": 2}",
+        "{\"a\": 1, \"a\": 2}",
+        "{\"a\": {\"b\": 1}, \"a\": {\"c\": 2}}",
+        "{\"a\": [1, 2.5, -0, 12345678901234567890, \"s\\u00e9\", false, null]}",
+        "{\"a\": {\"\": [true]}} // comment",
+        "[{\"a\": 1}, {\"a\": 2}] trailing",
+        "{\"a\": \"\\u0000b\"}",
+        "\"scalar\"",
+        "null",
+    };
+    const char* paths[] = { "a", "b", "a.b", "a.b.c", "a.c", "a[0]", "a[1]", "a[2]", "a[3]", "a[4]",
+                            "a[5]", "a[6]", "a.[0]", "[1].a", "[-1].a", "." };
+    for (size_t d = 0; d < sizeof(docs) / sizeof(docs[0]); ++d) {
+        for (size_t p = 0; p < sizeof(paths) / sizeof(paths[0]); ++p) {
+            std::vector<JsonPathNode> path = JsonPathParser::parse(paths[p], static_cast<int32_t>(strlen(paths[p])));
+            std::string streamed;
+            bool streamedFound = getJsonField(docs[d], static_cast<int32_t>(strlen(docs[d])), path, streamed);
+            JsonDocument jsonDoc(docs[d], static_cast<int32_t>(strlen(docs[d])));
+            std::string parsed;
+            bool parsedFound = jsonDoc.get(path, parsed);
+            EXPECT_EQ(parsedFound, streamedFound);
+            if (parsedFound && streamedFound) {
+                EXPECT_EQ(parsed, streamed);
+            }
+        }
+    }
+}
+
 static NValue timestampFromString(const std::string& dateString) {
     return ValueFactory::getTimestampValue(NValue::parseTimestampString(dateString));
 }
@@ -28,6 +28,11 @@
 #include "common/TupleSchema.h"
 #include "common/tabletuple.h"
 #include "common/ThreadLocalPool.h"
+#include "common/SQLException.h"
+#include "expressions/tuplevalueexpression.h"
+
+#include <cstdlib>
+#include <limits>
 
 using namespace voltdb;
 
@@ -443,6 +448,142 @@ TEST_F(IndexKeyTest, Int64Packing2Int32sWithSecondNull) {
     voltdb::TupleSchema::freeTupleSchema(keySchema);
 }
 
+// Normalized keys must order mixed-type keys, NULLs and odd values
+// exactly the way GenericKey's tuple comparison does.
+TEST_F(IndexKeyTest, NormalizedKeyMatchesGenericKey) {
+    std::vector<voltdb::ValueType> columnTypes;
+    std::vector<int32_t> columnLengths;
+    std::vector<bool> columnInBytes;
+    columnTypes.push_back(voltdb::VALUE_TYPE_INTEGER);
+    columnLengths.push_back(NValue::getTupleStorageSize(voltdb::VALUE_TYPE_INTEGER));
+    columnInBytes.push_back(false);
+    columnTypes.push_back(voltdb::VALUE_TYPE_VARCHAR);
+    columnLengths.push_back(6);
+    columnInBytes.push_back(true);
+    columnTypes.push_back(voltdb::VALUE_TYPE_DOUBLE);
+    columnLengths.push_back(NValue::getTupleStorageSize(voltdb::VALUE_TYPE_DOUBLE));
+    columnInBytes.push_back(false);
+    columnTypes.push_back(voltdb::VALUE_TYPE_DECIMAL);
+    columnLengths.push_back(NValue::getTupleStorageSize(voltdb::VALUE_TYPE_DECIMAL));
+    columnInBytes.push_back(false);
+    columnTypes.push_back(voltdb::VALUE_TYPE_VARBINARY);
+    columnLengths.push_back(4);
+    columnInBytes.push_back(false);
+    voltdb::TupleSchema *keySchema = voltdb::TupleSchema::createKeySchema(columnTypes, columnLengths, columnInBytes);
+    EXPECT_EQ(5 + 9 + 9 + 17 + 7, voltdb::NormalizedKeyEncoding::keyLength(keySchema));
+
+    voltdb::GenericKey<256>::KeyComparator genericComparator(keySchema);
+    voltdb::NormalizedKey<48>::KeyComparator comparator(keySchema);
+    voltdb::NormalizedKey<48>::KeyEqualityChecker equality(keySchema);
+    voltdb::NormalizedKey<48>::KeyHasher hasher(keySchema);
+
+    const double inf = std::numeric_limits<double>::infinity();
+    std::vector<voltdb::NValue> values[5];
+    values[0].push_back(ValueFactory::getIntegerValue(-5));
+    values[0].push_back(ValueFactory::getIntegerValue(0));
+    values[0].push_back(ValueFactory::getIntegerValue(INT32_MAX));
+    values[0].push_back(NValue::getNullValue(voltdb::VALUE_TYPE_INTEGER));
+    const char *strings[] = { "", "a", "ab", "b", "\xff" };
+    for (int ii = 0; ii < 5; ++ii) {
+        values[1].push_back(ValueFactory::getStringValue(strings[ii]));
+    }
+    values[1].push_back(ValueFactory::getStringValue(std::string("a\0", 2)));
+    values[1].push_back(ValueFactory::getStringValue(std::string("a\0z", 3)));
+    values[1].push_back(NValue::getNullValue(voltdb::VALUE_TYPE_VARCHAR));
+    const double doubles[] = { -inf, -1.5, -0.0, 0.0, 2.5, inf, std::numeric_limits<double>::quiet_NaN() };
+    for (int ii = 0; ii < 7; ++ii) {
+        values[2].push_back(ValueFactory::getDoubleValue(doubles[ii]));
+    }
+    values[2].push_back(NValue::getNullValue(voltdb::VALUE_TYPE_DOUBLE));
+    values[3].push_back(ValueFactory::getDecimalValueFromString("-1.5"));
+    values[3].push_back(ValueFactory::getDecimalValueFromString("0"));
+    values[3].push_back(ValueFactory::getDecimalValueFromString("0.25"));
+    values[3].push_back(NValue::getNullValue(voltdb::VALUE_TYPE_DECIMAL));
+    const char *binaries[] = { "", "00", "0001", "01", "FF" };
+    for (int ii = 0; ii < 5; ++ii) {
+        values[4].push_back(ValueFactory::getBinaryValue(binaries[ii]));
+    }
+    values[4].push_back(NValue::getNullValue(voltdb::VALUE_TYPE_VARBINARY));
+
+    const int keyCount = 300;
+    std::vector<char*> storage;
+    std::vector<voltdb::NormalizedKey<48> > keys;
+    voltdb::TableTuple tuple(keySchema);
+    srand(12345);
+    for (int ii = 0; ii < keyCount; ++ii) {
+        tuple.move(new char[tuple.tupleLength()]());
+        for (int col = 0; col < 5; ++col) {
+            tuple.setNValue(col, values[col][rand() % values[col].size()]);
+        }
+        storage.push_back(tuple.address());
+        keys.push_back(voltdb::NormalizedKey<48>(&tuple));
+    }
+
+    for (int ii = 0; ii < keyCount; ++ii) {
+        voltdb::TableTuple lhTuple(storage[ii], keySchema);
+        voltdb::GenericKey<256> lhs(&lhTuple);
+        for (int jj = 0; jj < keyCount; ++jj) {
+            voltdb::TableTuple rhTuple(storage[jj], keySchema);
+            voltdb::GenericKey<256> rhs(&rhTuple);
+            const int expected = genericComparator(lhs, rhs);
+            EXPECT_EQ(expected, comparator(keys[ii], keys[jj]));
+            EXPECT_EQ(expected == 0, equality(keys[ii], keys[jj]));
+            if (expected == 0) {
+                EXPECT_EQ(hasher(keys[ii]), hasher(keys[jj]));
+            }
+        }
+    }
+
+    for (int ii = 0; ii < keyCount; ++ii) {
+        delete [] storage[ii];
+    }
+    for (int col = 0; col < 5; ++col) {
+        for (size_t ii = 0; ii < values[col].size(); ++ii) {
+            values[col][ii].free();
+        }
+    }
+    voltdb::TupleSchema::freeTupleSchema(keySchema);
+}
+
+// An indexed expression value too wide for its normalized key column
+// must be rejected rather than silently truncated.
+TEST_F(IndexKeyTest, NormalizedKeyRejectsOverlongIndexedValue) {
+    std::vector<voltdb::ValueType> columnTypes(1, voltdb::VALUE_TYPE_VARCHAR);
+    std::vector<bool> columnInBytes(1, true);
+    std::vector<int32_t> tableLengths(1, 10);
+    std::vector<int32_t> keyLengths(1, 4);
+    voltdb::TupleSchema *tableSchema = voltdb::TupleSchema::createKeySchema(columnTypes, tableLengths, columnInBytes);
+    voltdb::TupleSchema *keySchema = voltdb::TupleSchema::createKeySchema(columnTypes, keyLengths, columnInBytes);
+
+    voltdb::TupleValueExpression expression(0, 0);
+    std::vector<voltdb::AbstractExpression*> expressions(1, &expression);
+    std::vector<int> indices(1, 0);
+
+    char *storage = new char[tableSchema->tupleLength() + TUPLE_HEADER_SIZE]();
+    voltdb::TableTuple tuple(storage, tableSchema);
+
+    NValue shortValue = ValueFactory::getStringValue("abcd");
+    tuple.setNValue(0, shortValue);
+    voltdb::NormalizedKey<16> fits(&tuple, indices, expressions, keySchema);
+
+    NValue longValue = ValueFactory::getStringValue("abcdefgh");
+    tuple.setNValue(0, longValue);
+    int flags = 0;
+    try {
+        voltdb::NormalizedKey<16> tooLong(&tuple, indices, expressions, keySchema);
+    }
+    catch (const voltdb::SQLException &e) {
+        flags = e.getInternalFlags();
+    }
+    EXPECT_EQ(voltdb::SQLException::TYPE_VAR_LENGTH_MISMATCH, flags);
+
+    shortValue.free();
+    longValue.free();
+    delete[] storage;
+    voltdb::TupleSchema::freeTupleSchema(keySchema);
+    voltdb::TupleSchema::freeTupleSchema(tableSchema);
+}
+
 int main() {
     return TestSuite::globalInstance()->runAll();
 }
@@ -747,6 +747,62 @@ TEST_F(IndexTest, IntsMulti) {
     delete[] searchkey.address();
 }
 
+TEST_F(IndexTest, IntsMultiBTree) {
+    vector<int> ixm_column_indices;
+    vector<ValueType> ixm_column_types;
+    ixm_column_indices.push_back(4);
+    ixm_column_indices.push_back(2);
+    ixm_column_types.push_back(VALUE_TYPE_BIGINT);
+    ixm_column_types.push_back(VALUE_TYPE_BIGINT);
+    init("ixmb",
+         BTREE_INDEX,
+         ixm_column_indices,
+         ixm_column_types,
+         false);
+
+    TableIndex* index = table->index("ixmb");
+    EXPECT_TRUE(index != NULL);
+    EXPECT_EQ(std::string("CompactingBTreeMultiMapIndex"), index->getTypeName());
+    IndexCursor indexCursor(index->getTupleSchema());
+
+    TableTuple tuple(table->schema());
+    vector<ValueType> keyColumnTypes(2, VALUE_TYPE_BIGINT);
+    vector<int32_t>
+        keyColumnLengths(2, NValue::getTupleStorageSize(VALUE_TYPE_BIGINT));
+    vector<bool> keyColumnAllowNull(2, true);
+    TupleSchema* keySchema =
+        TupleSchema::createTupleSchemaForTest(keyColumnTypes,
+                                       keyColumnLengths,
+                                       keyColumnAllowNull);
+    TableTuple searchkey(keySchema);
+    searchkey.move(new char[searchkey.tupleLength()]);
+    searchkey.setNValue(0, ValueFactory::getBigIntValue(static_cast<int64_t>(550)));
+    searchkey.setNValue(1, ValueFactory::getBigIntValue(static_cast<int64_t>(2)));
+    EXPECT_TRUE(index->moveToKey(&searchkey, indexCursor));
+    tuple = index->nextValueAtKey(indexCursor);
+    EXPECT_FALSE(tuple.isNullTuple());
+    EXPECT_TRUE(ValueFactory::getBigIntValue(50).op_equals(tuple.getNValue(0)).isTrue());
+    tuple = index->nextValueAtKey(indexCursor);
+    EXPECT_TRUE(tuple.isNullTuple());
+
+    // scan forward from a partial key across the whole index
+    searchkey.
+        setNValue(0, ValueFactory::getBigIntValue(static_cast<int64_t>(440)));
+    searchkey.
+        setNValue(1, ValueFactory::getBigIntValue(static_cast<int64_t>(-10000000)));
+    index->moveToKeyOrGreater(&searchkey, indexCursor);
+    for (int64_t i = 40; i <= NUM_OF_TUPLES; i++) {
+        EXPECT_FALSE((tuple = index->nextValue(indexCursor)).isNullTuple());
+        EXPECT_TRUE(ValueFactory::getBigIntValue(i).
+                    op_equals(tuple.getNValue(0)).isTrue());
+    }
+    EXPECT_TRUE(index->nextValue(indexCursor).isNullTuple());
+    EXPECT_EQ(NUM_OF_TUPLES, index->getSize());
+
+    TupleSchema::freeTupleSchema(keySchema);
+    delete[] searchkey.address();
+}
+
 TEST_F(IndexTest, TupleKeyUnique) {
 
     // make a tuple with the index key schema
@@ -131,7 +131,7 @@ public:
         delete m_table;
     }
 
-    void initTable() {
+    void initTable(int partitionColumn = -1) {
         m_tableSchema = voltdb::TupleSchema::createTupleSchemaForTest(m_tableSchemaTypes,
                                                                m_tableSchemaColumnSizes,
                                                                m_tableSchemaAllowNull);
@@ -165,7 +165,8 @@ public:
 
 
         m_table = dynamic_cast<voltdb::PersistentTable*>(
-                voltdb::TableFactory::getPersistentTable(m_tableId, "Foo", m_tableSchema, m_columnNames, signature));
+                voltdb::TableFactory::getPersistentTable(m_tableId, "Foo", m_tableSchema, m_columnNames, signature,
+                                                         false, partitionColumn));
 
         TableIndex *pkeyIndex = TableIndexFactory::getInstance(indexScheme);
         assert(pkeyIndex);
@@ -218,7 +219,6 @@ public:
         m_tuplesInsertedInLastUndo = 0;
     }
 
-    /// NEVER CALLED???
     void doRandomTableMutation(PersistentTable *table) {
         int rand = ::rand();
         int op = rand % 3;
@@ -523,6 +523,239 @@ TEST_F(CompactionTest, CompactionWithCopyOnWrite) {
     }
 }
 
+TEST_F(CompactionTest, IncrementalIndexBuild) {
+    initTable(0);
+#ifdef MEMCHECK
+    int tupleCount = 1000;
+#else
+    int tupleCount = 100000;
+#endif
+    addRandomUniqueTuples(m_table, tupleCount);
+
+    std::vector<int> columnIndices(1, 1);
+    voltdb::TableIndexScheme scheme("IncrementalIndex",
+                                    voltdb::BALANCED_TREE_INDEX,
+                                    columnIndices,
+                                    TableIndex::simplyIndexColumns(),
+                                    false, false, m_tableSchema);
+    TableIndex *index = TableIndexFactory::getInstance(scheme);
+    m_table->addIndexIncrementally(index);
+    ASSERT_TRUE(m_table->isBuildingIndex());
+    ASSERT_EQ(4, m_table->indexCount());
+
+    voltdb::TableIndex *pkeyIndex = m_table->primaryKeyIndex();
+    TableTuple key(pkeyIndex->getKeySchema());
+    boost::scoped_array<char> backingStore(new char[pkeyIndex->getKeySchema()->tupleLength()]);
+    key.moveNoHeader(backingStore.get());
+    IndexCursor indexCursor(pkeyIndex->getTupleSchema());
+
+    // Between chunks, change rows on both sides of the build's cursor and
+    // thin out every block so that compaction moves rows across it.
+    int chunks = 0;
+    while (m_table->continueIndexBuild(tupleCount / 20)) {
+        for (int ii = 0; ii < 200; ii++) {
+            doRandomTableMutation(m_table);
+        }
+        doRandomUndo();
+        for (int pkey = chunks % 10; pkey < tupleCount; pkey += 10) {
+            key.setNValue(0, ValueFactory::getIntegerValue(pkey));
+            if (pkeyIndex->moveToKey(&key, indexCursor)) {
+                TableTuple tuple = pkeyIndex->nextValueAtKey(indexCursor);
+                m_table->deleteTuple(tuple, true);
+            }
+        }
+        m_table->doForcedCompaction();
+        chunks++;
+    }
+    ASSERT_TRUE(chunks > 1);
+    ASSERT_FALSE(m_table->isBuildingIndex());
+    ASSERT_EQ(5, m_table->indexCount());
+    ASSERT_EQ(index, m_table->index("IncrementalIndex"));
+
+    // The finished index has every row, and only those rows.
+    ASSERT_EQ(m_table->activeTupleCount(), index->getSize());
+    TableTuple indexKey(index->getKeySchema());
+    boost::scoped_array<char> indexKeyStore(new char[index->getKeySchema()->tupleLength()]);
+    indexKey.moveNoHeader(indexKeyStore.get());
+    IndexCursor cursor(index->getTupleSchema());
+    TableIterator iter = m_table->iterator();
+    TableTuple tuple(m_table->schema());
+    while (iter.next(tuple)) {
+        indexKey.setNValue(0, tuple.getNValue(1));
+        ASSERT_TRUE(index->moveToKey(&indexKey, cursor));
+        bool found = false;
+        for (TableTuple match = index->nextValueAtKey(cursor);
+             !match.isNullTuple(); match = index->nextValueAtKey(cursor)) {
+            found = found || match.address() == tuple.address();
+        }
+        ASSERT_TRUE(found);
+    }
+
+    // A plan that needs an index before it is built finishes it.
+    voltdb::TableIndexScheme scheme2("IncrementalIndex2",
+                                     voltdb::HASH_TABLE_INDEX,
+                                     columnIndices,
+                                     TableIndex::simplyIndexColumns(),
+                                     false, false, m_tableSchema);
+    TableIndex *index2 = TableIndexFactory::getInstance(scheme2);
+    m_table->addIndexIncrementally(index2);
+    ASSERT_TRUE(m_table->isBuildingIndex());
+    ASSERT_EQ(index2, m_table->index("IncrementalIndex2"));
+    ASSERT_FALSE(m_table->isBuildingIndex());
+    ASSERT_EQ(m_table->activeTupleCount(), index2->getSize());
+}
+
+// Undoing an update made while an index was being built must take the
+// update back out of that index, even when a plan finished the build
+// in the meantime and no other index saw the update.
+TEST_F(CompactionTest, UndoUpdateAcrossIndexBuild) {
+    initTable(0);
+    int tupleCount = 1000;
+    addRandomUniqueTuples(m_table, tupleCount);
+    m_engine->setUndoToken(++m_undoToken);
+    ExecutorContext::getExecutorContext()->setupForPlanFragments(m_engine->getCurrentUndoQuantum(), 0, 0, 0, 0, false);
+
+    std::vector<int> columnIndices(1, 1);
+    voltdb::TableIndexScheme scheme("IncrementalIndex",
+                                    voltdb::BALANCED_TREE_INDEX,
+                                    columnIndices,
+                                    TableIndex::simplyIndexColumns(),
+                                    false, false, m_tableSchema);
+    TableIndex *index = TableIndexFactory::getInstance(scheme);
+    m_table->addIndexIncrementally(index);
+    ASSERT_TRUE(m_table->continueIndexBuild(tupleCount / 2));
+
+    // Update column 1 of the first and last rows, on either side of the
+    // build's cursor.  None of the installed indexes covers column 1.
+    voltdb::TableIndex *pkeyIndex = m_table->primaryKeyIndex();
+    TableTuple key(pkeyIndex->getKeySchema());
+    boost::scoped_array<char> backingStore(new char[pkeyIndex->getKeySchema()->tupleLength()]);
+    key.moveNoHeader(backingStore.get());
+    IndexCursor indexCursor(pkeyIndex->getTupleSchema());
+    const std::vector<TableIndex*> noIndexes;
+    const int pkeys[] = { 0, tupleCount - 1 };
+    for (int ii = 0; ii < 2; ii++) {
+        key.setNValue(0, ValueFactory::getIntegerValue(pkeys[ii]));
+        ASSERT_TRUE(pkeyIndex->moveToKey(&key, indexCursor));
+        TableTuple tuple = pkeyIndex->nextValueAtKey(indexCursor);
+        TableTuple tempTuple = m_table->tempTuple();
+        tempTuple.copy(tuple);
+        tempTuple.setNValue(1, ValueFactory::getIntegerValue(-1 - ii));
+        m_table->updateTupleWithSpecificIndexes(tuple, tempTuple, noIndexes);
+    }
+
+    ASSERT_EQ(index, m_table->index("IncrementalIndex"));
+    ASSERT_FALSE(m_table->isBuildingIndex());
+    m_engine->undoUndoToken(m_undoToken);
+
+    ASSERT_EQ(m_table->activeTupleCount(), index->getSize());
+    TableTuple indexKey(index->getKeySchema());
+    boost::scoped_array<char> indexKeyStore(new char[index->getKeySchema()->tupleLength()]);
+    indexKey.moveNoHeader(indexKeyStore.get());
+    IndexCursor cursor(index->getTupleSchema());
+    for (int ii = 0; ii < 2; ii++) {
+        indexKey.setNValue(0, ValueFactory::getIntegerValue(-1 - ii));
+        ASSERT_FALSE(index->moveToKey(&indexKey, cursor));
+    }
+    TableIterator iter = m_table->iterator();
+    TableTuple tuple(m_table->schema());
+    while (iter.next(tuple)) {
+        indexKey.setNValue(0, tuple.getNValue(1));
+        ASSERT_TRUE(index->moveToKey(&indexKey, cursor));
+        bool found = false;
+        for (TableTuple match = index->nextValueAtKey(cursor);
+             !match.isNullTuple(); match = index->nextValueAtKey(cursor)) {
+            found = found || match.address() == tuple.address();
+        }
+        ASSERT_TRUE(found);
+    }
+}
+
+/*
+ * Scans with a zone map filter must return every tuple in the required
+ * ranges, while skipping blocks that have none, through inserts,
+ * updates, deletes and compaction.
+ */
+TEST_F(CompactionTest, ZoneMapBlockSkipping) {
+    initTable();
+    int tupleCount = 32263 * 5;
+    addRandomUniqueTuples(m_table, tupleCount);
+    ASSERT_TRUE(m_table->allocatedBlockCount() > 2);
+    ASSERT_EQ(9, m_table->zoneMapColumns().size());
+
+    voltdb::TableIndex *pkeyIndex = m_table->primaryKeyIndex();
+    TableTuple key(pkeyIndex->getKeySchema());
+    boost::scoped_array<char> backingStore(new char[pkeyIndex->getKeySchema()->tupleLength()]);
+    key.moveNoHeader(backingStore.get());
+    IndexCursor indexCursor(pkeyIndex->getTupleSchema());
+
+    // Give one tuple a value of column 1 that no other tuple has.
+    key.setNValue(0, ValueFactory::getIntegerValue(tupleCount / 2));
+    ASSERT_TRUE(pkeyIndex->moveToKey(&key, indexCursor));
+    TableTuple updated = pkeyIndex->nextValueAtKey(indexCursor);
+    TableTuple &tempTuple = m_table->copyIntoTempTuple(updated);
+    tempTuple.setNValue(1, ValueFactory::getIntegerValue(-1));
+    m_table->updateTuple(updated, tempTuple);
+
+    for (int round = 0; round < 2; round++) {
+        // Keys are inserted in order, so a narrow key range is in one block or two.
+        ZoneMapFilter keyFilter(m_table->schema(), m_table->zoneMapColumns());
+        ASSERT_TRUE(keyFilter.addRange(0, 70000, 70100));
+        ZoneMapFilter valueFilter(m_table->schema(), m_table->zoneMapColumns());
+        ASSERT_TRUE(valueFilter.addRange(1, -1, -1));
+
+        int scanned = 0;
+        int matched = 0;
+        TableTuple tuple(m_table->schema());
+        TableIterator iter = m_table->iterator();
+        iter.setZoneMapFilter(&keyFilter);
+        while (iter.next(tuple)) {
+            scanned++;
+            int32_t pkey = ValuePeeker::peekAsInteger(tuple.getNValue(0));
+            if (pkey >= 70000 && pkey <= 70100) {
+                matched++;
+            }
+        }
+        int expected = 0;
+        iter = m_table->iterator();
+        while (iter.next(tuple)) {
+            int32_t pkey = ValuePeeker::peekAsInteger(tuple.getNValue(0));
+            if (pkey >= 70000 && pkey <= 70100) {
+                expected++;
+            }
+        }
+        ASSERT_TRUE(expected > 0);
+        ASSERT_EQ(expected, matched);
+        ASSERT_TRUE(scanned < m_table->activeTupleCount() / 2);
+
+        matched = 0;
+        iter = m_table->iterator();
+        iter.setZoneMapFilter(&valueFilter);
+        while (iter.next(tuple)) {
+            if (ValuePeeker::peekAsInteger(tuple.getNValue(1)) == -1) {
+                matched++;
+            }
+        }
+        ASSERT_EQ(1, matched);
+
+        // Thin out the table so that compaction moves tuples between blocks.
+        for (int pkey = round; pkey < tupleCount; pkey += 3) {
+            if (pkey == tupleCount / 2) {
+                continue;
+            }
+            key.setNValue(0, ValueFactory::getIntegerValue(pkey));
+            if (pkeyIndex->moveToKey(&key, indexCursor)) {
+                TableTuple tuple = pkeyIndex->nextValueAtKey(indexCursor);
+                m_table->deleteTuple(tuple, true);
+            }
+        }
+        m_engine->releaseUndoToken(m_undoToken);
+        m_engine->setUndoToken(++m_undoToken);
+        ExecutorContext::getExecutorContext()->setupForPlanFragments(m_engine->getCurrentUndoQuantum(), 0, 0, 0, 0, false);
+        m_table->doForcedCompaction();
+    }
+}
+
 /*
  * The problem I suspect in ENG897 is that the last
  * block handled by the COW iterator is not returned back to the set of
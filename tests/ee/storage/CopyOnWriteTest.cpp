@@ -23,6 +23,7 @@
 
 #include "harness.h"
 
+#include "common/LZ4Block.h"
 #include "common/NValue.hpp"
 #include "common/RecoveryProtoMessage.h"
 #include "common/TupleOutputStream.h"
@@ -925,7 +926,8 @@ public:
     void parsePredicateList(const std::vector<std::string> &predicateStrings, StreamPredicateList &predicates) {
         std::ostringstream errmsg;
         std::vector<bool> deleteFlags;
-        ASSERT_TRUE(predicates.parseStrings(predicateStrings, errmsg, deleteFlags));
+        std::vector<bool> compressFlags;
+        ASSERT_TRUE(predicates.parseStrings(predicateStrings, errmsg, deleteFlags, compressFlags));
     }
 
     boost::shared_ptr<ReferenceSerializeInputBE> getPredicateSerializeInput(const std::vector<std::string> &predicateStrings) {
@@ -1566,6 +1568,66 @@ TEST_F(CopyOnWriteTest, MultiStream) {
     }
 }
 
+/*
+ * Stream the same rows twice, asking for the first stream's rows to be
+ * compressed.  Its buffers must hold the second stream's rows in a
+ * compressed rows frame, after the same partition id and row count.
+ */
+TEST_F(CopyOnWriteTest, CompressedStream) {
+    initTable(1, 0);
+    addRandomUniqueTuples(m_table, TUPLE_COUNT);
+
+    char buffer[1024 * 256];
+    ReferenceSerializeOutput output(buffer, 1024 * 256);
+    output.writeInt(2);
+    for (int i = 0; i < 2; i++) {
+        Json::Value predicateStuff;
+        predicateStuff["triggersDelete"] = false;
+        predicateStuff["compressRows"] = (i == 0);
+        Json::FastWriter writer;
+        output.writeTextString(writer.write(predicateStuff));
+    }
+    ReferenceSerializeInputBE input(buffer, output.position());
+    ASSERT_TRUE(m_table->activateStream(TABLE_STREAM_SNAPSHOT, 0, m_tableId, input));
+
+    boost::scoped_array<char> compressedBuffer(new char[BUFFER_SIZE]);
+    boost::scoped_array<char> plainBuffer(new char[BUFFER_SIZE]);
+    boost::scoped_array<char> rows(new char[BUFFER_SIZE]);
+    size_t totalRows = 0;
+    int64_t remaining = TUPLE_COUNT;
+    while (remaining > 0) {
+        TupleOutputStreamProcessor outputStreams;
+        outputStreams.add(compressedBuffer.get(), BUFFER_SIZE);
+        outputStreams.add(plainBuffer.get(), BUFFER_SIZE);
+        std::vector<int> retPositions;
+        remaining = m_table->streamMore(outputStreams, TABLE_STREAM_SNAPSHOT, retPositions);
+        ASSERT_EQ(outputStreams.size(), retPositions.size());
+
+        ReferenceSerializeInputBE compressed(compressedBuffer.get(), retPositions[0]);
+        ReferenceSerializeInputBE plain(plainBuffer.get(), retPositions[1]);
+        ASSERT_EQ(plain.readInt(), compressed.readInt());
+        const int32_t rowCount = plain.readInt();
+        ASSERT_EQ(rowCount, compressed.readInt());
+        totalRows += rowCount;
+        if (rowCount == 0) {
+            continue;
+        }
+
+        // The rows are mostly zeroed BIGINTs, so they always shrink.
+        const int32_t rowsLength = retPositions[1] - 2 * static_cast<int32_t>(sizeof(int32_t));
+        ASSERT_EQ(TupleOutputStream::COMPRESSED_ROWS_MARKER, compressed.readInt());
+        ASSERT_EQ(rowsLength, compressed.readInt());
+        const int32_t compressedLength = compressed.readInt();
+        ASSERT_EQ(static_cast<int32_t>(retPositions[0] - 2 * sizeof(int32_t) -
+                                       TupleOutputStream::COMPRESSED_ROWS_HEADER_SIZE),
+                  compressedLength);
+        ASSERT_TRUE(LZ4Block::decompress(compressed.getRawPointer(compressedLength), compressedLength,
+                                         rows.get(), rowsLength));
+        ASSERT_EQ(0, ::memcmp(plain.getRawPointer(rowsLength), rows.get(), rowsLength));
+    }
+    ASSERT_EQ(TUPLE_COUNT, totalRows);
+}
+
 /*
  * Test for the ENG-4524 edge condition where serializeMore() yields on
  * precisely the last tuple which had caused the loop to skip the last call to
@@ -1847,9 +1909,10 @@ TEST_F(CopyOnWriteTest, ElasticIndex) {
     std::vector<std::string> predicateStrings;
     predicateStrings.push_back(generateHashRangePredicate(ranges));
     std::vector<bool> deleteFlags;
+    std::vector<bool> compressFlags;
     StreamPredicateList predicates;
     std::ostringstream errmsg;
-    ASSERT_TRUE(predicates.parseStrings(predicateStrings, errmsg, deleteFlags));
+    ASSERT_TRUE(predicates.parseStrings(predicateStrings, errmsg, deleteFlags, compressFlags));
 
     DummyElasticTableStreamer *streamerPtr = new DummyElasticTableStreamer(*this, 0, predicateStrings);
     boost::shared_ptr<TableStreamerInterface> streamer(streamerPtr);
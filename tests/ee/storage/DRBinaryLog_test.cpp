@@ -463,7 +463,10 @@ public:
 
     void flushAndApply(int64_t lastCommittedSpHandle, bool success = true) {
         ASSERT_TRUE(flush(lastCommittedSpHandle));
+        applyFlushed(success);
+    }
 
+    void applyFlushed(bool success = true) {
         int64_t uniqueId = addPartitionId(m_spHandleReplica);
         beginTxn(m_engineReplica,
                  uniqueId, // txnid
@@ -492,6 +495,31 @@ public:
         m_engine->prepareContext();
     }
 
+    /**
+     * Roll back the replica's transaction after applying a buffer threw,
+     * dropping any buffers not yet applied.
+     */
+    void abortApply() {
+        m_drStream.m_enabled = true;
+        m_drReplicatedStream.m_enabled = true;
+        applyNull();
+        m_topend.receivedDRBuffer = false;
+        endTxn(m_engineReplica, false);
+
+        m_engine->prepareContext();
+    }
+
+    /** Break the checksum of a transaction of the next flushed buffer. */
+    void corruptChecksum(int txnIndex) {
+        boost::shared_ptr<StreamBlock> sb = m_topend.blocks.front();
+        char *txn = &m_topend.data.front()[sb->headerSize()];
+        const size_t txnLengthOffset = DRTupleStream::BEGIN_RECORD_HEADER_SIZE + 1;
+        for (int i = 0; i < txnIndex; i++) {
+            txn += *reinterpret_cast<int32_t*>(txn + txnLengthOffset);
+        }
+        txn[*reinterpret_cast<int32_t*>(txn + txnLengthOffset) - 1] ^= 1;
+    }
+
     void enableActiveActive() {
         m_engine->enableActiveActiveForTest(m_engine->getConflictStreamedTable(), NULL);
         m_engineReplica->enableActiveActiveForTest(m_engineReplica->getConflictStreamedTable(), NULL);
@@ -1223,6 +1251,227 @@ TEST_F(DRBinaryLogTest, UpdateWithUniqueIndexWhenAAEnabled) {
     simpleUpdateTest();
 }
 
+TEST_F(DRBinaryLogTest, BatchApplyDelete) {
+    m_sinkWrapper.setBatchApply(true);
+    simpleDeleteTest();
+}
+
+TEST_F(DRBinaryLogTest, BatchApplyDeleteWithPrimaryKey) {
+    m_sinkWrapper.setBatchApply(true);
+    createUniqueIndexes();
+    simpleDeleteTest();
+}
+
+TEST_F(DRBinaryLogTest, BatchApplyDeleteIdenticalRows) {
+    m_sinkWrapper.setBatchApply(true);
+
+    beginTxn(m_engine, 99, 99, 98, 70);
+    TableTuple first_tuple = insertTuple(m_table, prepareTempTuple(m_table, 42, 55555, "349508345.34583", "a thing", "this is a rather long string of text that is used to cause nvalue to use outline storage for the underlying data. It should be longer than 64 bytes.", 5433));
+    insertTuple(m_table, prepareTempTuple(m_table, 42, 55555, "349508345.34583", "a thing", "this is a rather long string of text that is used to cause nvalue to use outline storage for the underlying data. It should be longer than 64 bytes.", 5433));
+    TableTuple third_tuple = insertTuple(m_table, prepareTempTuple(m_table, 72, 345, "4256.345", "something", "more tuple data, really not the same", 1812));
+    endTxn(m_engine, true);
+
+    flushAndApply(99);
+
+    EXPECT_EQ(3, m_tableReplica->activeTupleCount());
+
+    // Both deletes expect the same row image; each must remove its own row.
+    beginTxn(m_engine, 100, 100, 99, 71);
+    deleteTuple(m_table, first_tuple);
+    deleteTuple(m_table, first_tuple);
+    endTxn(m_engine, true);
+
+    flushAndApply(100);
+
+    EXPECT_EQ(1, m_tableReplica->activeTupleCount());
+    TableTuple tuple = m_tableReplica->lookupTupleForDR(third_tuple);
+    ASSERT_FALSE(tuple.isNullTuple());
+}
+
+TEST_F(DRBinaryLogTest, BatchApplyRepeatedUpdates) {
+    m_sinkWrapper.setBatchApply(true);
+    createUniqueIndexes();
+
+    beginTxn(m_engine, 99, 99, 98, 70);
+    TableTuple first_tuple = insertTuple(m_table, prepareTempTuple(m_table, 42, 55555, "349508345.34583", "a thing", "this is a rather long string of text that is used to cause nvalue to use outline storage for the underlying data. It should be longer than 64 bytes.", 5433));
+    TableTuple second_tuple = insertTuple(m_table, prepareTempTuple(m_table, 24, 2321, "23455.5554", "and another", "this is starting to get even sillier", 2222));
+    endTxn(m_engine, true);
+
+    flushAndApply(99);
+
+    EXPECT_EQ(2, m_tableReplica->activeTupleCount());
+
+    // The second update of the first row expects the result of the first.
+    beginTxn(m_engine, 100, 100, 99, 71);
+    TableTuple first_updated_tuple = updateTuple(m_table, first_tuple, 42, "not that");
+    updateTuple(m_table, second_tuple, 24, "not this either");
+    first_updated_tuple = updateTuple(m_table, first_updated_tuple, 42, "nor that");
+    endTxn(m_engine, true);
+
+    flushAndApply(100);
+
+    EXPECT_EQ(2, m_tableReplica->activeTupleCount());
+    TableTuple expected_tuple = prepareTempTuple(m_table, 42, 55555, "349508345.34583", "nor that", "this is a rather long string of text that is used to cause nvalue to use outline storage for the underlying data. It should be longer than 64 bytes.", 5433);
+    TableTuple tuple = m_tableReplica->lookupTupleByValues(expected_tuple);
+    ASSERT_FALSE(tuple.isNullTuple());
+    expected_tuple = prepareTempTuple(m_table, 24, 2321, "23455.5554", "not this either", "this is starting to get even sillier", 2222);
+    tuple = m_tableReplica->lookupTupleByValues(expected_tuple);
+    ASSERT_FALSE(tuple.isNullTuple());
+}
+
+TEST_F(DRBinaryLogTest, BatchApplyDeleteMissingTupleWhenAAEnabled) {
+    m_sinkWrapper.setBatchApply(true);
+    enableActiveActive();
+    createUniqueIndexes();
+
+    beginTxn(m_engine, 99, 99, 98, 70);
+    TableTuple first_tuple = insertTuple(m_table, prepareTempTuple(m_table, 42, 55555, "349508345.34583", "a thing", "this is a rather long string of text that is used to cause nvalue to use outline storage for the underlying data. It should be longer than 64 bytes.", 5433));
+    TableTuple second_tuple = insertTuple(m_table, prepareTempTuple(m_table, 24, 2321, "23455.5554", "and another", "this is starting to get even sillier", 2222));
+    TableTuple third_tuple = insertTuple(m_table, prepareTempTuple(m_table, 72, 345, "4256.345", "something", "more tuple data, really not the same", 1812));
+    endTxn(m_engine, true);
+    flushAndApply(99);
+
+    EXPECT_EQ(3, m_tableReplica->activeTupleCount());
+
+    // delete the second row on replica
+    beginTxn(m_engine, 100, 100, 99, 71);
+    deleteTuple(m_tableReplica, second_tuple);
+    endTxn(m_engine, true);
+    flushButDontApply(100);
+
+    // The run's second delete conflicts; the third is applied after the
+    // conflict has been handled.
+    beginTxn(m_engine, 101, 101, 100, 72);
+    deleteTuple(m_table, first_tuple);
+    deleteTuple(m_table, second_tuple);
+    deleteTuple(m_table, third_tuple);
+    endTxn(m_engine, true);
+    flushAndApply(101);
+
+    EXPECT_EQ(m_topend.actionType, DR_RECORD_DELETE);
+    EXPECT_EQ(m_topend.deleteConflictType, CONFLICT_EXPECTED_ROW_MISSING);
+    EXPECT_EQ(0, m_topend.existingTupleRowsForDelete->activeTupleCount());
+    EXPECT_EQ(1, m_topend.expectedTupleRowsForDelete->activeTupleCount());
+    EXPECT_EQ(m_topend.insertConflictType, NO_CONFLICT);
+
+    EXPECT_EQ(0, m_tableReplica->activeTupleCount());
+}
+
+TEST_F(DRBinaryLogTest, PipelinedApply) {
+    m_sinkWrapper.setPipelinedApply(true);
+
+    // More transactions than are decoded ahead of the site thread
+    for (int i = 0; i < 10; i++) {
+        beginTxn(m_engine, 99 + i, 99 + i, 98 + i, 70 + i);
+        insertTuple(m_table, prepareTempTuple(m_table, static_cast<int8_t>(i), 55555 + i, "349508345.34583", "a thing", "this is a rather long string of text that is used to cause nvalue to use outline storage for the underlying data. It should be longer than 64 bytes.", 5433));
+        endTxn(m_engine, true);
+    }
+
+    flushAndApply(108);
+
+    EXPECT_EQ(10, m_tableReplica->activeTupleCount());
+    for (int i = 0; i < 10; i++) {
+        TableTuple tuple = m_tableReplica->lookupTupleByValues(prepareTempTuple(m_table, static_cast<int8_t>(i), 55555 + i, "349508345.34583", "a thing", "this is a rather long string of text that is used to cause nvalue to use outline storage for the underlying data. It should be longer than 64 bytes.", 5433));
+        ASSERT_FALSE(tuple.isNullTuple());
+    }
+
+    m_sinkWrapper.setBatchApply(true);
+    beginTxn(m_engine, 109, 109, 108, 80);
+    for (int i = 0; i < 5; i++) {
+        TableTuple tuple = m_table->lookupTupleByValues(prepareTempTuple(m_table, static_cast<int8_t>(i), 55555 + i, "349508345.34583", "a thing", "this is a rather long string of text that is used to cause nvalue to use outline storage for the underlying data. It should be longer than 64 bytes.", 5433));
+        deleteTuple(m_table, tuple);
+    }
+    endTxn(m_engine, true);
+
+    flushAndApply(109);
+
+    EXPECT_EQ(5, m_tableReplica->activeTupleCount());
+}
+
+TEST_F(DRBinaryLogTest, PipelinedApplyCantFindTable) {
+    m_sinkWrapper.setPipelinedApply(true);
+
+    beginTxn(m_engine, 99, 99, 98, 70);
+    TableTuple temp_tuple = m_singleColumnTable->tempTuple();
+    temp_tuple.setNValue(0, ValueFactory::getTinyIntValue(1));
+    insertTuple(m_singleColumnTable, temp_tuple);
+    endTxn(m_engine, true);
+
+    // The exception reaches the site thread, and the helper lets go of the buffer.
+    try {
+        flushAndApply(99, false);
+        ASSERT_TRUE(false);
+    } catch (SerializableEEException &e) {
+        endTxn(m_engine, false);
+    } catch (...) {
+        ASSERT_TRUE(false);
+    }
+}
+
+TEST_F(DRBinaryLogTest, PipelinedApplyBadChecksum) {
+    m_sinkWrapper.setPipelinedApply(true);
+
+    for (int i = 0; i < 8; i++) {
+        beginTxn(m_engine, 99 + i, 99 + i, 98 + i, 70 + i);
+        insertTuple(m_table, prepareTempTuple(m_table, static_cast<int8_t>(i), 55555 + i, "349508345.34583", "a thing", "this is a rather long string of text that is used to cause nvalue to use outline storage for the underlying data. It should be longer than 64 bytes.", 5433));
+        endTxn(m_engine, true);
+    }
+    ASSERT_TRUE(flush(106));
+    ASSERT_EQ(1, m_topend.blocks.size());
+    corruptChecksum(5);
+
+    // The helper's exception reaches the site thread after the
+    // transactions before the bad one have been applied.
+    try {
+        applyFlushed();
+        ASSERT_TRUE(false);
+    } catch (FatalException &e) {
+        EXPECT_EQ(5, m_tableReplica->activeTupleCount());
+    } catch (...) {
+        ASSERT_TRUE(false);
+    }
+    abortApply();
+    EXPECT_EQ(0, m_tableReplica->activeTupleCount());
+}
+
+TEST_F(DRBinaryLogTest, PipelinedApplyThrowsWithTxnsDecodedAhead) {
+    m_sinkWrapper.setPipelinedApply(true);
+
+    // The helper has decoded transactions past the one that throws.
+    for (int i = 0; i < 10; i++) {
+        beginTxn(m_engine, 99 + i, 99 + i, 98 + i, 70 + i);
+        if (i == 2) {
+            TableTuple temp_tuple = m_singleColumnTable->tempTuple();
+            temp_tuple.setNValue(0, ValueFactory::getTinyIntValue(1));
+            insertTuple(m_singleColumnTable, temp_tuple);
+        }
+        else {
+            insertTuple(m_table, prepareTempTuple(m_table, static_cast<int8_t>(i), 55555 + i, "349508345.34583", "a thing", "this is a rather long string of text that is used to cause nvalue to use outline storage for the underlying data. It should be longer than 64 bytes.", 5433));
+        }
+        endTxn(m_engine, true);
+    }
+
+    try {
+        flushAndApply(108);
+        ASSERT_TRUE(false);
+    } catch (SerializableEEException &e) {
+        EXPECT_EQ(2, m_tableReplica->activeTupleCount());
+    } catch (...) {
+        ASSERT_TRUE(false);
+    }
+    abortApply();
+    EXPECT_EQ(0, m_tableReplica->activeTupleCount());
+
+    // The helper let go of the failed buffer and takes the next one.
+    beginTxn(m_engine, 109, 109, 108, 80);
+    insertTuple(m_table, prepareTempTuple(m_table, 42, 55555, "349508345.34583", "a thing", "this is a rather long string of text that is used to cause nvalue to use outline storage for the underlying data. It should be longer than 64 bytes.", 5433));
+    endTxn(m_engine, true);
+
+    flushAndApply(109);
+
+    EXPECT_EQ(1, m_tableReplica->activeTupleCount());
+}
+
 TEST_F(DRBinaryLogTest, PartialTxnRollback) {
     beginTxn(m_engine, 98, 98, 97, 69);
     TableTuple first_tuple = insertTuple(m_table, prepareTempTuple(m_table, 99, 29058, "92384598.2342", "what", "really, why am I writing anything in these?", 3455));
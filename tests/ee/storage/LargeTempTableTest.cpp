@@ -40,6 +40,7 @@
 #include "common/ValuePeeker.hpp"
 #include "common/tabletuple.h"
 #include "common/types.h"
+#include "expressions/tuplevalueexpression.h"
 #include "storage/LargeTempTable.h"
 #include "storage/tablefactory.h"
 
@@ -593,6 +594,143 @@ TEST_F(LargeTempTableTest, iteratorDeletingAsWeGo) {
     ASSERT_FALSE(tblIt.next(iterTuple));
 }
 
+TEST_F(LargeTempTableTest, sort) {
+    std::unique_ptr<Topend> topend{new LargeTempTableTopend()};
+
+    // Define an LTT block cache that can hold only three blocks, so
+    // that runs must be merged two at a time.
+    int64_t tempTableMemoryLimitInBytes = 24 * 1024 * 1024;
+    UniqueEngine engine = UniqueEngineBuilder()
+        .setTopend(std::move(topend))
+        .setTempTableMemoryLimit(tempTableMemoryLimitInBytes)
+        .build();
+    LargeTempTableBlockCache* lttBlockCache = ExecutorContext::getExecutorContext()->lttBlockCache();
+
+    typedef std::tuple<int64_t, std::string> StdTuple;
+    TupleSchema* schema = Tools::buildSchema<StdTuple>();
+    std::vector<std::string> names{"id", "str"};
+    auto ltt = makeUniqueTable(TableFactory::buildLargeTempTable("ltmp", schema, names));
+
+    TupleValueExpression keyExpr(0, 0);
+    std::vector<AbstractExpression*> keys{&keyExpr};
+    std::vector<SortDirectionType> dirs{SORT_DIRECTION_TYPE_ASC};
+    TupleComparer comparer(keys, dirs);
+
+    // As in the test above, 5000 tuples fill 3 blocks.  Insert them
+    // out of order (7 and 5000 are co-prime).
+    const int NUM_TUPLES = 5000;
+    StdTuple stdTuple{0, std::string(4096, 'z')};
+    TableTuple tupleForInsert = ltt->tempTuple();
+    for (int i = 0; i < NUM_TUPLES; ++i) {
+        std::get<0>(stdTuple) = (i * 7) % NUM_TUPLES;
+        Tools::initTuple(&tupleForInsert, stdTuple);
+        ltt->insertTuple(tupleForInsert);
+    }
+    ltt->finishInserts();
+    ASSERT_EQ(3, ltt->allocatedBlockCount());
+
+    ltt->sort(comparer, -1);
+
+    ASSERT_EQ(NUM_TUPLES, ltt->activeTupleCount());
+    ASSERT_EQ(0, lttBlockCache->numPinnedEntries());
+    ASSERT_EQ(ltt->allocatedBlockCount(), lttBlockCache->totalBlockCount());
+
+    TableIterator tblIt = ltt->iteratorDeletingAsWeGo();
+    TableTuple iterTuple{ltt->schema()};
+    int i = 0;
+    while (tblIt.next(iterTuple)) {
+        std::get<0>(stdTuple) = i;
+        ASSERT_TUPLES_EQ(stdTuple, iterTuple);
+        ++i;
+    }
+    ASSERT_EQ(NUM_TUPLES, i);
+    ASSERT_EQ(0, lttBlockCache->totalBlockCount());
+
+    // Now sort in descending order, keeping only the first 100 tuples.
+    for (i = 0; i < NUM_TUPLES; ++i) {
+        std::get<0>(stdTuple) = (i * 7) % NUM_TUPLES;
+        Tools::initTuple(&tupleForInsert, stdTuple);
+        ltt->insertTuple(tupleForInsert);
+    }
+    ltt->finishInserts();
+
+    dirs[0] = SORT_DIRECTION_TYPE_DESC;
+    ltt->sort(comparer, 100);
+
+    ASSERT_EQ(100, ltt->activeTupleCount());
+    ASSERT_EQ(1, lttBlockCache->totalBlockCount());
+
+    tblIt = ltt->iteratorDeletingAsWeGo();
+    i = 0;
+    while (tblIt.next(iterTuple)) {
+        std::get<0>(stdTuple) = NUM_TUPLES - 1 - i;
+        ASSERT_TUPLES_EQ(stdTuple, iterTuple);
+        ++i;
+    }
+    ASSERT_EQ(100, i);
+    ASSERT_EQ(0, lttBlockCache->totalBlockCount());
+
+    LargeTempTableTopend* theTopend = dynamic_cast<LargeTempTableTopend*>(ExecutorContext::getExecutorContext()->getTopend());
+    ASSERT_EQ(0, theTopend->storedBlockCount());
+}
+
+TEST_F(LargeTempTableTest, sortWithOtherBlockPinned) {
+    std::unique_ptr<Topend> topend{new LargeTempTableTopend()};
+
+    // A cache of four blocks, one of which another table keeps pinned
+    // while inserting.  Merging three runs at once would need the other
+    // three and one more for the writer.
+    int64_t tempTableMemoryLimitInBytes = 32 * 1024 * 1024;
+    UniqueEngine engine = UniqueEngineBuilder()
+        .setTopend(std::move(topend))
+        .setTempTableMemoryLimit(tempTableMemoryLimitInBytes)
+        .build();
+    LargeTempTableBlockCache* lttBlockCache = ExecutorContext::getExecutorContext()->lttBlockCache();
+
+    typedef std::tuple<int64_t, std::string> StdTuple;
+    std::vector<std::string> names{"id", "str"};
+    auto ltt = makeUniqueTable(TableFactory::buildLargeTempTable("ltmp", Tools::buildSchema<StdTuple>(), names));
+    auto otherLtt = makeUniqueTable(TableFactory::buildLargeTempTable("other", Tools::buildSchema<StdTuple>(), names));
+
+    StdTuple stdTuple{0, std::string(4096, 'z')};
+    TableTuple otherTuple = otherLtt->tempTuple();
+    Tools::initTuple(&otherTuple, stdTuple);
+    otherLtt->insertTuple(otherTuple);
+    ASSERT_EQ(1, lttBlockCache->numPinnedEntries());
+
+    TupleValueExpression keyExpr(0, 0);
+    std::vector<AbstractExpression*> keys{&keyExpr};
+    std::vector<SortDirectionType> dirs{SORT_DIRECTION_TYPE_ASC};
+    TupleComparer comparer(keys, dirs);
+
+    const int NUM_TUPLES = 5000;
+    TableTuple tupleForInsert = ltt->tempTuple();
+    for (int i = 0; i < NUM_TUPLES; ++i) {
+        std::get<0>(stdTuple) = (i * 7) % NUM_TUPLES;
+        Tools::initTuple(&tupleForInsert, stdTuple);
+        ltt->insertTuple(tupleForInsert);
+    }
+    ltt->finishInserts();
+    ASSERT_EQ(3, ltt->allocatedBlockCount());
+
+    ltt->sort(comparer, -1);
+
+    ASSERT_EQ(NUM_TUPLES, ltt->activeTupleCount());
+    ASSERT_EQ(1, lttBlockCache->numPinnedEntries());
+
+    TableIterator tblIt = ltt->iteratorDeletingAsWeGo();
+    TableTuple iterTuple{ltt->schema()};
+    int i = 0;
+    while (tblIt.next(iterTuple)) {
+        std::get<0>(stdTuple) = i;
+        ASSERT_TUPLES_EQ(stdTuple, iterTuple);
+        ++i;
+    }
+    ASSERT_EQ(NUM_TUPLES, i);
+
+    otherLtt->finishInserts();
+}
+
 int main() {
     return TestSuite::globalInstance()->runAll();
 }
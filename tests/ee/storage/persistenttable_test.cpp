@@ -786,6 +786,66 @@ TEST_F(PersistentTableTest, SwapTablesTest) {
     rollback();
 }
 
+TEST_F(PersistentTableTest, TableChecksumTest) {
+    VoltDBEngine* engine = getEngine();
+    engine->loadCatalog(0, catalogPayload());
+    PersistentTable* table = engine->getTableDelegate("T")->getPersistentTable();
+    ASSERT_NE(NULL, table);
+    PersistentTable* dupTable = engine->getTableDelegate("X")->getPersistentTable();
+    ASSERT_NE(NULL, dupTable);
+    ASSERT_EQ(0, table->hashCode());
+
+    // The same rows inserted in a different order give the same checksum.
+    beginWork();
+    const int tuplesToInsert = 10;
+    TableTuple tuple = table->tempTuple();
+    TableTuple dupTuple = dupTable->tempTuple();
+    for (int i = 0; i < tuplesToInsert; ++i) {
+        tuple.setNValue(0, ValueFactory::getBigIntValue(i));
+        tuple.setNValue(1, ValueFactory::getTempStringValue("row"));
+        table->insertTuple(tuple);
+        dupTuple.setNValue(0, ValueFactory::getBigIntValue(tuplesToInsert - 1 - i));
+        dupTuple.setNValue(1, ValueFactory::getTempStringValue("row"));
+        dupTable->insertTuple(dupTuple);
+    }
+    commit();
+    size_t checksum = table->hashCode();
+    ASSERT_NE(0, checksum);
+    ASSERT_EQ(checksum, dupTable->hashCode());
+
+    // Updates and deletes change the checksum, and their undo restores it.
+    beginWork();
+    TableTuple target(table->schema());
+    auto iterator = table->iterator();
+    ASSERT_TRUE(iterator.next(target));
+    TableTuple& tempTuple = table->copyIntoTempTuple(target);
+    tempTuple.setNValue(1, ValueFactory::getTempStringValue("updated row"));
+    table->updateTupleWithSpecificIndexes(target, tempTuple, table->allIndexes());
+    size_t updatedChecksum = table->hashCode();
+    ASSERT_NE(checksum, updatedChecksum);
+    ASSERT_TRUE(iterator.next(target));
+    table->deleteTuple(target, true);
+    ASSERT_NE(updatedChecksum, table->hashCode());
+    rollback();
+    ASSERT_EQ(checksum, table->hashCode());
+
+    // The checksum always matches one computed from the visible rows.
+    beginWork();
+    tableutil::addRandomTuples(table, tuplesToInsert);
+    size_t expected = 0;
+    iterator = table->iterator();
+    while (iterator.next(target)) {
+        expected += target.hashCode();
+    }
+    ASSERT_EQ(expected, table->hashCode());
+    commit();
+
+    beginWork();
+    table->deleteAllTuples(true);
+    commit();
+    ASSERT_EQ(0, table->hashCode());
+}
+
 int main() {
     return TestSuite::globalInstance()->runAll();
 }
@@ -57,6 +57,7 @@
 #include "common/serializeio.h"
 #include "common/debuglog.h"
 #include "common/tabletuple.h"
+#include "common/TupleOutputStream.h"
 #include "storage/temptable.h"
 #include "storage/tablefactory.h"
 #include "storage/tableiterator.h"
@@ -157,6 +158,60 @@ TEST_F(TableSerializeTest, RoundTrip) {
     delete deserialized;
 }
 
+TEST_F(TableSerializeTest, CompressedRows) {
+    // Stream the rows as a table stream does, compressed and not.
+    char plainBuffer[8192];
+    char compressedBuffer[8192];
+    TupleOutputStream plain(plainBuffer, sizeof(plainBuffer));
+    TupleOutputStream compressed(compressedBuffer, sizeof(compressedBuffer));
+    plain.startRows(0);
+    compressed.startRows(0);
+    TableTuple tuple(table_->schema());
+    TableIterator iter = table_->iterator();
+    while (iter.next(tuple)) {
+        plain.writeRow(tuple);
+        compressed.writeRow(tuple);
+    }
+    plain.endRows();
+    compressed.endRows();
+    std::vector<char> scratch;
+    ASSERT_TRUE(compressed.compressRows(scratch));
+    EXPECT_TRUE(compressed.position() < plain.position());
+
+    // Both load into the same rows.
+    TempTableLimits limits;
+    TempTable* fromPlain = TableFactory::buildTempTable("plain",
+            TupleSchema::createTupleSchema(table_->schema()), columnNames, &limits);
+    TempTable* fromCompressed = TableFactory::buildTempTable("compressed",
+            TupleSchema::createTupleSchema(table_->schema()), columnNames, &limits);
+    ReferenceSerializeInputBE plainIn(plainBuffer + sizeof(int32_t), plain.position() - sizeof(int32_t));
+    ReferenceSerializeInputBE compressedIn(compressedBuffer + sizeof(int32_t), compressed.position() - sizeof(int32_t));
+    fromPlain->loadTuplesFromNoHeader(plainIn, NULL);
+    fromCompressed->loadTuplesFromNoHeader(compressedIn, NULL);
+    EXPECT_EQ(TUPLES, fromCompressed->activeTupleCount());
+
+    CopySerializeOutput plainOut;
+    CopySerializeOutput compressedOut;
+    fromPlain->serializeTo(plainOut);
+    fromCompressed->serializeTo(compressedOut);
+    ASSERT_EQ(plainOut.size(), compressedOut.size());
+    EXPECT_EQ(0, ::memcmp(plainOut.data(), compressedOut.data(), plainOut.size()));
+
+    // Rows that do not shrink, like no rows at all, are left as they are.
+    char smallBuffer[256];
+    TupleOutputStream small(smallBuffer, sizeof(smallBuffer));
+    small.startRows(0);
+    small.endRows();
+    size_t uncompressedPosition = small.position();
+    EXPECT_FALSE(small.compressRows(scratch));
+    EXPECT_EQ(uncompressedPosition, small.position());
+
+    fromPlain->deleteAllTempTupleDeepCopies();
+    fromCompressed->deleteAllTempTupleDeepCopies();
+    delete fromPlain;
+    delete fromCompressed;
+}
+
 TEST_F(TableSerializeTest, NullStrings) {
     std::vector<std::string> columnNames(1);
     std::vector<voltdb::ValueType> columnTypes(1, voltdb::VALUE_TYPE_VARCHAR);
@@ -0,0 +1,272 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2018 VoltDB Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <map>
+#include <cstdlib>
+#include <cstdio>
+#include "harness.h"
+#include "structures/CompactingBTree.h"
+#include "common/FixUnusedAssertHack.h"
+
+using namespace voltdb;
+
+class IntComparator {
+public:
+    inline int operator()(const int &lhs, const int &rhs) const {
+        if (lhs > rhs) return 1;
+        else if (lhs < rhs) return -1;
+        else return 0;
+    }
+};
+
+/**
+ * A key that owns a resource and hands it over on copy and assignment,
+ * the way GenericPersistentKey owns its non-inlined objects.
+ */
+struct OwningKey {
+    static int s_owned;
+
+    OwningKey() : value(0), owner(false) {}
+    explicit OwningKey(int v) : value(v), owner(true) { ++s_owned; }
+    OwningKey(const OwningKey &other) : value(other.value), owner(other.owner) {
+        const_cast<OwningKey&>(other).owner = false;
+    }
+    const OwningKey& operator=(const OwningKey &other) {
+        OwningKey &writableOther = const_cast<OwningKey&>(other);
+        bool kept = owner;
+        owner = other.owner;
+        if (kept) {
+            std::swap(value, writableOther.value);
+            writableOther.owner = true;
+        }
+        else {
+            value = other.value;
+            writableOther.owner = false;
+        }
+        return *this;
+    }
+    ~OwningKey() {
+        if (owner) {
+            --s_owned;
+        }
+    }
+
+    int value;
+    bool owner;
+};
+
+int OwningKey::s_owned = 0;
+
+class OwningKeyComparator {
+public:
+    inline int operator()(const OwningKey &lhs, const OwningKey &rhs) const {
+        return IntComparator()(lhs.value, rhs.value);
+    }
+};
+
+typedef CompactingBTree<NormalKeyValuePair<int, int>, IntComparator, true> RankedTree;
+
+class CompactingBTreeTest : public Test {
+public:
+    CompactingBTreeTest() {}
+};
+
+TEST_F(CompactingBTreeTest, RandomUniqueRank) {
+    const int ITERATIONS = 200000;
+    const int BIGGEST_VAL = 20000;
+
+    std::map<int, int> stl;
+    RankedTree volt(true, IntComparator());
+    ASSERT_TRUE(volt.verify());
+
+    srand(0);
+    for (int i = 0; i < ITERATIONS; i++) {
+        int val = rand() % BIGGEST_VAL;
+        // Grow the tree for the first half, then shrink it.
+        bool inserting = (rand() % 4) < ((i < ITERATIONS / 2) ? 3 : 1);
+        if (inserting) {
+            bool inStl = stl.insert(std::make_pair(val, i)).second;
+            const int *conflict = volt.insert(val, i);
+            ASSERT_EQ(inStl, conflict == NULL);
+            if (conflict != NULL) {
+                ASSERT_EQ(stl[val], *conflict);
+            }
+        }
+        else {
+            bool inStl = stl.erase(val) == 1;
+            ASSERT_EQ(inStl, volt.erase(val));
+        }
+
+        if (i % 10000 == 0) {
+            ASSERT_TRUE(volt.verify());
+            ASSERT_TRUE(volt.verifyRank());
+        }
+        if (i % 100 == 0) {
+            std::map<int, int>::iterator stli = stl.lower_bound(val);
+            RankedTree::iterator volti = volt.lowerBound(val);
+            ASSERT_EQ(stli == stl.end(), volti.isEnd());
+            if (stli != stl.end()) {
+                ASSERT_EQ(stli->first, volti.key());
+                ASSERT_EQ(stli->second, volti.value());
+                ASSERT_EQ((int64_t)std::distance(stl.begin(), stli) + 1, volt.rankAsc(volti.key()));
+            }
+            stli = stl.upper_bound(val);
+            volti = volt.upperBound(val);
+            ASSERT_EQ(stli == stl.end(), volti.isEnd());
+            if (stli != stl.end()) {
+                ASSERT_EQ(stli->first, volti.key());
+            }
+        }
+    }
+    ASSERT_EQ(stl.size(), volt.size());
+    ASSERT_TRUE(volt.verify());
+    ASSERT_TRUE(volt.verifyRank());
+
+    // Walk the tree both ways.
+    std::map<int, int>::iterator stli = stl.begin();
+    for (RankedTree::iterator volti = volt.begin(); ! volti.isEnd(); volti.moveNext(), ++stli) {
+        ASSERT_EQ(stli->first, volti.key());
+    }
+    ASSERT_TRUE(stli == stl.end());
+    std::map<int, int>::reverse_iterator rstli = stl.rbegin();
+    for (RankedTree::iterator volti = volt.rbegin(); ! volti.isEnd(); volti.movePrev(), ++rstli) {
+        ASSERT_EQ(rstli->first, volti.key());
+    }
+    ASSERT_TRUE(rstli == stl.rend());
+}
+
+TEST_F(CompactingBTreeTest, RandomMultiRank) {
+    const int ITERATIONS = 100000;
+    const int BIGGEST_VAL = 500;
+
+    std::multimap<int, int> stl;
+    RankedTree volt(false, IntComparator());
+
+    srand(1);
+    for (int i = 0; i < ITERATIONS; i++) {
+        int val = rand() % BIGGEST_VAL;
+        if (rand() % 3 != 0) {
+            stl.insert(std::make_pair(val, i));
+            ASSERT_TRUE(volt.insert(val, i) == NULL);
+        }
+        else {
+            std::multimap<int, int>::iterator stli = stl.find(val);
+            RankedTree::iterator volti = volt.find(val);
+            ASSERT_EQ(stli == stl.end(), volti.isEnd());
+            if (stli != stl.end()) {
+                // Erase the entry the tree found, by its value.
+                while (stli->second != volti.value()) {
+                    ++stli;
+                    ASSERT_EQ(val, stli->first);
+                }
+                stl.erase(stli);
+                ASSERT_TRUE(volt.erase(volti));
+            }
+        }
+
+        if (i % 5000 == 0) {
+            ASSERT_TRUE(volt.verify());
+            ASSERT_TRUE(volt.verifyRank());
+            std::pair<RankedTree::iterator, RankedTree::iterator> range = volt.equalRange(val);
+            size_t matches = 0;
+            for (; ! range.first.equals(range.second); range.first.moveNext()) {
+                ASSERT_EQ(val, range.first.key());
+                ++matches;
+            }
+            ASSERT_EQ(stl.count(val), matches);
+            if (matches > 0) {
+                ASSERT_EQ((int64_t)std::distance(stl.begin(), stl.lower_bound(val)) + 1, volt.rankAsc(val));
+                ASSERT_EQ((int64_t)std::distance(stl.begin(), stl.upper_bound(val)), volt.rankUpper(val));
+            }
+        }
+    }
+    ASSERT_EQ(stl.size(), volt.size());
+    ASSERT_TRUE(volt.verify());
+    ASSERT_TRUE(volt.verifyRank());
+}
+
+TEST_F(CompactingBTreeTest, AppendAndCompact) {
+    const int COUNT = 100000;
+    typedef CompactingBTree<NormalKeyValuePair<int, int>, IntComparator> Tree;
+    Tree volt(true, IntComparator());
+
+    // Ascending keys fill every leaf.
+    for (int i = 0; i < COUNT; i++) {
+        ASSERT_TRUE(volt.insert(i, i) == NULL);
+    }
+    ASSERT_TRUE(volt.verify());
+    int fullLeaves = (COUNT + Tree::LEAF_CAPACITY - 1) / Tree::LEAF_CAPACITY;
+    size_t appendedBytes = volt.bytesAllocated();
+
+    // Deleting most entries hands memory back as the nodes compact.
+    for (int i = 0; i < COUNT; i++) {
+        if (i % 50 != 0) {
+            ASSERT_TRUE(volt.erase(i));
+        }
+    }
+    ASSERT_TRUE(volt.verify());
+    ASSERT_EQ(COUNT / 50, volt.size());
+    ASSERT_TRUE(volt.bytesAllocated() < appendedBytes / 4);
+    Tree::iterator iter = volt.begin();
+    for (int i = 0; i < COUNT; i += 50, iter.moveNext()) {
+        ASSERT_EQ(i, iter.key());
+    }
+    ASSERT_TRUE(iter.isEnd());
+
+    for (int i = 0; i < COUNT; i += 50) {
+        ASSERT_TRUE(volt.erase(i));
+    }
+    ASSERT_TRUE(volt.verify());
+    ASSERT_EQ(0, volt.size());
+    ASSERT_TRUE(volt.begin().isEnd());
+    ASSERT_TRUE(volt.rbegin().isEnd());
+    ASSERT_TRUE(fullLeaves > 0);
+}
+
+TEST_F(CompactingBTreeTest, OwningKeys) {
+    typedef CompactingBTree<NormalKeyValuePair<OwningKey, int>, OwningKeyComparator> Tree;
+    {
+        Tree volt(true, OwningKeyComparator());
+        srand(2);
+        for (int i = 0; i < 50000; i++) {
+            int val = rand() % 5000;
+            if (rand() % 2 == 0) {
+                volt.insert(OwningKey(val), val);
+            }
+            else {
+                volt.erase(OwningKey(val));
+            }
+            // Every key in the tree owns exactly one resource.
+            ASSERT_EQ(volt.size(), OwningKey::s_owned);
+        }
+        ASSERT_TRUE(volt.verify());
+        for (Tree::iterator iter = volt.begin(); ! iter.isEnd(); iter.moveNext()) {
+            ASSERT_EQ(iter.key().value, iter.value());
+        }
+    }
+    ASSERT_EQ(0, OwningKey::s_owned);
+}
+
+int main() {
+    return TestSuite::globalInstance()->runAll();
+}
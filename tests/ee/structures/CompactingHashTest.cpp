@@ -301,6 +301,81 @@ TEST_F(CompactingHashTest, ShrinkAndGrowMulti) {
     volt.verify();
 }
 
+TEST_F(CompactingHashTest, IncrementalResize) {
+    const uint64_t ITERATIONS = 200000;
+
+    for (int unique = 0; unique < 2; unique++) {
+        voltdb::CompactingHashTable<uint64_t,uint64_t> volt(unique == 1);
+        int checks = 0;
+
+        // grow through a few resizes, checking lookups while buckets migrate
+        for (uint64_t i = 0; i < ITERATIONS; i++) {
+            ASSERT_TRUE(volt.insert(i, i) == NULL);
+            if (!unique) {
+                ASSERT_TRUE(volt.insert(i, i + ITERATIONS) == NULL);
+            }
+            if (volt.isResizing()) {
+                if (i % 2000 == 0) {
+                    ASSERT_TRUE(volt.verify());
+                    for (uint64_t j = 0; j <= i; j += 7) {
+                        ASSERT_FALSE(volt.find(j).isEnd());
+                        ASSERT_FALSE(volt.find(j, j).isEnd());
+                    }
+                    checks++;
+                }
+                // erase and re-add older keys, which may be in either bucket array
+                if (i % 3 == 0) {
+                    ASSERT_TRUE(volt.erase(i / 2, i / 2));
+                    ASSERT_TRUE(volt.insert(i / 2, i / 2) == NULL);
+                }
+            }
+        }
+        ASSERT_TRUE(checks > 0);
+        ASSERT_TRUE(volt.verify());
+        ASSERT_EQ(ITERATIONS * (unique ? 1 : 2), volt.size());
+
+        // and shrink back down
+        for (uint64_t i = 0; i < ITERATIONS; i++) {
+            ASSERT_TRUE(volt.erase(i, i));
+            if (!unique) {
+                ASSERT_TRUE(volt.erase(i, i + ITERATIONS));
+            }
+            if (volt.isResizing() && i % 5000 == 0) {
+                ASSERT_TRUE(volt.verify());
+                ASSERT_FALSE(volt.find(ITERATIONS - 1).isEnd());
+            }
+        }
+        ASSERT_TRUE(volt.verify());
+        ASSERT_EQ(0, volt.size());
+    }
+}
+
+TEST_F(CompactingHashTest, Reserve) {
+    const uint64_t ITERATIONS = 100000;
+
+    voltdb::CompactingHashTable<uint64_t,uint64_t> volt(true);
+    size_t emptyBytes = volt.bytesAllocated();
+    volt.reserve(ITERATIONS);
+    ASSERT_FALSE(volt.isResizing());
+    ASSERT_TRUE(volt.bytesAllocated() > emptyBytes);
+
+    // the reserved buckets are neither grown by the inserts nor shrunk under them
+    for (uint64_t i = 0; i < ITERATIONS; i++) {
+        ASSERT_TRUE(volt.insert(i, i) == NULL);
+        ASSERT_FALSE(volt.isResizing());
+    }
+    ASSERT_TRUE(volt.verify());
+
+    // once filled, the table shrinks normally again
+    bool shrank = false;
+    for (uint64_t i = 0; i < ITERATIONS; i++) {
+        ASSERT_TRUE(volt.erase(i, i));
+        shrank = shrank || volt.isResizing();
+    }
+    ASSERT_TRUE(shrank);
+    ASSERT_TRUE(volt.verify());
+}
+
 TEST_F(CompactingHashTest, Benchmark) {
     const int ITERATIONS = 10000;
 
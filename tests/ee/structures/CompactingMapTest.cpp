@@ -497,6 +497,53 @@ TEST_F(CompactingMapTest, Trivial) {
     ASSERT_TRUE(m.verify());
 }
 
+TEST_F(CompactingMapTest, BulkLoad) {
+    // every size up to a few levels deep, so each shape of bottom level is built
+    for (int size = 0; size < 130; size++) {
+        std::vector<NormalKeyValuePair<int, int> > entries;
+        for (int i = 0; i < size; i++) {
+            entries.push_back(NormalKeyValuePair<int, int>(i * 2, i));
+        }
+        voltdb::CompactingMap<NormalKeyValuePair<int, int>, IntComparator, true> m(true, IntComparator());
+        ASSERT_TRUE(m.bulkLoad(entries));
+        ASSERT_EQ(size, m.size());
+        ASSERT_TRUE(m.verify());
+        ASSERT_TRUE(m.verifyRank());
+        for (int i = 0; i < size; i++) {
+            ASSERT_EQ(i, m.find(i * 2).value());
+            ASSERT_EQ(i + 1, m.rankAsc(i * 2));
+        }
+
+        // the loaded map keeps working as an ordinary map
+        for (int i = 0; i < size; i += 3) {
+            ASSERT_TRUE(m.erase(i * 2));
+            ASSERT_TRUE(m.insert(std::pair<int,int>(i * 2 + 1, i)));
+        }
+        ASSERT_TRUE(m.verify());
+        ASSERT_TRUE(m.verifyRank());
+
+        // only an empty map can be bulk loaded
+        if (size > 0) {
+            ASSERT_FALSE(m.bulkLoad(entries));
+        }
+    }
+
+    // duplicates are refused by a unique map, kept by a multimap
+    std::vector<NormalKeyValuePair<int, int> > dups;
+    dups.push_back(NormalKeyValuePair<int, int>(1, 1));
+    dups.push_back(NormalKeyValuePair<int, int>(2, 2));
+    dups.push_back(NormalKeyValuePair<int, int>(2, 3));
+    voltdb::CompactingMap<NormalKeyValuePair<int, int>, IntComparator> unique(true, IntComparator());
+    ASSERT_FALSE(unique.bulkLoad(dups));
+    ASSERT_EQ(0, unique.size());
+    voltdb::CompactingMap<NormalKeyValuePair<int, int>, IntComparator> multi(false, IntComparator());
+    ASSERT_TRUE(multi.bulkLoad(dups));
+    ASSERT_EQ(3, multi.size());
+    ASSERT_TRUE(multi.verify());
+    ASSERT_TRUE(multi.erase(2));
+    ASSERT_TRUE(multi.verify());
+}
+
 TEST_F(CompactingMapTest, RandomUnique) {
     const int ITERATIONS = 1001;
     const int BIGGEST_VAL = 100;
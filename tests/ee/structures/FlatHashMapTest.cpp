@@ -0,0 +1,157 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2018 VoltDB Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <cstdlib>
+#include <boost/unordered_map.hpp>
+#include "harness.h"
+#include "structures/FlatHashMap.h"
+
+using namespace voltdb;
+
+class FlatHashMapTest : public Test {
+};
+
+// A hasher that maps every key into only a few distinct hashes, to
+// exercise long probe sequences.
+struct CollidingHasher {
+    size_t operator()(int64_t key) const {
+        return static_cast<size_t>(key % 4);
+    }
+};
+
+TEST_F(FlatHashMapTest, Basic) {
+    FlatHashMap<int64_t, int64_t> map;
+    ASSERT_TRUE(map.empty());
+    ASSERT_TRUE(map.find(1) == map.end());
+    ASSERT_TRUE(map.begin() == map.end());
+
+    std::pair<FlatHashMap<int64_t, int64_t>::iterator, bool> result = map.insert(std::make_pair(1, 10));
+    ASSERT_TRUE(result.second);
+    ASSERT_EQ(1, result.first->first);
+    ASSERT_EQ(10, result.first->second);
+
+    // A second insert of the same key leaves the first value in place.
+    result = map.insert(std::make_pair(1, 20));
+    ASSERT_FALSE(result.second);
+    ASSERT_EQ(10, result.first->second);
+    ASSERT_EQ(1, map.size());
+
+    // Values can be updated through the iterator.
+    map.find(1)->second = 30;
+    FlatHashMap<int64_t, int64_t>::const_iterator iter = map.find(1);
+    ASSERT_TRUE(iter != map.end());
+    ASSERT_EQ(30, iter->second);
+    ASSERT_TRUE(map.find(2) == map.end());
+
+    // Zero is a valid key even though a zero hash marks an empty slot.
+    result = map.insert(std::make_pair(0, 0));
+    ASSERT_TRUE(result.second);
+    ASSERT_TRUE(map.find(0) != map.end());
+    ASSERT_EQ(2, map.size());
+}
+
+TEST_F(FlatHashMapTest, Fuzz) {
+    const int ITERATIONS = 100000;
+
+    boost::unordered_map<int64_t, int64_t> stl;
+    FlatHashMap<int64_t, int64_t> flat;
+
+    for (int i = 0; i < ITERATIONS; i++) {
+        int64_t key = rand() % (ITERATIONS / 4);
+        if (rand() % 2) {
+            bool stlInserted = stl.insert(std::make_pair(key, i)).second;
+            bool flatInserted = flat.insert(std::make_pair(key, i)).second;
+            ASSERT_EQ(stlInserted, flatInserted);
+        }
+        else {
+            boost::unordered_map<int64_t, int64_t>::iterator stlIter = stl.find(key);
+            FlatHashMap<int64_t, int64_t>::iterator flatIter = flat.find(key);
+            ASSERT_EQ(stlIter == stl.end(), flatIter == flat.end());
+            if (stlIter != stl.end()) {
+                ASSERT_EQ(stlIter->second, flatIter->second);
+            }
+        }
+        ASSERT_EQ(stl.size(), flat.size());
+    }
+
+    // Iteration visits every entry exactly once.
+    size_t count = 0;
+    for (FlatHashMap<int64_t, int64_t>::const_iterator iter = flat.begin(); iter != flat.end(); ++iter) {
+        ASSERT_EQ(stl[iter->first], iter->second);
+        ++count;
+    }
+    ASSERT_EQ(stl.size(), count);
+}
+
+TEST_F(FlatHashMapTest, Collisions) {
+    FlatHashMap<int64_t, int64_t, CollidingHasher> map;
+    for (int64_t i = 0; i < 1000; ++i) {
+        ASSERT_TRUE(map.insert(std::make_pair(i, i * 2)).second);
+    }
+    ASSERT_EQ(1000, map.size());
+    for (int64_t i = 0; i < 1000; ++i) {
+        FlatHashMap<int64_t, int64_t, CollidingHasher>::iterator iter = map.find(i);
+        ASSERT_TRUE(iter != map.end());
+        ASSERT_EQ(i * 2, iter->second);
+    }
+    ASSERT_TRUE(map.find(1000) == map.end());
+}
+
+TEST_F(FlatHashMapTest, ClearAndReuse) {
+    FlatHashMap<int64_t, int64_t> map;
+    for (int64_t i = 0; i < 10000; ++i) {
+        map.insert(std::make_pair(i, i));
+    }
+    size_t bucketCount = map.bucket_count();
+
+    // Clearing a well-used map keeps its slots.
+    map.clear();
+    ASSERT_TRUE(map.empty());
+    ASSERT_TRUE(map.begin() == map.end());
+    ASSERT_TRUE(map.find(5) == map.end());
+    ASSERT_EQ(bucketCount, map.bucket_count());
+
+    // Clearing a map that used far fewer slots than it has shrinks it.
+    for (int64_t i = 0; i < 10; ++i) {
+        map.insert(std::make_pair(i, i + 1));
+    }
+    ASSERT_EQ(10, map.size());
+    ASSERT_EQ(6, map.find(5)->second);
+    map.clear();
+    ASSERT_TRUE(map.bucket_count() < bucketCount);
+
+    for (int64_t i = 0; i < 100; ++i) {
+        ASSERT_TRUE(map.insert(std::make_pair(i, i)).second);
+    }
+    ASSERT_EQ(100, map.size());
+
+    FlatHashMap<int64_t, int64_t> other;
+    other.swap(map);
+    ASSERT_TRUE(map.empty());
+    ASSERT_EQ(100, other.size());
+    ASSERT_EQ(42, other.find(42)->second);
+}
+
+int main() {
+    return TestSuite::globalInstance()->runAll();
+}
@@ -0,0 +1,318 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2018 VoltDB Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef TESTS_EE_TEST_UTILS_JOINEXECUTORTESTBASE_HPP
+#define TESTS_EE_TEST_UTILS_JOINEXECUTORTESTBASE_HPP
+
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <boost/foreach.hpp>
+
+#include "harness.h"
+
+#include "test_utils/Tools.hpp"
+#include "test_utils/UniqueEngine.hpp"
+
+#include "common/executorcontext.hpp"
+#include "common/tabletuple.h"
+#include "common/ValuePeeker.hpp"
+#include "execution/ExecutorVector.h"
+#include "storage/AbstractTempTable.hpp"
+#include "storage/table.h"
+#include "storage/tableiterator.h"
+
+/**
+ * A fixture for tests of the join executors.  It loads a catalog of two
+ * tables,
+ *
+ * CREATE TABLE OUTER_T (
+ *     ID INTEGER NOT NULL,
+ *     K INTEGER
+ * );
+ * CREATE TABLE INNER_T (
+ *     ID INTEGER NOT NULL,
+ *     K INTEGER,
+ *     F FLOAT,
+ *     B BIGINT
+ * );
+ *
+ * and builds the JSON of plans that scan them into a join of all their
+ * columns.  Each test supplies its own rows and the attributes of the
+ * join node.
+ */
+class JoinExecutorTestBase : public Test {
+public:
+    typedef std::pair<int32_t, int32_t> IdPair;
+    // Stands in for the NULL ID of a null-padded side of a result row.
+    static const int32_t NULL_ID = -1;
+
+    // Value types of the columns of OUTER_T and INNER_T
+    static const int OUTER_TYPES[];
+    static const int INNER_TYPES[];
+
+    JoinExecutorTestBase()
+        : m_engine(UniqueEngineBuilder().build())
+    {
+        m_engine->loadCatalog(0, catalogPayload);
+    }
+
+    /** Insert rows of std::tuples, in order, into the named table. */
+    template <typename Row>
+    void insertRows(const std::string& tableName, const std::vector<Row>& rows)
+    {
+        voltdb::Table* table = m_engine->getTableByName(tableName);
+        voltdb::StandAloneTupleStorage storage(table->schema());
+        voltdb::TableTuple tuple = storage.tuple();
+        BOOST_FOREACH(const Row& row, rows) {
+            Tools::initTuple(&tuple, row);
+            table->insertTuple(tuple);
+        }
+    }
+
+    /**
+     * Execute the plan and return the (OUTER_T.ID, INNER_T.ID) pair of every
+     * result row, in the order the join produced them.
+     */
+    std::vector<IdPair> execute(const std::string& jsonPlan)
+    {
+        std::vector<IdPair> ids;
+        auto ev = voltdb::ExecutorVector::fromJsonPlan(m_engine.get(), jsonPlan, 0);
+        voltdb::UniqueTempTableResult result = m_engine->executePlanFragment(ev.get(), NULL);
+        voltdb::TableTuple tuple(result->schema());
+        voltdb::TableIterator iter = result->iterator();
+        while (iter.next(tuple)) {
+            ids.push_back(IdPair(peekId(tuple.getNValue(0)), peekId(tuple.getNValue(2))));
+        }
+        voltdb::ExecutorContext::getExecutorContext()->cleanupAllExecutors();
+        return ids;
+    }
+
+    void verify(const std::vector<IdPair>& expected, const std::vector<IdPair>& actual)
+    {
+        ASSERT_EQ(expected.size(), actual.size());
+        for (int i = 0; i < expected.size(); i++) {
+            EXPECT_EQ(expected[i].first, actual[i].first);
+            EXPECT_EQ(expected[i].second, actual[i].second);
+        }
+    }
+
+    /**
+     * A plan for
+     *
+     * SELECT * FROM OUTER_T <join> INNER_T ...;
+     *
+     * where the join node is of the given type, with the given JSON
+     * attributes particular to that type.
+     */
+    static std::string joinPlan(const std::string& joinNodeType, const std::string& joinAttributes)
+    {
+        std::ostringstream json;
+        json << "{\"PLAN_NODES\":["
+             << "{\"ID\":1,\"PLAN_NODE_TYPE\":\"" << joinNodeType << "\",\"CHILDREN_IDS\":[2,3],"
+             << "\"OUTPUT_SCHEMA\":["
+             << columnJson("ID", OUTER_TYPES[0], 0, 0) << ","
+             << columnJson("K", OUTER_TYPES[1], 1, 0) << ","
+             << columnJson("ID", INNER_TYPES[0], 0, 1) << ","
+             << columnJson("K", INNER_TYPES[1], 1, 1) << ","
+             << columnJson("F", INNER_TYPES[2], 2, 1) << ","
+             << columnJson("B", INNER_TYPES[3], 3, 1) << "],"
+             << joinAttributes << "},"
+             << "{\"ID\":2,\"PLAN_NODE_TYPE\":\"SEQSCAN\","
+             << "\"INLINE_NODES\":[{\"ID\":4,\"PLAN_NODE_TYPE\":\"PROJECTION\",\"OUTPUT_SCHEMA\":["
+             << columnJson("ID", OUTER_TYPES[0], 0, 0) << ","
+             << columnJson("K", OUTER_TYPES[1], 1, 0) << "]}],"
+             << "\"TARGET_TABLE_NAME\":\"OUTER_T\",\"TARGET_TABLE_ALIAS\":\"OUTER_T\"},"
+             << "{\"ID\":3,\"PLAN_NODE_TYPE\":\"SEQSCAN\","
+             << "\"INLINE_NODES\":[{\"ID\":5,\"PLAN_NODE_TYPE\":\"PROJECTION\",\"OUTPUT_SCHEMA\":["
+             << columnJson("ID", INNER_TYPES[0], 0, 0) << ","
+             << columnJson("K", INNER_TYPES[1], 1, 0) << ","
+             << columnJson("F", INNER_TYPES[2], 2, 0) << ","
+             << columnJson("B", INNER_TYPES[3], 3, 0) << "]}],"
+             << "\"TARGET_TABLE_NAME\":\"INNER_T\",\"TARGET_TABLE_ALIAS\":\"INNER_T\"}"
+             << "],"
+             << "\"EXECUTE_LIST\":[2,3,1],"
+             << "\"IS_LARGE_QUERY\":false}";
+        return json.str();
+    }
+
+    /** A tuple value expression for a key evaluated against one side's tuple alone. */
+    static std::string keyJson(int valueType, int columnIndex)
+    {
+        std::ostringstream json;
+        json << "{\"TYPE\":32,\"VALUE_TYPE\":" << valueType
+             << ",\"COLUMN_IDX\":" << columnIndex << "}";
+        return json.str();
+    }
+
+    static const std::string catalogPayload;
+
+protected:
+    UniqueEngine m_engine;
+
+private:
+    static int32_t peekId(const voltdb::NValue& id)
+    {
+        return id.isNull() ? NULL_ID : voltdb::ValuePeeker::peekInteger(id);
+    }
+
+    static std::string columnJson(const std::string& name, int valueType, int columnIndex, int tableIndex)
+    {
+        std::ostringstream json;
+        json << "{\"COLUMN_NAME\":\"" << name << "\","
+             << "\"EXPRESSION\":{\"TYPE\":32,\"VALUE_TYPE\":" << valueType
+             << ",\"COLUMN_IDX\":" << columnIndex
+             << ",\"TABLE_IDX\":" << tableIndex << "}}";
+        return json.str();
+    }
+};
+
+const int JoinExecutorTestBase::OUTER_TYPES[] = { 5, 5 };
+const int JoinExecutorTestBase::INNER_TYPES[] = { 5, 5, 8, 6 };
+
+const std::string JoinExecutorTestBase::catalogPayload =
+    "add / clusters cluster\n"
+    "set /clusters#cluster localepoch 1199145600\n"
+    "set $PREV securityEnabled false\n"
+    "set $PREV httpdportno -1\n"
+    "set $PREV jsonapi true\n"
+    "set $PREV networkpartition false\n"
+    "set $PREV heartbeatTimeout 90\n"
+    "set $PREV useddlschema false\n"
+    "set $PREV drConsumerEnabled false\n"
+    "set $PREV drProducerEnabled true\n"
+    "set $PREV drRole \"master\"\n"
+    "set $PREV drClusterId 0\n"
+    "set $PREV drProducerPort 5555\n"
+    "set $PREV drMasterHost \"\"\n"
+    "set $PREV drFlushInterval 1000\n"
+    "set $PREV preferredSource 0\n"
+    "add /clusters#cluster databases database\n"
+    "set /clusters#cluster/databases#database isActiveActiveDRed false\n"
+    "set $PREV securityprovider \"hash\"\n"
+    "add /clusters#cluster/databases#database tables OUTER_T\n"
+    "set /clusters#cluster/databases#database/tables#OUTER_T isreplicated true\n"
+    "set $PREV partitioncolumn null\n"
+    "set $PREV estimatedtuplecount 0\n"
+    "set $PREV materializer null\n"
+    "set $PREV signature \"OUTER_T|ii\"\n"
+    "set $PREV tuplelimit 2147483647\n"
+    "set $PREV isDRed false\n"
+    "add /clusters#cluster/databases#database/tables#OUTER_T columns ID\n"
+    "set /clusters#cluster/databases#database/tables#OUTER_T/columns#ID index 0\n"
+    "set $PREV type 5\n"
+    "set $PREV size 4\n"
+    "set $PREV nullable false\n"
+    "set $PREV name \"ID\"\n"
+    "set $PREV defaultvalue null\n"
+    "set $PREV defaulttype 0\n"
+    "set $PREV aggregatetype 0\n"
+    "set $PREV matviewsource null\n"
+    "set $PREV matview null\n"
+    "set $PREV inbytes false\n"
+    "add /clusters#cluster/databases#database/tables#OUTER_T columns K\n"
+    "set /clusters#cluster/databases#database/tables#OUTER_T/columns#K index 1\n"
+    "set $PREV type 5\n"
+    "set $PREV size 4\n"
+    "set $PREV nullable true\n"
+    "set $PREV name \"K\"\n"
+    "set $PREV defaultvalue null\n"
+    "set $PREV defaulttype 0\n"
+    "set $PREV aggregatetype 0\n"
+    "set $PREV matviewsource null\n"
+    "set $PREV matview null\n"
+    "set $PREV inbytes false\n"
+    "add /clusters#cluster/databases#database tables INNER_T\n"
+    "set /clusters#cluster/databases#database/tables#INNER_T isreplicated true\n"
+    "set $PREV partitioncolumn null\n"
+    "set $PREV estimatedtuplecount 0\n"
+    "set $PREV materializer null\n"
+    "set $PREV signature \"INNER_T|iifb\"\n"
+    "set $PREV tuplelimit 2147483647\n"
+    "set $PREV isDRed false\n"
+    "add /clusters#cluster/databases#database/tables#INNER_T columns ID\n"
+    "set /clusters#cluster/databases#database/tables#INNER_T/columns#ID index 0\n"
+    "set $PREV type 5\n"
+    "set $PREV size 4\n"
+    "set $PREV nullable false\n"
+    "set $PREV name \"ID\"\n"
+    "set $PREV defaultvalue null\n"
+    "set $PREV defaulttype 0\n"
+    "set $PREV aggregatetype 0\n"
+    "set $PREV matviewsource null\n"
+    "set $PREV matview null\n"
+    "set $PREV inbytes false\n"
+    "add /clusters#cluster/databases#database/tables#INNER_T columns K\n"
+    "set /clusters#cluster/databases#database/tables#INNER_T/columns#K index 1\n"
+    "set $PREV type 5\n"
+    "set $PREV size 4\n"
+    "set $PREV nullable true\n"
+    "set $PREV name \"K\"\n"
+    "set $PREV defaultvalue null\n"
+    "set $PREV defaulttype 0\n"
+    "set $PREV aggregatetype 0\n"
+    "set $PREV matviewsource null\n"
+    "set $PREV matview null\n"
+    "set $PREV inbytes false\n"
+    "add /clusters#cluster/databases#database/tables#INNER_T columns F\n"
+    "set /clusters#cluster/databases#database/tables#INNER_T/columns#F index 2\n"
+    "set $PREV type 8\n"
+    "set $PREV size 8\n"
+    "set $PREV nullable true\n"
+    "set $PREV name \"F\"\n"
+    "set $PREV defaultvalue null\n"
+    "set $PREV defaulttype 0\n"
+    "set $PREV aggregatetype 0\n"
+    "set $PREV matviewsource null\n"
+    "set $PREV matview null\n"
+    "set $PREV inbytes false\n"
+    "add /clusters#cluster/databases#database/tables#INNER_T columns B\n"
+    "set /clusters#cluster/databases#database/tables#INNER_T/columns#B index 3\n"
+    "set $PREV type 6\n"
+    "set $PREV size 8\n"
+    "set $PREV nullable true\n"
+    "set $PREV name \"B\"\n"
+    "set $PREV defaultvalue null\n"
+    "set $PREV defaulttype 0\n"
+    "set $PREV aggregatetype 0\n"
+    "set $PREV matviewsource null\n"
+    "set $PREV matview null\n"
+    "set $PREV inbytes false\n"
+    "add /clusters#cluster deployment deployment\n"
+    "set /clusters#cluster/deployment#deployment kfactor 0\n"
+    "add /clusters#cluster/deployment#deployment systemsettings systemsettings\n"
+    "set /clusters#cluster/deployment#deployment/systemsettings#systemsettings temptablemaxsize 100\n"
+    "set $PREV snapshotpriority 6\n"
+    "set $PREV elasticduration 50\n"
+    "set $PREV elasticthroughput 2\n"
+    "set $PREV querytimeout 10000\n"
+    "add /clusters#cluster logconfig log\n"
+    "set /clusters#cluster/logconfig#log enabled false\n"
+    "set $PREV synchronous false\n"
+    "set $PREV fsyncInterval 200\n"
+    "set $PREV maxTxns 2147483647\n"
+    "set $PREV logSize 1024\n";
+
+#endif // TESTS_EE_TEST_UTILS_JOINEXECUTORTESTBASE_HPP
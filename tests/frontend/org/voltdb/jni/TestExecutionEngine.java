@@ -292,7 +292,7 @@ public class TestExecutionEngine extends TestCase {
         predicates.addPredicate(new HashRangeExpressionBuilder()
                                         .put(0x00000000, 0x7fffffff)
                                         .build(0),
-                                true);
+                                true, false);
 
         // Build the index
         sourceEngine.activateTableStream(STOCK_TABLEID, TableStreamType.ELASTIC_INDEX, Long.MAX_VALUE, predicates.toBytes());
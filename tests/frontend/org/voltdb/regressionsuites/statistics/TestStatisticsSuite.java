@@ -447,7 +447,7 @@ public class TestStatisticsSuite extends StatisticsTestSuiteBase {
         System.out.println("\n\nTESTING MEMORY STATS\n\n\n");
         Client client  = getFullyConnectedClient();
 
-        ColumnInfo[] expectedSchema = new ColumnInfo[14];
+        ColumnInfo[] expectedSchema = new ColumnInfo[21];
         expectedSchema[0] = new ColumnInfo("TIMESTAMP", VoltType.BIGINT);
         expectedSchema[1] = new ColumnInfo("HOST_ID", VoltType.INTEGER);
         expectedSchema[2] = new ColumnInfo("HOSTNAME", VoltType.STRING);
@@ -462,6 +462,13 @@ public class TestStatisticsSuite extends StatisticsTestSuiteBase {
         expectedSchema[11] = new ColumnInfo("POOLEDMEMORY", VoltType.BIGINT);
         expectedSchema[12] = new ColumnInfo("PHYSICALMEMORY", VoltType.BIGINT);
         expectedSchema[13] = new ColumnInfo("JAVAMAXHEAP", VoltType.INTEGER);
+        expectedSchema[14] = new ColumnInfo("MAPPEDMEMORY", VoltType.BIGINT);
+        expectedSchema[15] = new ColumnInfo("HUGEPAGEMEMORY", VoltType.BIGINT);
+        expectedSchema[16] = new ColumnInfo("NUMALOCALMEMORY", VoltType.BIGINT);
+        expectedSchema[17] = new ColumnInfo("STREAMBUFFERHITS", VoltType.BIGINT);
+        expectedSchema[18] = new ColumnInfo("STREAMBUFFERMISSES", VoltType.BIGINT);
+        expectedSchema[19] = new ColumnInfo("STREAMBUFFEROUTSTANDING", VoltType.BIGINT);
+        expectedSchema[20] = new ColumnInfo("STREAMBUFFERPOOLED", VoltType.BIGINT);
         VoltTable expectedTable = new VoltTable(expectedSchema);
 
         VoltTable[] results = null;
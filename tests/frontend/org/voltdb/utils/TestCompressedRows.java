@@ -0,0 +1,121 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2018 VoltDB Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+package org.voltdb.utils;
+
+import java.io.IOException;
+import java.nio.ByteBuffer;
+import java.util.Arrays;
+
+import junit.framework.TestCase;
+
+import net.jpountz.lz4.LZ4Compressor;
+import net.jpountz.lz4.LZ4Factory;
+
+public class TestCompressedRows extends TestCase {
+
+    private static final int ROW_COUNT = 100;
+    private static final int HEADER_LENGTH = 10;
+
+    // Rows as the EE serializes them: a length and then the columns
+    private static byte[] makeRows() {
+        ByteBuffer rows = ByteBuffer.allocate(ROW_COUNT * 16);
+        for (int i = 0; i < ROW_COUNT; i++) {
+            rows.putInt(12);
+            rows.putInt(i);
+            rows.putLong(0);
+        }
+        return rows.array();
+    }
+
+    // A table header, the row count and the rows, compressed as the EE does
+    private static ByteBuffer makeChunk(byte rows[], boolean compress, int capacity) {
+        ByteBuffer chunk = ByteBuffer.allocate(capacity);
+        chunk.position(HEADER_LENGTH);
+        chunk.putInt(ROW_COUNT);
+        if (compress) {
+            LZ4Compressor compressor = LZ4Factory.fastestInstance().fastCompressor();
+            byte compressed[] = compressor.compress(rows);
+            chunk.putInt(CompressedRows.COMPRESSED_ROWS_MARKER);
+            chunk.putInt(rows.length);
+            chunk.putInt(compressed.length);
+            chunk.put(compressed);
+        } else {
+            chunk.put(rows);
+        }
+        chunk.flip();
+        return chunk;
+    }
+
+    private static byte[] getRows(ByteBuffer chunk) {
+        byte rows[] = new byte[chunk.limit() - HEADER_LENGTH - 4];
+        ByteBuffer dup = chunk.duplicate();
+        dup.position(HEADER_LENGTH + 4);
+        dup.get(rows);
+        return rows;
+    }
+
+    public void testDecompress() throws IOException {
+        byte rows[] = makeRows();
+        ByteBuffer chunk = makeChunk(rows, true, 4096);
+        assertTrue(chunk.limit() < HEADER_LENGTH + 4 + rows.length);
+        assertTrue(CompressedRows.isCompressed(chunk, HEADER_LENGTH));
+
+        CompressedRows.decompress(chunk, HEADER_LENGTH);
+        assertEquals(0, chunk.position());
+        assertEquals(HEADER_LENGTH + 4 + rows.length, chunk.limit());
+        assertEquals(ROW_COUNT, chunk.getInt(HEADER_LENGTH));
+        assertTrue(Arrays.equals(rows, getRows(chunk)));
+        assertFalse(CompressedRows.isCompressed(chunk, HEADER_LENGTH));
+    }
+
+    public void testPlainRows() throws IOException {
+        byte rows[] = makeRows();
+        ByteBuffer chunk = makeChunk(rows, false, 4096);
+        assertFalse(CompressedRows.isCompressed(chunk, HEADER_LENGTH));
+
+        CompressedRows.decompress(chunk, HEADER_LENGTH);
+        assertEquals(HEADER_LENGTH + 4 + rows.length, chunk.limit());
+        assertTrue(Arrays.equals(rows, getRows(chunk)));
+    }
+
+    public void testNoRoom() {
+        byte rows[] = makeRows();
+        ByteBuffer chunk = makeChunk(rows, true, HEADER_LENGTH + 4 + rows.length - 1);
+        try {
+            CompressedRows.decompress(chunk, HEADER_LENGTH);
+            fail("Decompressed rows into a buffer that is too small");
+        } catch (IOException expected) {}
+    }
+
+    public void testCorrupt() {
+        byte rows[] = makeRows();
+        ByteBuffer chunk = makeChunk(rows, true, 4096);
+        // Claim more rows than the block holds
+        chunk.putInt(HEADER_LENGTH + 8, rows.length + 16);
+        try {
+            CompressedRows.decompress(chunk, HEADER_LENGTH);
+            fail("Decompressed a corrupt block");
+        } catch (IOException expected) {}
+    }
+}